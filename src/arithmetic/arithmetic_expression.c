@@ -102,6 +102,21 @@ static void _AR_EXP_InplaceRepurposeConstant(AR_ExpNode *node, SIValue v) {
 	node->operand.constant  =  v;
 }
 
+void AR_EXP_InplaceRepurposeVariadic(AR_ExpNode *node, const char *alias) {
+	ASSERT(node  != NULL);
+	ASSERT(alias != NULL);
+
+	// free node internals
+	if(AR_EXP_IsOperation(node)) _AR_EXP_FreeOpInternals(node);
+	else if(AR_EXP_IsConstant(node)) SIValue_Free(node->operand.constant);
+
+	// repurpose as variadic operand
+	node->type                               =  AR_EXP_OPERAND;
+	node->operand.type                       =  AR_EXP_VARIADIC;
+	node->operand.variadic.entity_alias      =  alias;
+	node->operand.variadic.entity_alias_idx  =  IDENTIFIER_NOT_FOUND;
+}
+
 static AR_ExpNode *_AR_EXP_CloneOperand(AR_ExpNode *exp) {
 	AR_ExpNode *clone = rm_calloc(1, sizeof(AR_ExpNode));
 	clone->type = AR_EXP_OPERAND;
@@ -170,6 +170,10 @@ const char *AR_EXP_GetFuncName(const AR_ExpNode *exp);
 // clones given expression
 AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp);
 
+// repurpose node in place as a reference to the record entry 'alias'
+// 'alias' isn't owned by the node and must outlive it
+void AR_EXP_InplaceRepurposeVariadic(AR_ExpNode *node, const char *alias);
+
 // free arithmetic expression tree
 void AR_EXP_Free(AR_ExpNode *root);
 
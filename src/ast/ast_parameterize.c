@@ -0,0 +1,135 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ast_parameterize.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+
+// prefix of lifted parameter names
+#define LIFTED_PARAM_PREFIX "__p"
+
+#define RANGE_ISLT(a, b) ((a)->start.offset < (b)->start.offset)
+
+// collects literals which can be replaced by parameters
+static void _CollectLiterals
+(
+	const cypher_astnode_t *node,
+	struct cypher_input_range **ranges
+) {
+	cypher_astnode_type_t t = cypher_astnode_type(node);
+
+	if(t == CYPHER_AST_INTEGER ||
+	   t == CYPHER_AST_FLOAT   ||
+	   t == CYPHER_AST_STRING) {
+		array_append(*ranges, cypher_astnode_range(node));
+		return;
+	}
+
+	// variable length traversal bounds are not expressions
+	if(t == CYPHER_AST_RANGE) return;
+
+	// procedure arguments might be required to be constant
+	if(t == CYPHER_AST_CALL) return;
+
+	// unaliased projections are named after their expression
+	// ORDER BY might refer to such a projection by its expression
+	if(t == CYPHER_AST_ORDER_BY) return;
+	if(t == CYPHER_AST_PROJECTION &&
+	   cypher_ast_projection_get_alias(node) == NULL) return;
+
+	uint n = cypher_astnode_nchildren(node);
+	for(uint i = 0; i < n; i++) {
+		_CollectLiterals(cypher_astnode_get_child(node, i), ranges);
+	}
+}
+
+sds AST_ParameterizeLiterals
+(
+	const cypher_parse_result_t *result,
+	const char *query,
+	const char *body
+) {
+	ASSERT(body   != NULL);
+	ASSERT(query  != NULL);
+	ASSERT(result != NULL);
+
+	// the body is expected to be the query's suffix
+	size_t query_len = strlen(query);
+	size_t body_len  = strlen(body);
+	if(body_len > query_len) return NULL;
+
+	size_t params_len = query_len - body_len;
+	if(strcmp(query + params_len, body) != 0) return NULL;
+
+	// avoid clashing with user provided parameters
+	sds params = sdsnewlen(query, params_len);
+	if(strstr(params, LIFTED_PARAM_PREFIX) != NULL) {
+		sdsfree(params);
+		return NULL;
+	}
+
+	// locate query root, skipping comments
+	const cypher_astnode_t *root = NULL;
+	uint nroots = cypher_parse_result_nroots(result);
+	for(uint i = 0; i < nroots && root == NULL; i++) {
+		const cypher_astnode_t *r = cypher_parse_result_get_root(result, i);
+		if(cypher_astnode_type(r) == CYPHER_AST_STATEMENT) root = r;
+	}
+
+	// only queries are parameterized, index operations are left as is
+	const cypher_astnode_t *stmt = root ? cypher_ast_statement_get_body(root) : NULL;
+	if(stmt == NULL || cypher_astnode_type(stmt) != CYPHER_AST_QUERY) {
+		sdsfree(params);
+		return NULL;
+	}
+
+	struct cypher_input_range *ranges = array_new(struct cypher_input_range, 0);
+	_CollectLiterals(stmt, &ranges);
+
+	uint n = array_len(ranges);
+	if(n == 0) {
+		array_free(ranges);
+		sdsfree(params);
+		return NULL;
+	}
+
+	// order literals by their position within the query
+	QSORT(struct cypher_input_range, ranges, n, RANGE_ISLT);
+
+	// CYPHER <user params> <lifted params> <body>
+	sds rewritten = sdsempty();
+	if(params_len == 0) rewritten = sdscat(rewritten, "CYPHER ");
+	else rewritten = sdscatsds(rewritten, params);
+	rewritten = sdscat(rewritten, " ");
+
+	for(uint i = 0; i < n; i++) {
+		size_t start = ranges[i].start.offset;
+		size_t end   = ranges[i].end.offset;
+		ASSERT(start < end && end <= body_len);
+
+		rewritten = sdscatprintf(rewritten, LIFTED_PARAM_PREFIX "%u=", i);
+		rewritten = sdscatlen(rewritten, body + start, end - start);
+		rewritten = sdscat(rewritten, " ");
+	}
+
+	// replace each literal with its parameter
+	size_t offset = 0;
+	for(uint i = 0; i < n; i++) {
+		size_t start = ranges[i].start.offset;
+		ASSERT(start >= offset);
+
+		rewritten = sdscatlen(rewritten, body + offset, start - offset);
+		rewritten = sdscatprintf(rewritten, "$" LIFTED_PARAM_PREFIX "%u", i);
+		offset = ranges[i].end.offset;
+	}
+	rewritten = sdscat(rewritten, body + offset);
+
+	array_free(ranges);
+	sdsfree(params);
+
+	return rewritten;
+}
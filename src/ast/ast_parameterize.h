@@ -0,0 +1,27 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "ast.h"
+#include "../util/sds/sds.h"
+
+// lifts the literals of a parsed query into parameters
+// such that queries which differ only by their literals share a cache entry
+//
+// e.g.
+// MATCH (n {v: 1}) RETURN n.x AS x
+// is rewritten as:
+// CYPHER __p0=1 MATCH (n {v: $__p0}) RETURN n.x AS x
+//
+// returns NULL if there are no literals to lift, otherwise returns the
+// rewritten query, including the user provided parameters
+sds AST_ParameterizeLiterals
+(
+	const cypher_parse_result_t *result,  // parsed query body
+	const char *query,                    // full query, including parameters
+	const char *body                      // query body
+);
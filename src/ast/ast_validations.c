@@ -1808,6 +1808,47 @@ cleanup:
 	return res;
 }
 
+// validate a unique constraint operation
+// CREATE CONSTRAINT ON (n:L) ASSERT n.v IS UNIQUE
+static AST_Validation _ValidateConstraint
+(
+	const cypher_astnode_t *body
+) {
+	bool create = (cypher_astnode_type(body) ==
+			CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT);
+
+	bool unique = create
+		? cypher_ast_create_node_prop_constraint_is_unique(body)
+		: cypher_ast_drop_node_prop_constraint_is_unique(body);
+	const cypher_astnode_t *identifier = create
+		? cypher_ast_create_node_prop_constraint_get_identifier(body)
+		: cypher_ast_drop_node_prop_constraint_get_identifier(body);
+	const cypher_astnode_t *exp = create
+		? cypher_ast_create_node_prop_constraint_get_expression(body)
+		: cypher_ast_drop_node_prop_constraint_get_expression(body);
+
+	if(!unique) {
+		ErrorCtx_SetError("RedisGraph only supports unique constraints");
+		return AST_INVALID;
+	}
+
+	// constrained expression must be an attribute of the constrained node
+	const cypher_astnode_t *entity = NULL;
+	if(cypher_astnode_type(exp) == CYPHER_AST_PROPERTY_OPERATOR) {
+		entity = cypher_ast_property_operator_get_expression(exp);
+	}
+
+	if(entity == NULL ||
+	   cypher_astnode_type(entity) != CYPHER_AST_IDENTIFIER ||
+	   strcmp(cypher_ast_identifier_get_name(entity),
+		   cypher_ast_identifier_get_name(identifier)) != 0) {
+		ErrorCtx_SetError("Unique constraint must be defined over a property of the constrained node");
+		return AST_INVALID;
+	}
+
+	return AST_VALID;
+}
+
 AST_Validation AST_Validate_QueryParams(const cypher_parse_result_t *result) {
 	int index;
 	if(_AST_Validate_ParseResultRoot(result, &index) != AST_VALID) return AST_INVALID;
@@ -1845,6 +1886,11 @@ AST_Validation AST_Validate_Query(const cypher_parse_result_t *result) {
 		return AST_VALID;
 	}
 
+	if(body_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   body_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		return _ValidateConstraint(body);
+	}
+
 	// validate positions of allShortestPaths
 	bool invalid = _ValidateAllShortestPaths(body);
 	if(invalid) {
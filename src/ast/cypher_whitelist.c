@@ -37,8 +37,8 @@ static void _buildTypesWhitelist(void) {
 		CYPHER_AST_CREATE_NODE_PROPS_INDEX,
 		CYPHER_AST_DROP_PROPS_INDEX,
 		CYPHER_AST_CREATE_PATTERN_PROPS_INDEX,
-		// CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
-		// CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
 		// CYPHER_AST_CREATE_REL_PROP_CONSTRAINT,
 		// CYPHER_AST_DROP_REL_PROP_CONSTRAINT,
 		CYPHER_AST_QUERY,
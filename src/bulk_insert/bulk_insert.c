@@ -410,6 +410,9 @@ int BulkInsert
 	ASSERT(argc == 0);
 
 cleanup:
+	// back populated entity blocks by the storage tier
+	if(res == BULK_OK) Graph_SealStorage(g);
+
 	// reset graph sync policy
 	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
 	Graph_ReleaseLock(g);
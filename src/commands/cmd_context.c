@@ -10,13 +10,20 @@
 #include "../util/rmalloc.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
+#include "prepared_statement.h"
 #include "../util/blocked_client.h"
+#include "../arithmetic/arithmetic_expression.h"
 
 /* Array with one entry per worker thread
  * keeps track after currently executing commands
  * initialized at module.c accessed via cmd_* and debug.c */
 CommandCtx **command_ctxs = NULL;
 
+// rax callback routine for freeing bound parameter values
+static void _ParameterFreeCallback(void *param_val) {
+	AR_EXP_Free(param_val);
+}
+
 CommandCtx *CommandCtx_New
 (
 	RedisModuleCtx *ctx,
@@ -26,7 +33,7 @@ CommandCtx *CommandCtx_New
 	GraphContext *graph_ctx,
 	ExecutorThread thread,
 	bool replicated_command,
-	bool compact,
+	ResultSetFormatterType format,
 	long long timeout
 ) {
 	CommandCtx *context = rm_malloc(sizeof(CommandCtx));
@@ -34,8 +41,10 @@ CommandCtx *CommandCtx_New
 	context->ctx = ctx;
 	context->query = NULL;
 	context->thread = thread;
-	context->compact = compact;
+	context->format = format;
 	context->timeout = timeout;
+	context->stmt = NULL;
+	context->params = NULL;
 	context->command_name = NULL;
 	context->graph_ctx = graph_ctx;
 	context->replicated_command = replicated_command;
@@ -143,6 +152,11 @@ void CommandCtx_Free(CommandCtx *command_ctx) {
 	CommandCtx_UntrackCtx(command_ctx);
 
 	if(command_ctx->query) rm_free(command_ctx->query);
+	if(command_ctx->stmt) PreparedStatement_Free(command_ctx->stmt);
+	// parameters weren't handed over to a query
+	if(command_ctx->params) {
+		raxFreeWithCallback(command_ctx->params, _ParameterFreeCallback);
+	}
 	rm_free(command_ctx->command_name);
 	rm_free(command_ctx);
 }
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include "rax.h"
 #include "cypher-parser.h"
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
+#include "../resultset/formatters/resultset_formatters.h"
 
 // ExecutorThread lists the diffrent types of threads in the system
 typedef enum {
@@ -25,9 +27,11 @@ typedef struct {
 	GraphContext *graph_ctx;        // Graph context.
 	RedisModuleBlockedClient *bc;   // Blocked client.
 	bool replicated_command;        // Whether this instance was spawned by a replication command.
-	bool compact;                   // Whether this query was issued with the compact flag.
+	ResultSetFormatterType format;  // Reply format requested by the client.
 	ExecutorThread thread;          // Which thread executes this command
 	long long timeout;              // The query timeout, if specified.
+	PreparedStatement *stmt;        // Prepared statement to execute, if any.
+	rax *params;                    // Parameters bound to the prepared statement.
 } CommandCtx;
 
 // Create a new command context.
@@ -40,7 +44,7 @@ CommandCtx *CommandCtx_New
 	GraphContext *graph_ctx,        // Graph context.
 	ExecutorThread thread,          // Which thread executes this command
 	bool replicated_command,        // Whether this instance was spawned by a replication command.
-	bool compact,                   // Whether this query was issued with the compact flag.
+	ResultSetFormatterType format,  // Reply format requested by the client.
 	long long timeout               // The query timeout, if specified.
 );
 
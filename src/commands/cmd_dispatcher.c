@@ -8,6 +8,7 @@
 #include "commands.h"
 #include "cmd_context.h"
 #include "../util/thpool/pools.h"
+#include "prepared_statement.h"
 #include "../util/blocked_client.h"
 #include "../configuration/config.h"
 
@@ -16,24 +17,28 @@
 // Command handler function pointer.
 typedef void(*Command_Handler)(void *args);
 
-// Read configuration flags, returning REDIS_MODULE_ERR if flag parsing failed.
-static int _read_flags(RedisModuleString **argv, int argc, bool *compact,
-					   long long *timeout, uint *graph_version, char **errmsg) {
+// Read configuration flags starting at argument 'offset',
+// returning REDIS_MODULE_ERR if flag parsing failed.
+static int _read_flags(RedisModuleString **argv, int argc, int offset,
+					   bool *compact, bool *binary, long long *timeout,
+					   uint *graph_version, char **errmsg) {
 
 	ASSERT(compact);
+	ASSERT(binary);
 	ASSERT(timeout);
 
 	// set defaults
 	*compact = false;  // verbose
+	*binary  = false;
 	*graph_version = GRAPH_VERSION_MISSING;
 	Config_Option_get(Config_TIMEOUT, timeout);
 
 	// GRAPH.QUERY <GRAPH_KEY> <QUERY>
-	// make sure we've got more than 3 arguments
-	if(argc <= 3) return REDISMODULE_OK;
+	// make sure we've got more than 'offset' arguments
+	if(argc <= offset) return REDISMODULE_OK;
 
 	// scan arguments
-	for(int i = 3; i < argc; i++) {
+	for(int i = offset; i < argc; i++) {
 		const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
 
 		// compact result-set
@@ -42,6 +47,12 @@ static int _read_flags(RedisModuleString **argv, int argc, bool *compact,
 			continue;
 		}
 
+		// binary result-set
+		if(!strcasecmp(arg, "--binary")) {
+			*binary = true;
+			continue;
+		}
+
 		if(!strcasecmp(arg, "version")) {
 			long long v = GRAPH_VERSION_MISSING;
 			int err = REDISMODULE_ERR;
@@ -86,6 +97,22 @@ static bool _verifyGraphVersion(GraphContext *gc, uint version) {
 	return (GraphContext_GetVersion(gc) == version);
 }
 
+// Determine reply format from the client's flags and protocol.
+static ResultSetFormatterType _reply_format(RedisModuleCtx *ctx, bool compact,
+		bool binary) {
+	if(binary) return FORMATTER_BINARY;
+	if(compact) return FORMATTER_COMPACT;
+
+	// verbose replies use native types when the client speaks RESP3
+	// and the server is able to emit them
+	if((RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_RESP3) &&
+	   RedisModule_ReplyWithMap != NULL) {
+		return FORMATTER_RESP3;
+	}
+
+	return FORMATTER_VERBOSE;
+}
+
 static void _rejectOnVersionMismatch(RedisModuleCtx *ctx, uint version) {
 	RedisModule_ReplyWithArray(ctx, 2);
 	RedisModule_ReplyWithError(ctx, "version mismatch");
@@ -100,10 +127,14 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		case CMD_EXPLAIN:
 		case CMD_PROFILE:
 			// Expect a command, graph name, a query, and optional config flags.
-			return arity >= 3 && arity <= 8;
+			return arity >= 3 && arity <= 9;
 		case CMD_SLOWLOG:
 			// Expect just a command and graph name.
 			return arity == 2;
+		case CMD_EXECUTE:
+			// Expect a command, graph name, a handle, the statement's
+			// arguments and optional config flags.
+			return arity >= 3;
 		default:
 			ASSERT("encountered unhandled query type" && false);
 			return false;
@@ -115,6 +146,7 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 	switch(cmd) {
 		case CMD_QUERY:
 		case CMD_RO_QUERY:
+		case CMD_EXECUTE:
 			return Graph_Query;
 		case CMD_EXPLAIN:
 			return Graph_Explain;
@@ -135,6 +167,7 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.EXPLAIN")  == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE")  == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG")  == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.EXECUTE")  == 0) return CMD_EXECUTE;
 
 	// we shouldn't reach this point
 	ASSERT(false);
@@ -149,6 +182,7 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 		case CMD_PROFILE:
 			return true;
 		case CMD_SLOWLOG:
+		case CMD_EXECUTE:
 			return false;
 		default:
 			ASSERT(false);
@@ -156,12 +190,69 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 	return false;
 }
 
+// Retrieve the prepared statement GRAPH.EXECUTE refers to.
+// Returns NULL if the handle is unknown or arguments are missing,
+// 'errmsg' is set and should be freed by the caller.
+static PreparedStatement *_retrieve_statement(GraphContext *gc,
+		RedisModuleString **argv, int argc, char **errmsg) {
+	long long handle;
+	PreparedStatement *stmt = NULL;
+
+	// GRAPH.EXECUTE <GRAPH_KEY> <HANDLE> <ARG> ...
+	if(RedisModule_StringToLongLong(argv[2], &handle) == REDISMODULE_OK) {
+		stmt = GraphContext_GetPreparedStatement(gc, handle);
+	}
+
+	if(stmt == NULL) {
+		asprintf(errmsg, "Unknown prepared statement");
+		return NULL;
+	}
+
+	if(argc - 3 < (int)PreparedStatement_ParamCount(stmt)) {
+		asprintf(errmsg, "Prepared statement expects %u arguments",
+				PreparedStatement_ParamCount(stmt));
+		return NULL;
+	}
+
+	return stmt;
+}
+
+// Hand bound parameters over to the command context.
+static void _bind_statement(CommandCtx *context, PreparedStatement *stmt,
+		rax *params, RedisModuleString **args) {
+	// keep the statement alive even if it is deallocated during execution
+	PreparedStatement_IncreaseRefCount(stmt);
+	context->stmt = stmt;
+	context->params = params;
+
+	// replace the handle with the statement's query
+	rm_free(context->query);
+
+	if(stmt->readonly) {
+		context->query = rm_strdup(stmt->query);
+		return;
+	}
+
+	// replicas aren't aware of prepared statements,
+	// write statements are replicated as the equivalent GRAPH.QUERY
+	sds query = PreparedStatement_Render(stmt, args);
+	context->query = rm_strdup(query);
+	sdsfree(query);
+
+	rm_free(context->command_name);
+	context->command_name = rm_strdup("graph.QUERY");
+}
+
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	char *errmsg;
+	bool binary;
 	bool compact;
 	uint version;
 	long long timeout;
+	rax *params = NULL;
+	GraphContext *gc = NULL;
 	CommandCtx *context = NULL;
+	PreparedStatement *stmt = NULL;
 
 	RedisModuleString *graph_name = argv[1];
 	RedisModuleString *query = (argc > 2) ? argv[2] : NULL;
@@ -170,20 +261,31 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
 	if(_validate_command_arity(cmd, argc) == false) return RedisModule_WrongArity(ctx);
 
-	// parse additional arguments
-	int res = _read_flags(argv, argc, &compact, &timeout, &version, &errmsg);
-	if(res == REDISMODULE_ERR) {
-		// emit error and exit if argument parsing failed
-		RedisModule_ReplyWithError(ctx, errmsg);
-		free(errmsg);
-		// the API reference dictates that registered functions should always return OK
-		return REDISMODULE_OK;
+	// config flags follow the command's arguments
+	int flags_offset = 3;
+
+	// statement arguments are variadic, the statement determines their count
+	if(cmd == CMD_EXECUTE) {
+		gc = GraphContext_Retrieve(ctx, graph_name, true, false);
+		// if GraphContext is null, key access failed and an error been emitted
+		if(!gc) return REDISMODULE_ERR;
+
+		stmt = _retrieve_statement(gc, argv, argc, &errmsg);
+		if(stmt == NULL) goto error;
+		flags_offset += PreparedStatement_ParamCount(stmt);
 	}
 
-	bool shouldCreate = should_command_create_graph(cmd);
-	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true, shouldCreate);
-	// if GraphContext is null, key access failed and an error been emitted
-	if(!gc) return REDISMODULE_ERR;
+	// parse additional arguments
+	int res = _read_flags(argv, argc, flags_offset, &compact, &binary,
+			&timeout, &version, &errmsg);
+	if(res == REDISMODULE_ERR) goto error;
+
+	if(gc == NULL) {
+		bool shouldCreate = should_command_create_graph(cmd);
+		gc = GraphContext_Retrieve(ctx, graph_name, true, shouldCreate);
+		// if GraphContext is null, key access failed and an error been emitted
+		if(!gc) return REDISMODULE_ERR;
+	}
 
 	// return incase caller provided a mismatched graph version
 	if(!_verifyGraphVersion(gc, version)) {
@@ -206,17 +308,27 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 										   REDISMODULE_CTX_FLAGS_LOADING)) ?
 								 EXEC_THREAD_MAIN : EXEC_THREAD_READER;
 
+	// convert arguments to parameter values, the query isn't parsed again
+	if(stmt != NULL) {
+		params = PreparedStatement_Bind(stmt, argv + 3, &errmsg);
+		if(params == NULL) goto error;
+	}
+
+	ResultSetFormatterType format = _reply_format(ctx, compact, binary);
+
 	Command_Handler handler = get_command_handler(cmd);
 	if(exec_thread == EXEC_THREAD_MAIN) {
 		// run query on Redis main thread
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, exec_thread,
-								 is_replicated, compact, timeout);
+								 is_replicated, format, timeout);
+		if(stmt != NULL) _bind_statement(context, stmt, params, argv + 3);
 		handler(context);
 	} else {
 		// run query on a dedicated thread
 		RedisModuleBlockedClient *bc = RedisGraph_BlockClient(ctx);
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, exec_thread,
-								 is_replicated, compact, timeout);
+								 is_replicated, format, timeout);
+		if(stmt != NULL) _bind_statement(context, stmt, params, argv + 3);
 
 		if(ThreadPools_AddWorkReader(handler, context) == THPOOL_QUEUE_FULL) {
 			// Report an error once our workers thread pool internal queue
@@ -231,5 +343,15 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	}
 
 	return REDISMODULE_OK;
+
+error:
+	// emit error and exit if argument parsing failed
+	RedisModule_ReplyWithError(ctx, errmsg);
+	free(errmsg);
+	// Release the GraphContext, as we increased its reference count
+	// when retrieving it.
+	if(gc) GraphContext_DecreaseRefCount(gc);
+	// the API reference dictates that registered functions should always return OK
+	return REDISMODULE_OK;
 }
 
@@ -0,0 +1,46 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../graph/graphcontext.h"
+#include "../serializers/export/graph_export.h"
+
+// GRAPH.EXPORT <graph> <filename>
+// writes graph to a columnar file within the server's working directory
+int Graph_Export(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	const char *filename = RedisModule_StringPtrLen(argv[2], NULL);
+	if(!GraphExport_ValidFilename(filename)) {
+		RedisModule_ReplyWithError(ctx, "Invalid export file name.");
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	char *err = NULL;
+	uint64_t nodes = 0;
+	uint64_t edges = 0;
+
+	Graph_AcquireReadLock(gc->g);
+	bool success = GraphExport_Write(gc, filename, &nodes, &edges, &err);
+	Graph_ReleaseLock(gc->g);
+
+	if(success) {
+		char reply[1024];
+		int len = snprintf(reply, 1024, "%llu nodes exported, %llu edges exported",
+				(unsigned long long)nodes, (unsigned long long)edges);
+		RedisModule_ReplyWithStringBuffer(ctx, reply, len);
+	} else {
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+	return REDISMODULE_OK;
+}
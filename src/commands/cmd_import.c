@@ -0,0 +1,83 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../graph/graphcontext.h"
+#include "../serializers/export/graph_export.h"
+
+// GRAPH.IMPORT <graph> <filename>
+// GRAPH.IMPORT <graph> DATA <content>
+// creates a new graph from a file produced by GRAPH.EXPORT
+// or from the file's content, which is how imports are replicated
+int Graph_Import(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	bool inline_data = (argc == 4 &&
+			strcasecmp(RedisModule_StringPtrLen(argv[2], NULL), "DATA") == 0);
+	if(argc != 3 && !inline_data) return RedisModule_WrongArity(ctx);
+
+	RedisModuleString *rs_graph_name = argv[1];
+	const char *graphname = RedisModule_StringPtrLen(rs_graph_name, NULL);
+	const char *filename  = RedisModule_StringPtrLen(argv[2], NULL);
+
+	if(!inline_data && !GraphExport_ValidFilename(filename)) {
+		RedisModule_ReplyWithError(ctx, "Invalid export file name.");
+		return REDISMODULE_OK;
+	}
+
+	// verify that graph does not already exist
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, rs_graph_name,
+			REDISMODULE_READ);
+	RedisModule_CloseKey(key);
+
+	char *err = NULL;
+	if(key) {
+		asprintf(&err, "Graph with name '%s' cannot be created, "
+				"as key '%s' already exists.", graphname, graphname);
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return REDISMODULE_OK;
+	}
+
+	// content is validated in full before the graph is created
+	GraphImport *imp;
+	if(inline_data) {
+		size_t len;
+		const char *data = RedisModule_StringPtrLen(argv[3], &len);
+		imp = GraphImport_OpenBuffer(data, len, &err);
+	} else {
+		imp = GraphImport_Open(filename, &err);
+	}
+	if(imp == NULL) {
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, rs_graph_name, false, true);
+	if(gc == NULL) {
+		// failed to retrieve GraphContext; an error has been emitted
+		GraphImport_Free(imp);
+		return REDISMODULE_OK;
+	}
+
+	GraphImport_Load(imp, gc);
+
+	// replicate the imported content rather than the file name
+	// replicas and the AOF don't have access to the file
+	size_t len;
+	const char *data = GraphImport_Content(imp, &len);
+	RedisModule_Replicate(ctx, "GRAPH.IMPORT", "scb", rs_graph_name, "DATA",
+			data, len);
+
+	char reply[1024];
+	int reply_len = snprintf(reply, 1024, "%llu nodes imported, %llu edges imported",
+			(unsigned long long)GraphImport_NodeCount(imp),
+			(unsigned long long)GraphImport_EdgeCount(imp));
+	RedisModule_ReplyWithStringBuffer(ctx, reply, reply_len);
+
+	GraphImport_Free(imp);
+	GraphContext_DecreaseRefCount(gc);
+	return REDISMODULE_OK;
+}
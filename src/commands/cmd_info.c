@@ -0,0 +1,43 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../graph/graphcontext.h"
+
+static void _ReplyWithField
+(
+	RedisModuleCtx *ctx,
+	const char *name,
+	long long value
+) {
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithCString(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, value);
+}
+
+// GRAPH.INFO <graph>
+// replies with the graph's execution-plan cache statistics
+int Graph_Info(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 2) return RedisModule_WrongArity(ctx);
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	// cache counters are read without blocking concurrent queries
+	CacheStats stats;
+	Cache_GetStats(GraphContext_GetCache(gc), &stats);
+
+	RedisModule_ReplyWithArray(ctx, 5);
+	_ReplyWithField(ctx, "cache_capacity",  stats.cap);
+	_ReplyWithField(ctx, "cache_size",      stats.size);
+	_ReplyWithField(ctx, "cache_hits",      stats.hits);
+	_ReplyWithField(ctx, "cache_misses",    stats.misses);
+	_ReplyWithField(ctx, "cache_evictions", stats.evictions);
+
+	GraphContext_DecreaseRefCount(gc);
+	return REDISMODULE_OK;
+}
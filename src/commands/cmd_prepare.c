@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../errors.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "prepared_statement.h"
+
+// GRAPH.PREPARE <graph> <query> [<name> <type> ...]
+// parses and plans query once, replies with a handle to be passed to
+// GRAPH.EXECUTE, each parameter the query refers to is declared by a
+// (name, type) pair
+int Graph_Prepare(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// expecting a (name, type) pair for each parameter
+	if(argc < 3 || argc % 2 == 0) return RedisModule_WrongArity(ctx);
+
+	// statements aren't replicated, preparing mustn't create the graph key
+	// as it would only be created on this server
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	// statements are prepared on Redis main thread
+	// which is also the only thread accessing the graph's statements
+	CommandCtx *command_ctx = CommandCtx_New(ctx, NULL, argv[0], argv[2], gc,
+			EXEC_THREAD_MAIN, false, FORMATTER_NOP, 0);
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	if(strcmp(command_ctx->query, "") == 0) {
+		ErrorCtx_SetError("Error: empty query.");
+		goto cleanup;
+	}
+
+	PreparedStatement *stmt = PreparedStatement_New(command_ctx->query,
+			argv + 3, argc - 3);
+	if(stmt == NULL) goto cleanup;
+
+	uint64_t handle = GraphContext_AddPreparedStatement(gc, stmt);
+	RedisModule_ReplyWithLongLong(ctx, handle);
+
+cleanup:
+	if(ErrorCtx_EncounteredError()) ErrorCtx_EmitException();
+	GraphContext_DecreaseRefCount(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // reset the QueryCtx and free its allocations
+	ErrorCtx_Clear();
+
+	return REDISMODULE_OK;
+}
+
+// GRAPH.DEALLOCATE <graph> <handle>
+// removes a statement prepared by GRAPH.PREPARE, releasing its resources
+// executions already in progress run to completion
+int Graph_Deallocate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	// statements are deallocated on Redis main thread
+	// which is also the only thread accessing the graph's statements
+	long long handle;
+	if(RedisModule_StringToLongLong(argv[2], &handle) == REDISMODULE_OK &&
+	   GraphContext_RemovePreparedStatement(gc, handle)) {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "Unknown prepared statement");
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+	return REDISMODULE_OK;
+}
@@ -13,10 +13,14 @@
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/storage_tier.h"
 #include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
+#include "../index/index_construct.h"
+#include "../serializers/changelog/changelog.h"
 #include "../execution_plan/execution_plan.h"
 #include "execution_ctx.h"
+#include "prepared_statement.h"
 
 // GraphQueryCtx stores the allocations required to execute a query.
 typedef struct {
@@ -59,6 +63,93 @@ void static inline GraphQueryCtx_Free(GraphQueryCtx *ctx) {
 	rm_free(ctx);
 }
 
+// CREATE CONSTRAINT ON (n:L) ASSERT n.v IS UNIQUE
+// the constraint is backed by the exact-match index over the constrained
+// attribute, which is introduced if missing
+static void _create_unique_constraint
+(
+	GraphContext *gc,
+	const cypher_astnode_t *constraint_op
+) {
+	const char *label = cypher_ast_label_get_name(
+			cypher_ast_create_node_prop_constraint_get_label(constraint_op));
+	const char *prop = cypher_ast_prop_name_get_value(
+			cypher_ast_property_operator_get_prop_name(
+				cypher_ast_create_node_prop_constraint_get_expression(
+					constraint_op)));
+
+	ResultSetStatistics *stats = QueryCtx_GetResultSetStatistics();
+
+	QueryCtx_LockForCommit();
+
+	Index *idx = NULL;
+	bool index_added = (GraphContext_AddExactMatchIndex(&idx, gc, SCHEMA_NODE,
+				label, prop) == INDEX_OK);
+	if(!index_added) {
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+	}
+
+	// uniqueness is validated and enforced against a fully populated index
+	// populate it within the calling thread, aborting any construction
+	// in progress
+	if(index_added || !Index_Enabled(idx)) Index_Construct(idx, gc->g);
+
+	if(!Index_IsUnique(idx, prop)) {
+		if(Index_HasDuplicates(idx, prop)) {
+			if(index_added) {
+				GraphContext_DeleteIndex(gc, SCHEMA_NODE, label, prop,
+						IDX_EXACT_MATCH);
+			}
+			// nothing changed, avoid replicating the failed command
+			ResultSetStat_Clear(stats);
+			ErrorCtx_SetError("ERR Unable to create unique constraint on :%s(%s): property holds duplicate values.", label, prop);
+		} else {
+			Index_SetUnique(idx, prop, true);
+			stats->constraints_created++;
+
+			// constraints are part of the snapshot, not the change log
+			ChangeLog_RequestCompaction();
+		}
+	}
+
+	QueryCtx_UnlockCommit(NULL);
+}
+
+// DROP CONSTRAINT ON (n:L) ASSERT n.v IS UNIQUE
+// the backing index is retained
+static void _drop_unique_constraint
+(
+	GraphContext *gc,
+	const cypher_astnode_t *constraint_op
+) {
+	const char *label = cypher_ast_label_get_name(
+			cypher_ast_drop_node_prop_constraint_get_label(constraint_op));
+	const char *prop = cypher_ast_prop_name_get_value(
+			cypher_ast_property_operator_get_prop_name(
+				cypher_ast_drop_node_prop_constraint_get_expression(
+					constraint_op)));
+
+	ResultSetStatistics *stats = QueryCtx_GetResultSetStatistics();
+
+	QueryCtx_LockForCommit();
+
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	Index *idx = (s != NULL) ? Schema_GetIndex(s, NULL, IDX_EXACT_MATCH) : NULL;
+	bool dropped = (idx != NULL && Index_IsUnique(idx, prop));
+	if(dropped) {
+		Index_SetUnique(idx, prop, false);
+		stats->constraints_deleted++;
+		ChangeLog_RequestCompaction();
+	}
+
+	QueryCtx_UnlockCommit(NULL);
+
+	if(!dropped) {
+		ErrorCtx_SetError("ERR Unable to drop constraint on :%s(%s): no such constraint.", label, prop);
+	}
+}
+
 static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 							 ExecutionType exec_type) {
 	Index       *idx         =  NULL;
@@ -66,7 +157,12 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 	IndexType   idx_type     =  IDX_EXACT_MATCH;
 
 	const cypher_astnode_t *index_op = ast->root;
-	if(exec_type == EXECUTION_TYPE_INDEX_CREATE) {
+	cypher_astnode_type_t op_type = cypher_astnode_type(index_op);
+	if(op_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) {
+		_create_unique_constraint(gc, index_op);
+	} else if(op_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		_drop_unique_constraint(gc, index_op);
+	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE) {
 		// retrieve strings from AST node
 		bool                  index_added = false;
 		const char            *label      = NULL;
@@ -88,19 +184,33 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		}
 	
 		// add index for each property
+		const char *props[nprops];
 		QueryCtx_LockForCommit();
 		for(unsigned int i = 0; i < nprops; i++) {
 			const cypher_astnode_t *prop_name = t == CYPHER_AST_CREATE_NODE_PROPS_INDEX
 				? cypher_ast_create_node_props_index_get_prop_name(index_op, i)
 				: cypher_ast_property_operator_get_prop_name(cypher_ast_create_pattern_props_index_get_property_operator(index_op, i));
 			const char *prop = cypher_ast_prop_name_get_value(prop_name);
+			props[i] = prop;
 
 			index_added |= (GraphContext_AddExactMatchIndex(&idx, gc,
 						schema_type, label, prop) == INDEX_OK);
 		}
 
+		// multiple properties are additionally indexed as a composite
+		// ordered by the properties in the order specified
+		if(nprops > 1) {
+			index_added |= (GraphContext_AddCompositeIndex(&idx, gc,
+						schema_type, label, props, nprops) == INDEX_OK);
+		}
+
 		// populate the index only when at least one attribute was introduced
-		if(index_added) Index_Construct(idx, gc->g);
+		// unique constraints are enforced against a fully populated index
+		// as such an index backing a constraint is populated synchronously
+		if(index_added) {
+			if(Index_UniqueCount(idx) > 0) Index_Construct(idx, gc->g);
+			else Index_ConstructAsync(idx, gc);
+		}
 
 		QueryCtx_UnlockCommit(NULL);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
@@ -118,11 +228,22 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		}
 
 		QueryCtx_LockForCommit();
-		int res = GraphContext_DeleteIndex(gc, schema_type, label, prop,
-				idx_type);
+
+		// an index backing a unique constraint is retained
+		Schema *s = GraphContext_GetSchema(gc, label, schema_type);
+		idx = (s != NULL) ? Schema_GetIndex(s, NULL, idx_type) : NULL;
+		bool constrained = (idx != NULL && Index_IsUnique(idx, prop));
+
+		int res = INDEX_FAIL;
+		if(!constrained) {
+			res = GraphContext_DeleteIndex(gc, schema_type, label, prop,
+					idx_type);
+		}
 		QueryCtx_UnlockCommit(NULL);
 
-		if(res != INDEX_OK) {
+		if(constrained) {
+			ErrorCtx_SetError("ERR Unable to drop index on :%s(%s): index backs a unique constraint.", label, prop);
+		} else if(res != INDEX_OK) {
 			ErrorCtx_SetError("ERR Unable to drop index on :%s(%s): no such index.", label, prop);
 		}
 	} else {
@@ -177,15 +298,15 @@ static void _ExecuteQuery(void *args) {
 	}
 
 	// instantiate the query ResultSet
-	bool compact = command_ctx->compact;
 	ResultSetFormatterType resultset_format = profile
-		? FORMATTER_NOP 
-		: (compact) 
-			? FORMATTER_COMPACT 
-			: FORMATTER_VERBOSE;
+		? FORMATTER_NOP
+		: command_ctx->format;
 	ResultSet *result_set = NewResultSet(rm_ctx, resultset_format);
 	if(exec_ctx->cached) ResultSet_CachedExecution(result_set); // indicate a cached execution
 
+	// write queries are rolled back on error, their rows can't be streamed
+	if(readonly) ResultSet_EnableStreaming(result_set);
+
 	QueryCtx_SetResultSet(result_set);
 
 	// acquire the appropriate lock
@@ -248,6 +369,14 @@ static void _ExecuteQuery(void *args) {
 
 	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
 
+	// back entity blocks populated by a write query by the storage tier
+	// replied records no longer reference entity attributes
+	if(!readonly && StorageTier_Enabled()) {
+		Graph_AcquireWriteLock(gc->g);
+		Graph_SealStorage(gc->g);
+		Graph_ReleaseLock(gc->g);
+	}
+
 	// log query to slowlog
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
 	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
@@ -302,8 +431,15 @@ void _query(bool profile, void *args) {
 
 	QueryCtx_BeginTimer(); // Start query timing.
 
-	// parse query parameters and build an execution plan or retrieve it from the cache
-	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	if(command_ctx->stmt != NULL) {
+		// prepared statement, parameters are already bound
+		exec_ctx = PreparedStatement_ExecutionCtx(command_ctx->stmt,
+				command_ctx->params);
+		command_ctx->params = NULL;
+	} else {
+		// parse query parameters and build an execution plan or retrieve it from the cache
+		exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	}
 	if(exec_ctx == NULL) goto cleanup;
 
 	ExecutionType exec_type = exec_ctx->exec_type;
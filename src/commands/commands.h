@@ -24,7 +24,8 @@ typedef enum {
 	CMD_PROFILE        = 6,
 	CMD_BULK_INSERT    = 7,
 	CMD_SLOWLOG        = 8,
-	CMD_LIST           = 9
+	CMD_LIST           = 9,
+	CMD_EXECUTE        = 10
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -36,7 +37,12 @@ void Graph_Slowlog(void *args);
 void Graph_Profile(void *args);
 void Graph_Explain(void *args);
 int Graph_List(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Info(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Prepare(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Deallocate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Export(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Import(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
@@ -8,6 +8,8 @@
 #include "RG.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../ast/ast_parameterize.h"
+#include "../configuration/config.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
@@ -16,6 +18,8 @@ static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
 	if(root_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX) return EXECUTION_TYPE_INDEX_CREATE;
 	if(root_type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX) return EXECUTION_TYPE_INDEX_CREATE;
 	if(root_type == CYPHER_AST_DROP_PROPS_INDEX) return EXECUTION_TYPE_INDEX_DROP;
+	if(root_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) return EXECUTION_TYPE_INDEX_CREATE;
+	if(root_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) return EXECUTION_TYPE_INDEX_DROP;
 	ASSERT(false && "Unknown execution type");
 	return 0;
 }
@@ -28,6 +32,8 @@ static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan,
 	exec_ctx->plan      = plan;
 	exec_ctx->cached    = false;
 	exec_ctx->exec_type = exec_type;
+	exec_ctx->template  = NULL;
+	exec_ctx->ref_count = 1;
 
 	return exec_ctx;
 }
@@ -42,13 +48,20 @@ ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *orig) {
 	execution_ctx->plan      = ExecutionPlan_Clone(orig->plan);
 	execution_ctx->cached    = orig->cached;
 	execution_ctx->exec_type = orig->exec_type;
+	execution_ctx->ref_count = 1;
+
+	// the clone's plan references the template's query graphs
+	// keep template alive, it might get evicted from the cache meanwhile
+	__atomic_fetch_add(&orig->ref_count, 1, __ATOMIC_RELAXED);
+	execution_ctx->template = orig;
 
 	return execution_ctx;
 }
 
 static AST *_ExecutionCtx_ParseAST(const char *query_string,
+								   cypher_parse_result_t *query_parse_result,
 								   cypher_parse_result_t *params_parse_result) {
-	cypher_parse_result_t *query_parse_result = parse_query(query_string);
+	if(query_parse_result == NULL) query_parse_result = parse_query(query_string);
 	// If no output from the parser, the query is not valid.
 	if(ErrorCtx_EncounteredError() || query_parse_result == NULL) {
 		parse_result_free(query_parse_result);
@@ -101,7 +114,49 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	}
 
 	// No cached execution plan, try to parse the query.
-	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
+	cypher_parse_result_t *query_parse_result = NULL;
+
+	bool auto_parameterize;
+	Config_Option_get(Config_AUTO_PARAMETERIZE, &auto_parameterize);
+	if(auto_parameterize) {
+		query_parse_result = parse_query(query_string);
+		if(query_parse_result == NULL) {
+			parse_result_free(params_parse_result);
+			if(!ErrorCtx_EncounteredError()) {
+				ErrorCtx_SetError("Error: could not parse query");
+			}
+			return NULL;
+		}
+
+		sds parameterized = AST_ParameterizeLiterals(query_parse_result, query,
+				query_string);
+
+		// literals lifted, continue with the parameterized query
+		if(parameterized != NULL) {
+			parse_result_free(query_parse_result);
+			query_parse_result = NULL;
+
+			// replaces the original parameters
+			cypher_parse_result_t *lifted_params_parse_result =
+				parse_params(parameterized, &query_string);
+			sdsfree(parameterized);
+			parse_result_free(params_parse_result);
+			params_parse_result = lifted_params_parse_result;
+			if(params_parse_result == NULL) return NULL;
+
+			ctx->query_data.query_no_params = query_string;
+
+			ret = Cache_GetValue(cache, query_string);
+			if(ret) {
+				AST_SetParamsParseResult(ret->ast, params_parse_result);
+				ret->cached = true;
+				return ret;
+			}
+		}
+	}
+
+	AST *ast = _ExecutionCtx_ParseAST(query_string, query_parse_result,
+			params_parse_result);
 	// if query parsing failed, return NULL
 	if(!ast) {
 		// if no error has been set, emit one now
@@ -137,11 +192,61 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	}
 }
 
+ExecutionCtx *ExecutionCtx_Prepare(const char *query) {
+	ASSERT(query != NULL);
+
+	// no parameters to strip, errors are reported relative to the query
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	ctx->query_data.query_no_params = query;
+
+	cypher_parse_result_t *query_parse_result = parse_query(query);
+	if(query_parse_result == NULL) {
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError("Error: could not parse query");
+		}
+		return NULL;
+	}
+
+	// parameter values are bound on execution, a CYPHER prefix is ignored
+	uint nroots = cypher_parse_result_nroots(query_parse_result);
+	for(uint i = 0; i < nroots; i++) {
+		const cypher_astnode_t *root =
+			cypher_parse_result_get_root(query_parse_result, i);
+		if(cypher_astnode_type(root) == CYPHER_AST_STATEMENT &&
+		   cypher_ast_statement_noptions(root) > 0) {
+			parse_result_free(query_parse_result);
+			ErrorCtx_SetError("Error: prepared statements can't specify parameter values");
+			return NULL;
+		}
+	}
+
+	AST *ast = AST_Build(query_parse_result);
+	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
+	if(exec_type != EXECUTION_TYPE_QUERY) {
+		return _ExecutionCtx_New(ast, NULL, exec_type);
+	}
+
+	ExecutionPlan *plan = NewExecutionPlan();
+	if(ErrorCtx_EncounteredError()) {
+		AST_Free(ast);
+		ExecutionPlan_Free(plan);
+		return NULL;
+	}
+
+	return _ExecutionCtx_New(ast, plan, exec_type);
+}
+
 void ExecutionCtx_Free(ExecutionCtx *ctx) {
 	if(ctx == NULL) return;
+	// acquire-release, orders other threads' use of the context before free
+	if(__atomic_sub_fetch(&ctx->ref_count, 1, __ATOMIC_ACQ_REL) > 0) return;
+
 	if(ctx->plan != NULL) ExecutionPlan_Free(ctx->plan);
 	if(ctx->ast != NULL) AST_Free(ctx->ast);
 
+	// release template once clone's plan is freed
+	ExecutionCtx_Free(ctx->template);
+
 	rm_free(ctx);
 }
 
@@ -20,13 +20,19 @@ typedef enum {
 
 /**
  * @brief  A struct for saving execution objects in cache.
+ * @note   Cached contexts serve as immutable templates, each execution works
+ *         on a clone which shares the template's query graphs and AST.
+ *         A template is freed once the cache and all of its clones release it.
  */
-typedef struct {
+typedef struct ExecutionCtx ExecutionCtx;
+struct ExecutionCtx {
 	AST *ast;                   // AST
 	bool cached;                // cache hit/miss
 	ExecutionPlan *plan;        // execution plan
 	ExecutionType exec_type;    // execution type: query, index create/delete
-} ExecutionCtx;
+	ExecutionCtx *template;     // template this context was cloned from
+	uint ref_count;             // number of references to this context
+};
 
 /**
  * @brief  Returns the objects and information required for query execution.
@@ -37,13 +43,21 @@ typedef struct {
 ExecutionCtx *ExecutionCtx_FromQuery(const char *query);
 
 /**
- * @brief  Clone the execution ctx and return it (shallow copy for the ast, deep copy for the execution plan).
+ * @brief  Parses and plans a query which doesn't specify parameter values, bypassing the cache.
+ * @note   Used by prepared statements, their parameters are bound on each execution.
+ * @param  *query: String representing the query.
+ * @retval ExecutionCtx serving as an execution template, NULL on error.
+ */
+ExecutionCtx *ExecutionCtx_Prepare(const char *query);
+
+/**
+ * @brief  Clone the execution ctx and return it (shallow copy for the ast, the execution plan ops are cloned while its query graphs are shared).
  * @param  *ctx: A pointer to ExecutionCTX struct
  */
 ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *ctx);
 
 /**
- * @brief  Free an ExecutionCTX struct and its inner fields.
+ * @brief  Release a reference to an ExecutionCTX struct, freeing it and its inner fields once unreferenced.
  * @param  *ctx: ExecutionCTX struct
  */
 void ExecutionCtx_Free(ExecutionCtx *ctx);
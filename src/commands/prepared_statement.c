@@ -0,0 +1,320 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "prepared_statement.h"
+#include "RG.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../arithmetic/arithmetic_expression.h"
+
+#include <math.h>
+
+static const char *_ParamTypeName[] = {
+	[PARAM_TYPE_INTEGER] = "INTEGER",
+	[PARAM_TYPE_FLOAT]   = "FLOAT",
+	[PARAM_TYPE_STRING]  = "STRING",
+	[PARAM_TYPE_BOOLEAN] = "BOOLEAN",
+};
+
+static bool _ParseParamType
+(
+	const char *name,
+	ParamType *t
+) {
+	for(uint i = 0; i < sizeof(_ParamTypeName) / sizeof(char *); i++) {
+		if(strcasecmp(name, _ParamTypeName[i]) == 0) {
+			*t = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// collects the distinct names of parameters referred to by 'node'
+static void _CollectParams
+(
+	const cypher_astnode_t *node,
+	rax *params
+) {
+	if(cypher_astnode_type(node) == CYPHER_AST_PARAMETER) {
+		const char *name = cypher_ast_parameter_get_name(node);
+		raxTryInsert(params, (unsigned char *)name, strlen(name), NULL, NULL);
+		return;
+	}
+
+	uint n = cypher_astnode_nchildren(node);
+	for(uint i = 0; i < n; i++) {
+		_CollectParams(cypher_astnode_get_child(node, i), params);
+	}
+}
+
+static void _ParamFree
+(
+	void *param
+) {
+	AR_EXP_Free(param);
+}
+
+PreparedStatement *PreparedStatement_New
+(
+	const char *query,
+	RedisModuleString **decl,
+	int ndecl
+) {
+	ASSERT(query != NULL);
+	ASSERT(ndecl % 2 == 0);
+
+	PreparedStatement *stmt = rm_calloc(1, sizeof(PreparedStatement));
+	stmt->ref_count = 1;
+	stmt->query = rm_strdup(query);
+	stmt->names = array_new(char *, ndecl / 2);
+	stmt->types = array_new(ParamType, ndecl / 2);
+
+	//--------------------------------------------------------------------------
+	// parse parameter declarations
+	//--------------------------------------------------------------------------
+
+	rax *declared = raxNew();
+	for(int i = 0; i < ndecl; i += 2) {
+		size_t len;
+		const char *name = RedisModule_StringPtrLen(decl[i], &len);
+		const char *type = RedisModule_StringPtrLen(decl[i + 1], NULL);
+
+		ParamType t;
+		if(!_ParseParamType(type, &t)) {
+			ErrorCtx_SetError("Unknown type '%s' for parameter '%s', expecting INTEGER, FLOAT, STRING or BOOLEAN",
+					type, name);
+			goto error;
+		}
+
+		if(raxTryInsert(declared, (unsigned char *)name, len, NULL, NULL) == 0) {
+			ErrorCtx_SetError("Parameter '%s' is declared more than once", name);
+			goto error;
+		}
+
+		array_append(stmt->names, rm_strdup(name));
+		array_append(stmt->types, t);
+	}
+
+	//--------------------------------------------------------------------------
+	// parse and plan query
+	//--------------------------------------------------------------------------
+
+	stmt->exec_ctx = ExecutionCtx_Prepare(query);
+	if(stmt->exec_ctx == NULL) goto error;
+
+	if(stmt->exec_ctx->exec_type != EXECUTION_TYPE_QUERY) {
+		ErrorCtx_SetError("Index operations can't be prepared");
+		goto error;
+	}
+
+	AST *ast = stmt->exec_ctx->ast;
+	stmt->readonly = AST_ReadOnly(ast->root);
+
+	// each parameter the query refers to must be declared and vice versa
+	rax *referred = raxNew();
+	_CollectParams(ast->root, referred);
+
+	raxIterator it;
+	raxStart(&it, referred);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		if(raxFind(declared, it.key, it.key_len) == raxNotFound) {
+			ErrorCtx_SetError("Missing type declaration for parameter '%.*s'",
+					(int)it.key_len, it.key);
+			break;
+		}
+	}
+	raxStop(&it);
+
+	for(uint i = 0; i < array_len(stmt->names) && !ErrorCtx_EncounteredError(); i++) {
+		const char *name = stmt->names[i];
+		if(raxFind(referred, (unsigned char *)name, strlen(name)) == raxNotFound) {
+			ErrorCtx_SetError("Declared parameter '%s' isn't referred to by the query",
+					name);
+		}
+	}
+	raxFree(referred);
+
+	if(ErrorCtx_EncounteredError()) goto error;
+
+	raxFree(declared);
+	return stmt;
+
+error:
+	raxFree(declared);
+	PreparedStatement_Free(stmt);
+	return NULL;
+}
+
+uint PreparedStatement_ParamCount
+(
+	const PreparedStatement *stmt
+) {
+	ASSERT(stmt != NULL);
+	return array_len(stmt->names);
+}
+
+rax *PreparedStatement_Bind
+(
+	const PreparedStatement *stmt,
+	RedisModuleString **args,
+	char **err
+) {
+	ASSERT(err  != NULL);
+	ASSERT(stmt != NULL);
+
+	rax *params = raxNew();
+	uint n = array_len(stmt->names);
+
+	for(uint i = 0; i < n; i++) {
+		bool valid = true;
+		SIValue v = SI_NullVal();
+		const char *name = stmt->names[i];
+
+		switch(stmt->types[i]) {
+			case PARAM_TYPE_INTEGER: {
+				long long l = 0;
+				valid = RedisModule_StringToLongLong(args[i], &l) == REDISMODULE_OK;
+				v = SI_LongVal(l);
+				break;
+			}
+			case PARAM_TYPE_FLOAT: {
+				// non finite values can't be replicated as Cypher literals
+				double d = 0;
+				valid = RedisModule_StringToDouble(args[i], &d) == REDISMODULE_OK &&
+					isfinite(d);
+				v = SI_DoubleVal(d);
+				break;
+			}
+			case PARAM_TYPE_STRING:
+				v = SI_DuplicateStringVal(RedisModule_StringPtrLen(args[i], NULL));
+				break;
+			case PARAM_TYPE_BOOLEAN: {
+				const char *b = RedisModule_StringPtrLen(args[i], NULL);
+				valid = strcasecmp(b, "true") == 0 || strcasecmp(b, "false") == 0;
+				v = SI_BoolVal(strcasecmp(b, "true") == 0);
+				break;
+			}
+			default:
+				ASSERT(false);
+		}
+
+		if(!valid) {
+			asprintf(err, "Failed to parse argument for parameter '%s' as %s",
+					name, _ParamTypeName[stmt->types[i]]);
+			raxFreeWithCallback(params, _ParamFree);
+			return NULL;
+		}
+
+		raxInsert(params, (unsigned char *)name, strlen(name),
+				AR_EXP_NewConstOperandNode(v), NULL);
+	}
+
+	return params;
+}
+
+sds PreparedStatement_Render
+(
+	const PreparedStatement *stmt,
+	RedisModuleString **args
+) {
+	ASSERT(stmt != NULL);
+
+	sds query = sdsnew("CYPHER");
+	uint n = array_len(stmt->names);
+
+	for(uint i = 0; i < n; i++) {
+		size_t len;
+		const char *arg = RedisModule_StringPtrLen(args[i], &len);
+		query = sdscatprintf(query, " %s=", stmt->names[i]);
+
+		switch(stmt->types[i]) {
+			case PARAM_TYPE_INTEGER: {
+				long long l = 0;
+				RedisModule_StringToLongLong(args[i], &l);
+				query = sdscatprintf(query, "%lld", l);
+				break;
+			}
+			case PARAM_TYPE_FLOAT: {
+				// keep the value a float, e.g. 1.0 rather than 1
+				double d = 0;
+				char buf[64];
+				RedisModule_StringToDouble(args[i], &d);
+				snprintf(buf, sizeof(buf), "%.17g", d);
+				query = sdscat(query, buf);
+				if(strpbrk(buf, ".e") == NULL) query = sdscat(query, ".0");
+				break;
+			}
+			case PARAM_TYPE_STRING:
+				query = sdscatlen(query, "'", 1);
+				for(size_t j = 0; j < len; j++) {
+					if(arg[j] == '\'' || arg[j] == '\\') {
+						query = sdscatlen(query, "\\", 1);
+					}
+					query = sdscatlen(query, arg + j, 1);
+				}
+				query = sdscatlen(query, "'", 1);
+				break;
+			case PARAM_TYPE_BOOLEAN:
+				query = sdscat(query, strcasecmp(arg, "true") == 0 ?
+						"true" : "false");
+				break;
+			default:
+				ASSERT(false);
+		}
+	}
+
+	query = sdscatprintf(query, " %s", stmt->query);
+	return query;
+}
+
+ExecutionCtx *PreparedStatement_ExecutionCtx
+(
+	PreparedStatement *stmt,
+	rax *params
+) {
+	ASSERT(stmt   != NULL);
+	ASSERT(params != NULL);
+
+	// error positions are reported relative to the statement query
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	ctx->query_data.query_no_params = stmt->query;
+	QueryCtx_SetParams(params);
+
+	ExecutionCtx *exec_ctx = ExecutionCtx_Clone(stmt->exec_ctx);
+	exec_ctx->cached = true;
+
+	return exec_ctx;
+}
+
+void PreparedStatement_IncreaseRefCount
+(
+	PreparedStatement *stmt
+) {
+	ASSERT(stmt != NULL);
+	__atomic_fetch_add(&stmt->ref_count, 1, __ATOMIC_RELAXED);
+}
+
+void PreparedStatement_Free
+(
+	PreparedStatement *stmt
+) {
+	if(stmt == NULL) return;
+	// acquire-release, orders other threads' use of the statement before free
+	if(__atomic_sub_fetch(&stmt->ref_count, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	uint n = array_len(stmt->names);
+	for(uint i = 0; i < n; i++) rm_free(stmt->names[i]);
+	array_free(stmt->names);
+	array_free(stmt->types);
+
+	ExecutionCtx_Free(stmt->exec_ctx);
+	rm_free(stmt->query);
+	rm_free(stmt);
+}
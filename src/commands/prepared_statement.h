@@ -0,0 +1,93 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "execution_ctx.h"
+#include "../redismodule.h"
+#include "../util/sds/sds.h"
+
+// prepared statements are parsed and planned once by GRAPH.PREPARE
+// GRAPH.EXECUTE binds the statement's parameters straight from its
+// command arguments, skipping the Cypher parser altogether
+
+// declared type of a statement parameter
+typedef enum {
+	PARAM_TYPE_INTEGER,
+	PARAM_TYPE_FLOAT,
+	PARAM_TYPE_STRING,
+	PARAM_TYPE_BOOLEAN,
+} ParamType;
+
+typedef struct PreparedStatement PreparedStatement;
+struct PreparedStatement {
+	char *query;             // statement query
+	char **names;            // parameter names, in argument order
+	ParamType *types;        // parameter types, in argument order
+	bool readonly;           // statement doesn't modify the graph
+	ExecutionCtx *exec_ctx;  // execution template
+	uint ref_count;          // number of references to this statement
+};
+
+// parses and plans 'query'
+// 'decl' holds a (name, type) pair for each parameter the query refers to
+// expects the QueryCtx graph to be set
+// returns NULL on failure, in which case an error is set in the ErrorCtx
+PreparedStatement *PreparedStatement_New
+(
+	const char *query,        // query to prepare
+	RedisModuleString **decl, // parameter declarations
+	int ndecl                 // number of declaration arguments
+);
+
+// number of arguments expected by the statement
+uint PreparedStatement_ParamCount
+(
+	const PreparedStatement *stmt
+);
+
+// converts 'args' to parameter values according to their declared types
+// returns NULL on failure, 'err' is set and should be freed by the caller
+rax *PreparedStatement_Bind
+(
+	const PreparedStatement *stmt,  // statement
+	RedisModuleString **args,       // one argument per parameter
+	char **err                      // [output] error message
+);
+
+// renders a query equivalent to executing 'stmt' with 'args'
+// e.g. CYPHER a=1 b='x' <query>
+// used to replicate write statements, as replicas aren't aware of handles
+// 'args' are expected to have been validated by PreparedStatement_Bind
+sds PreparedStatement_Render
+(
+	const PreparedStatement *stmt,  // statement
+	RedisModuleString **args        // one argument per parameter
+);
+
+// creates an execution context for 'stmt' on the current thread
+// takes ownership over 'params'
+ExecutionCtx *PreparedStatement_ExecutionCtx
+(
+	PreparedStatement *stmt,  // statement
+	rax *params               // bound parameters
+);
+
+// increases statement's reference count
+// held by commands executing the statement, such that a deallocated
+// statement isn't freed while it is being executed
+void PreparedStatement_IncreaseRefCount
+(
+	PreparedStatement *stmt
+);
+
+// decreases statement's reference count
+// the statement is freed once its last reference is released
+void PreparedStatement_Free
+(
+	PreparedStatement *stmt
+);
@@ -49,6 +49,18 @@
 // size of node creation buffer
 #define NODE_CREATION_BUFFER "NODE_CREATION_BUFFER"
 
+// interval(ms) between change log flushes, 0 disables incremental save
+#define INCREMENTAL_SAVE_INTERVAL "INCREMENTAL_SAVE_INTERVAL"
+
+// whether entity blocks are backed by a memory-mapped file
+#define STORAGE_TIER "STORAGE_TIER"
+
+// whether query literals are lifted into parameters prior to caching
+#define AUTO_PARAMETERIZE "AUTO_PARAMETERIZE"
+
+// number of records sorted in memory before spilling to disk, 0 disables spilling
+#define SORT_SPILL_THRESHOLD "SORT_SPILL_THRESHOLD"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -70,6 +82,10 @@ typedef struct {
 	int64_t query_mem_capacity;        // Max mem(bytes) that query/thread can utilize at any given time
 	uint64_t node_creation_buffer;     // Number of extra node creations to buffer as margin in matrices
 	int64_t delta_max_pending_changes; // number of pending changed befor RG_Matrix flushed
+	uint64_t incremental_save_interval;// interval(ms) between change log flushes
+	bool storage_tier;                 // If true, entity blocks are backed by a memory-mapped file.
+	bool auto_parameterize;            // If true, query literals are lifted into parameters.
+	uint64_t sort_spill_threshold;     // number of records sorted in memory before spilling to disk
 	Config_on_change cb;               // callback function which being called when config param changed
 } RG_Config;
 
@@ -266,6 +282,54 @@ uint64_t Config_node_creation_buffer_get(void) {
 	return config.node_creation_buffer;
 }
 
+//------------------------------------------------------------------------------
+// incremental save interval
+//------------------------------------------------------------------------------
+
+void Config_incremental_save_interval_set(uint64_t interval) {
+	config.incremental_save_interval = interval;
+}
+
+uint64_t Config_incremental_save_interval_get(void) {
+	return config.incremental_save_interval;
+}
+
+//------------------------------------------------------------------------------
+// storage tier
+//------------------------------------------------------------------------------
+
+void Config_storage_tier_set(bool storage_tier) {
+	config.storage_tier = storage_tier;
+}
+
+bool Config_storage_tier_get(void) {
+	return config.storage_tier;
+}
+
+//------------------------------------------------------------------------------
+// auto parameterize
+//------------------------------------------------------------------------------
+
+void Config_auto_parameterize_set(bool auto_parameterize) {
+	config.auto_parameterize = auto_parameterize;
+}
+
+bool Config_auto_parameterize_get(void) {
+	return config.auto_parameterize;
+}
+
+//------------------------------------------------------------------------------
+// sort spill threshold
+//------------------------------------------------------------------------------
+
+void Config_sort_spill_threshold_set(uint64_t threshold) {
+	config.sort_spill_threshold = threshold;
+}
+
+uint64_t Config_sort_spill_threshold_get(void) {
+	return config.sort_spill_threshold;
+}
+
 bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 	ASSERT(field_str != NULL);
 
@@ -291,6 +355,14 @@ bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 		f = Config_DELTA_MAX_PENDING_CHANGES;
 	} else if(!(strcasecmp(field_str, NODE_CREATION_BUFFER))) {
 		f = Config_NODE_CREATION_BUFFER;
+	} else if(!(strcasecmp(field_str, INCREMENTAL_SAVE_INTERVAL))) {
+		f = Config_INCREMENTAL_SAVE_INTERVAL;
+	} else if(!(strcasecmp(field_str, STORAGE_TIER))) {
+		f = Config_STORAGE_TIER;
+	} else if(!(strcasecmp(field_str, AUTO_PARAMETERIZE))) {
+		f = Config_AUTO_PARAMETERIZE;
+	} else if(!(strcasecmp(field_str, SORT_SPILL_THRESHOLD))) {
+		f = Config_SORT_SPILL_THRESHOLD;
 	} else {
 		return false;
 	}
@@ -346,6 +418,22 @@ const char *Config_Field_name(Config_Option_Field field) {
 			name = NODE_CREATION_BUFFER;
 			break;
 
+		case Config_INCREMENTAL_SAVE_INTERVAL:
+			name = INCREMENTAL_SAVE_INTERVAL;
+			break;
+
+		case Config_STORAGE_TIER:
+			name = STORAGE_TIER;
+			break;
+
+		case Config_AUTO_PARAMETERIZE:
+			name = AUTO_PARAMETERIZE;
+			break;
+
+		case Config_SORT_SPILL_THRESHOLD:
+			name = SORT_SPILL_THRESHOLD;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -398,6 +486,18 @@ void _Config_SetToDefaults(void) {
 
 	// the amount of empty space to reserve for node creations in matrices
 	config.node_creation_buffer = NODE_CREATION_BUFFER_DEFAULT;
+
+	// incremental save is disabled by default
+	config.incremental_save_interval = INCREMENTAL_SAVE_DISABLED;
+
+	// entities are kept in memory by default
+	config.storage_tier = false;
+
+	// queries are cached by their exact text by default
+	config.auto_parameterize = false;
+
+	// sorts are performed in memory by default
+	config.sort_spill_threshold = SORT_SPILL_DISABLED;
 }
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -605,6 +705,62 @@ bool Config_Option_get(Config_Option_Field field, ...) {
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// interval between change log flushes
+		//----------------------------------------------------------------------
+
+		case Config_INCREMENTAL_SAVE_INTERVAL: {
+			va_start(ap, field);
+			uint64_t *incremental_save_interval = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(incremental_save_interval != NULL);
+			(*incremental_save_interval) = Config_incremental_save_interval_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// storage tier
+		//----------------------------------------------------------------------
+
+		case Config_STORAGE_TIER: {
+			va_start(ap, field);
+			bool *storage_tier = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(storage_tier != NULL);
+			(*storage_tier) = Config_storage_tier_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// auto parameterize
+		//----------------------------------------------------------------------
+
+		case Config_AUTO_PARAMETERIZE: {
+			va_start(ap, field);
+			bool *auto_parameterize = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(auto_parameterize != NULL);
+			(*auto_parameterize) = Config_auto_parameterize_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// sort spill threshold
+		//----------------------------------------------------------------------
+
+		case Config_SORT_SPILL_THRESHOLD: {
+			va_start(ap, field);
+			uint64_t *sort_spill_threshold = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(sort_spill_threshold != NULL);
+			(*sort_spill_threshold) = Config_sort_spill_threshold_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -768,6 +924,52 @@ bool Config_Option_set(Config_Option_Field field, const char *val) {
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// interval between change log flushes
+		//----------------------------------------------------------------------
+
+		case Config_INCREMENTAL_SAVE_INTERVAL: {
+			long long interval;
+			if(!_Config_ParseNonNegativeInteger(val, &interval)) return false;
+			Config_incremental_save_interval_set(interval);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// storage tier
+		//----------------------------------------------------------------------
+
+		case Config_STORAGE_TIER: {
+			bool storage_tier;
+			if(!_Config_ParseYesNo(val, &storage_tier)) return false;
+
+			Config_storage_tier_set(storage_tier);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// auto parameterize
+		//----------------------------------------------------------------------
+
+		case Config_AUTO_PARAMETERIZE: {
+			bool auto_parameterize;
+			if(!_Config_ParseYesNo(val, &auto_parameterize)) return false;
+
+			Config_auto_parameterize_set(auto_parameterize);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// sort spill threshold
+		//----------------------------------------------------------------------
+
+		case Config_SORT_SPILL_THRESHOLD: {
+			long long threshold;
+			if(!_Config_ParseNonNegativeInteger(val, &threshold)) return false;
+			Config_sort_spill_threshold_set(threshold);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -15,6 +15,8 @@
 #define VKEY_ENTITY_COUNT_UNLIMITED        UINT64_MAX
 #define DELTA_MAX_PENDING_CHANGES_DEFAULT  10000
 #define NODE_CREATION_BUFFER_DEFAULT       16384
+#define INCREMENTAL_SAVE_DISABLED          0
+#define SORT_SPILL_DISABLED                0
 
 typedef enum {
 	Config_TIMEOUT                   = 0,     // timeout value for queries
@@ -28,7 +30,11 @@ typedef enum {
 	Config_QUERY_MEM_CAPACITY        = 8,     // max mem(bytes) that query/thread can utilize at any given time
 	Config_DELTA_MAX_PENDING_CHANGES = 9,     // number of pending changes before RG_Matrix flushed
 	Config_NODE_CREATION_BUFFER      = 10,    // size of buffer to maintain as margin in matrices
-	Config_END_MARKER                = 11
+	Config_INCREMENTAL_SAVE_INTERVAL = 11,    // interval(ms) between change log flushes
+	Config_STORAGE_TIER              = 12,    // back entity blocks by memory-mapped file
+	Config_AUTO_PARAMETERIZE         = 13,    // lift query literals into parameters
+	Config_SORT_SPILL_THRESHOLD      = 14,    // number of records sorted in memory before spilling to disk
+	Config_END_MARKER                = 15
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -36,14 +42,16 @@ typedef enum {
 typedef void (*Config_on_change)(Config_Option_Field type);
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 6
+#define RUNTIME_CONFIG_COUNT 8
 static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_RESULTSET_MAX_SIZE,
 	Config_TIMEOUT,
 	Config_MAX_QUEUED_QUERIES,
 	Config_QUERY_MEM_CAPACITY,
 	Config_DELTA_MAX_PENDING_CHANGES,
-	Config_VKEY_MAX_ENTITY_COUNT
+	Config_VKEY_MAX_ENTITY_COUNT,
+	Config_AUTO_PARAMETERIZE,
+	Config_SORT_SPILL_THRESHOLD
 };
 
 // Set module-level configurations to defaults or to user arguments where provided.
@@ -6,6 +6,9 @@
 
 #include "RG.h"
 #include "point.h"
+#include <math.h>
+
+#define DegreeToRadians(d) ((d) * M_PI / 180.0)
 
 float Point_lat(SIValue point) {
 	ASSERT(SI_TYPE(point) == T_POINT);
@@ -19,3 +22,34 @@ float Point_lon(SIValue point) {
 	return point.point.longitude;
 }
 
+double Point_Distance(SIValue p1, SIValue p2) {
+	// a = sin²(Δφ/2) + cos φ1 ⋅ cos φ2 ⋅ sin²(Δλ/2)
+	// c = 2 * atan2( √a, √(1−a) )
+	// d = R * c
+	// where φ represent the latitudes, and λ represent the longitudes
+
+	ASSERT(SI_TYPE(p1) == T_POINT);
+	ASSERT(SI_TYPE(p2) == T_POINT);
+
+	float lat[2] = { DegreeToRadians(p1.point.latitude),
+					 DegreeToRadians(p2.point.latitude)
+				   };
+
+	float lon[2] = { DegreeToRadians(p1.point.longitude),
+					 DegreeToRadians(p2.point.longitude)
+				   };
+
+	float dlat = lat[1] - lat[0];
+	float dlon = lon[1] - lon[0];
+
+	// a = sin²(Δφ/2) + cos φ1 ⋅ cos φ2 ⋅ sin²(Δλ/2)
+	float a = pow(sin(dlat / 2), 2) + cos(lat[0]) * cos(lat[1]) * pow(sin(dlon / 2), 2);
+
+	// c = 2 * atan2( √a, √(1−a) )
+	float c = 2 * atan2(sqrt(a), sqrt(1 - a));
+
+	// d = R * c
+	float d = EARTH_RADIUS * c;
+
+	return d;
+}
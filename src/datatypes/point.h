@@ -8,9 +8,15 @@
 
 #include "../value.h"
 
+// earth radius in meters
+#define EARTH_RADIUS 6378140.0
+
 // returns latitude of given point
 float Point_lat(SIValue point);
 
 // returns longitude of given point
 float Point_lon(SIValue point);
 
+// returns the distance in meters between two points
+// computed by the haversine formula
+double Point_Distance(SIValue p1, SIValue p2);
@@ -506,15 +506,18 @@ ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan) {
 static void _ExecutionPlan_FreeInternals(ExecutionPlan *plan) {
 	if(plan == NULL) return;
 
-	if(plan->connected_components) {
-		uint connected_component_count = array_len(plan->connected_components);
-		for(uint i = 0; i < connected_component_count; i ++) {
-			QueryGraph_Free(plan->connected_components[i]);
+	// query graphs of a cloned plan belong to its template
+	if(!plan->shared_query_graphs) {
+		if(plan->connected_components) {
+			uint connected_component_count = array_len(plan->connected_components);
+			for(uint i = 0; i < connected_component_count; i ++) {
+				QueryGraph_Free(plan->connected_components[i]);
+			}
+			array_free(plan->connected_components);
 		}
-		array_free(plan->connected_components);
-	}
 
-	QueryGraph_Free(plan->query_graph);
+		QueryGraph_Free(plan->query_graph);
+	}
 	if(plan->record_map) raxFree(plan->record_map);
 	if(plan->record_pool) ObjectPool_Free(plan->record_pool);
 	if(plan->ast_segment) AST_Free(plan->ast_segment);
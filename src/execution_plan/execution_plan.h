@@ -22,6 +22,7 @@ struct ExecutionPlan {
 	QueryGraph **connected_components;  // Array of all connected components in this segment.
 	ObjectPool *record_pool;
 	bool prepared;                      // Indicates if the execution plan is ready for execute.
+	bool shared_query_graphs;           // Query graphs are owned by the template this plan was cloned from.
 };
 
 /* Creates a new execution plan from AST */
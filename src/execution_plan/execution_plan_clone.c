@@ -15,14 +15,14 @@ static ExecutionPlan *_ClonePlanInternals(const ExecutionPlan *template) {
 
 	clone->record_map = raxClone(template->record_map);
 	if(template->ast_segment) clone->ast_segment = AST_ShallowCopy(template->ast_segment);
+	// query graphs are not modified once the plan is built
+	// share them with the template rather than cloning them
 	if(template->query_graph) {
 		QueryGraph_ResolveUnknownRelIDs(template->query_graph);
-		clone->query_graph = QueryGraph_Clone(template->query_graph);
-	}
-	// TODO improve QueryGraph logic so that we do not need to store or clone connected_components.
-	if(template->connected_components) {
-		array_clone_with_cb(clone->connected_components, template->connected_components, QueryGraph_Clone);
+		clone->query_graph = template->query_graph;
 	}
+	clone->connected_components = template->connected_components;
+	clone->shared_query_graphs = true;
 
 	return clone;
 }
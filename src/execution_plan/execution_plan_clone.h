@@ -8,6 +8,7 @@
 
 #include "execution_plan.h"
 
-/* Clones an execution plan */
+/* Clones an execution plan
+ * the clone shares the template's query graphs, template must outlive it */
 ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *plan);
 
@@ -185,7 +185,6 @@ static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 	CondVarLenTraverse  *op     = (CondVarLenTraverse *)opBase;
 	OpBase              *child  =  op->op.children[0];
-	Node                dest    =  GE_NEW_NODE();
 	EntityID            dest_id =  INVALID_ENTITY_ID;
 
 	while((dest_id = AllNeighborsCtx_NextNeighbor(op->allNeighborsCtx)) ==
@@ -196,8 +195,8 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 		if(op->r) OpBase_DeleteRecord(op->r);
 		op->r = childRecord;
 
-		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
-		if(srcNode == NULL) {
+		NodeID src_id = Record_GetNodeID(op->r, op->srcNodeIdx);
+		if(src_id == INVALID_ENTITY_ID) {
 			// the child Record may not contain the source node
 			// in scenarios like a failed OPTIONAL MATCH
 			// in this case, delete the Record and try again
@@ -220,11 +219,11 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 		}
 
 		if(op->allNeighborsCtx == NULL) {
-			op->allNeighborsCtx = AllNeighborsCtx_New(srcNode->id, op->M,
+			op->allNeighborsCtx = AllNeighborsCtx_New(src_id, op->M,
 					op->minHops, op->maxHops);
 		} else {
 			// in case ctx already allocated simply reset it
-			AllNeighborsCtx_Reset(op->allNeighborsCtx, srcNode->id, op->M,
+			AllNeighborsCtx_Reset(op->allNeighborsCtx, src_id, op->M,
 					op->minHops, op->maxHops);
 		}
 	}
@@ -232,17 +231,13 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 	// could not produce destination node, return
 	if(dest_id == INVALID_ENTITY_ID) return NULL;
 
-	int res = Graph_GetNode(op->g, dest_id, &dest);
-	UNUSED(res);
-	ASSERT(res == true);
-
 	//--------------------------------------------------------------------------
 	// populate output record
 	//--------------------------------------------------------------------------
 
-	// add destination node to record
+	// add destination node to record, its attributes are retrieved on demand
 	Record r = OpBase_CloneRecord(op->r);
-	Record_AddNode(r, op->destNodeIdx, dest);
+	Record_AddNodeID(r, op->destNodeIdx, dest_id);
 
 	return r;
 }
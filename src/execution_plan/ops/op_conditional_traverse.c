@@ -30,8 +30,7 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 		Record r = op->records[i];
 		/* Update filter matrix F, set row i at position srcId
 		 * F[i, srcId] = true. */
-		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);	
+		NodeID srcId = Record_GetNodeID(r, op->srcNodeIdx);
 		GrB_Matrix_setElement_BOOL(FM, true, i, srcId);
 	}
 
@@ -148,7 +147,7 @@ static Record CondTraverseConsume(OpBase *opBase) {
 			Record childRecord = OpBase_Consume(child);
 			// If the Record is NULL, the child has been depleted.
 			if(!childRecord) break;
-			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
+			if(Record_GetNodeID(childRecord, op->srcNodeIdx) == INVALID_ENTITY_ID) {
 				/* The child Record may not contain the source node in scenarios like
 				 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
 				OpBase_DeleteRecord(childRecord);
@@ -169,15 +168,13 @@ static Record CondTraverseConsume(OpBase *opBase) {
 
 	/* Get node from current column. */
 	op->r = op->records[src_id];
-	// Populate the destination node and add it to the Record.
-	Node destNode = GE_NEW_NODE();
-	Graph_GetNode(op->graph, dest_id, &destNode);
-	Record_AddNode(op->r, op->destNodeIdx, destNode);
+	// Add the destination node to the Record, its attributes are retrieved on demand.
+	Record_AddNodeID(op->r, op->destNodeIdx, dest_id);
 
 	if(op->edge_ctx) {
-		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		NodeID srcId = Record_GetNodeID(op->r, op->srcNodeIdx);
 		// Collect all appropriate edges connecting the current pair of endpoints.
-		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		EdgeTraverseCtx_CollectEdges(op->edge_ctx, srcId, dest_id);
 		// We're guaranteed to have at least one edge.
 		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
 	}
@@ -8,6 +8,7 @@
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
 #include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_ordered.h"
 
 // forward declarations
 static OpResult EdgeIndexScanInit(OpBase *opBase);
@@ -36,7 +37,7 @@ OpBase *NewEdgeIndexScanOp
 	const ExecutionPlan *plan,
 	Graph *g,
 	QGEdge *e,
-	RSIndex *idx,
+	Index *idx,
 	FT_FilterNode *filter
 ) {
 	// validate inputs
@@ -50,10 +51,13 @@ OpBase *NewEdgeIndexScanOp
 
 	OpEdgeIndexScan *op      =  rm_malloc(sizeof(OpEdgeIndexScan));
 	op->g                    =  g;
-	op->idx                  =  idx;
+	op->idx                  =  idx->idx;
+	op->index                =  idx;
 	op->edge                 =  e;
 	op->iter                 =  NULL;
+	op->ordered_iter         =  NULL;
 	op->filter               =  filter;
+	op->attr_filter          =  filter;
 	op->child_record         =  NULL;
 	op->current_src_node_id  =  NULL;
 	op->current_dest_node_id =  NULL;
@@ -198,15 +202,130 @@ static inline bool _PassUnresolvedFilters
 	return FilterTree_applyFilters(unresolved_filters, r) == FILTER_PASS;
 }
 
+// build an iterator over edges passing the scan filters
+// once the source node is resolved its edges are located through the
+// adjacent index, otherwise the native ordered index is preferred and
+// RediSearch is consulted as a last resort
+// runtime values within the filters are resolved by 'r' if provided
+static void _BuildIterator
+(
+	OpEdgeIndexScan *op,
+	const Record r
+) {
+	// ordered fields only cover edge attributes
+	// source and destination nodes are checked against retrieved index keys
+	FT_FilterNode *filter = FilterTree_Clone(op->attr_filter);
+	if(r != NULL) FilterTree_ResolveVariables(filter, r);
+	if(op->current_src_node_id != NULL) {
+		EntityID src_id = op->current_src_node_id->operand.constant.longval;
+		op->ordered_iter = FilterTreeToAdjacentIterator(&op->unresolved_filters,
+				filter, op->index, src_id);
+	}
+	if(op->ordered_iter == NULL) {
+		op->ordered_iter = FilterTreeToOrderedIterator(&op->unresolved_filters,
+				filter, op->index, NULL);
+	}
+	FilterTree_Free(filter);
+	if(op->ordered_iter != NULL) return;
+
+	filter = FilterTree_Clone(op->filter);
+	if(r != NULL) {
+		FilterTree_ResolveVariables(filter, r);
+
+		// make sure there's only one unresolve entity in filter
+		#ifdef RG_DEBUG
+		{
+			rax *entities = FilterTree_CollectModified(filter);
+			ASSERT(raxSize(entities) == 1);
+			raxFree(entities);
+		}
+		#endif
+	}
+
+	// convert filter into a RediSearch query
+	RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
+			filter, op->idx);
+	FilterTree_Free(filter);
+
+	// create iterator
+	ASSERT(rs_query_node != NULL);
+	op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+}
+
+static inline bool _HasIterator
+(
+	const OpEdgeIndexScan *op
+) {
+	return (op->iter != NULL || op->ordered_iter != NULL);
+}
+
+static void _ResetIterator
+(
+	OpEdgeIndexScan *op
+) {
+	if(op->iter) RediSearch_ResultsIteratorReset(op->iter);
+	if(op->ordered_iter) OrderedIndexIterator_Reset(op->ordered_iter);
+}
+
+static void _FreeIterator
+(
+	OpEdgeIndexScan *op
+) {
+	if(op->iter) {
+		RediSearch_ResultsIteratorFree(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->ordered_iter) {
+		OrderedIndexIterator_Free(op->ordered_iter);
+		op->ordered_iter = NULL;
+	}
+}
+
+// retrieve the next edge key from the active iterator
+// returns false once the iterator is depleted
+static bool _NextEdgeKey
+(
+	OpEdgeIndexScan *op,
+	EdgeIndexKey *edge_key
+) {
+	if(op->iter) {
+		const EdgeIndexKey *k = RediSearch_ResultsIteratorNext(op->iter,
+				op->idx, NULL);
+		if(k == NULL) return false;
+		*edge_key = *k;
+		return true;
+	}
+
+	const void *k;
+	while((k = OrderedIndexIterator_Next(op->ordered_iter)) != NULL) {
+		memcpy(edge_key, k, sizeof(EdgeIndexKey));
+
+		// skip edges which aren't connected to resolved nodes
+		if(op->current_src_node_id &&
+		   edge_key->src_id != (EntityID)op->current_src_node_id->operand.constant.longval) {
+			continue;
+		}
+		if(op->current_dest_node_id &&
+		   edge_key->dest_id != (EntityID)op->current_dest_node_id->operand.constant.longval) {
+			continue;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
 static void UpdateCurrentAwareIds(const OpEdgeIndexScan *op) {
 	if(op->current_src_node_id) {
-		Node *n = Record_GetNode(op->child_record, op->srcRecIdx);
-		op->current_src_node_id->operand.constant = SI_LongVal(ENTITY_GET_ID(n));
+		NodeID id = Record_GetNodeID(op->child_record, op->srcRecIdx);
+		op->current_src_node_id->operand.constant = SI_LongVal(id);
 	}
 
 	if(op->current_dest_node_id) {
-		Node *n = Record_GetNode(op->child_record, op->destRecIdx);
-		op->current_dest_node_id->operand.constant = SI_LongVal(ENTITY_GET_ID(n));
+		NodeID id = Record_GetNodeID(op->child_record, op->destRecIdx);
+		op->current_dest_node_id->operand.constant = SI_LongVal(id);
 	}
 }
 
@@ -215,18 +334,17 @@ static Record EdgeIndexScanConsumeFromChild
 	OpBase *opBase
 ) {
 	OpEdgeIndexScan	*op = (OpEdgeIndexScan*)opBase;
-	const EdgeIndexKey *edgeKey = NULL;
+	EdgeIndexKey edgeKey;
 
 pull_index:
 	//--------------------------------------------------------------------------
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((edgeKey = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(_HasIterator(op) && op->child_record != NULL) {
+		while(_NextEdgeKey(op, &edgeKey)) {
 			// populate record with edge
-			_UpdateRecord(op, op->child_record, edgeKey);
+			_UpdateRecord(op, op->child_record, &edgeKey);
 			// apply unresolved filters
 			if(_PassUnresolvedFilters(op, op->child_record)) {
 				// clone the held Record, as it will be freed upstream
@@ -258,10 +376,7 @@ pull_index:
 
 	if(op->rebuild_index_query) {
 		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
-		}
+		_FreeIterator(op);
 
 		// free previous unresolved filters
 		if(op->unresolved_filters != NULL) {
@@ -273,38 +388,16 @@ pull_index:
 
 		// rebuild index query, probably relies on runtime values
 		// resolve runtime variables within filter
-		FT_FilterNode *filter = FilterTree_Clone(op->filter);
-		FilterTree_ResolveVariables(filter, op->child_record);
-
-		// make sure there's only one unresolve entity in filter
-		#ifdef RG_DEBUG
-		{
-			rax *entities = FilterTree_CollectModified(filter);
-			ASSERT(raxSize(entities) == 1);
-			raxFree(entities);
-		}
-		#endif
-
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
-		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		_BuildIterator(op, op->child_record);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
+		if(!_HasIterator(op)) {
 			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(
-					&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+			_BuildIterator(op, NULL);
 		} else {
 			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			_ResetIterator(op);
 		}
 	}
 
@@ -319,23 +412,18 @@ static Record EdgeIndexScanConsume
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
 
 	// create iterator on first call
-	if(op->iter == NULL) {
+	if(!_HasIterator(op)) {
 		UpdateCurrentAwareIds(op);
-
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
-
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		_BuildIterator(op, NULL);
 	}
 
-	const EdgeIndexKey *edgeKey = NULL;
+	EdgeIndexKey edgeKey;
 
 	// populate the Record with the actual edge
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((edgeKey = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
+	while(_NextEdgeKey(op, &edgeKey)) {
 		// populate record with edge
-		_UpdateRecord(op, r, edgeKey);
+		_UpdateRecord(op, r, &edgeKey);
 		// apply unresolved filters
 		if(_PassUnresolvedFilters(op, r)) {
 			return r;
@@ -351,14 +439,13 @@ static OpResult EdgeIndexScanReset(OpBase *opBase) {
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
 
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+		_FreeIterator(op);
 		if(op->unresolved_filters) {
 			FilterTree_Free(op->unresolved_filters);
 			op->unresolved_filters = NULL;
 		}
 	} else {
-		RediSearch_ResultsIteratorReset(op->iter);
+		_ResetIterator(op);
 	}
 
 	return OP_OK;
@@ -370,10 +457,7 @@ static void EdgeIndexScanFree(OpBase *opBase) {
 	// read locked, if this index scan operation is part of
 	// a query which will modified this index we'll be stuck in
 	// a dead lock, as we're unable to acquire index write lock
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
-	}
+	_FreeIterator(op);
 
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
@@ -9,13 +9,15 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
+#include "../../index/index.h"
 #include "redisearch_api.h"
 
 typedef struct {
 	OpBase op;
 	Graph *g;
-	bool rebuild_index_query;           // should we rebuild RediSearch index query for each input record
-	RSIndex *idx;                       // index to query
+	bool rebuild_index_query;           // should we rebuild index query for each input record
+	Index *index;                       // queried index
+	RSIndex *idx;                       // RediSearch index to query
 	QGEdge *edge;                       // edge scanned
 	int edgeRecIdx;                     // record index of source node
 	int srcRecIdx;                      // record index of destination node
@@ -23,7 +25,9 @@ typedef struct {
 	bool srcAware;                      // src node already resolved
 	bool destAware;                     // dest node already resolved
 	RSResultsIterator *iter;            // iterator over an index
+	OrderedIndexIterator *ordered_iter; // iterator over an ordered or adjacent field, preferred over RediSearch
 	FT_FilterNode *filter;              // index query
+	FT_FilterNode *attr_filter;         // subset of filter, edge attribute filters
 	AR_ExpNode *current_src_node_id;    // current source node id
 	AR_ExpNode *current_dest_node_id;   // current destination node id
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
@@ -36,7 +40,7 @@ OpBase *NewEdgeIndexScanOp
 	const ExecutionPlan *plan,
 	Graph *g,
 	QGEdge *e,
-	RSIndex *idx,
+	Index *idx,
 	FT_FilterNode *filter
 );
 
@@ -43,8 +43,7 @@ static void _populate_filter_matrix
 		// update filter matrix F
 		// set row i at position srcId
 		// F[i, srcId] = true
-		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);
+		NodeID srcId = Record_GetNodeID(r, op->srcNodeIdx);
 		GrB_Matrix_setElement_BOOL(FM, true, i, srcId);
 	}
 
@@ -213,15 +212,13 @@ static Record _handoff
 		// resolve row index
 		if(op->single_operand) {
 			// row idx = src node ID
-			Node *srcNode = Record_GetNode(r, op->srcNodeIdx);
-			row = ENTITY_GET_ID(srcNode);
+			row = Record_GetNodeID(r, op->srcNodeIdx);
 		} else {
 			// row idx = record idx
 			row = op->record_count;
 		}
 
-		Node *destNode  =  Record_GetNode(r, op->destNodeIdx);
-		NodeID col      =  ENTITY_GET_ID(destNode);
+		NodeID col      =  Record_GetNodeID(r, op->destNodeIdx);
 		// TODO: in the case of multiple operands ()-[:A]->()-[:B]->()
 		// M is the result of F*A*B, in which case we can switch from
 		// M being a RG_Matrix to a GrB_Matrix, making the extract element
@@ -239,8 +236,7 @@ static Record _handoff
 		if(op->edge_ctx != NULL) {
 			op->r = r;
 
-			Node      *srcNode  =  Record_GetNode(r, op->srcNodeIdx);
-			EntityID  row       =  ENTITY_GET_ID(srcNode);
+			EntityID  row       =  Record_GetNodeID(r, op->srcNodeIdx);
 
 			// collect all edges connecting the current pair of endpoints
 			EdgeTraverseCtx_CollectEdges(op->edge_ctx, row, col);
@@ -285,8 +281,8 @@ static Record ExpandIntoConsume
 			if(r == NULL) break;
 
 			// check if both src and destination nodes are set
-			if(!Record_GetNode(r, op->srcNodeIdx) ||
-			   !Record_GetNode(r, op->destNodeIdx)) {
+			if(Record_GetNodeID(r, op->srcNodeIdx)  == INVALID_ENTITY_ID ||
+			   Record_GetNodeID(r, op->destNodeIdx) == INVALID_ENTITY_ID) {
 				// the child Record may not contain eithe
 				// source or destination nodes in scenarios like a failed
 				// OPTIONAL MATCH in this case, delete the Record and try again
@@ -7,7 +7,10 @@
 #include "op_node_by_index_scan.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
+#include "../../graph/rg_matrix/rg_matrix_iter.h"
 #include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_ordered.h"
+#include "../../filter_tree/ft_to_spatial.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
@@ -22,20 +25,34 @@ static void IndexScanToString(const OpBase *ctx, sds *buf) {
 }
 
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter) {
+		Index *idx, FT_FilterNode *filter) {
 	// validate inputs
-	ASSERT(g      != NULL);
-	ASSERT(idx    != NULL);
-	ASSERT(plan   != NULL);
-	ASSERT(filter != NULL);
+	ASSERT(g    != NULL);
+	ASSERT(idx  != NULL);
+	ASSERT(plan != NULL);
 
 	IndexScan *op = rm_malloc(sizeof(IndexScan));
 	op->g                    =  g;
 	op->n                    =  n;
-	op->idx                  =  idx;
+	op->idx                  =  idx->idx;
+	op->index                =  idx;
 	op->iter                 =  NULL;
+	op->ordered_iter         =  NULL;
+	op->spatial_iter         =  NULL;
 	op->filter               =  filter;
 	op->child_record         =  NULL;
+	op->order_by             =  NULL;
+	op->desc                 =  false;
+	op->nearest              =  NULL;
+	op->origin               =  SI_NullVal();
+	op->unindexed            =  NULL;
+	op->unindexed_pos        =  0;
+	op->covered              =  NULL;
+	op->covered_idx          =  NULL;
+	op->covered_pos          =  NULL;
+	op->covered_aliases      =  NULL;
+	op->unique               =  NULL;
+	op->unique_exp           =  NULL;
 	op->unresolved_filters   =  NULL;
 	op->rebuild_index_query  =  false;
 
@@ -47,6 +64,152 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
 	return (OpBase *)op;
 }
 
+bool IndexScanOp_OrderBy(IndexScan *op, const char *attr, bool desc) {
+	ASSERT(op   != NULL);
+	ASSERT(attr != NULL);
+
+	// index query is rebuilt for every input record
+	// each rebuilt query produces an ordered sequence of its own
+	if(op->op.childCount > 0) return false;
+
+	if(op->filter == NULL) {
+		// entire label is scanned through the attribute's ordered index
+		if(Index_GetOrderedIndex(op->index, attr) == NULL) return false;
+	} else if(!FilterTreeOrderedBy(op->filter, op->index, attr)) {
+		return false;
+	}
+
+	if(op->order_by) rm_free(op->order_by);
+	op->order_by = rm_strdup(attr);
+	op->desc     = desc;
+	return true;
+}
+
+bool IndexScanOp_OrderByDistance(IndexScan *op, const char *attr,
+		SIValue origin) {
+	ASSERT(op   != NULL);
+	ASSERT(attr != NULL);
+
+	// index query is rebuilt for every input record
+	if(op->op.childCount > 0) return false;
+
+	if(SI_TYPE(origin) != T_POINT) return false;
+	if(Index_GetSpatialIndex(op->index, attr) == NULL) return false;
+
+	if(op->nearest) rm_free(op->nearest);
+	op->nearest = rm_strdup(attr);
+	op->origin  = origin;
+	return true;
+}
+
+// returns the attributes stored along the entries of the scanned index
+// caller is responsible for freeing the returned array
+static const char **_StoredAttributes(const IndexScan *op,
+		const FT_FilterNode *filter) {
+	// entries of the spatial index store no attributes
+	if(op->nearest != NULL) return NULL;
+
+	if(filter != NULL) {
+		return FilterTreeCoveredAttributes(filter, op->index, op->order_by);
+	}
+
+	// entire label is scanned through the order by attribute's index
+	const char **attrs = array_new(const char *, 1);
+	array_append(attrs, op->order_by);
+	return attrs;
+}
+
+const char *IndexScanOp_Cover(IndexScan *op, const char *attr) {
+	ASSERT(op   != NULL);
+	ASSERT(attr != NULL);
+
+	// index query is rebuilt for every input record
+	if(op->op.childCount > 0) return NULL;
+
+	uint covered_count = array_len(op->covered);
+	for(uint i = 0; i < covered_count; i++) {
+		if(strcmp(op->covered[i], attr) == 0) return op->covered_aliases[i];
+	}
+
+	// make sure the scanned index stores attribute
+	bool stored = false;
+	const char **attrs = _StoredAttributes(op, op->filter);
+	if(attrs == NULL) return NULL;
+
+	uint attr_count = array_len(attrs);
+	for(uint i = 0; i < attr_count && !stored; i++) {
+		stored = (strcmp(attrs[i], attr) == 0);
+	}
+	array_free(attrs);
+	if(!stored) return NULL;
+
+	if(op->covered == NULL) {
+		op->covered          =  array_new(char *, 1);
+		op->covered_idx      =  array_new(uint, 1);
+		op->covered_aliases  =  array_new(char *, 1);
+	}
+
+	// hidden alias, can't be referred to by the query
+	size_t len = strlen(op->n.alias) + strlen(attr) + 4;
+	char *alias = rm_malloc(len);
+	sprintf(alias, "__%s.%s", op->n.alias, attr);
+
+	array_append(op->covered, rm_strdup(attr));
+	array_append(op->covered_aliases, alias);
+	array_append(op->covered_idx, OpBase_Modifies((OpBase *)op, alias));
+
+	return alias;
+}
+
+bool IndexScanOp_Count(IndexScan *op, uint64_t *count) {
+	ASSERT(op    != NULL);
+	ASSERT(count != NULL);
+
+	if(op->op.childCount > 0 || op->filter == NULL) return false;
+
+	// every filter must be resolved by the ordered index
+	FT_FilterNode *unresolved = NULL;
+	OrderedIndexIterator *it = FilterTreeToOrderedIterator(&unresolved,
+			op->filter, op->index, NULL);
+
+	bool counted = (it != NULL && unresolved == NULL);
+	if(counted) {
+		*count = 0;
+		while(OrderedIndexIterator_Next(it) != NULL) (*count)++;
+	}
+
+	if(it != NULL) OrderedIndexIterator_Free(it);
+	if(unresolved != NULL) FilterTree_Free(unresolved);
+
+	return counted;
+}
+
+// a filter consisting of a single equality over a unique field
+// matches at most one node, which is located by probing the field's
+// ordered index with the value evaluated against each input record
+// sparing the construction of an index query per record
+// MERGE (n:L {id: row.id})
+static void _InitUniqueProbe(IndexScan *op) {
+	FT_FilterNode *filter = op->filter;
+	if(filter == NULL || filter->t != FT_N_PRED) return;
+	if(filter->pred.op != OP_EQUAL) return;
+
+	char *attr = NULL;
+	AR_ExpNode *lhs = filter->pred.lhs;
+	if(!AR_EXP_IsAttribute(lhs, &attr)) return;
+
+	AR_ExpNode *entity = lhs->op.children[0];
+	if(!AR_EXP_IsVariadic(entity) ||
+	   strcmp(entity->operand.variadic.entity_alias, op->n.alias) != 0) {
+		return;
+	}
+
+	if(!Index_Enabled(op->index) || !Index_IsUnique(op->index, attr)) return;
+
+	op->unique     = Index_GetOrderedIndex(op->index, attr);
+	op->unique_exp = filter->pred.rhs;
+}
+
 static OpResult IndexScanInit(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
@@ -59,6 +222,8 @@ static OpResult IndexScanInit(OpBase *opBase) {
 		op->rebuild_index_query = raxSize(entities) > 1; // this is us
 		raxFree(entities);
 
+		if(op->rebuild_index_query) _InitUniqueProbe(op);
+
 		OpBase_UpdateConsume(opBase, IndexScanConsumeFromChild);
 	}
 
@@ -73,12 +238,204 @@ static OpResult IndexScanInit(OpBase *opBase) {
 	return OP_OK;
 }
 
-static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id) {
-	// Populate the Record with the graph entity data.
-	Node n = GE_NEW_NODE();
-	int res = Graph_GetNode(op->g, node_id, &n);
-	ASSERT(res != 0);
-	Record_AddNode(r, op->nodeRecIdx, n);
+// 'values' are the values stored along the node's index entry
+// NULL if the node wasn't produced by the ordered index
+static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id,
+		const SIValue *values) {
+	// node attributes are retrieved once accessed
+	Record_AddNodeID(r, op->nodeRecIdx, node_id);
+
+	uint covered_count = array_len(op->covered);
+	for(uint i = 0; i < covered_count; i++) {
+		SIValue v = SI_NullVal();
+		int pos = (values != NULL) ? op->covered_pos[i] : -1;
+		if(pos >= 0) {
+			v = values[pos];
+		} else {
+			// read attribute from node
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			Attribute_ID attr_id = GraphContext_GetAttributeID(gc,
+					op->covered[i]);
+			Node *n = Record_GetNode(r, op->nodeRecIdx);
+			SIValue *attr = GraphEntity_GetProperty((GraphEntity *)n, attr_id);
+			if(attr != ATTRIBUTE_NOTFOUND) v = *attr;
+		}
+
+		uint idx = op->covered_idx[i];
+		Record_FreeEntry(r, idx);
+		Record_AddScalar(r, idx, SI_CloneValue(v));
+	}
+}
+
+// locate each covered attribute within the entries of the scanned index
+static void _LocateCovered(IndexScan *op, const FT_FilterNode *filter) {
+	uint covered_count = array_len(op->covered);
+	if(covered_count == 0) return;
+
+	if(op->covered_pos == NULL) {
+		op->covered_pos = array_new(int, covered_count);
+		for(uint i = 0; i < covered_count; i++) {
+			array_append(op->covered_pos, -1);
+		}
+	}
+
+	const char **attrs = _StoredAttributes(op, filter);
+	uint attr_count = (attrs != NULL) ? array_len(attrs) : 0;
+	for(uint i = 0; i < covered_count; i++) {
+		op->covered_pos[i] = -1;
+		for(uint j = 0; j < attr_count; j++) {
+			if(strcmp(attrs[j], op->covered[i]) == 0) {
+				op->covered_pos[i] = j;
+				break;
+			}
+		}
+	}
+
+	if(attrs != NULL) array_free(attrs);
+}
+
+// collect labeled nodes holding no point
+// such that they're produced following the nodes ordered by distance
+static void _CollectPointless(IndexScan *op, const SpatialIndex *spatial) {
+	Graph *g = op->g;
+
+	// every labeled node is indexed
+	uint64_t n = Graph_LabeledNodeCount(g, op->n.label_id);
+	if(SpatialIndex_Count(spatial) == n) return;
+
+	op->unindexed = array_new(EntityID, 0);
+
+	RG_MatrixTupleIter it = {0};
+	RG_MatrixTupleIter_attach(&it, Graph_GetLabelMatrix(g, op->n.label_id));
+
+	EntityID id;
+	while(RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) == GrB_SUCCESS) {
+		if(!SpatialIndex_Contains(spatial, &id)) {
+			array_append(op->unindexed, id);
+		}
+	}
+
+	RG_MatrixTupleIter_detach(&it);
+}
+
+// build an iterator over nodes passing 'filter'
+// the native ordered and spatial indices are preferred
+// RediSearch is consulted otherwise
+static void _BuildIterator(IndexScan *op, const FT_FilterNode *filter) {
+	if(op->nearest != NULL) {
+		// scan nodes by ascending distance, filters are applied on results
+		SpatialIndex *spatial = Index_GetSpatialIndex(op->index, op->nearest);
+		op->spatial_iter = SpatialIndexIterator_NewNearest(spatial, op->origin);
+		_CollectPointless(op, spatial);
+		if(filter != NULL) op->unresolved_filters = FilterTree_Clone(filter);
+		return;
+	}
+
+	// a distance filter is served by a spatial index
+	// unless nodes are expected in attribute order
+	if(filter != NULL && op->order_by == NULL) {
+		op->spatial_iter = FilterTreeToSpatialIterator(&op->unresolved_filters,
+				filter, op->index);
+		if(op->spatial_iter != NULL) return;
+	}
+
+	if(filter == NULL) {
+		// scan the entire label in order
+		// nodes holding no indexable value are kept in order under their type
+		OrderedIndex *ordered = Index_GetOrderedIndex(op->index, op->order_by);
+		OrderedRange *ranges = array_new(OrderedRange, 1);
+		array_append(ranges, OrderedRange_NewPrefix(NULL, 0, T_NULL,
+					SI_NullVal(), false, SI_NullVal(), false));
+		op->ordered_iter = OrderedIndexIterator_New(ordered, ranges);
+	} else {
+		op->ordered_iter = FilterTreeToOrderedIterator(&op->unresolved_filters,
+				filter, op->index, op->order_by);
+	}
+
+	if(op->ordered_iter != NULL) {
+		if(op->desc) OrderedIndexIterator_Reverse(op->ordered_iter);
+		_LocateCovered(op, filter);
+		return;
+	}
+
+	RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
+			filter, op->idx);
+	ASSERT(rs_query_node != NULL);
+	op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+}
+
+static inline bool _HasIterator(const IndexScan *op) {
+	return (op->iter != NULL || op->ordered_iter != NULL ||
+			op->spatial_iter != NULL);
+}
+
+static void _ResetIterator(IndexScan *op) {
+	if(op->iter) RediSearch_ResultsIteratorReset(op->iter);
+	if(op->ordered_iter) OrderedIndexIterator_Reset(op->ordered_iter);
+	if(op->spatial_iter) SpatialIndexIterator_Reset(op->spatial_iter);
+	op->unindexed_pos = 0;
+}
+
+static void _FreeIterator(IndexScan *op) {
+	if(op->iter) {
+		RediSearch_ResultsIteratorFree(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->ordered_iter) {
+		OrderedIndexIterator_Free(op->ordered_iter);
+		op->ordered_iter = NULL;
+	}
+
+	if(op->spatial_iter) {
+		SpatialIndexIterator_Free(op->spatial_iter);
+		op->spatial_iter = NULL;
+	}
+
+	if(op->unindexed) {
+		array_free(op->unindexed);
+		op->unindexed = NULL;
+	}
+	op->unindexed_pos = 0;
+}
+
+// retrieve the next node ID from the active iterator
+// 'values' is set to the values stored along the node's ordered index entry
+// returns false once the iterator is depleted
+static bool _NextNodeID(IndexScan *op, EntityID *id, const SIValue **values) {
+	*values = NULL;
+
+	if(op->ordered_iter) {
+		const void *key = OrderedIndexIterator_Next(op->ordered_iter);
+		if(key == NULL) return false;
+
+		memcpy(id, key, sizeof(EntityID));
+		*values = OrderedIndexIterator_Values(op->ordered_iter);
+		return true;
+	}
+
+	if(op->spatial_iter) {
+		const void *key = SpatialIndexIterator_Next(op->spatial_iter);
+		if(key != NULL) {
+			memcpy(id, key, sizeof(EntityID));
+			return true;
+		}
+
+		// nodes holding no point following the ones ordered by distance
+		uint unindexed_count = (op->unindexed) ? array_len(op->unindexed) : 0;
+		if(op->unindexed_pos < unindexed_count) {
+			*id = op->unindexed[op->unindexed_pos++];
+			return true;
+		}
+
+		return false;
+	}
+
+	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx,
+			NULL);
+	if(nodeId == NULL) return false;
+	*id = *nodeId;
+	return true;
 }
 
 static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
@@ -89,18 +446,18 @@ static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
 
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	const EntityID *nodeId = NULL;
+	EntityID nodeId;
+	const SIValue *values;
 
 pull_index:
 	//--------------------------------------------------------------------------
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(_HasIterator(op) && op->child_record != NULL) {
+		while(_NextNodeID(op, &nodeId, &values)) {
 			// populate record with node
-			_UpdateRecord(op, op->child_record, *nodeId);
+			_UpdateRecord(op, op->child_record, nodeId, values);
 			// apply unresolved filters
 			if(_PassUnresolvedFilters(op, op->child_record)) {
 				// clone the held Record, as it will be freed upstream
@@ -126,16 +483,35 @@ pull_index:
 	op->child_record = OpBase_Consume(op->op.children[0]);
 	if(op->child_record == NULL) return NULL; // depleted
 
+	//--------------------------------------------------------------------------
+	// probe unique field
+	//--------------------------------------------------------------------------
+
+	if(op->unique != NULL) {
+		SIValue v = AR_EXP_Evaluate(op->unique_exp, op->child_record);
+		if(OrderedIndex_Indexable(v)) {
+			_FreeIterator(op);
+			bool found = (OrderedIndex_Lookup(op->unique, v, &nodeId) != NULL);
+			SIValue_Free(v);
+
+			// no match, pull next input record
+			if(!found) goto pull_index;
+
+			_UpdateRecord(op, op->child_record, nodeId, NULL);
+			return OpBase_CloneRecord(op->child_record);
+		}
+
+		// values which aren't indexable are looked up by an index query
+		SIValue_Free(v);
+	}
+
 	//--------------------------------------------------------------------------
 	// reset index iterator
 	//--------------------------------------------------------------------------
 
 	if(op->rebuild_index_query) {
 		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
-		}
+		_FreeIterator(op);
 
 		// free previous unresolved filters
 		if(op->unresolved_filters != NULL) {
@@ -157,25 +533,18 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query
+		_BuildIterator(op, filter);
 		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
+		if(!_HasIterator(op)) {
 			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+			_BuildIterator(op, op->filter);
 		} else {
 			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			_ResetIterator(op);
 		}
 	}
 
@@ -187,21 +556,16 @@ static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	// create iterator on first call
-	if(op->iter == NULL) {
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
+	if(!_HasIterator(op)) _BuildIterator(op, op->filter);
 
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
-	}
-
-	const EntityID *nodeId = NULL;
+	EntityID nodeId;
+	const SIValue *values;
 
 	// populate the Record with the actual node
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
+	while(_NextNodeID(op, &nodeId, &values)) {
 		// populate record with node
-		_UpdateRecord(op, r, *nodeId);
+		_UpdateRecord(op, r, nodeId, values);
 		// apply unresolved filters
 		if(_PassUnresolvedFilters(op, r)) {
 			return r;
@@ -217,14 +581,13 @@ static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+		_FreeIterator(op);
 		if(op->unresolved_filters) {
 			FilterTree_Free(op->unresolved_filters);
 			op->unresolved_filters = NULL;
 		}
 	} else {
-		RediSearch_ResultsIteratorReset(op->iter);
+		_ResetIterator(op);
 	}
 
 	return OP_OK;
@@ -236,10 +599,7 @@ static void IndexScanFree(OpBase *opBase) {
 	 * read locked, if this index scan operation is part of
 	 * a query which will modified this index we'll be stuck in
 	 * a dead lock, as we're unable to acquire index write lock. */
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
-	}
+	_FreeIterator(op);
 
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
@@ -255,5 +615,32 @@ static void IndexScanFree(OpBase *opBase) {
 		FilterTree_Free(op->unresolved_filters);
 		op->unresolved_filters = NULL;
 	}
+
+	if(op->order_by) {
+		rm_free(op->order_by);
+		op->order_by = NULL;
+	}
+
+	if(op->nearest) {
+		rm_free(op->nearest);
+		op->nearest = NULL;
+	}
+
+	if(op->covered) {
+		uint covered_count = array_len(op->covered);
+		for(uint i = 0; i < covered_count; i++) {
+			rm_free(op->covered[i]);
+			rm_free(op->covered_aliases[i]);
+		}
+		array_free(op->covered);
+		array_free(op->covered_idx);
+		array_free(op->covered_aliases);
+		op->covered = NULL;
+	}
+
+	if(op->covered_pos) {
+		array_free(op->covered_pos);
+		op->covered_pos = NULL;
+	}
 }
 
@@ -16,17 +16,53 @@
 typedef struct {
 	OpBase op;
 	Graph *g;
-	bool rebuild_index_query;           // should we rebuild RediSearch index query for each input record
-	RSIndex *idx;                       // index to query
+	bool rebuild_index_query;           // should we rebuild index query for each input record
+	Index *index;                       // queried index
+	RSIndex *idx;                       // RediSearch index to query
 	NodeScanCtx n;                      // label data of node being scanned
 	uint nodeRecIdx;                    // index of the node being scanned in the Record
 	RSResultsIterator *iter;            // rediSearch iterator over an index with the appropriate filters
+	OrderedIndexIterator *ordered_iter; // iterator over an ordered field, preferred over RediSearch
+	SpatialIndexIterator *spatial_iter; // iterator over a point field, serves distance filters
 	FT_FilterNode *filter;              // filter from which to compose index query
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
+	char *order_by;                     // attribute nodes are expected to be ordered by, NULL if none
+	bool desc;                          // nodes are expected in descending order
+	char *nearest;                      // point attribute nodes are ordered by distance over, NULL if none
+	SIValue origin;                     // point distances are measured from
+	EntityID *unindexed;                // labeled nodes holding no point, scanned by distance
+	uint unindexed_pos;                 // next unindexed node to produce
+	char **covered;                     // attributes produced from index entries
+	char **covered_aliases;             // record alias of each covered attribute
+	uint *covered_idx;                  // record index of each covered attribute
+	int *covered_pos;                   // position of each covered attribute within entries
+	OrderedIndex *unique;               // unique field probed per input record, NULL if none
+	AR_ExpNode *unique_exp;             // evaluates to the probed value
 	Record child_record;                // the Record this op acts on if it is not a tap
 } IndexScan;
 
 // creates a new IndexScan operation
+// a NULL filter scans the entire label, in which case an order must be set
+// either by attribute or by distance
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter);
+		Index *idx, FT_FilterNode *filter);
+
+// require scanned nodes to be produced in 'attr' order
+// returns false if the index scan can't guarantee such an order
+bool IndexScanOp_OrderBy(IndexScan *op, const char *attr, bool desc);
+
+// require scanned nodes to be produced by ascending distance of
+// their 'attr' point from 'origin', nodes holding no point come last
+// returns false if the index scan can't guarantee such an order
+bool IndexScanOp_OrderByDistance(IndexScan *op, const char *attr,
+		SIValue origin);
+
+// produce attribute 'attr' of scanned nodes from the scanned index entries
+// returns the alias under which the attribute's value is placed in records
+// or NULL if the scanned index doesn't store 'attr'
+const char *IndexScanOp_Cover(IndexScan *op, const char *attr);
+
+// count the nodes the index scan produces without accessing them
+// returns false if the count can't be answered by the index alone
+bool IndexScanOp_Count(IndexScan *op, uint64_t *count);
 
@@ -118,10 +118,8 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 }
 
 static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_id) {
-	// Populate the Record with the graph entity data.
-	Node n = GE_NEW_NODE();
-	Graph_GetNode(op->g, node_id, &n);
-	Record_AddNode(r, op->nodeRecIdx, n);
+	// Populate the Record with the node's ID, its attributes are retrieved on demand.
+	Record_AddNodeID(r, op->nodeRecIdx, node_id);
 }
 
 static inline void _ResetIterator(NodeByLabelScan *op) {
@@ -7,10 +7,15 @@
 #include "op_sort.h"
 #include "op_project.h"
 #include "op_aggregate.h"
+#include "shared/record_spill.h"
+#include "../../errors.h"
 #include "../../util/arr.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../util/sort_key.h"
+#include "../../ast/ast_build_op_contexts.h"
 #include "../../query_ctx.h"
+#include "../../configuration/config.h"
 
 /* Forward declarations. */
 static OpResult SortInit(OpBase *opBase);
@@ -19,69 +24,226 @@ static OpResult SortReset(OpBase *opBase);
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void SortFree(OpBase *opBase);
 
-// Heapsort function to compare two records on a subset of fields.
-// Return value similar to strcmp.
-static int _record_compare(Record a, Record b, const OpSort *op) {
+// Encodes the values record is sorted by into a single sort key.
+static SortEntry _entry(const OpSort *op, Record r) {
+	sds key = sdsempty();
 	uint comparison_count = array_len(op->record_offsets);
 	for(uint i = 0; i < comparison_count; i++) {
-		SIValue aVal = Record_Get(a, op->record_offsets[i]);
-		SIValue bVal = Record_Get(b, op->record_offsets[i]);
-		int rel = SIValue_Compare(aVal, bVal, NULL);
-		if(rel == 0) continue;      // Elements are equal; try next ORDER BY element.
-		rel *= op->directions[i];   // Flip value for descending order.
-		return rel;
+		SIValue v = Record_Get(r, op->record_offsets[i]);
+		key = SortKey_Append(key, v, op->directions[i] == DIR_DESC);
 	}
-	return 0;
+	return (SortEntry) {.key = key, .r = r};
 }
 
-// Quicksort function to compare two records on a subset of fields.
-// Returns true if a is less than b.
-static bool _record_islt(Record a, Record b, const OpSort *op) {
-	return _record_compare(a, b, op) >
-		   0; // Return true if the current left element is less than the right.
+static void _freeEntry(SortEntry *e) {
+	sdsfree(e->key);
+	OpBase_DeleteRecord(e->r);
 }
 
-// Compares two heap record nodes.
-static int _heap_elem_compare(const void *A, const void *B, const void *udata) {
-	OpSort *op = (OpSort *)udata;
-	Record aRec = (Record)A;
-	Record bRec = (Record)B;
-	return _record_compare(aRec, bRec, op);
+// Quicksort function to compare two entries.
+// Returns true if a is ordered after b, as records are handed off
+// from the end of the buffer.
+static inline bool _entry_isgt(const SortEntry *a, const SortEntry *b) {
+	return SortKey_Compare(a->key, b->key) > 0;
+}
+
+// Compares the heads of two spilled runs.
+// The heap polls its greatest element, as such the comparison is reversed
+// for the run holding the first record to be polled first.
+static int _run_compare(const void *A, const void *B, const void *udata) {
+	const SortRun *a = A;
+	const SortRun *b = B;
+	return SortKey_Compare(b->head.key, a->head.key);
+}
+
+#define ENTRY_SORT(a, b) (_entry_isgt((a), (b)))
+
+#define SWAP_ENTRIES(a, b) do { SortEntry tmp = (a); (a) = (b); (b) = tmp; } while(0)
+
+// Partial sort, retains the first 'limit' records of the buffer in sort order
+// and discards the rest. Records are partitioned in place (quickselect) using a
+// three-way partition, which keeps duplicate sort keys linear.
+static void _select(OpSort *op) {
+	SortEntry *buf = op->buffer;
+	int64_t n = array_len(buf);
+	int64_t k = op->limit;
+	if(n <= k) return;
+
+	int64_t lo = 0;
+	int64_t hi = n - 1;
+	while(lo < hi) {
+		sds pivot = buf[lo + (hi - lo) / 2].key;
+		int64_t lt = lo;
+		int64_t gt = hi;
+		int64_t i  = lo;
+		// buf[lo..lt) < pivot, buf[lt..i) == pivot, buf(gt..hi] > pivot
+		while(i <= gt) {
+			int rel = SortKey_Compare(buf[i].key, pivot);
+			if(rel < 0) {
+				SWAP_ENTRIES(buf[lt], buf[i]);
+				lt++;
+				i++;
+			} else if(rel > 0) {
+				SWAP_ENTRIES(buf[i], buf[gt]);
+				gt--;
+			} else {
+				i++;
+			}
+		}
+
+		if(k - 1 < lt) hi = lt - 1;
+		else if(k - 1 > gt) lo = gt + 1;
+		else break;
+	}
+
+	for(int64_t i = k; i < n; i++) _freeEntry(buf + i);
+	op->buffer = array_trimm_len(op->buffer, k);
+
+	// the k-th record is the worst of the retained records
+	op->threshold = (k > 0) ? op->buffer[k - 1].key : NULL;
+}
+
+// Sorts the buffered records and writes them to a temporary file.
+static void _spill(OpSort *op) {
+	uint n = array_len(op->buffer);
+	QSORT(SortEntry, op->buffer, n, ENTRY_SORT);
+
+	FILE *stream = tmpfile();
+	if(stream == NULL) {
+		ErrorCtx_RaiseRuntimeException("Sort failed to create a temporary file");
+	}
+
+	// register run prior to writing, so it is closed in case of an error
+	SortRun run = {.stream = stream, .head = {0}};
+	array_append(op->runs, run);
+
+	// records are handed off from the end of the buffer
+	bool written = true;
+	for(int i = n - 1; i >= 0; i--) {
+		written &= RecordSpill_Write(stream, op->buffer[i].r);
+	}
+
+	if(!written || fflush(stream) != 0) {
+		ErrorCtx_RaiseRuntimeException("Sort failed to write to a temporary file");
+	}
+
+	for(uint i = 0; i < n; i++) _freeEntry(op->buffer + i);
+	array_clear(op->buffer);
+}
+
+// Reads the next record of a spilled run.
+// Returns false once the run is depleted.
+static bool _advanceRun(OpSort *op, SortRun *run) {
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	run->head.r = r;
+	if(RecordSpill_Read(run->stream, r)) {
+		run->head = _entry(op, r);
+		return true;
+	}
+
+	OpBase_DeleteRecord(r);
+	run->head.r = NULL;
+	return false;
+}
+
+// Prepares spilled runs for a k-way merge.
+static void _initMerge(OpSort *op) {
+	// spill remaining records as the last run
+	if(array_len(op->buffer) > 0) _spill(op);
+
+	uint run_count = array_len(op->runs);
+	op->heap = Heap_new(_run_compare, op);
+	for(uint i = 0; i < run_count; i++) {
+		SortRun *run = op->runs + i;
+		rewind(run->stream);
+		if(_advanceRun(op, run)) Heap_offer(&op->heap, run);
+	}
+}
+
+// Produces the next record out of the spilled runs.
+static Record _merge(OpSort *op) {
+	if(Heap_count(op->heap) == 0) return NULL;
+
+	SortRun *run = Heap_poll(op->heap);
+	Record r = run->head.r;
+	sdsfree(run->head.key);
+	run->head.key = NULL;
+	if(_advanceRun(op, run)) Heap_offer(&op->heap, run);
+
+	return r;
 }
 
 static void _accumulate(OpSort *op, Record r) {
-	if(op->limit == UNLIMITED) {
-		/* Not using a heap and there's room for record. */
-		array_append(op->buffer, r);
+	if(op->limit == 0) {
+		OpBase_DeleteRecord(r);
 		return;
 	}
 
-	if(Heap_count(op->heap) < op->limit) {
-		Heap_offer(&op->heap, r);
-	} else {
-		// No room in the heap, see if we need to replace
-		// a heap stored record with the current record.
-		if(_heap_elem_compare(Heap_peek(op->heap), r, op) > 0) {
-			Record replaced = Heap_poll(op->heap);
-			OpBase_DeleteRecord(replaced);
-			Heap_offer(&op->heap, r);
-		} else {
-			OpBase_DeleteRecord(r);
+	SortEntry e = _entry(op, r);
+
+	if(op->limit != UNLIMITED) {
+		// Discard records which can't make it into the top n.
+		if(op->threshold && SortKey_Compare(e.key, op->threshold) >= 0) {
+			_freeEntry(&e);
+			return;
 		}
+
+		array_append(op->buffer, e);
+		// Once the buffer is full, retain only the top n records.
+		if(array_len(op->buffer) >= 2 * (uint64_t)op->limit) _select(op);
+		return;
+	}
+
+	array_append(op->buffer, e);
+	if(op->spill_threshold != SORT_SPILL_DISABLED &&
+	   array_len(op->buffer) >= op->spill_threshold) {
+		_spill(op);
 	}
 }
 
+// Frees buffered records and spilled runs.
+static void _clear(OpSort *op) {
+	if(op->buffer) {
+		uint recordCount = array_len(op->buffer);
+		for(uint i = 0; i < recordCount; i++) _freeEntry(op->buffer + i);
+		array_clear(op->buffer);
+	}
+
+	if(op->runs) {
+		uint run_count = array_len(op->runs);
+		for(uint i = 0; i < run_count; i++) {
+			SortRun *run = op->runs + i;
+			if(run->head.r) _freeEntry(&run->head);
+			fclose(run->stream);
+		}
+		array_clear(op->runs);
+	}
+
+	if(op->heap) {
+		Heap_free(op->heap);
+		op->heap = NULL;
+	}
+
+	op->threshold = NULL;
+}
+
 static inline Record _handoff(OpSort *op) {
-	if(array_len(op->buffer) > 0) return array_pop(op->buffer);
-	return NULL;
+	if(array_len(op->buffer) == 0) return NULL;
+
+	SortEntry e = array_pop(op->buffer);
+	sdsfree(e.key);
+	return e.r;
 }
 
 OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions) {
 	OpSort *op = rm_malloc(sizeof(OpSort));
 	op->heap = NULL;
+	op->runs = NULL;
 	op->skip = 0;
 	op->limit = UNLIMITED;
 	op->buffer = NULL;
+	op->threshold = NULL;
+	op->spill_threshold = SORT_SPILL_DISABLED;
 	op->directions = directions;
 	op->exps = exps;
 
@@ -108,25 +270,25 @@ static OpResult SortInit(OpBase *opBase) {
 	// the sorting criteria. In order to do so, it must collect the l records,
 	// but if there is a SKIP value, s, set, it must collect l+s records,
 	// sort them and return the top l.
-	if(op->limit != UNLIMITED) {
-		op->limit += op->skip;
-		// If a limit is specified, use heapsort to poll the top N.
-		op->heap = Heap_new(_heap_elem_compare, op);
-	} else {
-		// If all records are being sorted, use quicksort.
-		op->buffer = array_new(Record, 32);
+	if(op->limit != UNLIMITED) op->limit += op->skip;
+
+	// If all records are being sorted, sorted runs which exceed
+	// the spill threshold are written to disk and merged once depleted.
+	if(op->limit == UNLIMITED) {
+		Config_Option_get(Config_SORT_SPILL_THRESHOLD, &op->spill_threshold);
 	}
 
+	op->buffer = array_new(SortEntry, 32);
+	op->runs = array_new(SortRun, 0);
+
 	return OP_OK;
 }
 
-/* `op` is an actual variable in the caller function. Using it in a
- * macro like this is rather ugly, but the macro passed to QSORT must
- * accept only 2 arguments. */
-#define RECORD_SORT(a, b) (_record_islt((*a), (*b), op))
-
 static Record SortConsume(OpBase *opBase) {
 	OpSort *op = (OpSort *)opBase;
+	// Merging spilled runs.
+	if(op->heap) return _merge(op);
+
 	Record r = _handoff(op);
 	if(r) return r;
 
@@ -140,21 +302,15 @@ static Record SortConsume(OpBase *opBase) {
 	}
 	if(!newData) return NULL;
 
-	if(op->buffer) {
-		QSORT(Record, op->buffer, array_len(op->buffer), RECORD_SORT);
-	} else {
-		// Heap, responses need to be reversed.
-		int records_count = Heap_count(op->heap);
-		op->buffer = array_new(Record, records_count);
-
-		/* Pop items from heap */
-		while(records_count > 0) {
-			r = Heap_poll(op->heap);
-			array_append(op->buffer, r);
-			records_count--;
-		}
+	if(array_len(op->runs) > 0) {
+		_initMerge(op);
+		return _merge(op);
 	}
 
+	// Retain the top n records, then sort them.
+	if(op->limit != UNLIMITED) _select(op);
+	QSORT(SortEntry, op->buffer, array_len(op->buffer), ENTRY_SORT);
+
 	// Pass ordered records downward.
 	return _handoff(op);
 }
@@ -162,24 +318,7 @@ static Record SortConsume(OpBase *opBase) {
 /* Restart iterator */
 static OpResult SortReset(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
-	uint recordCount;
-
-	if(op->heap) {
-		recordCount = Heap_count(op->heap);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = (Record)Heap_poll(op->heap);
-			OpBase_DeleteRecord(r);
-		}
-	}
-
-	if(op->buffer) {
-		recordCount = array_len(op->buffer);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = array_pop(op->buffer);
-			OpBase_DeleteRecord(r);
-		}
-	}
-
+	_clear(op);
 	return OP_OK;
 }
 
@@ -197,26 +336,18 @@ static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase) {
 static void SortFree(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 
-	if(op->heap) {
-		uint recordCount = Heap_count(op->heap);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = (Record)Heap_poll(op->heap);
-			OpBase_DeleteRecord(r);
-		}
-		Heap_free(op->heap);
-		op->heap = NULL;
-	}
+	_clear(op);
 
 	if(op->buffer) {
-		uint recordCount = array_len(op->buffer);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = array_pop(op->buffer);
-			OpBase_DeleteRecord(r);
-		}
 		array_free(op->buffer);
 		op->buffer = NULL;
 	}
 
+	if(op->runs) {
+		array_free(op->runs);
+		op->runs = NULL;
+	}
+
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
@@ -8,16 +8,33 @@
 
 #include "op.h"
 #include "../../util/heap.h"
+#include "../../util/sort_key.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include <stdio.h>
+
+// record paired with the encoding of the values it is sorted by
+typedef struct {
+	sds key;                    // Sort key, see util/sort_key.h
+	Record r;                   // Sorted record.
+} SortEntry;
+
+// sorted run of records spilled to disk
+typedef struct {
+	FILE *stream;               // Temporary file holding the run.
+	SortEntry head;             // Next record of the run.
+} SortRun;
 
 typedef struct {
 	OpBase op;
 	uint *record_offsets;       // All Record offsets containing values to sort by.
-	heap_t *heap;               // Holds top n records.
-	Record *buffer;             // Holds all records.
+	SortEntry *buffer;          // Holds records pending sort.
+	sds threshold;              // Key of the worst record retained by a top n sort.
 	uint skip;                  // Total number of records to skip
 	uint limit;                 // Total number of records to produce
+	uint64_t spill_threshold;   // Number of buffered records spilled as a single run.
+	SortRun *runs;              // Sorted runs spilled to disk.
+	heap_t *heap;               // Merges spilled runs.
 	int *directions;            // Array of sort directions(ascending / desending) for each item.
 	AR_ExpNode **exps;          // Projected expressons.
 } OpSort;
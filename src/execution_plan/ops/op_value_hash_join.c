@@ -17,33 +17,22 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-/* Determins order between two records by inspecting
- * element stored at postion idx. */
-static bool _record_islt(Record l, Record r, uint idx) {
-	SIValue lv = Record_Get(l, idx);
-	SIValue rv = Record_Get(r, idx);
-	return SIValue_Compare(lv, rv, NULL) < 0;
-}
-
-/* `idx` is an actual variable in the caller function.
- * Using it in a macro like this is rather ugly,
- * but the macro passed to QSORT must accept only 2 arguments. */
-#define RECORD_SORT_ON_ENTRY(a, b) (_record_islt((*a), (*b), idx))
+/* Determins order between two cached records
+ * by comparing their joined values sort keys. */
+#define CACHED_RECORD_SORT(a, b) (SortKey_Compare((a)->key, (b)->key) < 0)
 
 // Performs binary search, returns the leftmost index of a match.
-static bool _binarySearchLeftmost(uint *idx, Record *array, uint array_len,
-								  int join_key_idx, SIValue v) {
+static bool _binarySearchLeftmost(uint *idx, CachedRecord *array, uint array_len,
+								  int join_key_idx, sds key, SIValue v) {
 	ASSERT(idx != NULL);
 
-	SIValue x;
 	uint pos = 0;
 	uint left = 0;
 	uint right = array_len;
 
 	while(left < right) {
 		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
+		if(SortKey_Compare(array[pos].key, key) < 0) left = pos + 1;
 		else right = pos;
 	}
 
@@ -51,29 +40,28 @@ static bool _binarySearchLeftmost(uint *idx, Record *array, uint array_len,
 	*idx = left;
 
 	if(left == array_len) return false;
+	if(SortKey_Compare(array[left].key, key) != 0) return false;
 
-	x = Record_Get(array[*idx], join_key_idx);
-	// Return false if the value wasn't found or evaluated to NULL.
+	SIValue x = Record_Get(array[left].r, join_key_idx);
+	// Return false if the value evaluated to NULL.
 	int disjointOrNull = 0;
 	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
 			disjointOrNull != COMPARED_NULL);
 }
 
 // Performs binary search, returns the rightmost index of a match.
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost(uint *idx, Record *array, uint array_len, int join_key_idx,
-								   SIValue v) {
+// assuming 'key' exists in 'array'
+static bool _binarySearchRightmost(uint *idx, CachedRecord *array, uint array_len,
+								   sds key) {
 	ASSERT(idx != NULL);
 
-	SIValue x;
 	uint pos = 0;
 	uint left = 0;
 	uint right = array_len;
 
 	while(left < right) {
 		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
+		if(SortKey_Compare(key, array[pos].key) < 0) right = pos;
 		else left = pos + 1;
 	}
 
@@ -88,7 +76,7 @@ static Record _get_intersecting_record(OpValueHashJoin *op) {
 	if(op->intersect_idx == -1 ||
 	   op->number_of_intersections == 0) return NULL;
 
-	Record cr = op->cached_records[op->intersect_idx];
+	Record cr = op->cached_records[op->intersect_idx].r;
 
 	// Update intersection trackers.
 	op->intersect_idx++;
@@ -107,8 +95,12 @@ static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
 	uint leftmost_idx = 0;
 	uint rightmost_idx = 0;
 
+	// Encode value once, cached records are compared against its key.
+	sds key = SortKey_Append(sdsempty(), v, false);
+
 	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-							  array_len(op->cached_records), op->join_value_rec_idx, v)) {
+							  record_count, op->join_value_rec_idx, key, v)) {
+		sdsfree(key);
 		return false;
 	}
 
@@ -121,10 +113,10 @@ static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
 	/* Count how many records share the same node.
 	 * reduce search space by truncating left bound */
 	bool found = _binarySearchRightmost(&rightmost_idx, op->cached_records +
-								  leftmost_idx, record_count - leftmost_idx,
-								  op->join_value_rec_idx, v);
+								  leftmost_idx, record_count - leftmost_idx, key);
 	UNUSED(found);
 	ASSERT(found == true);
+	sdsfree(key);
 
 	// Compensate index.
 	rightmost_idx += leftmost_idx;
@@ -137,9 +129,8 @@ static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
 
 /* Sorts cached records by joined value. */
 void _sort_cached_records(OpValueHashJoin *op) {
-	uint idx = op->join_value_rec_idx;
-	QSORT(Record, op->cached_records,
-		  array_len(op->cached_records), RECORD_SORT_ON_ENTRY);
+	QSORT(CachedRecord, op->cached_records,
+		  array_len(op->cached_records), CACHED_RECORD_SORT);
 }
 
 /* Caches all records coming from left branch. */
@@ -147,7 +138,7 @@ void _cache_records(OpValueHashJoin *op) {
 	ASSERT(op->cached_records == NULL);
 
 	OpBase *left_child = op->op.children[0];
-	op->cached_records = array_new(Record, 32);
+	op->cached_records = array_new(CachedRecord, 32);
 
 	Record r = left_child->consume(left_child);
 	if(!r) return;
@@ -163,8 +154,9 @@ void _cache_records(OpValueHashJoin *op) {
 		// Add joined value to record.
 		Record_AddScalar(r, op->join_value_rec_idx, v);
 
-		// Cache the record.
-		array_append(op->cached_records, r);
+		// Cache the record along with its joined value sort key.
+		CachedRecord cr = {.key = SortKey_Append(sdsempty(), v, false), .r = r};
+		array_append(op->cached_records, cr);
 	} while((r = left_child->consume(left_child)));
 }
 
@@ -297,8 +289,9 @@ static OpResult ValueHashJoinReset(OpBase *ctx) {
 	if(op->cached_records) {
 		uint record_count = array_len(op->cached_records);
 		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
+			CachedRecord *cr = op->cached_records + i;
+			sdsfree(cr->key);
+			OpBase_DeleteRecord(cr->r);
 		}
 		array_free(op->cached_records);
 		op->cached_records = NULL;
@@ -325,8 +318,9 @@ static void ValueHashJoinFree(OpBase *ctx) {
 	if(op->cached_records) {
 		uint record_count = array_len(op->cached_records);
 		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
+			CachedRecord *cr = op->cached_records + i;
+			sdsfree(cr->key);
+			OpBase_DeleteRecord(cr->r);
 		}
 		array_free(op->cached_records);
 		op->cached_records = NULL;
@@ -8,15 +8,22 @@
 
 #include "op.h"
 #include "../execution_plan.h"
+#include "../../util/sort_key.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// left hand side record paired with the sort key of its joined value
+typedef struct {
+	sds key;                            // Sort key, see util/sort_key.h
+	Record r;                           // Cached record.
+} CachedRecord;
+
 typedef struct {
 	OpBase op;
 	Record rhs_rec;                     // Right hand side record.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
 	int64_t intersect_idx;              // Current intersection, < number_of_intersections
-	Record *cached_records;             // Cached left hand side records.
+	CachedRecord *cached_records;       // Cached left hand side records.
 	uint join_value_rec_idx;            // position on joined expression within record.
 	int64_t number_of_intersections;    // Number of intersections located.
 } OpValueHashJoin;
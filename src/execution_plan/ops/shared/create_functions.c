@@ -111,6 +111,8 @@ static void _CommitEdgesBlueprint
 }
 
 // commit edges
+// edges are grouped by relationship type and each group is introduced
+// into the graph as a single batch
 static void _CommitEdges
 (
 	PendingCreations *pending
@@ -123,29 +125,66 @@ static void _CommitEdges
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
 
+	// relationship type of each pending edge
+	int *relations = array_new(int, edge_count);
+	// distinct relationship types
+	// this originates from the CREATE pattern, e.g.
+	// CREATE (a)-[:R]->(b)
+	// as such we're not expecting a large number of entries
+	int *distinct_relations = array_new(int, 1);
+
 	for(uint i = 0; i < edge_count; i++) {
 		e = pending->created_edges[i];
-		NodeID srcNodeID;
-		NodeID destNodeID;
-		AttributeSet attr = pending->edge_attributes[i];
 
 		// Nodes which already existed prior to this query would
 		// have their ID set under e->srcNodeID and e->destNodeID
 		// Nodes which are created as part of this query would be
 		// saved under edge src/dest pointer.
-		if(e->srcNodeID != INVALID_ENTITY_ID) srcNodeID = e->srcNodeID;
-		else srcNodeID = ENTITY_GET_ID(Edge_GetSrcNode(e));
-		if(e->destNodeID != INVALID_ENTITY_ID) destNodeID = e->destNodeID;
-		else destNodeID = ENTITY_GET_ID(Edge_GetDestNode(e));
+		if(e->srcNodeID == INVALID_ENTITY_ID) {
+			e->srcNodeID = ENTITY_GET_ID(Edge_GetSrcNode(e));
+		}
+		if(e->destNodeID == INVALID_ENTITY_ID) {
+			e->destNodeID = ENTITY_GET_ID(Edge_GetDestNode(e));
+		}
 
 		Schema *s = GraphContext_GetSchema(gc, e->relationship, SCHEMA_EDGE);
 		// all schemas have been created in the edge blueprint loop or earlier
 		ASSERT(s != NULL);
 		int relation_id = Schema_GetID(s);
+		array_append(relations, relation_id);
+
+		uint j = 0;
+		uint distinct_count = array_len(distinct_relations);
+		for(; j < distinct_count; j++) {
+			if(distinct_relations[j] == relation_id) break;
+		}
+		if(j == distinct_count) array_append(distinct_relations, relation_id);
+	}
+
+	// create edges in batches, one per relationship type
+	Edge         **edges  =  array_new(Edge *, edge_count);
+	AttributeSet *attrs   =  array_new(AttributeSet, edge_count);
+	uint distinct_count = array_len(distinct_relations);
 
-		pending->stats->properties_set += CreateEdge(gc, e, srcNodeID,
-				destNodeID, relation_id, attr);
+	for(uint i = 0; i < distinct_count; i++) {
+		int relation_id = distinct_relations[i];
+
+		array_clear(edges);
+		array_clear(attrs);
+		for(uint j = 0; j < edge_count; j++) {
+			if(relations[j] != relation_id) continue;
+			array_append(edges, pending->created_edges[j]);
+			array_append(attrs, pending->edge_attributes[j]);
+		}
+
+		pending->stats->properties_set += CreateEdges(gc, edges, relation_id,
+				attrs);
 	}
+
+	array_free(edges);
+	array_free(attrs);
+	array_free(relations);
+	array_free(distinct_relations);
 }
 
 // Initialize all variables for storing pending creations.
@@ -208,10 +247,21 @@ void CommitNewEntities
 		_CommitEdges(pending);
 	}
 
+	// index created entities in bulk
+	CommitIndexUpdates(QueryCtx_GetGraphCtx());
+
 	// update statistics
 	pending->stats->nodes_created          +=  node_count;
 	pending->stats->relationships_created  +=  edge_count;
 
+	// a created node violated a unique constraint
+	// fail while still holding the lock, changes are rolled back
+	// before they're replicated
+	if(ErrorCtx_EncounteredError()) {
+		Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+		ErrorCtx_RaiseRuntimeException(NULL);
+	}
+
 	// release lock
 	QueryCtx_UnlockCommit(op);
 
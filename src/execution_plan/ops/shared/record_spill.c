@@ -0,0 +1,340 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "record_spill.h"
+#include "../../../errors.h"
+#include "../../../query_ctx.h"
+#include "../../../datatypes/map.h"
+#include "../../../datatypes/array.h"
+#include "../../../util/rmalloc.h"
+#include "../../../datatypes/path/path.h"
+#include "../../../datatypes/path/sipath.h"
+
+//------------------------------------------------------------------------------
+// write
+//------------------------------------------------------------------------------
+
+#define WRITE(stream, v) fwrite(&(v), sizeof(v), 1, (stream))
+
+static void _WriteEdge
+(
+	FILE *stream,
+	const Edge *e
+) {
+	EntityID id   = ENTITY_GET_ID(e);
+	int relation  = Edge_GetRelationID(e);
+	NodeID src    = Edge_GetSrcNodeID(e);
+	NodeID dest   = Edge_GetDestNodeID(e);
+
+	WRITE(stream, id);
+	WRITE(stream, relation);
+	WRITE(stream, src);
+	WRITE(stream, dest);
+}
+
+static void _WriteValue
+(
+	FILE *stream,
+	SIValue v
+) {
+	SIType t = SI_TYPE(v);
+	WRITE(stream, t);
+
+	switch(t) {
+		case T_NULL:
+			break;
+		case T_DOUBLE:
+			WRITE(stream, v.doubleval);
+			break;
+		case T_POINT:
+			WRITE(stream, v.point.latitude);
+			WRITE(stream, v.point.longitude);
+			break;
+		case T_STRING: {
+			uint32_t len = strlen(v.stringval);
+			WRITE(stream, len);
+			fwrite(v.stringval, 1, len, stream);
+			break;
+		}
+		case T_NODE: {
+			EntityID id = ENTITY_GET_ID((Node *)v.ptrval);
+			WRITE(stream, id);
+			break;
+		}
+		case T_EDGE:
+			_WriteEdge(stream, v.ptrval);
+			break;
+		case T_ARRAY: {
+			uint32_t len = SIArray_Length(v);
+			WRITE(stream, len);
+			for(uint32_t i = 0; i < len; i++) {
+				_WriteValue(stream, SIArray_Get(v, i));
+			}
+			break;
+		}
+		case T_MAP: {
+			uint32_t len = Map_KeyCount(v);
+			WRITE(stream, len);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				_WriteValue(stream, key);
+				_WriteValue(stream, val);
+			}
+			break;
+		}
+		case T_PATH: {
+			Path *p = v.ptrval;
+			uint32_t len = Path_Len(p);
+			WRITE(stream, len);
+			for(uint32_t i = 0; i < len; i++) {
+				EntityID id = ENTITY_GET_ID(Path_GetNode(p, i));
+				WRITE(stream, id);
+				_WriteEdge(stream, Path_GetEdge(p, i));
+			}
+			EntityID id = ENTITY_GET_ID(Path_GetNode(p, len));
+			WRITE(stream, id);
+			break;
+		}
+		case T_PTR:
+			ErrorCtx_RaiseRuntimeException("Unable to spill value of type %s",
+					SIType_ToString(t));
+			break;
+		default:
+			// booleans, integers and temporal values
+			WRITE(stream, v.longval);
+			break;
+	}
+}
+
+bool RecordSpill_Write
+(
+	FILE *stream,
+	const Record r
+) {
+	ASSERT(r != NULL);
+	ASSERT(stream != NULL);
+
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		uint8_t t = Record_GetType(r, i);
+		switch(t) {
+			case REC_TYPE_NODE:
+			case REC_TYPE_NODE_ID: {
+				// nodes are read back by their ID
+				t = REC_TYPE_NODE_ID;
+				EntityID id = Record_GetNodeID(r, i);
+				WRITE(stream, t);
+				WRITE(stream, id);
+				break;
+			}
+			case REC_TYPE_EDGE:
+				WRITE(stream, t);
+				_WriteEdge(stream, Record_GetEdge(r, i));
+				break;
+			case REC_TYPE_SCALAR:
+				WRITE(stream, t);
+				_WriteValue(stream, Record_Get(r, i));
+				break;
+			default:
+				t = REC_TYPE_UNKNOWN;
+				WRITE(stream, t);
+				break;
+		}
+	}
+
+	return ferror(stream) == 0;
+}
+
+//------------------------------------------------------------------------------
+// read
+//------------------------------------------------------------------------------
+
+static void _Read
+(
+	FILE *stream,
+	void *v,
+	size_t n
+) {
+	if(fread(v, n, 1, stream) != 1) {
+		ErrorCtx_RaiseRuntimeException("Failed to read spilled records");
+	}
+}
+
+#define READ(stream, v) _Read((stream), &(v), sizeof(v))
+
+static void _ReadEdge
+(
+	FILE *stream,
+	Edge *e
+) {
+	EntityID id;
+	int relation;
+	NodeID src;
+	NodeID dest;
+
+	READ(stream, id);
+	READ(stream, relation);
+	READ(stream, src);
+	READ(stream, dest);
+
+	Graph_GetEdge(QueryCtx_GetGraph(), id, e);
+	e->relationID = relation;
+	e->srcNodeID  = src;
+	e->destNodeID = dest;
+}
+
+static void _ReadNode
+(
+	FILE *stream,
+	Node *n
+) {
+	EntityID id;
+	READ(stream, id);
+	Graph_GetNode(QueryCtx_GetGraph(), id, n);
+}
+
+// reads a value, the returned value owns its allocations
+static SIValue _ReadValue
+(
+	FILE *stream
+) {
+	SIType t;
+	SIValue v = SI_NullVal();
+	READ(stream, t);
+
+	switch(t) {
+		case T_NULL:
+			break;
+		case T_DOUBLE:
+			READ(stream, v.doubleval);
+			break;
+		case T_POINT: {
+			float lat;
+			float lon;
+			READ(stream, lat);
+			READ(stream, lon);
+			v = SI_Point(lat, lon);
+			break;
+		}
+		case T_STRING: {
+			uint32_t len;
+			READ(stream, len);
+			char *s = rm_malloc(len + 1);
+			if(len > 0) _Read(stream, s, len);
+			s[len] = '\0';
+			v = SI_TransferStringVal(s);
+			break;
+		}
+		case T_NODE: {
+			Node n = GE_NEW_NODE();
+			_ReadNode(stream, &n);
+			v = SI_CloneValue(SI_Node(&n));
+			break;
+		}
+		case T_EDGE: {
+			Edge e = {0};
+			_ReadEdge(stream, &e);
+			v = SI_CloneValue(SI_Edge(&e));
+			break;
+		}
+		case T_ARRAY: {
+			uint32_t len;
+			READ(stream, len);
+			v = SI_Array(len);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue elem = _ReadValue(stream);
+				SIArray_Append(&v, elem);
+				SIValue_Free(elem);
+			}
+			break;
+		}
+		case T_MAP: {
+			uint32_t len;
+			READ(stream, len);
+			v = Map_New(len);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue key = _ReadValue(stream);
+				SIValue val = _ReadValue(stream);
+				Map_Add(&v, key, val);
+				SIValue_Free(key);
+				SIValue_Free(val);
+			}
+			break;
+		}
+		case T_PATH: {
+			uint32_t len;
+			READ(stream, len);
+			Path *p = Path_New(len);
+			for(uint32_t i = 0; i < len; i++) {
+				Node n = GE_NEW_NODE();
+				Edge e = {0};
+				_ReadNode(stream, &n);
+				_ReadEdge(stream, &e);
+				Path_AppendNode(p, n);
+				Path_AppendEdge(p, e);
+			}
+			Node n = GE_NEW_NODE();
+			_ReadNode(stream, &n);
+			Path_AppendNode(p, n);
+			v = SI_Path(p);
+			Path_Free(p);
+			break;
+		}
+		default:
+			// booleans, integers and temporal values
+			READ(stream, v.longval);
+			break;
+	}
+
+	v.type = t;
+	return v;
+}
+
+bool RecordSpill_Read
+(
+	FILE *stream,
+	Record r
+) {
+	ASSERT(r != NULL);
+	ASSERT(stream != NULL);
+
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		uint8_t t;
+		if(fread(&t, sizeof(t), 1, stream) != 1) {
+			// stream is only expected to end in between records
+			if(i == 0 && feof(stream)) return false;
+			ErrorCtx_RaiseRuntimeException("Failed to read spilled records");
+		}
+
+		switch(t) {
+			case REC_TYPE_NODE_ID: {
+				EntityID id;
+				READ(stream, id);
+				Record_AddNodeID(r, i, id);
+				break;
+			}
+			case REC_TYPE_EDGE: {
+				Edge e = {0};
+				_ReadEdge(stream, &e);
+				Record_AddEdge(r, i, e);
+				break;
+			}
+			case REC_TYPE_SCALAR:
+				Record_AddScalar(r, i, _ReadValue(stream));
+				break;
+			default:
+				Record_Remove(r, i);
+				break;
+		}
+	}
+
+	return true;
+}
+
@@ -0,0 +1,34 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../record.h"
+#include <stdio.h>
+
+// serializes records to and from a local file
+// used by operations which spill intermediate records to disk
+//
+// nodes and edges are written by ID and retrieved from the graph once read
+// as such, a spilled record must be read back within the same query
+
+// writes 'r' to 'stream'
+// returns false on I/O failure
+bool RecordSpill_Write
+(
+	FILE *stream,  // stream to write to
+	const Record r // record to write
+);
+
+// reads the next record from 'stream' into 'r'
+// 'r' is expected to share the mapping of the written record
+// returns false once 'stream' is depleted
+bool RecordSpill_Read
+(
+	FILE *stream,  // stream to read from
+	Record r       // [output] record to populate
+);
+
@@ -77,6 +77,12 @@ void CommitUpdates
 	}
 
 	if(stats) stats->properties_set += properties_set;
+
+	// reindex updated entities in bulk
+	CommitIndexUpdates(gc);
+
+	// an updated node violated a unique constraint
+	if(ErrorCtx_EncounteredError()) ErrorCtx_RaiseRuntimeException(NULL);
 }
 
 void EvalEntityUpdates
@@ -100,15 +106,15 @@ void EvalEntityUpdates
 	if(t == REC_TYPE_UNKNOWN) return;
 
 	// make sure we're updating either a node or an edge
-	if(t != REC_TYPE_NODE && t != REC_TYPE_EDGE) {
+	if(!(t & (REC_TYPE_NODE | REC_TYPE_NODE_ID | REC_TYPE_EDGE))) {
 		ErrorCtx_RaiseRuntimeException(
 			"Update error: alias '%s' did not resolve to a graph entity",
 			ctx->alias);
 	}
 
-	PendingUpdateCtx **updates = t == REC_TYPE_NODE
-		? node_updates
-		: edge_updates;
+	PendingUpdateCtx **updates = t == REC_TYPE_EDGE
+		? edge_updates
+		: node_updates;
 
 	GraphEntity *entity = Record_GetGraphEntity(r, ctx->record_idx);
 
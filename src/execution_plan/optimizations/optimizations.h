@@ -30,6 +30,8 @@ void reduceFilters(ExecutionPlan *plan);
 void reduceTraversal(ExecutionPlan *plan);
 void reduceDistinct(ExecutionPlan *plan);
 void reduceCount(ExecutionPlan *plan);
+void reduceSort(ExecutionPlan *plan);
+void utilizeCoveringIndices(ExecutionPlan *plan);
 void applyLimit(ExecutionPlan *plan);
 void applySkip(ExecutionPlan *plan);
 void optimizeLabelScan(ExecutionPlan *plan);
@@ -55,6 +55,12 @@ void optimizePlan(ExecutionPlan *plan) {
 	// try to reduce execution plan incase it perform node or edge counting
 	reduceCount(plan);
 
+	// omit sorting of records produced in order by an index scan
+	reduceSort(plan);
+
+	// produce indexed attributes from index entries rather than nodes
+	utilizeCoveringIndices(plan);
+
 	// let operations know about specified limit(s)
 	applyLimit(plan);
 
@@ -14,7 +14,11 @@
  * performing solely node/edge counting: total number of nodes/edges
  * in the graph, total number of nodes/edges with a specific label/relation.
  * In which case we can avoid performing both SCAN* and AGGREGATE
- * operations by simply returning a precomputed count */
+ * operations by simply returning a precomputed count
+ *
+ * nodes matched by an index scan whose filters are entirely resolved by
+ * an ordered index are counted by walking index entries,
+ * without accessing the nodes themselves */
 
 static int _identifyResultAndAggregateOps(OpBase *root, OpResult **opResult,
 										  OpAggregate **opAggregate) {
@@ -60,9 +64,10 @@ static int _identifyNodeCountPattern(OpBase *root, OpResult **opResult, OpAggreg
 	if(!_identifyResultAndAggregateOps(root, opResult, opAggregate)) return 0;
 	OpBase *op = ((OpBase *)*opAggregate)->children[0];
 
-	// Scan, either a full node or label scan.
+	// Scan, either a full node, label or index scan.
 	if((op->type != OPType_ALL_NODE_SCAN &&
-		op->type != OPType_NODE_BY_LABEL_SCAN) ||
+		op->type != OPType_NODE_BY_LABEL_SCAN &&
+		op->type != OPType_NODE_BY_INDEX_SCAN) ||
 	   op->childCount != 0) {
 		return 0;
 	}
@@ -94,8 +99,13 @@ bool _reduceNodeCount(ExecutionPlan *plan) {
 	SIValue nodeCount;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 
-	// If label is specified, count only labeled entities.
-	if(label) {
+	if(opScan->type == OPType_NODE_BY_INDEX_SCAN) {
+		// count nodes passing the index scan filters
+		uint64_t count;
+		if(!IndexScanOp_Count((IndexScan *)opScan, &count)) return false;
+		nodeCount = SI_LongVal(count);
+	} else if(label) {
+		// If label is specified, count only labeled entities.
 		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 		if(s) nodeCount = SI_LongVal(Graph_LabeledNodeCount(gc->g, s->id));
 		else nodeCount = SI_LongVal(0); // Specified Label doesn't exists.
@@ -0,0 +1,207 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../../query_ctx.h"
+#include "../ops/op_sort.h"
+#include "../ops/op_project.h"
+#include "../ops/op_node_by_label_scan.h"
+#include "../ops/op_node_by_index_scan.h"
+#include "../../util/arr.h"
+#include "../../ast/ast_build_op_contexts.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// the reduce sort optimizer looks for sort operations ordering records
+// by a single attribute of a node retrieved by an index scan
+// in case the index scan can produce nodes ordered by that attribute
+// e.g. a composite over (tenant, ts) scanned for a single tenant
+// the sort operation is omitted from the execution plan
+//
+// MATCH (n:L) WHERE n.tenant = 1 AND n.ts > 10 RETURN n ORDER BY n.ts
+//
+// a label scan is replaced by an ordered scan over the attribute's index
+// such that a following limit stops the scan once satisfied
+//
+// MATCH (n:L) RETURN n ORDER BY n.ts DESC LIMIT 20
+//
+// ordering by distance of a point attribute from a constant point is
+// served by the attribute's spatial index, producing nearest nodes first
+//
+// MATCH (n:L) RETURN n ORDER BY distance(n.loc, point({...})) LIMIT 5
+
+// locate the projected expression 'name' refers to
+static AR_ExpNode *_ProjectedExp
+(
+	const OpProject *project,
+	const char *name
+) {
+	uint exp_count = array_len(project->exps);
+	for(uint i = 0; i < exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(strcmp(exp->resolved_name, name) == 0) return exp;
+	}
+
+	return NULL;
+}
+
+// replace a label scan with a scan over the label's index ordered by 'attr'
+// or by distance of 'attr' from 'origin' if set
+// returns false if the label has no such index
+static bool _OrderedLabelScan
+(
+	ExecutionPlan *plan,
+	NodeByLabelScan *scan,
+	const char *attr,
+	bool desc,
+	const SIValue *origin
+) {
+	// scan should produce the entire label
+	if(scan->op.childCount > 0) return false;
+	if(scan->n.label_id == GRAPH_UNKNOWN_LABEL) return false;
+
+	const UnsignedRange *r = scan->id_range;
+	if(r->min > 0 || !r->include_min || r->max < UINT64_MAX) return false;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Index *idx = GraphContext_GetIndexByID(gc, scan->n.label_id, NULL,
+			IDX_EXACT_MATCH, SCHEMA_NODE);
+
+	// no index for label, or index is still under construction
+	if(idx == NULL || !Index_Enabled(idx)) return false;
+
+	OpBase *index_scan = NewIndexScanOp(scan->op.plan, scan->g, scan->n, idx,
+			NULL);
+	bool ordered = (origin != NULL) ?
+		IndexScanOp_OrderByDistance((IndexScan *)index_scan, attr, *origin) :
+		IndexScanOp_OrderBy((IndexScan *)index_scan, attr, desc);
+	if(!ordered) {
+		OpBase_Free(index_scan);
+		return false;
+	}
+
+	ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, index_scan);
+	OpBase_Free((OpBase *)scan);
+	return true;
+}
+
+// returns true if 'exp' accesses attribute 'attr' of 'alias'
+static bool _AccessesAttribute
+(
+	AR_ExpNode *exp,
+	const char *alias,
+	char **attr
+) {
+	if(!AR_EXP_IsAttribute(exp, attr)) return false;
+
+	AR_ExpNode *entity = exp->op.children[0];
+	return (AR_EXP_IsVariadic(entity) &&
+			strcmp(entity->operand.variadic.entity_alias, alias) == 0);
+}
+
+// returns true if 'exp' is of the form distance(alias.attr, point)
+// where point is a constant, sets 'origin' to the constant point
+static bool _DistanceFromPoint
+(
+	AR_ExpNode *exp,
+	const char *alias,
+	char **attr,
+	SIValue *origin
+) {
+	if(!AR_EXP_IsOperation(exp)) return false;
+	if(strcasecmp(AR_EXP_GetFuncName(exp), "distance") != 0) return false;
+
+	for(int i = 0; i < 2; i++) {
+		AR_ExpNode *lhs = exp->op.children[i];
+		AR_ExpNode *rhs = exp->op.children[1 - i];
+		if(!_AccessesAttribute(lhs, alias, attr)) continue;
+
+		SIValue v;
+		if(!AR_EXP_ReduceToScalar(rhs, true, &v)) return false;
+		if(SI_TYPE(v) != T_POINT) {
+			SIValue_Free(v);
+			return false;
+		}
+
+		*origin = v;
+		return true;
+	}
+
+	return false;
+}
+
+static void _reduceSort
+(
+	ExecutionPlan *plan,
+	OpSort *sort
+) {
+	// sorting by a single attribute
+	if(array_len(sort->exps) != 1) return;
+	bool desc = (sort->directions[0] == DIR_DESC);
+
+	// sort -> project -> [filter]* -> index scan / label scan
+	OpBase *op = sort->op.children[0];
+	if(op->type != OPType_PROJECT) return;
+	OpProject *project = (OpProject *)op;
+
+	do {
+		if(op->childCount != 1) return;
+		op = op->children[0];
+	} while(op->type == OPType_FILTER);
+
+	const char *alias = NULL;
+	if(op->type == OPType_NODE_BY_INDEX_SCAN) {
+		alias = ((IndexScan *)op)->n.alias;
+	} else if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+		alias = ((NodeByLabelScan *)op)->n.alias;
+	} else {
+		return;
+	}
+
+	// sort expression should access an attribute of the scanned node
+	// or compute its distance from a constant point, nearest first
+	char *attr = NULL;
+	SIValue origin = SI_NullVal();
+	AR_ExpNode *exp = _ProjectedExp(project, sort->exps[0]->resolved_name);
+	if(exp == NULL) return;
+
+	bool nearest = false;
+	if(!_AccessesAttribute(exp, alias, &attr)) {
+		if(desc || !_DistanceFromPoint(exp, alias, &attr, &origin)) return;
+		nearest = true;
+	}
+
+	// records arrive ordered, sort is redundant
+	bool ordered;
+	if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+		ordered = _OrderedLabelScan(plan, (NodeByLabelScan *)op, attr, desc,
+				nearest ? &origin : NULL);
+	} else if(nearest) {
+		ordered = IndexScanOp_OrderByDistance((IndexScan *)op, attr, origin);
+	} else {
+		ordered = IndexScanOp_OrderBy((IndexScan *)op, attr, desc);
+	}
+
+	if(!ordered) return;
+
+	ExecutionPlan_RemoveOp(plan, (OpBase *)sort);
+	OpBase_Free((OpBase *)sort);
+}
+
+void reduceSort
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	OpBase **sort_ops = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	uint sort_count = array_len(sort_ops);
+	for(uint i = 0; i < sort_count; i++) {
+		_reduceSort(plan, (OpSort *)sort_ops[i]);
+	}
+
+	array_free(sort_ops);
+}
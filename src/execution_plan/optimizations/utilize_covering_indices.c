@@ -0,0 +1,91 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/op_project.h"
+#include "../ops/op_aggregate.h"
+#include "../ops/op_node_by_index_scan.h"
+#include "../../util/arr.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// the utilize covering indices optimizer looks for projections and
+// aggregations accessing attributes of nodes retrieved by an index scan
+// attributes stored along the scanned index entries are produced by the
+// index scan itself, sparing access to the nodes' attribute sets
+//
+// MATCH (n:L) WHERE n.v STARTS WITH 'a' RETURN n.v
+// MATCH (n:L) WHERE n.tenant = 1 RETURN n.ts ORDER BY n.ts LIMIT 10
+
+// replace attribute lookups on the scanned node within 'exp'
+// with references to values produced by the index scan
+static void _CoverExp
+(
+	IndexScan *scan,
+	AR_ExpNode *exp
+) {
+	if(!AR_EXP_IsOperation(exp)) return;
+
+	char *attr = NULL;
+	if(AR_EXP_IsAttribute(exp, &attr)) {
+		AR_ExpNode *entity = exp->op.children[0];
+		if(AR_EXP_IsVariadic(entity) &&
+		   strcmp(entity->operand.variadic.entity_alias, scan->n.alias) == 0) {
+			const char *alias = IndexScanOp_Cover(scan, attr);
+			if(alias != NULL) AR_EXP_InplaceRepurposeVariadic(exp, alias);
+			return;
+		}
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		_CoverExp(scan, exp->op.children[i]);
+	}
+}
+
+static void _utilizeCoveringIndex
+(
+	IndexScan *scan
+) {
+	// index query is rebuilt for every input record
+	if(scan->op.childCount > 0) return;
+
+	// index scan -> [filter]* -> project / aggregate
+	OpBase *op = scan->op.parent;
+	while(op != NULL && op->type == OPType_FILTER) op = op->parent;
+	if(op == NULL) return;
+
+	if(op->type == OPType_PROJECT) {
+		OpProject *project = (OpProject *)op;
+		uint exp_count = array_len(project->exps);
+		for(uint i = 0; i < exp_count; i++) {
+			_CoverExp(scan, project->exps[i]);
+		}
+	} else if(op->type == OPType_AGGREGATE) {
+		OpAggregate *aggregate = (OpAggregate *)op;
+		for(uint i = 0; i < aggregate->key_count; i++) {
+			_CoverExp(scan, aggregate->key_exps[i]);
+		}
+		for(uint i = 0; i < aggregate->aggregate_count; i++) {
+			_CoverExp(scan, aggregate->aggregate_exps[i]);
+		}
+	}
+}
+
+void utilizeCoveringIndices
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	OpBase **scans = ExecutionPlan_CollectOps(plan->root,
+			OPType_NODE_BY_INDEX_SCAN);
+
+	uint scan_count = array_len(scans);
+	for(uint i = 0; i < scan_count; i++) {
+		_utilizeCoveringIndex((IndexScan *)scans[i]);
+	}
+
+	array_free(scans);
+}
@@ -88,6 +88,66 @@ static bool _validateInExpression(AR_ExpNode *exp) {
 	return true;
 }
 
+// return true if filter is of the form: n.v STARTS WITH 'prefix'
+// prefix lookups are served by the attribute's ordered index
+static bool _applicableStartsWith
+(
+	const char *filtered_entity,
+	const Index *idx,
+	FT_FilterNode *filter
+) {
+	AR_ExpNode *exp = filter->exp.exp;
+	ASSERT(exp->op.child_count == 2);
+
+	char *attr = NULL;
+	AR_ExpNode *lhs = exp->op.children[0];
+	if(!AR_EXP_IsAttribute(lhs, &attr)) return false;
+
+	AR_ExpNode *entity = lhs->op.children[0];
+	if(!AR_EXP_IsVariadic(entity)) return false;
+	if(strcmp(entity->operand.variadic.entity_alias, filtered_entity) != 0) {
+		return false;
+	}
+
+	if(Index_GetOrderedIndex(idx, attr) == NULL) return false;
+
+	// prefix must be a constant string
+	AR_ExpNode *rhs = exp->op.children[1];
+	AR_EXP_ReduceToScalar(rhs, false, NULL);
+	return (AR_EXP_IsConstant(rhs) &&
+			SI_TYPE(rhs->operand.constant) == T_STRING);
+}
+
+// return true if filter is of the form: x IN n.v
+// or any(t IN n.v WHERE t = x)
+// membership lookups are served by the attribute's members index
+static bool _applicableMembership
+(
+	const char *filtered_entity,
+	const Index *idx,
+	FT_FilterNode *filter
+) {
+	AR_ExpNode *list = NULL;
+	AR_ExpNode *elem = NULL;
+	extractMembership(filter, &list, &elem);
+
+	char *attr = NULL;
+	AR_EXP_IsAttribute(list, &attr);
+
+	AR_ExpNode *entity = list->op.children[0];
+	if(!AR_EXP_IsVariadic(entity)) return false;
+	if(strcmp(entity->operand.variadic.entity_alias, filtered_entity) != 0) {
+		return false;
+	}
+
+	if(Index_GetMemberIndex(idx, attr) == NULL) return false;
+
+	// looked up element must be a constant or a parameter
+	AR_EXP_ReduceToScalar(elem, true, NULL);
+	return (AR_EXP_IsConstant(elem) &&
+			(SI_TYPE(elem->operand.constant) & (SI_NUMERIC | T_STRING | T_BOOL)));
+}
+
 // return true if filter can be resolved by an index query
 static bool _applicable_predicate(const char* filtered_entity,
 		FT_FilterNode *filter) {
@@ -183,14 +243,21 @@ bool _applicableFilter
 	rax            *entities     =  NULL;
 	FT_FilterNode  *filter_tree  =  *filter;
 
-	// make sure the filter root is not a function, other then IN or distance
+	// make sure the filter root is not a function, other then IN, distance,
+	// STARTS WITH or a membership test
 	// make sure the "not equal, <>" operator isn't used
 	if(FilterTree_containsOp(filter_tree, OP_NEQUAL)) {
 		res = false;
 		goto cleanup;
 	}
 
-	if(!_applicable_predicate(filtered_entity, filter_tree)) {
+	if(isStartsWithFilter(filter_tree)) {
+		res = _applicableStartsWith(filtered_entity, idx, filter_tree);
+		if(!res) goto cleanup;
+	} else if(isMembershipFilter(filter_tree)) {
+		res = _applicableMembership(filtered_entity, idx, filter_tree);
+		if(!res) goto cleanup;
+	} else if(!_applicable_predicate(filtered_entity, filter_tree)) {
 		res = false;
 		goto cleanup;
 	}
@@ -297,7 +364,7 @@ void reduce_scan_op
 	// that has the minimum NNZ entries
 	int         min_label_id;                 // tracks min label ID
 	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
-	RSIndex     *rs_idx        = NULL;        // the index to be applied
+	Index       *min_idx       = NULL;        // the index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
 	const char  *min_label_str = NULL;        // tracks min label name
@@ -319,11 +386,10 @@ void reduce_scan_op
 
 		idx = GraphContext_GetIndexByID(gc, label_id, NULL, IDX_EXACT_MATCH, SCHEMA_NODE);
 
-		// no index for current label
-		if(idx == NULL) continue;
+		// no index for current label, or index is still under construction
+		if(idx == NULL || !Index_Enabled(idx)) continue;
 
 		// get all applicable filter for index
-		RSIndex *cur_idx = idx->idx;
 		// TODO switch to reusable array
 		OpFilter **cur_filters = _applicableFilters((OpBase *)scan, scan->n.alias, idx);
 
@@ -339,7 +405,7 @@ void reduce_scan_op
 
 		nnz = Graph_LabeledNodeCount(g, label_id);
 		if(min_nnz > nnz) {
-			rs_idx         =  cur_idx;
+			min_idx        =  idx;
 			min_nnz        =  nnz;
 			min_label_str  =  label;
 			min_label_id   =  label_id;
@@ -353,7 +419,7 @@ void reduce_scan_op
 	}
 
 	// no label possessed indexed and filtered attributes, return early
-	if(rs_idx == NULL) goto cleanup;
+	if(min_idx == NULL) goto cleanup;
 
 	// did we found a better label to utilize? if so swap
 	if(scan->n.label_id != min_label_id) {
@@ -387,7 +453,7 @@ void reduce_scan_op
 	}
 
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx,
+	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, min_idx,
 			root);
 
 	// replace the redundant scan op with the newly-constructed Index Scan
@@ -421,10 +487,9 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 	const char *label = QGEdge_Relation(e, 0);
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH, SCHEMA_EDGE);
-	if(idx == NULL) return;
+	if(idx == NULL || !Index_Enabled(idx)) return;
 
 	// get all applicable filter for index
-	RSIndex *rs_idx = idx->idx;
 	OpFilter **filters = _applicableFilters((OpBase *)cond, edge, idx);
 
 	// no filters, return
@@ -432,7 +497,7 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 	if(filters_count == 0) goto cleanup;
 
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewEdgeIndexScanOp(cond->op.plan, cond->graph, e, rs_idx,
+	OpBase *indexOp = NewEdgeIndexScanOp(cond->op.plan, cond->graph, e, idx,
 			root);
 
 	// The OPType_ALL_NODE_SCAN operation is redundant
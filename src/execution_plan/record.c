@@ -7,6 +7,7 @@
 #include "RG.h"
 #include "record.h"
 #include "../errors.h"
+#include "../query_ctx.h"
 #include "../util/rmalloc.h"
 
 /* Migrate the entry at the given index in the source Record at the same index in the destination.
@@ -98,8 +99,23 @@ RecordEntryType Record_GetType(const Record r, uint idx) {
 	return r->entries[idx].type;
 }
 
-Node *Record_GetNode(const Record r, uint idx) {
+// retrieve the attributes of an ID-only node, turning it into a regular node
+static void _MaterializeNode(Record r, uint idx) {
+	Node *n = &(r->entries[idx].value.n);
+	// the node might have been deleted since it was added to the record
+	// in which case it is materialized as a deleted node without attributes
+	// just as if it was retrieved eagerly
+	bool found = Graph_GetNodeIncludingDeleted(QueryCtx_GetGraph(), n->id, n);
+	UNUSED(found);
+	ASSERT(found == true);
+	r->entries[idx].type = REC_TYPE_NODE;
+}
+
+Node *Record_GetNode(Record r, uint idx) {
 	switch(r->entries[idx].type) {
+		case REC_TYPE_NODE_ID:
+			_MaterializeNode(r, idx);
+		// fall through
 		case REC_TYPE_NODE:
 			return &(r->entries[idx].value.n);
 		case REC_TYPE_UNKNOWN:
@@ -113,6 +129,22 @@ Node *Record_GetNode(const Record r, uint idx) {
 	}
 }
 
+EntityID Record_GetNodeID(const Record r, uint idx) {
+	switch(r->entries[idx].type) {
+		case REC_TYPE_NODE:
+		case REC_TYPE_NODE_ID:
+			return ENTITY_GET_ID(&(r->entries[idx].value.n));
+		case REC_TYPE_UNKNOWN:
+			return INVALID_ENTITY_ID;
+		case REC_TYPE_SCALAR:
+			// Null scalar values are expected here; otherwise fall through.
+			if(SIValue_IsNull(r->entries[idx].value.s)) return INVALID_ENTITY_ID;
+		default:
+			ErrorCtx_RaiseRuntimeException("encountered unexpected type in Record; expected Node");
+			return INVALID_ENTITY_ID;
+	}
+}
+
 Edge *Record_GetEdge(const Record r, uint idx) {
 	switch(r->entries[idx].type) {
 		case REC_TYPE_EDGE:
@@ -132,6 +164,7 @@ SIValue Record_Get(Record r, uint idx) {
 	Entry e = r->entries[idx];
 	switch(e.type) {
 		case REC_TYPE_NODE:
+		case REC_TYPE_NODE_ID:
 			return SI_Node(Record_GetNode(r, idx));
 		case REC_TYPE_EDGE:
 			return SI_Edge(Record_GetEdge(r, idx));
@@ -149,10 +182,11 @@ void Record_Remove(Record r, uint idx) {
 	r->entries[idx].type = REC_TYPE_UNKNOWN;
 }
 
-GraphEntity *Record_GetGraphEntity(const Record r, uint idx) {
+GraphEntity *Record_GetGraphEntity(Record r, uint idx) {
 	Entry e = r->entries[idx];
 	switch(e.type) {
 		case REC_TYPE_NODE:
+		case REC_TYPE_NODE_ID:
 			return (GraphEntity *)Record_GetNode(r, idx);
 		case REC_TYPE_EDGE:
 			return (GraphEntity *)Record_GetEdge(r, idx);
@@ -189,6 +223,13 @@ Node *Record_AddNode(Record r, uint idx, Node node) {
 	return &(r->entries[idx].value.n);
 }
 
+void Record_AddNodeID(Record r, uint idx, NodeID id) {
+	Node n = GE_NEW_NODE();
+	n.id = id;
+	r->entries[idx].value.n = n;
+	r->entries[idx].type = REC_TYPE_NODE_ID;
+}
+
 Edge *Record_AddEdge(Record r, uint idx, Edge edge) {
 	r->entries[idx].value.e = edge;
 	r->entries[idx].type = REC_TYPE_EDGE;
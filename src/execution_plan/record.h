@@ -21,6 +21,7 @@ typedef enum  {
 	REC_TYPE_NODE = 1 << 1,
 	REC_TYPE_EDGE = 1 << 2,
 	REC_TYPE_HEADER = 1 << 3,
+	REC_TYPE_NODE_ID = 1 << 4,  // node whose attributes weren't retrieved yet
 } RecordEntryType;
 
 typedef struct {
@@ -65,7 +66,12 @@ uint Record_GetEntryIdx(Record r, const char *alias);
 RecordEntryType Record_GetType(const Record r, uint idx);
 
 // Get a node from record at position idx.
-Node *Record_GetNode(const Record r, uint idx);
+// ID-only nodes are materialized in place.
+Node *Record_GetNode(Record r, uint idx);
+
+// Get the ID of the node at position idx without materializing it.
+// Returns INVALID_ENTITY_ID if the entry is missing or NULL.
+EntityID Record_GetNodeID(const Record r, uint idx);
 
 // Get an edge from record at position idx.
 Edge *Record_GetEdge(const Record r, uint idx);
@@ -77,7 +83,7 @@ SIValue Record_Get(Record r, uint idx);
 void Record_Remove(Record r, uint idx);
 
 // Get a graph entity from record at position idx.
-GraphEntity *Record_GetGraphEntity(const Record r, uint idx);
+GraphEntity *Record_GetGraphEntity(Record r, uint idx);
 
 // Add a scalar, node, or edge to the record, depending on the SIValue type.
 void Record_Add(Record r, uint idx, SIValue v);
@@ -88,6 +94,10 @@ SIValue *Record_AddScalar(Record r, uint idx, SIValue v);
 // Add a node to record at position idx and return a reference to it.
 Node *Record_AddNode(Record r, uint idx, Node node);
 
+// Add a node to record at position idx by its ID alone,
+// its attributes are retrieved on first access.
+void Record_AddNodeID(Record r, uint idx, NodeID id);
+
 // Add an edge to record at position idx and return a reference to it.
 Edge *Record_AddEdge(Record r, uint idx, Edge edge);
 
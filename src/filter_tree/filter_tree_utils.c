@@ -6,6 +6,7 @@
 
 #include "filter_tree_utils.h"
 #include "RG.h"
+#include "../arithmetic/comprehension_funcs/comprehension_funcs.h"
 
 bool isInFilter(const FT_FilterNode *filter) {
 	return (filter->t == FT_N_EXP &&
@@ -13,6 +14,75 @@ bool isInFilter(const FT_FilterNode *filter) {
 			strcasecmp(AR_EXP_GetFuncName(filter->exp.exp), "in") == 0);
 }
 
+bool isStartsWithFilter(const FT_FilterNode *filter) {
+	return (filter->t == FT_N_EXP &&
+			filter->exp.exp->type == AR_EXP_OP &&
+			strcasecmp(AR_EXP_GetFuncName(filter->exp.exp), "starts with") == 0);
+}
+
+// extracts both the list and the looked up element from a membership filter
+// x IN n.tags
+// any(t IN n.tags WHERE t = x)
+bool extractMembership(const FT_FilterNode *filter, AR_ExpNode **list,
+		AR_ExpNode **elem) {
+	ASSERT(filter != NULL);
+
+	if(filter->t != FT_N_EXP) return false;
+
+	AR_ExpNode *exp = filter->exp.exp;
+	if(!AR_EXP_IsOperation(exp)) return false;
+
+	const char *func = AR_EXP_GetFuncName(exp);
+	AR_ExpNode *l = NULL;
+	AR_ExpNode *e = NULL;
+
+	if(strcasecmp(func, "in") == 0) {
+		// x IN n.tags
+		l = exp->op.children[1];
+		e = exp->op.children[0];
+	} else if(strcasecmp(func, "any") == 0) {
+		// any(t IN n.tags WHERE t = x)
+		l = exp->op.children[0];
+		ListComprehensionCtx *ctx = exp->op.private_data;
+		FT_FilterNode *pred = ctx->ft;
+		if(pred == NULL || pred->t != FT_N_PRED) return false;
+		if(pred->pred.op != OP_EQUAL) return false;
+
+		// one side of the equality is the comprehension's variable
+		// the other side mustn't refer to it
+		for(int i = 0; i < 2 && e == NULL; i++) {
+			AR_ExpNode *var   = (i == 0) ? pred->pred.lhs : pred->pred.rhs;
+			AR_ExpNode *other = (i == 0) ? pred->pred.rhs : pred->pred.lhs;
+			if(!AR_EXP_IsVariadic(var)) continue;
+			if(strcmp(var->operand.variadic.entity_alias,
+						ctx->variable_str) != 0) continue;
+
+			rax *aliases = raxNew();
+			AR_EXP_CollectEntities(other, aliases);
+			bool refers = raxFind(aliases, (unsigned char *)ctx->variable_str,
+					strlen(ctx->variable_str)) != raxNotFound;
+			raxFree(aliases);
+
+			if(!refers) e = other;
+		}
+		if(e == NULL) return false;
+	} else {
+		return false;
+	}
+
+	if(!AR_EXP_IsAttribute(l, NULL)) return false;
+
+	if(list) *list = l;
+	if(elem) *elem = e;
+	return true;
+}
+
+// return true if filter tests an attribute list for membership
+// 'red' IN n.tags
+bool isMembershipFilter(const FT_FilterNode *filter) {
+	return extractMembership(filter, NULL, NULL);
+}
+
 // extracts both origin and radius from a distance filter
 // distance(n.location, origin) < radius
 bool extractOriginAndRadius(const FT_FilterNode *filter, SIValue *origin,
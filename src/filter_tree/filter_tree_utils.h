@@ -10,6 +10,13 @@
 
 bool isInFilter(const FT_FilterNode *filter);
 
+bool isStartsWithFilter(const FT_FilterNode *filter);
+
+bool extractMembership(const FT_FilterNode *filter, AR_ExpNode **list,
+		AR_ExpNode **elem);
+
+bool isMembershipFilter(const FT_FilterNode *filter);
+
 bool extractOriginAndRadius(const FT_FilterNode *filter, SIValue *origin,
 		SIValue *radius, char **point);
 
@@ -0,0 +1,700 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "ft_to_ordered.h"
+#include "filter_tree_utils.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../datatypes/array.h"
+
+// kind of lookup a filter translates into, higher is more selective
+typedef enum {
+	LOOKUP_NONE = 0,  // filter can't be resolved by an ordered field
+	LOOKUP_RANGE,     // n.v > x
+	LOOKUP_PREFIX,    // n.v STARTS WITH x
+	LOOKUP_MEMBER,    // x IN n.v, served by the field's members index
+	LOOKUP_IN,        // n.v IN [x, y]
+	LOOKUP_EQUAL,     // n.v = x
+} _LookupKind;
+
+// bounds of a single field collected out of a number of filters
+typedef struct {
+	SIType t;          // type of bounded values, numerics share a single type
+	SIValue min;       // lower bound, null if open
+	SIValue max;       // upper bound, null if open
+	bool include_min;  // lower bound is inclusive
+	bool include_max;  // upper bound is inclusive
+	bool empty;        // bounds conflict, no value satisfies them
+} _Bounds;
+
+// lookup driving the scan, either over a single field or a composite
+typedef struct {
+	_LookupKind kind;                 // single field lookup kind
+	const char *field;                // single looked up field
+	const IndexComposite *composite;  // looked up composite, NULL if none
+	uint prefix_len;                  // composite fields bound by equality
+	bool ranged;                      // composite field after prefix is ranged
+} _Lookup;
+
+#define RANGE_ISLT(a, b) (SortKey_Compare((a)->min, (b)->min) < 0)
+
+// determine which kind of lookup 'tree' translates into
+// sets 'field' to the looked up field
+static _LookupKind _Classify
+(
+	const FT_FilterNode *tree,  // filter to classify
+	const Index *idx,           // queried index
+	char **field                // [output] looked up field
+) {
+	AR_ExpNode *list = NULL;
+	AR_ExpNode *elem = NULL;
+	if(extractMembership(tree, &list, &elem)) {
+		// x IN n.v or any(t IN n.v WHERE t = x)
+		AR_EXP_IsAttribute(list, field);
+		if(Index_GetMemberIndex(idx, *field) == NULL) return LOOKUP_NONE;
+		if(!AR_EXP_IsConstant(elem)) return LOOKUP_NONE;
+		if(!OrderedIndex_Indexable(elem->operand.constant)) return LOOKUP_NONE;
+
+		return LOOKUP_MEMBER;
+	}
+
+	if(isInFilter(tree)) {
+		// n.v IN [x, y, z]
+		AR_ExpNode *in = tree->exp.exp;
+		if(!AR_EXP_IsAttribute(in->op.children[0], field)) return LOOKUP_NONE;
+		if(Index_GetOrderedIndex(idx, *field) == NULL) return LOOKUP_NONE;
+
+		AR_ExpNode *list_exp = in->op.children[1];
+		if(!AR_EXP_IsConstant(list_exp)) return LOOKUP_NONE;
+
+		SIValue list = list_exp->operand.constant;
+		if(SI_TYPE(list) != T_ARRAY) return LOOKUP_NONE;
+
+		uint list_len = SIArray_Length(list);
+		for(uint i = 0; i < list_len; i++) {
+			SIValue v = SIArray_Get(list, i);
+			if(!OrderedIndex_Indexable(v)) return LOOKUP_NONE;
+		}
+
+		return LOOKUP_IN;
+	}
+
+	if(isStartsWithFilter(tree)) {
+		// n.v STARTS WITH 'x'
+		AR_ExpNode *exp = tree->exp.exp;
+		if(!AR_EXP_IsAttribute(exp->op.children[0], field)) return LOOKUP_NONE;
+		if(Index_GetOrderedIndex(idx, *field) == NULL) return LOOKUP_NONE;
+
+		AR_ExpNode *prefix = exp->op.children[1];
+		if(!AR_EXP_IsConstant(prefix)) return LOOKUP_NONE;
+		if(SI_TYPE(prefix->operand.constant) != T_STRING) return LOOKUP_NONE;
+
+		return LOOKUP_PREFIX;
+	}
+
+	if(tree->t != FT_N_PRED) return LOOKUP_NONE;
+
+	// n.v op x
+	if(!AR_EXP_IsAttribute(tree->pred.lhs, field)) return LOOKUP_NONE;
+	if(Index_GetOrderedIndex(idx, *field) == NULL) return LOOKUP_NONE;
+	if(!AR_EXP_IsConstant(tree->pred.rhs)) return LOOKUP_NONE;
+
+	SIValue v = tree->pred.rhs->operand.constant;
+	if(!OrderedIndex_Indexable(v)) return LOOKUP_NONE;
+
+	switch(tree->pred.op) {
+		case OP_EQUAL:
+			return LOOKUP_EQUAL;
+		case OP_LT:
+		case OP_LE:
+		case OP_GT:
+		case OP_GE:
+			return LOOKUP_RANGE;
+		default:
+			return LOOKUP_NONE;
+	}
+}
+
+// tighten bounds with 'op v'
+static void _TightenBounds
+(
+	_Bounds *b,       // bounds to tighten
+	AST_Operator op,  // bounding operator
+	SIValue v         // bounding value
+) {
+	// values of different types never compare as equal
+	SIType t = (SI_TYPE(v) & SI_NUMERIC) ? SI_NUMERIC : SI_TYPE(v);
+	if(b->t == T_NULL) {
+		b->t = t;
+	} else if(b->t != t) {
+		b->empty = true;
+		return;
+	}
+
+	if(op == OP_EQUAL || op == OP_GT || op == OP_GE) {
+		bool inclusive = (op != OP_GT);
+		int rel = SIValue_IsNull(b->min) ? 1 : SIValue_Compare(v, b->min, NULL);
+		if(rel > 0 || (rel == 0 && !inclusive)) {
+			b->min = v;
+			b->include_min = inclusive;
+		}
+	}
+
+	if(op == OP_EQUAL || op == OP_LT || op == OP_LE) {
+		bool inclusive = (op != OP_LT);
+		int rel = SIValue_IsNull(b->max) ? -1 : SIValue_Compare(v, b->max, NULL);
+		if(rel < 0 || (rel == 0 && !inclusive)) {
+			b->max = v;
+			b->include_max = inclusive;
+		}
+	}
+
+	if(!SIValue_IsNull(b->min) && !SIValue_IsNull(b->max)) {
+		int rel = SIValue_Compare(b->min, b->max, NULL);
+		if(rel > 0 || (rel == 0 && !(b->include_min && b->include_max))) {
+			b->empty = true;
+		}
+	}
+}
+
+// create a point range for each distinct value in list
+static OrderedRange *_InToRanges
+(
+	SIValue list
+) {
+	uint list_len = SIArray_Length(list);
+	OrderedRange *ranges = array_new(OrderedRange, list_len);
+
+	for(uint i = 0; i < list_len; i++) {
+		SIValue v = SIArray_Get(list, i);
+		OrderedRange range = {
+			.min = SortKey_Append(sdsempty(), v, false),
+			.max = SortKey_Append(sdsempty(), v, false),
+			.include_min = true,
+			.include_max = true
+		};
+		array_append(ranges, range);
+	}
+
+	// iterated ranges must be ascending and disjoint
+	QSORT(OrderedRange, ranges, list_len, RANGE_ISLT);
+	uint n = 0;
+	for(uint i = 0; i < list_len; i++) {
+		if(n > 0 && SortKey_Compare(ranges[n - 1].min, ranges[i].min) == 0) {
+			OrderedRange_Free(ranges + i);
+			continue;
+		}
+		ranges[n++] = ranges[i];
+	}
+	ranges = array_trimm_len(ranges, n);
+
+	return ranges;
+}
+
+// intersect all equalities and ranges over 'field'
+// intersected filters are marked as consumed
+static _Bounds _FieldBounds
+(
+	FT_FilterNode **trees,  // filters
+	uint tree_count,        // number of filters
+	const Index *idx,       // queried index
+	const char *field,      // bounded field
+	bool *consumed          // [output] consumed filters
+) {
+	_Bounds b = {
+		.t           = T_NULL,
+		.min         = SI_NullVal(),
+		.max         = SI_NullVal(),
+		.include_min = false,
+		.include_max = false,
+		.empty       = false
+	};
+
+	for(uint i = 0; i < tree_count; i++) {
+		char *f = NULL;
+		_LookupKind k = _Classify(trees[i], idx, &f);
+		if(k != LOOKUP_EQUAL && k != LOOKUP_RANGE) continue;
+		if(strcmp(f, field) != 0) continue;
+
+		FT_FilterNode *pred = trees[i];
+		_TightenBounds(&b, pred->pred.op, pred->pred.rhs->operand.constant);
+		consumed[i] = true;
+	}
+
+	return b;
+}
+
+// determine if 'field' is bound by an equality and if it is ranged
+static void _FieldPredicates
+(
+	FT_FilterNode **trees,  // filters
+	uint tree_count,        // number of filters
+	const Index *idx,       // queried index
+	const char *field,      // inspected field
+	bool *equal,            // [output] field is bound by an equality
+	bool *range             // [output] field is ranged
+) {
+	*equal = false;
+	*range = false;
+
+	for(uint i = 0; i < tree_count; i++) {
+		char *f = NULL;
+		_LookupKind k = _Classify(trees[i], idx, &f);
+		if(k == LOOKUP_NONE || strcmp(f, field) != 0) continue;
+
+		*equal |= (k == LOOKUP_EQUAL);
+		*range |= (k == LOOKUP_RANGE);
+	}
+}
+
+// returns true if entities produced by 'lookup' are ordered by 'attr'
+static bool _OrderedBy
+(
+	const _Lookup *lookup,
+	const char *attr
+) {
+	// a members index is ordered by elements rather than by lists
+	if(lookup->kind == LOOKUP_MEMBER) return false;
+	if(lookup->composite == NULL) return strcmp(lookup->field, attr) == 0;
+
+	// fields bound by equality hold a single value
+	// the field following them is scanned in order
+	const IndexComposite *composite = lookup->composite;
+	uint n = array_len(composite->fields);
+	uint last = (lookup->prefix_len < n) ? lookup->prefix_len : n - 1;
+	for(uint i = 0; i <= last; i++) {
+		if(strcmp(composite->fields[i], attr) == 0) return true;
+	}
+
+	return false;
+}
+
+// pick the lookup driving the scan
+// a composite is picked if it resolves more fields than a single field would
+// when 'order_by' is specified, lookups producing entities ordered by it
+// are preferred
+// returns false if none of the filters can be resolved by an ordered index
+static bool _PlanLookup
+(
+	FT_FilterNode **trees,  // filters
+	uint tree_count,        // number of filters
+	const Index *idx,       // queried index
+	const char *order_by,   // [optional] attribute to order entities by
+	_Lookup *lookup         // [output] picked lookup
+) {
+	_Lookup best = {
+		.kind       = LOOKUP_NONE,
+		.field      = NULL,
+		.composite  = NULL,
+		.prefix_len = 0,
+		.ranged     = false
+	};
+
+	// single field, an equality is preferred over an IN list
+	// which is preferred over a range
+	for(uint i = 0; i < tree_count; i++) {
+		char *f = NULL;
+		_LookupKind k = _Classify(trees[i], idx, &f);
+		if(k > best.kind) {
+			best.kind  = k;
+			best.field = f;
+		}
+	}
+
+	// composite fields are indexed individually as well
+	if(best.kind == LOOKUP_NONE) return false;
+
+	uint best_coverage = 1;
+	bool best_ordered  = (order_by != NULL && _OrderedBy(&best, order_by));
+
+	uint composite_count = Index_CompositeCount(idx);
+	const IndexComposite *composites = Index_GetComposites(idx);
+	for(uint i = 0; i < composite_count; i++) {
+		const IndexComposite *composite = composites + i;
+		if(composite->ordered == NULL) continue;
+
+		// count leading fields bound by equality
+		// followed by an optional ranged field
+		_Lookup l = {
+			.kind       = LOOKUP_NONE,
+			.field      = NULL,
+			.composite  = composite,
+			.prefix_len = 0,
+			.ranged     = false
+		};
+
+		uint n = array_len(composite->fields);
+		for(uint j = 0; j < n; j++) {
+			bool equal;
+			bool range;
+			_FieldPredicates(trees, tree_count, idx, composite->fields[j],
+					&equal, &range);
+			if(equal) {
+				l.prefix_len++;
+				continue;
+			}
+			l.ranged = range;
+			break;
+		}
+
+		uint coverage = l.prefix_len + l.ranged;
+		if(coverage == 0) continue;
+
+		bool ordered = (order_by != NULL && _OrderedBy(&l, order_by));
+		if(ordered > best_ordered ||
+		   (ordered == best_ordered && coverage > best_coverage)) {
+			best          = l;
+			best_ordered  = ordered;
+			best_coverage = coverage;
+		}
+	}
+
+	// fallback to a single field lookup over the order by field
+	if(order_by != NULL && !best_ordered) {
+		for(uint i = 0; i < tree_count; i++) {
+			char *f = NULL;
+			_LookupKind k = _Classify(trees[i], idx, &f);
+			if(k == LOOKUP_NONE || k == LOOKUP_MEMBER) continue;
+			if(strcmp(f, order_by) != 0) continue;
+
+			if(best.composite != NULL || !_OrderedBy(&best, order_by) ||
+			   k > best.kind) {
+				best.kind      = k;
+				best.field     = f;
+				best.composite = NULL;
+			}
+		}
+	}
+
+	*lookup = best;
+	return true;
+}
+
+// create the range scanned by a composite lookup
+static OrderedRange *_CompositeRanges
+(
+	FT_FilterNode **trees,   // filters
+	uint tree_count,         // number of filters
+	const Index *idx,        // queried index
+	const _Lookup *lookup,   // composite lookup
+	bool *consumed           // [output] consumed filters
+) {
+	const IndexComposite *composite = lookup->composite;
+	uint prefix_len = lookup->prefix_len;
+	bool empty      = false;
+
+	SIValue prefix[prefix_len + 1];
+	for(uint i = 0; i < prefix_len; i++) {
+		_Bounds b = _FieldBounds(trees, tree_count, idx, composite->fields[i],
+				consumed);
+		empty |= b.empty;
+		prefix[i] = b.min;
+	}
+
+	_Bounds b = {
+		.t           = T_NULL,
+		.min         = SI_NullVal(),
+		.max         = SI_NullVal(),
+		.include_min = false,
+		.include_max = false,
+		.empty       = false
+	};
+
+	if(lookup->ranged) {
+		b = _FieldBounds(trees, tree_count, idx, composite->fields[prefix_len],
+				consumed);
+		empty |= b.empty;
+	}
+
+	OrderedRange *ranges = array_new(OrderedRange, 1);
+	if(!empty) {
+		OrderedRange range = OrderedRange_NewPrefix(prefix, prefix_len, b.t,
+				b.min, b.include_min, b.max, b.include_max);
+		array_append(ranges, range);
+	}
+
+	return ranges;
+}
+
+// create the ranges scanned by a single field lookup
+static OrderedRange *_FieldRanges
+(
+	FT_FilterNode **trees,   // filters
+	uint tree_count,         // number of filters
+	const Index *idx,        // queried index
+	const _Lookup *lookup,   // single field lookup
+	bool *consumed           // [output] consumed filters
+) {
+	OrderedRange *ranges = NULL;
+
+	if(lookup->kind == LOOKUP_MEMBER) {
+		// scan the lists holding a single element
+		for(uint i = 0; i < tree_count; i++) {
+			char *f = NULL;
+			if(_Classify(trees[i], idx, &f) != LOOKUP_MEMBER) continue;
+			if(strcmp(f, lookup->field) != 0) continue;
+
+			AR_ExpNode *elem = NULL;
+			extractMembership(trees[i], NULL, &elem);
+			SIValue v = elem->operand.constant;
+
+			OrderedRange range = {
+				.min = SortKey_Append(sdsempty(), v, false),
+				.max = SortKey_Append(sdsempty(), v, false),
+				.include_min = true,
+				.include_max = true
+			};
+			ranges = array_new(OrderedRange, 1);
+			array_append(ranges, range);
+			consumed[i] = true;
+			break;
+		}
+		return ranges;
+	}
+
+	if(lookup->kind == LOOKUP_IN || lookup->kind == LOOKUP_PREFIX) {
+		// scan a single IN list or prefix
+		// remaining filters are applied on results
+		for(uint i = 0; i < tree_count; i++) {
+			char *f = NULL;
+			if(_Classify(trees[i], idx, &f) != lookup->kind) continue;
+			if(strcmp(f, lookup->field) != 0) continue;
+
+			SIValue v = trees[i]->exp.exp->op.children[1]->operand.constant;
+			if(lookup->kind == LOOKUP_IN) {
+				ranges = _InToRanges(v);
+			} else {
+				ranges = array_new(OrderedRange, 1);
+				array_append(ranges, OrderedRange_NewStringPrefix(v.stringval));
+			}
+			consumed[i] = true;
+			break;
+		}
+		return ranges;
+	}
+
+	// intersect all equalities and ranges over field
+	_Bounds b = _FieldBounds(trees, tree_count, idx, lookup->field,
+			consumed);
+
+	ranges = array_new(OrderedRange, 1);
+	if(!b.empty) {
+		OrderedRange range = OrderedRange_New(b.t, b.min, b.include_min,
+				b.max, b.include_max);
+		array_append(ranges, range);
+	}
+
+	return ranges;
+}
+
+OrderedIndexIterator *FilterTreeToOrderedIterator
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	const Index *idx,
+	const char *order_by
+) {
+	ASSERT(idx                    != NULL);
+	ASSERT(tree                   != NULL);
+	ASSERT(none_converted_filters != NULL);
+
+	*none_converted_filters = NULL;
+
+	// clone filter tree, as it is about to be modified
+	FT_FilterNode  *t           =  FilterTree_Clone(tree);
+	FT_FilterNode  **trees      =  FilterTree_SubTrees(t);
+	uint           tree_count   =  array_len(trees);
+	bool           consumed[tree_count];
+	_Lookup        lookup;
+
+	for(uint i = 0; i < tree_count; i++) consumed[i] = false;
+
+	//--------------------------------------------------------------------------
+	// pick the lookup driving the scan
+	//--------------------------------------------------------------------------
+
+	if(!_PlanLookup(trees, tree_count, idx, order_by, &lookup)) {
+		for(uint i = 0; i < tree_count; i++) FilterTree_Free(trees[i]);
+		array_free(trees);
+		return NULL;
+	}
+
+	//--------------------------------------------------------------------------
+	// compose ranges
+	//--------------------------------------------------------------------------
+
+	OrderedIndex *ordered = NULL;
+	OrderedRange *ranges  = NULL;
+
+	if(lookup.composite != NULL) {
+		ordered = lookup.composite->ordered;
+		ranges  = _CompositeRanges(trees, tree_count, idx, &lookup, consumed);
+	} else {
+		ordered = (lookup.kind == LOOKUP_MEMBER) ?
+			Index_GetMemberIndex(idx, lookup.field) :
+			Index_GetOrderedIndex(idx, lookup.field);
+		ranges  = _FieldRanges(trees, tree_count, idx, &lookup, consumed);
+	}
+
+	//--------------------------------------------------------------------------
+	// combine remaining filters
+	//--------------------------------------------------------------------------
+
+	uint remaining = 0;
+	for(uint i = 0; i < tree_count; i++) {
+		if(consumed[i]) FilterTree_Free(trees[i]);
+		else trees[remaining++] = trees[i];
+	}
+	*none_converted_filters = FilterTree_Combine(trees, remaining);
+	array_free(trees);
+
+	return OrderedIndexIterator_New(ordered, ranges);
+}
+
+OrderedIndexIterator *FilterTreeToAdjacentIterator
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	const Index *idx,
+	EntityID src_id
+) {
+	ASSERT(idx                    != NULL);
+	ASSERT(tree                   != NULL);
+	ASSERT(none_converted_filters != NULL);
+
+	*none_converted_filters = NULL;
+
+	// clone filter tree, as it is about to be modified
+	FT_FilterNode  *t           =  FilterTree_Clone(tree);
+	FT_FilterNode  **trees      =  FilterTree_SubTrees(t);
+	uint           tree_count   =  array_len(trees);
+	bool           consumed[tree_count];
+	_Lookup        lookup      =  {0};
+
+	for(uint i = 0; i < tree_count; i++) consumed[i] = false;
+
+	// single field, an equality is preferred over an IN list
+	// which is preferred over a range
+	for(uint i = 0; i < tree_count; i++) {
+		char *f = NULL;
+		_LookupKind k = _Classify(trees[i], idx, &f);
+		if(k == LOOKUP_MEMBER) continue;
+		if(k > lookup.kind && Index_GetAdjacentIndex(idx, f) != NULL) {
+			lookup.kind  = k;
+			lookup.field = f;
+		}
+	}
+
+	if(lookup.kind == LOOKUP_NONE) {
+		for(uint i = 0; i < tree_count; i++) FilterTree_Free(trees[i]);
+		array_free(trees);
+		return NULL;
+	}
+
+	// entries are keyed by the source node followed by the indexed value
+	// restrict each range to the edges of 'src_id'
+	OrderedIndex *adjacent = Index_GetAdjacentIndex(idx, lookup.field);
+	OrderedRange *ranges   = _FieldRanges(trees, tree_count, idx, &lookup,
+			consumed);
+
+	sds src = SortKey_Append(sdsempty(), SI_LongVal(src_id), false);
+	uint range_count = array_len(ranges);
+	for(uint i = 0; i < range_count; i++) {
+		OrderedRange r = ranges[i];
+		ranges[i].min = sdscatsds(sdsdup(src), r.min);
+		ranges[i].max = sdscatsds(sdsdup(src), r.max);
+		OrderedRange_Free(&r);
+	}
+	sdsfree(src);
+
+	// combine remaining filters
+	uint remaining = 0;
+	for(uint i = 0; i < tree_count; i++) {
+		if(consumed[i]) FilterTree_Free(trees[i]);
+		else trees[remaining++] = trees[i];
+	}
+	*none_converted_filters = FilterTree_Combine(trees, remaining);
+	array_free(trees);
+
+	return OrderedIndexIterator_New(adjacent, ranges);
+}
+
+bool FilterTreeOrderedBy
+(
+	const FT_FilterNode *tree,
+	const Index *idx,
+	const char *attr
+) {
+	ASSERT(idx  != NULL);
+	ASSERT(tree != NULL);
+	ASSERT(attr != NULL);
+
+	FT_FilterNode  *t          =  FilterTree_Clone(tree);
+	FT_FilterNode  **trees     =  FilterTree_SubTrees(t);
+	uint           tree_count  =  array_len(trees);
+	bool           ordered     =  false;
+	bool           equal;
+	bool           range;
+	_Lookup        lookup;
+
+	// an attribute bound by an equality holds a single value
+	_FieldPredicates(trees, tree_count, idx, attr, &equal, &range);
+	if(equal) {
+		ordered = true;
+	} else if(_PlanLookup(trees, tree_count, idx, attr, &lookup)) {
+		ordered = _OrderedBy(&lookup, attr);
+	}
+
+	for(uint i = 0; i < tree_count; i++) FilterTree_Free(trees[i]);
+	array_free(trees);
+
+	return ordered;
+}
+
+const char **FilterTreeCoveredAttributes
+(
+	const FT_FilterNode *tree,
+	const Index *idx,
+	const char *order_by
+) {
+	ASSERT(idx  != NULL);
+	ASSERT(tree != NULL);
+
+	FT_FilterNode  *t          =  FilterTree_Clone(tree);
+	FT_FilterNode  **trees     =  FilterTree_SubTrees(t);
+	uint           tree_count  =  array_len(trees);
+	const char     **attrs     =  NULL;
+	_Lookup        lookup;
+
+	// a members index stores elements rather than lists
+	if(_PlanLookup(trees, tree_count, idx, order_by, &lookup) &&
+	   lookup.kind != LOOKUP_MEMBER) {
+		if(lookup.composite != NULL) {
+			uint n = array_len(lookup.composite->fields);
+			attrs = array_new(const char *, n);
+			for(uint i = 0; i < n; i++) {
+				array_append(attrs, lookup.composite->fields[i]);
+			}
+		} else {
+			// the field as named by the index, outliving the filter tree
+			uint field_count = Index_FieldsCount(idx);
+			const IndexField *fields = Index_GetFields(idx);
+			attrs = array_new(const char *, 1);
+			for(uint i = 0; i < field_count; i++) {
+				if(strcmp(fields[i].name, lookup.field) == 0) {
+					array_append(attrs, fields[i].name);
+					break;
+				}
+			}
+		}
+	}
+
+	for(uint i = 0; i < tree_count; i++) FilterTree_Free(trees[i]);
+	array_free(trees);
+
+	return attrs;
+}
@@ -0,0 +1,56 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/index.h"
+
+// construct an ordered index iterator from filter tree
+// the scan is driven by a single ordered field, an equality is preferred
+// over an IN list which is preferred over a prefix or a range, or by a composite
+// resolving equalities on a prefix of its fields and a range on the next one
+// filters which aren't resolved by the scan are returned to the caller
+// returns NULL if none of the filters can be resolved by an ordered field
+OrderedIndexIterator *FilterTreeToOrderedIterator
+(
+	FT_FilterNode **none_converted_filters,  // [output] none converted filters
+	const FT_FilterNode *tree,               // filter tree to convert
+	const Index *idx,                        // index to query
+	const char *order_by                     // [optional] preferred order
+);
+
+// construct an iterator over the edges of source node 'src_id'
+// out of the adjacent index of the best single field lookup
+// filters which aren't resolved by the scan are returned to the caller
+// returns NULL if none of the filters can be resolved by an adjacent index
+OrderedIndexIterator *FilterTreeToAdjacentIterator
+(
+	FT_FilterNode **none_converted_filters,  // [output] none converted filters
+	const FT_FilterNode *tree,               // filter tree to convert
+	const Index *idx,                        // edge index to query
+	EntityID src_id                          // source node
+);
+
+// returns true if the iterator constructed from filter tree
+// with 'attr' as its preferred order, produces entities ordered by 'attr'
+bool FilterTreeOrderedBy
+(
+	const FT_FilterNode *tree,  // filter tree to convert
+	const Index *idx,           // index to query
+	const char *attr            // attribute to order by
+);
+
+// returns the attributes whose values are stored by the ordered index
+// scanned by the iterator constructed from filter tree, in stored order
+// returns NULL if filter tree can't be resolved by an ordered index
+// caller is responsible for freeing the returned array
+const char **FilterTreeCoveredAttributes
+(
+	const FT_FilterNode *tree,  // filter tree to convert
+	const Index *idx,           // index to query
+	const char *order_by        // [optional] preferred order
+);
@@ -532,6 +532,9 @@ static bool _FilterTreeToQueryNode
 		return _FilterTreeConditionToQueryNode(root, tree, idx);
 	} else if(t == FT_N_PRED) {
 		return _FilterTreePredicateToQueryNode(root, tree, idx);
+	} else if(isStartsWithFilter(tree)) {
+		// resolved by the ordered index, applied on results otherwise
+		return false;
 	} else {
 		ASSERT("unknown filter tree node type");
 		return false;
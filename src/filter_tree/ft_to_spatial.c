@@ -0,0 +1,59 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "ft_to_spatial.h"
+#include "filter_tree_utils.h"
+#include "../util/arr.h"
+
+SpatialIndexIterator *FilterTreeToSpatialIterator
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	const Index *idx
+) {
+	ASSERT(idx                    != NULL);
+	ASSERT(tree                   != NULL);
+	ASSERT(none_converted_filters != NULL);
+
+	*none_converted_filters = NULL;
+
+	FT_FilterNode         *t           =  FilterTree_Clone(tree);
+	FT_FilterNode         **trees      =  FilterTree_SubTrees(t);
+	uint                  tree_count   =  array_len(trees);
+	SpatialIndexIterator  *it          =  NULL;
+
+	// pick the first distance filter over a spatially indexed field
+	for(uint i = 0; i < tree_count && it == NULL; i++) {
+		if(!isDistanceFilter(trees[i])) continue;
+
+		char *field = NULL;
+		SIValue origin;
+		SIValue radius;
+		extractOriginAndRadius(trees[i], &origin, &radius, &field);
+
+		SpatialIndex *spatial = Index_GetSpatialIndex(idx, field);
+		if(spatial != NULL && SI_TYPE(origin) == T_POINT) {
+			it = SpatialIndexIterator_NewRadius(spatial, origin,
+					SI_GET_NUMERIC(radius));
+		}
+
+		SIValue_Free(origin);
+		SIValue_Free(radius);
+	}
+
+	if(it == NULL) {
+		for(uint i = 0; i < tree_count; i++) FilterTree_Free(trees[i]);
+		array_free(trees);
+		return NULL;
+	}
+
+	// distance is verified against the filter itself
+	*none_converted_filters = FilterTree_Combine(trees, tree_count);
+	array_free(trees);
+
+	return it;
+}
@@ -0,0 +1,23 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/index.h"
+
+// construct a spatial index iterator from filter tree
+// the scan is driven by a distance filter over a point field
+// distance(n.location, point({latitude: 1.1, longitude: 2.2})) < 1000
+// iterated entities are a superset of the entities passing the distance
+// filter, as such all filters are returned to the caller
+// returns NULL if none of the filters can be resolved by a spatial index
+SpatialIndexIterator *FilterTreeToSpatialIterator
+(
+	FT_FilterNode **none_converted_filters,  // [output] none converted filters
+	const FT_FilterNode *tree,               // filter tree to convert
+	const Index *idx                         // index to query
+);
@@ -5,6 +5,7 @@
 */
 
 #include <limits.h>
+#include <string.h>
 
 #include "RG.h"
 #include "attribute_set.h"
@@ -16,11 +17,37 @@
 // determine if set is empty
 #define ATTRIBUTESET_EMPTY(set) (set) == NULL
 
+// packed sets and strings are kept word aligned
+#define PACKED_ALIGN(n) (((n) + 7) & ~((size_t)7))
+
 // returned value for a missing attribute
 SIValue *ATTRIBUTE_NOTFOUND = &(SIValue) {
 	.longval = 0, .type = T_NULL
 };
 
+// moves a packed set back to the heap, prior to resizing it
+// the region holding the packed set is left untouched
+static void _AttributeSet_Unpack
+(
+	AttributeSet *set
+) {
+	AttributeSet _set = *set;
+	if(_set == NULL || !_set->packed) return;
+
+	size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+	AttributeSet heap = rm_malloc(n);
+	memcpy(heap, _set, n);
+	heap->packed = false;
+
+	// strings residing within the region are duplicated
+	for(int i = 0; i < heap->attr_count; i++) {
+		SIValue *v = &heap->attributes[i].value;
+		if(v->allocation == M_CONST) *v = SI_CloneValue(*v);
+	}
+
+	*set = heap;
+}
+
 // removes an attribute from set
 static bool _AttributeSet_Remove
 (
@@ -42,6 +69,10 @@ static bool _AttributeSet_Remove
 			return true;
 		}
 
+		// shrinking a packed set requires a heap allocation
+		_AttributeSet_Unpack(set);
+		_set = *set;
+
 		// attribute located
 		// free attribute value
 		SIValue_Free(_set->attributes[i].value);
@@ -70,6 +101,7 @@ AttributeSet AttributeSet_New(void) {
 	AttributeSet set = rm_malloc(sizeof(_AttributeSet));
 
 	set->attr_count = 0;
+	set->packed     = false;
 
 	return set;
 }
@@ -144,7 +176,10 @@ void AttributeSet_Add
 	if(_set == NULL) {
 		_set = rm_malloc(sizeof(_AttributeSet) + sizeof(Attribute));
 		_set->attr_count = 1;
+		_set->packed     = false;
 	} else {
+		_AttributeSet_Unpack(set);
+		_set = *set;
 		_set->attr_count++;
 		size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
 		_set = rm_realloc(_set, n);
@@ -184,6 +219,8 @@ void AttributeSet_Set_Allow_Null
 	}
 
 	// allocate room for new attribute
+	_AttributeSet_Unpack(set);
+	_set = *set;
 	_set->attr_count++;
 	size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
 	_set = rm_realloc(_set, n);
@@ -227,6 +264,63 @@ bool AttributeSet_Update
 	return true;
 }
 
+// returns number of bytes required to pack set and its string values
+size_t AttributeSet_PackedSize
+(
+	const AttributeSet *set  // set to pack
+) {
+	ASSERT(set != NULL);
+
+	const AttributeSet _set = *set;
+	if(ATTRIBUTESET_EMPTY(_set) || _set->packed) return 0;
+
+	size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+	for(int i = 0; i < _set->attr_count; i++) {
+		SIValue v = _set->attributes[i].value;
+		if(SI_TYPE(v) == T_STRING && v.allocation == M_SELF) {
+			n += PACKED_ALIGN(strlen(v.stringval) + 1);
+		}
+	}
+
+	return n;
+}
+
+// moves set and its string values into 'buf'
+void *AttributeSet_Pack
+(
+	AttributeSet *set,  // set to pack
+	void *buf           // destination
+) {
+	ASSERT(set != NULL);
+	ASSERT(buf != NULL);
+
+	AttributeSet _set = *set;
+	if(ATTRIBUTESET_EMPTY(_set) || _set->packed) return buf;
+
+	size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+	AttributeSet packed = buf;
+	memcpy(packed, _set, n);
+	packed->packed = true;
+
+	// strings follow the set, ownership of any other value is transferred
+	char *pos = (char *)buf + n;
+	for(int i = 0; i < packed->attr_count; i++) {
+		SIValue *v = &packed->attributes[i].value;
+		if(SI_TYPE(*v) != T_STRING || v->allocation != M_SELF) continue;
+
+		size_t len = strlen(v->stringval) + 1;
+		memcpy(pos, v->stringval, len);
+		rm_free(v->stringval);
+		*v = SI_ConstStringVal(pos);
+		pos += PACKED_ALIGN(len);
+	}
+
+	rm_free(_set);
+	*set = packed;
+
+	return pos;
+}
+
 // clones attribute set
 AttributeSet AttributeSet_Clone
 (
@@ -237,7 +331,8 @@ AttributeSet AttributeSet_Clone
 	size_t n = ATTRIBUTESET_BYTE_SIZE(set);
 	AttributeSet clone  = rm_malloc(n);
 	clone->attr_count   = set->attr_count;
-	
+	clone->packed       = false;
+
 	for (uint i = 0; i < set->attr_count; i++) {
 		Attribute *attr        = set->attributes   + i;
 		Attribute *clone_attr  = clone->attributes + i;
@@ -261,10 +356,11 @@ void AttributeSet_Free
 	if(_set == NULL) return;
 
 	// free all allocated properties
+	// strings of a packed set are owned by its region
 	for(int i = 0; i < _set->attr_count; i++) {
 		SIValue_Free(_set->attributes[i].value);
 	}
 
-	rm_free(_set);
+	if(!_set->packed) rm_free(_set);
 	*set = NULL;
 }
@@ -26,6 +26,7 @@ typedef struct {
 
 typedef struct {
 	ushort attr_count;       // number of attributes
+	bool packed;             // set resides within a storage tier region
 	Attribute attributes[];  // key value pair of attributes
 } _AttributeSet;
 
@@ -76,6 +77,23 @@ bool AttributeSet_Update
 	SIValue value          // new value
 );
 
+// returns number of bytes required to pack set and its string values
+// 0 if set is empty or already packed
+size_t AttributeSet_PackedSize
+(
+	const AttributeSet *set  // set to pack
+);
+
+// moves set and its string values into 'buf'
+// 'buf' must hold at least AttributeSet_PackedSize bytes and outlive the set
+// a packed set is moved back to the heap once it grows or shrinks
+// returns the position within 'buf' following the packed set
+void *AttributeSet_Pack
+(
+	AttributeSet *set,  // set to pack
+	void *buf           // destination
+);
+
 // clones attribute set
 AttributeSet AttributeSet_Clone
 (
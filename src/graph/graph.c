@@ -318,6 +318,16 @@ void Graph_ApplyAllPending
 	}
 }
 
+void Graph_SealStorage
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	DataBlock_Seal(g->nodes);
+	DataBlock_Seal(g->edges);
+}
+
 bool Graph_Pending
 (
 	const Graph *g
@@ -382,6 +392,14 @@ Graph *Graph_New
 
 	g->nodes      =  DataBlock_New(node_cap, node_cap, sizeof(AttributeSet), cb);
 	g->edges      =  DataBlock_New(edge_cap, edge_cap, sizeof(AttributeSet), cb);
+
+	// no-op unless the storage tier is enabled
+	// attribute sets are packed into their entity block once it is sealed
+	fpPackedSize packedSize = (fpPackedSize)AttributeSet_PackedSize;
+	fpPack pack = (fpPack)AttributeSet_Pack;
+	DataBlock_UseStorageTier(g->nodes, packedSize, pack);
+	DataBlock_UseStorageTier(g->edges, packedSize, pack);
+
 	g->labels     =  array_new(RG_Matrix, GRAPH_DEFAULT_LABEL_CAP);
 	g->relations  =  array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 
@@ -407,6 +425,45 @@ Graph *Graph_New
 	return g;
 }
 
+void Graph_TrackChanges
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	DataBlock_TrackChanges(g->nodes);
+	if(g->edge_changes == NULL) g->edge_changes = array_new(Edge, 0);
+}
+
+inline const Edge *Graph_EdgeChanges
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+	return g->edge_changes;
+}
+
+void Graph_ClearChanges
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	DataBlock_ClearDirty(g->nodes);
+	if(g->edge_changes != NULL) array_clear(g->edge_changes);
+}
+
+// record edge modification, edge connection isn't stored in the edges
+// datablock, as such it is captured at the time of modification
+static inline void _Graph_TrackEdge
+(
+	Graph *g,
+	const Edge *e
+) {
+	if(g->edge_changes == NULL) return;
+	array_append(g->edge_changes, *e);
+}
+
 // All graph matrices are required to be squared NXN
 // where N = Graph_RequiredMatrixDim.
 inline size_t Graph_RequiredMatrixDim(const Graph *g) {
@@ -482,6 +539,21 @@ int Graph_GetNode
 	return (n->attributes != NULL);
 }
 
+bool Graph_GetNodeIncludingDeleted
+(
+	const Graph *g,
+	NodeID id,
+	Node *n
+) {
+	ASSERT(g != NULL);
+	ASSERT(n != NULL);
+
+	n->id         = id;
+	n->attributes = DataBlock_GetItemIncludingDeleted(g->nodes, id);
+
+	return (n->attributes != NULL);
+}
+
 int Graph_GetEdge
 (
 	const Graph *g,
@@ -637,6 +709,40 @@ void Graph_CreateNode
 	if(label_count > 0) _Graph_LabelNode(g, n->id, labels, label_count);
 }
 
+void Graph_LabelNodes
+(
+	Graph *g,
+	int l,
+	const NodeID *ids,
+	uint64_t n
+) {
+	ASSERT(g   != NULL);
+	ASSERT(ids != NULL);
+
+	if(n == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	// label column of the node-label matrix
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * n);
+	for(uint64_t i = 0; i < n; i++) J[i] = l;
+
+	// set label matrix at positions [id, id]
+	RG_Matrix m = Graph_GetLabelMatrix(g, l);
+	info = RG_Matrix_setElements_BOOL(m, ids, ids, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	// map this label in each node's set of labels
+	RG_Matrix nl = Graph_GetNodeLabelMatrix(g);
+	info = RG_Matrix_setElements_BOOL(nl, ids, J, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	GraphStatistics_IncNodeCount(&g->stats, l, n);
+
+	rm_free(J);
+}
+
 void Graph_FormConnection
 (
 	Graph *g,
@@ -693,6 +799,71 @@ void Graph_CreateEdge
 
 
 	Graph_FormConnection(g, src, dest, id, r);
+	_Graph_TrackEdge(g, e);
+}
+
+void Graph_CreateEdges
+(
+	Graph *g,
+	int r,
+	Edge **edges
+) {
+	ASSERT(g != NULL);
+	ASSERT(edges != NULL);
+	ASSERT(r < Graph_RelationTypeCount(g));
+
+	GrB_Info info;
+	UNUSED(info);
+
+	uint edge_count = array_len(edges);
+	if(edge_count == 0) return;
+
+	RG_Matrix  M    =  Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix  adj  =  Graph_GetAdjacencyMatrix(g, false);
+
+	GrB_Index  *I   =  rm_malloc(sizeof(GrB_Index) * edge_count);
+	GrB_Index  *J   =  rm_malloc(sizeof(GrB_Index) * edge_count);
+	uint64_t   *X   =  rm_malloc(sizeof(uint64_t)  * edge_count);
+
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges[i];
+
+#ifdef RG_DEBUG
+		// make sure both src and destination nodes exists
+		Node node = GE_NEW_NODE();
+		ASSERT(Graph_GetNode(g, e->srcNodeID, &node) == 1);
+		ASSERT(Graph_GetNode(g, e->destNodeID, &node) == 1);
+#endif
+
+		EdgeID id;
+		AttributeSet *set = DataBlock_AllocateItem(g->edges, &id);
+		*set = NULL;
+
+		e->id          =  id;
+		e->attributes  =  set;
+		e->relationID  =  r;
+
+		// rows represent source nodes, columns represent destination nodes
+		I[i] = e->srcNodeID;
+		J[i] = e->destNodeID;
+		X[i] = id;
+
+		_Graph_TrackEdge(g, e);
+	}
+
+	// connect all edges at once
+	info = RG_Matrix_setElements_BOOL(adj, I, J, edge_count);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_setElements_UINT64(M, I, J, X, edge_count);
+	ASSERT(info == GrB_SUCCESS);
+
+	// edges of type r have just been created, update statistics
+	GraphStatistics_IncEdgeCount(&g->stats, r, edge_count);
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
 }
 
 // retrieves all either incoming or outgoing edges
@@ -896,7 +1067,8 @@ int Graph_DeleteEdge
 
 	// free and remove edges from datablock.
 	DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
-	
+	_Graph_TrackEdge(g, e);
+
 	return 1;
 }
 
@@ -918,15 +1090,23 @@ static void _Graph_FreeRelationMatrices
 // update entity's attribute with given value
 int Graph_UpdateEntity
 (
+	Graph *g,                    // graph containing the entity
 	GraphEntity *ge,             // entity yo update
 	Attribute_ID attr_id,        // attribute to update
 	SIValue value,               // value to be set
 	GraphEntityType entity_type  // type of the entity node/edge
 ) {
+	ASSERT(g  != NULL);
 	ASSERT(ge != NULL);
 
 	int res = 0;
 
+	if(entity_type == GETYPE_NODE) {
+		DataBlock_MarkDirty(g->nodes, ENTITY_GET_ID(ge));
+	} else {
+		_Graph_TrackEdge(g, (Edge *)ge);
+	}
+
 	// handle the case in which we are deleting all attributes
 	if(attr_id == ATTRIBUTE_ID_ALL) {
 		return GraphEntity_ClearAttributes(ge);
@@ -1130,6 +1310,7 @@ static void _Graph_Free
 	// free blocks
 	DataBlock_Free(g->nodes);
 	DataBlock_Free(g->edges);
+	if(g->edge_changes) array_free(g->edge_changes);
 
 	int res;
 	UNUSED(res);
@@ -55,6 +55,7 @@ struct Graph {
 	bool _writelocked;                  // true if the read-write lock was acquired by a writer
 	SyncMatrixFunc SynchronizeMatrix;   // function pointer to matrix synchronization routine
 	GraphStatistics stats;              // graph related statistics
+	Edge *edge_changes;                 // edges modified since last flush, NULL if changes aren't tracked
 };
 
 // graph synchronization functions
@@ -111,6 +112,15 @@ bool Graph_Pending
 	const Graph *g
 );
 
+// back fully populated entity blocks and their attribute sets
+// by the storage tier, no-op unless the storage tier is enabled
+// attribute string values are moved, the caller must hold the write lock
+// and make sure no records referencing entity attributes are alive
+void Graph_SealStorage
+(
+	Graph *g
+);
+
 // create a new graph
 Graph *Graph_New
 (
@@ -118,6 +128,27 @@ Graph *Graph_New
 	size_t edge_cap     // Allocation size for edge datablocks.
 );
 
+// start tracking modified nodes and edges
+// nodes are tracked by DataBlock ranges, edges by their connection
+// used by incremental persistence, see serializers/changelog
+void Graph_TrackChanges
+(
+	Graph *g
+);
+
+// returns edges created, updated or deleted since the last call to
+// Graph_ClearChanges, the same edge may appear multiple times
+const Edge *Graph_EdgeChanges
+(
+	const Graph *g
+);
+
+// forget tracked changes
+void Graph_ClearChanges
+(
+	Graph *g
+);
+
 // creates a new label matrix, returns id given to label
 int Graph_AddLabel
 (
@@ -133,6 +164,15 @@ void Graph_LabelNode
 	uint label_count
 );
 
+// associate a batch of nodes with a single label
+void Graph_LabelNodes
+(
+	Graph *g,             // graph to update
+	int l,                // label
+	const NodeID *ids,    // nodes to label
+	uint64_t n            // number of nodes
+);
+
 // creates a new relation matrix, returns id given to relation
 int Graph_AddRelationType
 (
@@ -174,6 +214,15 @@ void Graph_CreateEdge
 	Edge *e
 );
 
+// connects a batch of edges of the same relationship type
+// each edge is expected to have its source and destination node IDs set
+void Graph_CreateEdges
+(
+	Graph *g,           // graph on which to operate
+	int r,              // edges type
+	Edge **edges        // array_t of edges to create
+);
+
 // removes node and all of its connections within the graph
 void Graph_DeleteNode
 (
@@ -191,6 +240,7 @@ int Graph_DeleteEdge
 // update entity attribute with new value
 int Graph_UpdateEntity
 (
+	Graph *g,                    // graph containing the entity
 	GraphEntity *ge,             // entity yo update
 	Attribute_ID attr_id,        // attribute to update
 	SIValue value,               // value to be set
@@ -298,6 +348,16 @@ int Graph_GetNode
 	Node *n
 );
 
+// retrieves node with given id from graph, even if it was deleted
+// a deleted node holds no attributes, see Graph_EntityIsDeleted
+// returns false if node id is out of bounds
+bool Graph_GetNodeIncludingDeleted
+(
+	const Graph *g,
+	NodeID id,
+	Node *n
+);
+
 // retrieves edge with given id from graph,
 // returns NULL if edge wasn't found
 int Graph_GetEdge
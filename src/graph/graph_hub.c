@@ -6,6 +6,7 @@
 
 #include "graph_hub.h"
 #include "../query_ctx.h"
+#include "../errors.h"
 #include "../undo_log/undo_log.h"
 
 // delete all references to a node from any relevant index
@@ -59,40 +60,106 @@ static void _DeleteEdgeFromIndices
 	if(idx) Index_RemoveEdge(idx, e);
 }
 
-// add node to any relevant index
-static void _AddNodeToIndices
+// make sure node holds no value held by another node
+// under any of the unique constraints of its labels
+// sets the query error and returns false on violation
+static bool _UniqueConstraintsHold
 (
 	GraphContext *gc,
-	Node *n
+	Node *n,
+	const LabelID *labels,
+	uint label_count
 ) {
-	ASSERT(n  != NULL);
-	ASSERT(gc != NULL);
+	EntityID node_id = ENTITY_GET_ID(n);
 
-	Schema    *s       =  NULL;
-	Graph     *g       =  gc->g;
-	EntityID  node_id  =  ENTITY_GET_ID(n);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
 
-	// retrieve node labels
-	uint label_count;
-	NODE_GET_LABELS(g, n, label_count);
+		Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+		if(idx == NULL || Index_UniqueCount(idx) == 0) continue;
 
+		const char *field = Index_UniqueViolation(idx, (GraphEntity *)n,
+				&node_id);
+		if(field != NULL) {
+			ErrorCtx_SetError("Unique constraint violation on :%s(%s)",
+					Schema_GetName(s), field);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// returns true if any of the node's labels is indexed
+static bool _NodeIndexed
+(
+	GraphContext *gc,
+	const LabelID *labels,
+	uint label_count
+) {
 	for(uint i = 0; i < label_count; i++) {
-		int label_id = labels[i];
-		s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
 		ASSERT(s != NULL);
-		Schema_AddNodeToIndices(s, n);
+		if(Schema_HasIndices(s)) return true;
 	}
+
+	return false;
 }
 
-// add edge to any relevant index
-static void _AddEdgeToIndices(GraphContext *gc, Edge *e) {
-	Schema  *s  =  NULL;
-	Graph   *g  =  gc->g;
+// returns true if any of the schema's indices covers the attribute
+static bool _SchemaIndexesAttribute
+(
+	const Schema *s,
+	Attribute_ID attr_id
+) {
+	Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+	if(idx != NULL && (attr_id == ATTRIBUTE_ID_ALL ||
+	   Index_ContainsAttribute(idx, attr_id))) {
+		return true;
+	}
 
-	int relation_id = EDGE_GET_RELATION_ID(e, g);
+	idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
+	return (idx != NULL && (attr_id == ATTRIBUTE_ID_ALL ||
+			Index_ContainsAttribute(idx, attr_id)));
+}
 
-	s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
-	Schema_AddEdgeToIndices(s, e);
+// returns true if setting entity's attribute to 'v' changes any of
+// the entity's index entries, either the attribute is indexed and its value
+// differs from the current one or all attributes are cleared
+static bool _IndexInvalidated
+(
+	GraphContext *gc,
+	GraphEntity *ge,
+	Attribute_ID attr_id,
+	SIValue v,
+	GraphEntityType entity_type
+) {
+	bool indexed = false;
+
+	if(entity_type == GETYPE_NODE) {
+		uint label_count;
+		NODE_GET_LABELS(gc->g, (Node *)ge, label_count);
+		for(uint i = 0; i < label_count && !indexed; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+			ASSERT(s != NULL);
+			indexed = _SchemaIndexesAttribute(s, attr_id);
+		}
+	} else {
+		int relation_id = EDGE_GET_RELATION_ID((Edge *)ge, gc->g);
+		Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+		ASSERT(s != NULL);
+		indexed = _SchemaIndexesAttribute(s, attr_id);
+	}
+
+	if(!indexed) return false;
+	if(attr_id == ATTRIBUTE_ID_ALL) return true;
+
+	// skip updates setting an attribute to its current value
+	SIValue *orig = GraphEntity_GetProperty(ge, attr_id);
+	if(orig == ATTRIBUTE_NOTFOUND) return !SIValue_IsNull(v);
+	return (SI_TYPE(*orig) != SI_TYPE(v) ||
+			SIValue_Compare(*orig, v, NULL) != 0);
 }
 
 // add properties to the GraphEntity
@@ -126,17 +193,15 @@ uint CreateNode
 	Graph_CreateNode(gc->g, n, labels, label_count);
 	uint properties_set = _AddProperties((GraphEntity *)n, props);
 
-	// add node labels
-	for(uint i = 0; i < label_count; i++) {
-		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
-		ASSERT(s);
-		Schema_AddNodeToIndices(s, n);
-	}
-
 	// add node creation operation to undo log
 	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
 	UndoLog_CreateNode(&query_ctx->undo_log, *n);
 
+	// node is indexed once the commit completes
+	if(_NodeIndexed(gc, labels, label_count)) {
+		IndexBuffer_AddNode(query_ctx->index_buffer, n);
+	}
+
 	return properties_set;
 }
 
@@ -158,12 +223,51 @@ uint CreateEdge
 	Schema *s = GraphContext_GetSchema(gc, e->relationship, SCHEMA_EDGE);
 	// all schemas have been created in the edge blueprint loop or earlier
 	ASSERT(s != NULL);
-	Schema_AddEdgeToIndices(s, e);
 
 	// add edge creation operation to undo log
 	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
 	UndoLog_CreateEdge(&query_ctx->undo_log, *e);
 
+	// edge is indexed once the commit completes
+	if(Schema_HasIndices(s)) IndexBuffer_AddEdge(query_ctx->index_buffer, e);
+
+	return properties_set;
+}
+
+uint CreateEdges
+(
+	GraphContext *gc,
+	Edge **edges,
+	int r,
+	AttributeSet *props
+) {
+	ASSERT(gc != NULL);
+	ASSERT(edges != NULL);
+	ASSERT(props != NULL);
+
+	uint properties_set = 0;
+	uint edge_count = array_len(edges);
+
+	Graph_CreateEdges(gc->g, r, edges);
+
+	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	// all schemas have been created in the edge blueprint loop or earlier
+	ASSERT(s != NULL);
+
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+	bool indexed = Schema_HasIndices(s);
+
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges[i];
+		properties_set += _AddProperties((GraphEntity *)e, props[i]);
+
+		// add edge creation operation to undo log
+		UndoLog_CreateEdge(&query_ctx->undo_log, *e);
+
+		// edge is indexed once the commit completes
+		if(indexed) IndexBuffer_AddEdge(query_ctx->index_buffer, e);
+	}
+
 	return properties_set;
 }
 
@@ -251,7 +355,7 @@ static int _Update_Entity
 		UndoLog_UpdateEntity(&query_ctx->undo_log, ge, attr_id, *orig_value, entity_type);
 	}
 
-	return Graph_UpdateEntity(ge, attr_id, new_value, entity_type);
+	return Graph_UpdateEntity(gc->g, ge, attr_id, new_value, entity_type);
 }
 
 int UpdateEntity
@@ -265,16 +369,134 @@ int UpdateEntity
 	ASSERT(ge != NULL);
 
 	int updates = 0;
+	bool reindex = false;
 	for (uint i = 0; i < ATTRIBUTE_SET_COUNT(set); i++) {
 		Attribute *prop = set->attributes + i;
+		// determine if the update affects the entity's index entries
+		// prior to applying it
+		if(!reindex) {
+			reindex = _IndexInvalidated(gc, ge, prop->id, prop->value,
+					entity_type);
+		}
 		updates += _Update_Entity(gc, ge, prop->id, prop->value, entity_type);
 	}
 
-	if(entity_type == GETYPE_NODE) {
-		_AddNodeToIndices(gc, (Node *)ge);
-	} else {
-		_AddEdgeToIndices(gc, (Edge *)ge);
+	// entity is reindexed once the commit completes
+	if(reindex) {
+		QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+		if(entity_type == GETYPE_NODE) {
+			IndexBuffer_AddNode(query_ctx->index_buffer, (Node *)ge);
+		} else {
+			IndexBuffer_AddEdge(query_ctx->index_buffer, (Edge *)ge);
+		}
 	}
 
 	return updates;
 }
+
+// introduce buffered nodes to their indices
+// returns false if a node violates a unique constraint
+static bool _CommitNodeIndexUpdates
+(
+	GraphContext *gc,
+	rax *nodes
+) {
+	Node n;
+	Graph *g = gc->g;
+	raxIterator it;
+	raxStart(&it, nodes);
+
+	// remove buffered nodes from indices backing unique constraints
+	// such that a value moved between buffered nodes isn't mistaken
+	// for a violation against the node's own stale entry
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		EntityID id = *(EntityID *)it.key;
+		if(!Graph_GetNode(g, id, &n)) continue;
+
+		uint label_count;
+		NODE_GET_LABELS(g, &n, label_count);
+		for(uint i = 0; i < label_count; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+			Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+			if(idx != NULL && Index_UniqueCount(idx) > 0) {
+				Index_RemoveNode(idx, &n);
+			}
+		}
+	}
+
+	bool valid = true;
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		// node was deleted after it had been buffered
+		EntityID id = *(EntityID *)it.key;
+		if(!Graph_GetNode(g, id, &n)) continue;
+
+		uint label_count;
+		NODE_GET_LABELS(g, &n, label_count);
+
+		// a node violating a unique constraint isn't indexed
+		valid = _UniqueConstraintsHold(gc, &n, labels, label_count);
+		if(!valid) break;
+
+		for(uint i = 0; i < label_count; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+			ASSERT(s != NULL);
+			Schema_AddNodeToIndices(s, &n);
+		}
+	}
+
+	raxStop(&it);
+	return valid;
+}
+
+// introduce buffered edges to their indices
+static void _CommitEdgeIndexUpdates
+(
+	GraphContext *gc,
+	rax *edges
+) {
+	Edge e;
+	Graph *g = gc->g;
+	raxIterator it;
+	raxStart(&it, edges);
+
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		// buffered copy holds the edge's endpoints and relation
+		Edge *buffered = it.data;
+		e = *buffered;
+
+		// edge was deleted after it had been buffered
+		Edge current;
+		if(!Graph_GetEdge(g, ENTITY_GET_ID(&e), &current)) continue;
+		e.attributes = current.attributes;
+
+		int relation_id = EDGE_GET_RELATION_ID(&e, g);
+		Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+		ASSERT(s != NULL);
+		Schema_AddEdgeToIndices(s, &e);
+	}
+
+	raxStop(&it);
+}
+
+void CommitIndexUpdates
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+	IndexBuffer *buff = query_ctx->index_buffer;
+
+	if(IndexBuffer_IsEmpty(buff)) return;
+
+	// on violation remaining entities aren't indexed
+	// the query fails and its changes are rolled back
+	if(_CommitNodeIndexUpdates(gc, buff->nodes)) {
+		_CommitEdgeIndexUpdates(gc, buff->edges);
+	}
+
+	IndexBuffer_Clear(buff);
+}
@@ -10,10 +10,14 @@
 
 // graph hub responsible for crud operations on a graph
 // while updating relevant components e.g. indexes and undo log
+//
+// index maintenance is deferred, created and updated entities are buffered
+// and introduced to their indexes in bulk by CommitIndexUpdates
+// which is expected to be called before a commit releases its lock
 
 // create a node
 // set the node labels and attributes
-// add the node to the relevant indexes
+// buffer the node for indexing
 // add node creation operation to undo-log
 // return the # of attributes set
 uint CreateNode
@@ -27,7 +31,7 @@ uint CreateNode
 
 // create an edge
 // set the edge src, dst endpoints and attributes
-// add the edge to the relevant indexes
+// buffer the edge for indexing
 // add edge creation operation to undo-log
 // return the # of attributes set
 uint CreateEdge
@@ -40,6 +44,20 @@ uint CreateEdge
 	const AttributeSet props  // edge attributes
 );
 
+// create a batch of edges of the same relation type
+// edges src, dst endpoints are expected to be set
+// set the edges attributes
+// buffer the edges for indexing
+// add edge creation operations to undo-log
+// return the # of attributes set
+uint CreateEdges
+(
+	GraphContext *gc,         // graph context to create the edges
+	Edge **edges,             // array_t of edges to create
+	int r,                    // edges relation type
+	AttributeSet *props       // edges attributes, props[i] for edges[i]
+);
+
 // delete a node
 // delete the node from the graph
 // delete the node from the relevant indexes
@@ -64,7 +82,8 @@ int DeleteEdge
 
 // update an entity(node/edge)
 // update the entity attributes
-// update the relevant indexes of the entity
+// buffer the entity for reindexing, unless none of its indexed
+// attributes has changed
 // add entity update operations to undo log
 // return the # of properties updated
 int UpdateEntity
@@ -74,3 +93,11 @@ int UpdateEntity
 	const AttributeSet set,      // attributes to update
 	GraphEntityType entity_type  // the entity type (node/edge)
 );
+
+// introduce buffered entities to their indexes
+// a node violating a unique constraint isn't indexed and sets the query error
+// in which case the caller is expected to fail the query
+void CommitIndexUpdates
+(
+	GraphContext *gc  // graph context of the committed entities
+);
@@ -16,6 +16,8 @@
 #include "../util/thpool/pools.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../commands/prepared_statement.h"
+#include "../serializers/changelog/changelog.h"
 
 // Global array tracking all extant GraphContexts (defined in module.c)
 extern GraphContext **graphs_in_keyspace;
@@ -27,6 +29,12 @@ extern RedisModuleType *GraphContextRedisModuleType;
 static void _GraphContext_Free(void *arg);
 static void _GraphContext_UpdateVersion(GraphContext *gc, const char *str);
 
+// freeing a graph touches every page it occupies, while a forked child
+// shares these pages with the server process deletion is postponed
+static bool defer_free = false;
+static GraphContext **deferred_frees = NULL;
+static pthread_mutex_t deferred_frees_lock = PTHREAD_MUTEX_INITIALIZER;
+
 // delete a GraphContext reference from the `graphs_in_keyspace` global array
 void _GraphContext_RemoveFromRegistry(GraphContext *gc) {
 	uint graph_count = array_len(graphs_in_keyspace);
@@ -61,6 +69,16 @@ inline void GraphContext_DecreaseRefCount
 		// remove graph context from global `graphs_in_keyspace` array
 		_GraphContext_RemoveFromRegistry(gc);
 
+		// logged changes no longer apply
+		ChangeLog_DropGraph(gc->graph_name);
+
+		// postpone deletion until forked child exits
+		pthread_mutex_lock(&deferred_frees_lock);
+		bool deferred = defer_free;
+		if(deferred) array_append(deferred_frees, gc);
+		pthread_mutex_unlock(&deferred_frees_lock);
+		if(deferred) return;
+
 		if(async_delete) {
 			// Async delete
 			// add deletion task to pool using force mode
@@ -73,6 +91,40 @@ inline void GraphContext_DecreaseRefCount
 	}
 }
 
+// postpone freeing of graphs
+// once deferral is turned off postponed graphs are freed
+void GraphContext_DeferFree
+(
+	bool defer
+) {
+	GraphContext **graphs = NULL;
+
+	pthread_mutex_lock(&deferred_frees_lock);
+	defer_free = defer;
+	if(defer && deferred_frees == NULL) {
+		deferred_frees = array_new(GraphContext *, 0);
+	} else if(!defer) {
+		graphs = deferred_frees;
+		deferred_frees = NULL;
+	}
+	pthread_mutex_unlock(&deferred_frees_lock);
+
+	if(graphs == NULL) return;
+
+	bool async_delete;
+	Config_Option_get(Config_ASYNC_DELETE, &async_delete);
+
+	uint n = array_len(graphs);
+	for(uint i = 0; i < n; i++) {
+		if(async_delete) {
+			ThreadPools_AddWorkWriter(_GraphContext_Free, graphs[i], 1);
+		} else {
+			_GraphContext_Free(graphs[i]);
+		}
+	}
+	array_free(graphs);
+}
+
 //------------------------------------------------------------------------------
 // GraphContext API
 //------------------------------------------------------------------------------
@@ -118,8 +170,14 @@ GraphContext *GraphContext_New
 	gc->cache = Cache_New(cache_size, (CacheEntryFreeFunc)ExecutionCtx_Free,
 						  (CacheEntryCopyFunc)ExecutionCtx_Clone);
 
+	gc->prepared      = raxNew();
+	gc->next_prepared = 0;
+
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
+	// track modifications for incremental persistence
+	if(ChangeLog_Enabled()) Graph_TrackChanges(gc->g);
+
 	return gc;
 }
 
@@ -431,12 +489,44 @@ int GraphContext_AddExactMatchIndex
 
 	int res = Schema_AddIndex(idx, s, &idx_field, IDX_EXACT_MATCH);
 
+	// indices are part of the snapshot, not the change log
+	if(res == INDEX_OK) ChangeLog_RequestCompaction();
+
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexCreated(result_set, res);
 
 	return res;
 }
 
+int GraphContext_AddCompositeIndex
+(
+	Index **idx,
+	GraphContext *gc,
+	SchemaType schema_type,
+	const char *label,
+	const char **fields,
+	uint n
+) {
+	ASSERT(idx     !=  NULL);
+	ASSERT(gc      !=  NULL);
+	ASSERT(label   !=  NULL);
+	ASSERT(fields  !=  NULL);
+
+	Index *_idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH,
+			schema_type);
+	if(_idx == NULL) return INDEX_FAIL;
+
+	// composites are part of the exact match index
+	// and aren't reported as created indices
+	if(!Index_AddComposite(_idx, fields, n)) return INDEX_FAIL;
+
+	// indices are part of the snapshot, not the change log
+	ChangeLog_RequestCompaction();
+
+	*idx = _idx;
+	return INDEX_OK;
+}
+
 int GraphContext_AddFullTextIndex
 (
 	Index **idx,
@@ -460,6 +550,7 @@ int GraphContext_AddFullTextIndex
 	Attribute_ID field_id = GraphContext_FindOrAddAttribute(gc, field);
 	IndexField_New(&index_field, field_id, field, weight, nostem, phonetic);
 	int res = Schema_AddIndex(idx, s, &index_field, IDX_FULLTEXT);
+	if(res == INDEX_OK) ChangeLog_RequestCompaction();
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexCreated(result_set, res);
 
@@ -487,6 +578,7 @@ int GraphContext_DeleteIndex
 			// update resultset statistics
 			ResultSet *result_set = QueryCtx_GetResultSet();
 			ResultSet_IndexDeleted(result_set, res);
+			ChangeLog_RequestCompaction();
 		}
 	}
 
@@ -543,6 +635,57 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 	return gc->cache;
 }
 
+uint64_t GraphContext_AddPreparedStatement
+(
+	GraphContext *gc,
+	PreparedStatement *stmt
+) {
+	ASSERT(gc   != NULL);
+	ASSERT(stmt != NULL);
+
+	// a stale handle must never refer to a different statement
+	uint64_t handle = gc->next_prepared++;
+	raxInsert(gc->prepared, (unsigned char *)&handle, sizeof(handle), stmt,
+			NULL);
+
+	return handle;
+}
+
+PreparedStatement *GraphContext_GetPreparedStatement
+(
+	const GraphContext *gc,
+	long long handle
+) {
+	ASSERT(gc != NULL);
+
+	if(handle < 0) return NULL;
+
+	uint64_t h = handle;
+	void *stmt = raxFind(gc->prepared, (unsigned char *)&h, sizeof(h));
+	return (stmt == raxNotFound) ? NULL : stmt;
+}
+
+bool GraphContext_RemovePreparedStatement
+(
+	GraphContext *gc,
+	long long handle
+) {
+	ASSERT(gc != NULL);
+
+	if(handle < 0) return false;
+
+	void *stmt;
+	uint64_t h = handle;
+	if(!raxRemove(gc->prepared, (unsigned char *)&h, sizeof(h), &stmt)) {
+		return false;
+	}
+
+	// commands executing the statement hold their own reference
+	PreparedStatement_Free(stmt);
+
+	return true;
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
@@ -606,6 +749,11 @@ static void _GraphContext_Free(void *arg) {
 
 	if(gc->cache) Cache_Free(gc->cache);
 
+	if(gc->prepared) {
+		raxFreeWithCallback(gc->prepared,
+				(void(*)(void *))PreparedStatement_Free);
+	}
+
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
 	rm_free(gc->graph_name);
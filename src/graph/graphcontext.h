@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "rax.h"
 #include "../redismodule.h"
 #include "../index/index.h"
 #include "../schema/schema.h"
@@ -15,6 +16,8 @@
 #include "../serializers/decode_context.h"
 #include "../util/cache/cache.h"
 
+typedef struct PreparedStatement PreparedStatement;
+
 // GraphContext holds refrences to various elements of a graph object
 // It is the value sitting behind a Redis graph key
 //
@@ -39,6 +42,8 @@ typedef struct {
 	GraphEncodeContext *encoding_context;   // encode context of the graph
 	GraphDecodeContext *decoding_context;   // decode context of the graph
 	Cache *cache;                           // global cache of execution plans
+	rax *prepared;                          // statements prepared via GRAPH.PREPARE
+	uint64_t next_prepared;                 // handle of the next prepared statement
 	XXH32_hash_t version;                   // graph version
 } GraphContext;
 
@@ -64,6 +69,14 @@ void GraphContext_DecreaseRefCount
 	GraphContext *gc
 );
 
+// postpone freeing of graphs whose ref count drops to 0
+// used while a forked child shares memory pages with the server process
+// turning deferral off frees postponed graphs
+void GraphContext_DeferFree
+(
+	bool defer
+);
+
 // retrive the graph context according to the graph name
 // readOnly is the access mode to the graph key
 GraphContext *GraphContext_Retrieve
@@ -217,6 +230,18 @@ int GraphContext_AddExactMatchIndex
 	const char *field
 );
 
+// create a composite over exact match indexed attributes of the given label
+// attributes are expected to be indexed
+int GraphContext_AddCompositeIndex
+(
+	Index **idx,
+	GraphContext *gc,
+	SchemaType schema_type,
+	const char *label,
+	const char **fields,
+	uint n
+);
+
 // create a full text index for the given label and attribute
 int GraphContext_AddFullTextIndex
 (
@@ -286,3 +311,27 @@ Cache *GraphContext_GetCache
 	const GraphContext *gc
 );
 
+// registers a prepared statement, returning its handle
+// each registration is assigned a new handle, handles are never reused
+// prepared statements are accessed from Redis main thread only
+uint64_t GraphContext_AddPreparedStatement
+(
+	GraphContext *gc,
+	PreparedStatement *stmt
+);
+
+// retrieves a prepared statement by its handle, NULL if missing
+PreparedStatement *GraphContext_GetPreparedStatement
+(
+	const GraphContext *gc,
+	long long handle
+);
+
+// removes a prepared statement from the registry
+// returns false if handle doesn't refer to a prepared statement
+bool GraphContext_RemovePreparedStatement
+(
+	GraphContext *gc,
+	long long handle
+);
+
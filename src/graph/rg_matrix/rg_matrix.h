@@ -210,6 +210,25 @@ GrB_Info RG_Matrix_setElement_UINT64      // C (i,j) = x
 	GrB_Index j                         // column index
 );
 
+// set a batch of entries C(I[k],J[k]) = true
+GrB_Info RG_Matrix_setElements_BOOL     // C (I,J) = true
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	GrB_Index nvals                     // number of entries
+);
+
+// set a batch of entries C(I[k],J[k]) = X[k]
+GrB_Info RG_Matrix_setElements_UINT64   // C (I,J) = X
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	const uint64_t *X,                  // values to assign
+	GrB_Index nvals                     // number of entries
+);
+
 GrB_Info RG_Matrix_extractElement_BOOL     // x = A(i,j)
 (
 	bool *x,                               // extracted scalar
@@ -297,6 +316,17 @@ GrB_Info RG_Matrix_wait
 	bool force_sync
 );
 
+// defer merging pending changes into M for all matrices
+// used while a forked child shares memory pages with the server process
+// forced syncs are never deferred
+void RG_Matrix_DeferSync
+(
+	bool defer
+);
+
+// number of merges deferred since deferral was last enabled
+uint64_t RG_Matrix_DeferredSyncCount(void);
+
 void RG_Matrix_free
 (
 	RG_Matrix *C
@@ -0,0 +1,244 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_utils.h"
+#include "rg_matrix.h"
+#include "../../util/rmalloc.h"
+
+// batch version of RG_Matrix_setElement_BOOL, ignoring C's transpose
+//
+// entries marked for deletion are unmarked: DM<!P> = DM
+// entries missing from M are added as pending additions: DP += P<!M>
+static GrB_Info _setElements_BOOL
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	GrB_Index nvals                     // number of entries
+) {
+	GrB_Info    info;
+	GrB_Index   nrows;
+	GrB_Index   ncols;
+	GrB_Index   dm_nvals;
+	GrB_Matrix  P   =  NULL;
+	GrB_Matrix  A   =  NULL;
+	GrB_Scalar  s   =  NULL;
+	GrB_Matrix  m   =  RG_MATRIX_M(C);
+	GrB_Matrix  dp  =  RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix  dm  =  RG_MATRIX_DELTA_MINUS(C);
+
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// P = pattern of the batch, duplicates collapse into a single entry
+	info = GrB_Scalar_new(&s, GrB_BOOL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Scalar_setElement_BOOL(s, true);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_new(&P, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Matrix_build_Scalar(P, I, J, s, nvals);
+	ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// unmark entries pending deletion
+	//--------------------------------------------------------------------------
+
+	info = GrB_Matrix_nvals(&dm_nvals, dm);
+	ASSERT(info == GrB_SUCCESS);
+	if(dm_nvals > 0) {
+		info = GrB_transpose(dm, P, GrB_NULL, dm, GrB_DESC_RSCT0);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	//--------------------------------------------------------------------------
+	// add entries missing from 'm' to delta-plus
+	//--------------------------------------------------------------------------
+
+	info = GrB_Matrix_new(&A, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_transpose(A, m, GrB_NULL, P, GrB_DESC_SCT0);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_eWiseAdd_BinaryOp(dp, NULL, NULL, GrB_LOR, dp, A, NULL);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	RG_Matrix_setDirty(C);
+
+	GrB_free(&s);
+	GrB_free(&P);
+	GrB_free(&A);
+
+	return info;
+}
+
+GrB_Info RG_Matrix_setElements_BOOL     // C (I,J) = true
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	GrB_Index nvals                     // number of entries
+) {
+	ASSERT(C != NULL);
+	ASSERT(!RG_MATRIX_MULTI_EDGE(C));
+	ASSERT(nvals == 0 || (I != NULL && J != NULL));
+
+	if(nvals == 0) return GrB_SUCCESS;
+
+	GrB_Info info;
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = _setElements_BOOL(C->transposed, J, I, nvals);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+	}
+
+	return _setElements_BOOL(C, I, J, nvals);
+}
+
+// sets a batch of edge IDs
+//
+// the bulk of the batch is expected to introduce new single-edge entries
+// those are built into a temporary matrix which is merged into delta-plus
+// with a single eWiseAdd
+// entries which require multi-edge handling i.e. already exist in C,
+// pending deletion or repeated within the batch are set one by one
+// via RG_Matrix_setElement_UINT64
+GrB_Info RG_Matrix_setElements_UINT64   // C (I,J) = X
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	const uint64_t *X,                  // values to assign
+	GrB_Index nvals                     // number of entries
+) {
+	ASSERT(C != NULL);
+	ASSERT(nvals == 0 || (I != NULL && J != NULL && X != NULL));
+
+	if(nvals == 0) return GrB_SUCCESS;
+
+	GrB_Info    info;
+	GrB_Index   nrows;
+	GrB_Index   ncols;
+	GrB_Index   p_nvals;
+	GrB_Index   k_nvals;
+	GrB_Matrix  P       =  NULL;   // number of occurrences of each entry
+	GrB_Matrix  K       =  NULL;   // conflicting entries
+	GrB_Matrix  F       =  NULL;   // entries to add via delta-plus
+	GrB_Matrix  m       =  RG_MATRIX_M(C);
+	GrB_Matrix  dp      =  RG_MATRIX_DELTA_PLUS(C);
+	uint64_t    *ones   =  rm_malloc(sizeof(uint64_t) * nvals);
+
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(GrB_Index k = 0; k < nvals; k++) ones[k] = 1;
+
+	info = GrB_Matrix_new(&P, GrB_UINT64, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_build_UINT64(P, I, J, ones, nvals, GrB_PLUS_UINT64);
+	ASSERT(info == GrB_SUCCESS);
+	rm_free(ones);
+
+	//--------------------------------------------------------------------------
+	// compute conflicting entries
+	//--------------------------------------------------------------------------
+
+	// K = P ∩ M, entries marked for deletion are a subset of M
+	info = GrB_Matrix_new(&K, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_eWiseMult_BinaryOp(K, NULL, NULL, GrB_ONEB_BOOL, P, m,
+			NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	// K += P ∩ DP
+	info = GrB_Matrix_eWiseMult_BinaryOp(K, NULL, GrB_LOR, GrB_ONEB_BOOL, P,
+			dp, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	// K += P > 1, multiple edges connecting the same pair of nodes
+	info = GrB_Matrix_nvals(&p_nvals, P);
+	ASSERT(info == GrB_SUCCESS);
+	if(p_nvals < nvals) {
+		info = GrB_Matrix_select_UINT64(K, NULL, GrB_LOR, GrB_VALUEGT_UINT64,
+				P, 1, NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = GrB_Matrix_nvals(&k_nvals, K);
+	ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// partition batch
+	//--------------------------------------------------------------------------
+
+	GrB_Index  n   =  nvals;
+	GrB_Index  *_I =  (GrB_Index *)I;
+	GrB_Index  *_J =  (GrB_Index *)J;
+	uint64_t   *_X =  (uint64_t *)X;
+
+	if(k_nvals > 0) {
+		// set conflicting entries one by one
+		// collect the rest into a new set of arrays
+		n  = 0;
+		_I = rm_malloc(sizeof(GrB_Index) * nvals);
+		_J = rm_malloc(sizeof(GrB_Index) * nvals);
+		_X = rm_malloc(sizeof(uint64_t)  * nvals);
+
+		for(GrB_Index k = 0; k < nvals; k++) {
+			bool x;
+			info = GrB_Matrix_extractElement_BOOL(&x, K, I[k], J[k]);
+			if(info == GrB_SUCCESS) {
+				info = RG_Matrix_setElement_UINT64(C, X[k], I[k], J[k]);
+				ASSERT(info == GrB_SUCCESS);
+			} else {
+				_I[n] = I[k];
+				_J[n] = J[k];
+				_X[n] = X[k];
+				n++;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// DP += F
+	//--------------------------------------------------------------------------
+
+	if(n > 0) {
+		if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+			info = RG_Matrix_setElements_BOOL(C->transposed, _J, _I, n);
+			ASSERT(info == GrB_SUCCESS);
+		}
+
+		// F and DP are disjoint, 'first' is never applied
+		info = GrB_Matrix_new(&F, GrB_UINT64, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_build_UINT64(F, _I, _J, _X, n, GrB_FIRST_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_eWiseAdd_BinaryOp(dp, NULL, NULL, GrB_FIRST_UINT64,
+				dp, F, NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		RG_Matrix_setDirty(C);
+	}
+
+	if(_I != I) {
+		rm_free(_I);
+		rm_free(_J);
+		rm_free(_X);
+	}
+
+	GrB_free(&P);
+	GrB_free(&K);
+	GrB_free(&F);
+
+	return GrB_SUCCESS;
+}
@@ -9,6 +9,15 @@
 #include "../../util/rmalloc.h"
 #include "configuration/config.h"
 
+// while a forked child shares memory pages with the server process
+// merging pending changes into M copies M's pages, as such merging is
+// deferred unless pending changes grow beyond this factor of
+// DELTA_MAX_PENDING_CHANGES
+#define DEFERRED_SYNC_FACTOR 16
+
+static bool defer_sync = false;      // defer merging of pending changes
+static uint64_t deferred_syncs = 0;  // number of merges deferred
+
 static inline void _SetUndirty
 (
 	RG_Matrix C
@@ -122,13 +131,32 @@ GrB_Info RG_Matrix_wait
 
 	uint64_t delta_max_pending_changes;
 	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &delta_max_pending_changes);
-	if(force_sync ||
-	   delta_plus_nvals + delta_minus_nvals >= delta_max_pending_changes) {
-		info = RG_Matrix_sync(A);
+
+	GrB_Index pending = delta_plus_nvals + delta_minus_nvals;
+	bool sync = force_sync || pending >= delta_max_pending_changes;
+
+	if(sync && !force_sync && defer_sync &&
+	   pending < delta_max_pending_changes * DEFERRED_SYNC_FACTOR) {
+		sync = false;
+		__atomic_fetch_add(&deferred_syncs, 1, __ATOMIC_RELAXED);
 	}
 
+	if(sync) info = RG_Matrix_sync(A);
+
 	_SetUndirty(A);
 
 	return info;
 }
 
+
+void RG_Matrix_DeferSync
+(
+	bool defer
+) {
+	if(defer) __atomic_store_n(&deferred_syncs, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&defer_sync, defer, __ATOMIC_RELAXED);
+}
+
+uint64_t RG_Matrix_DeferredSyncCount(void) {
+	return __atomic_load_n(&deferred_syncs, __ATOMIC_RELAXED);
+}
@@ -15,8 +15,132 @@
 #include "../graph/entities/node.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
 
-extern void populateEdgeIndex(Index *idx, Graph *g); 
-extern void populateNodeIndex(Index *idx, Graph *g);
+extern void populateEdgeIndex(Index *idx, Graph *g, NodeID min_row,
+		NodeID max_row);
+extern void populateNodeIndex(Index *idx, Graph *g, NodeID min_row,
+		NodeID max_row);
+
+// source of construction identifiers
+static uint64_t _build_id = 0;
+
+// buffer a change made to an entity while index is under construction
+// returns false if index is operational, in which case the caller should
+// apply the change
+bool Index_BufferChange
+(
+	Index *idx,
+	const void *key,
+	size_t key_len,
+	IndexChange change
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	if(Index_Enabled(idx)) return false;
+
+	// latest change wins, the builder reads entities as they are once applied
+	raxInsert(idx->pending, (unsigned char *)key, key_len,
+			(void *)(uintptr_t)change, NULL);
+
+	return true;
+}
+
+// index entity under each of its ordered fields
+void Index_IndexOrdered
+(
+	Index *idx,
+	const GraphEntity *e,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(e   != NULL);
+	ASSERT(key != NULL);
+
+	uint field_count = array_len(idx->fields);
+	for(uint i = 0; i < field_count; i++) {
+		IndexField *field = idx->fields + i;
+		if(field->ordered == NULL) continue;
+
+		SIValue *v = GraphEntity_GetProperty(e, field->id);
+		if(v != ATTRIBUTE_NOTFOUND && OrderedIndex_Indexable(*v)) {
+			OrderedIndex_Insert(field->ordered, *v, key);
+		} else if(idx->entity_type == GETYPE_NODE) {
+			// every labeled node is indexed, missing attributes as null
+			// such that the entire label can be scanned in order
+			SIValue value = (v == ATTRIBUTE_NOTFOUND) ? SI_NullVal() : *v;
+			OrderedIndex_Insert(field->ordered, value, key);
+		} else {
+			OrderedIndex_Remove(field->ordered, key);
+		}
+
+		// arrays are indexed by their elements
+		if(field->members != NULL) {
+			if(v != ATTRIBUTE_NOTFOUND && SI_TYPE(*v) == T_ARRAY) {
+				OrderedIndex_InsertMembers(field->members, *v, key);
+			} else {
+				OrderedIndex_Remove(field->members, key);
+			}
+		}
+
+		// edges are additionally grouped by their source node
+		if(field->adjacent != NULL) {
+			if(v != ATTRIBUTE_NOTFOUND && OrderedIndex_Indexable(*v)) {
+				const EdgeIndexKey *edge_key = key;
+				SIValue tuple[2] = {SI_LongVal(edge_key->src_id), *v};
+				OrderedIndex_InsertTuple(field->adjacent, tuple, 2, key);
+			} else {
+				OrderedIndex_Remove(field->adjacent, key);
+			}
+		}
+
+		if(field->spatial == NULL) continue;
+		if(v != ATTRIBUTE_NOTFOUND && SI_TYPE(*v) == T_POINT) {
+			SpatialIndex_Insert(field->spatial, *v, key);
+		} else {
+			SpatialIndex_Remove(field->spatial, key);
+		}
+	}
+
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		IndexComposite *composite = idx->composites + i;
+		if(composite->ordered == NULL) continue;
+
+		uint n = array_len(composite->ids);
+		SIValue values[n];
+		for(uint j = 0; j < n; j++) {
+			SIValue *v = GraphEntity_GetProperty(e, composite->ids[j]);
+			values[j] = (v == ATTRIBUTE_NOTFOUND) ? SI_NullVal() : *v;
+		}
+
+		OrderedIndex_InsertTuple(composite->ordered, values, n, key);
+	}
+}
+
+// remove entity from each of the ordered fields
+void Index_RemoveOrdered
+(
+	Index *idx,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	uint field_count = array_len(idx->fields);
+	for(uint i = 0; i < field_count; i++) {
+		IndexField *field = idx->fields + i;
+		if(field->ordered) OrderedIndex_Remove(field->ordered, key);
+		if(field->spatial) SpatialIndex_Remove(field->spatial, key);
+		if(field->adjacent) OrderedIndex_Remove(field->adjacent, key);
+		if(field->members) OrderedIndex_Remove(field->members, key);
+	}
+
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		IndexComposite *composite = idx->composites + i;
+		if(composite->ordered) OrderedIndex_Remove(composite->ordered, key);
+	}
+}
 
 RSDoc *Index_IndexGraphEntity
 (
@@ -143,6 +267,11 @@ void IndexField_New
 	field->weight   = weight;
 	field->nostem   = nostem;
 	field->phonetic = rm_strdup(phonetic);
+	field->ordered  = NULL;
+	field->spatial  = NULL;
+	field->adjacent = NULL;
+	field->members  = NULL;
+	field->unique   = false;
 }
 
 void IndexField_Free
@@ -153,6 +282,23 @@ void IndexField_Free
 
 	rm_free(field->name);
 	rm_free(field->phonetic);
+	if(field->ordered) OrderedIndex_Free(field->ordered);
+	if(field->spatial) SpatialIndex_Free(field->spatial);
+	if(field->adjacent) OrderedIndex_Free(field->adjacent);
+	if(field->members) OrderedIndex_Free(field->members);
+}
+
+static void _IndexComposite_Free
+(
+	IndexComposite *composite
+) {
+	ASSERT(composite != NULL);
+
+	uint n = array_len(composite->fields);
+	for(uint i = 0; i < n; i++) rm_free(composite->fields[i]);
+	array_free(composite->fields);
+	array_free(composite->ids);
+	if(composite->ordered) OrderedIndex_Free(composite->ordered);
 }
 
 // create a new index
@@ -169,10 +315,15 @@ Index *Index_New
 	idx->type          =  type;
 	idx->label         =  rm_strdup(label);
 	idx->fields        =  array_new(IndexField, 1);
+	idx->composites    =  array_new(IndexComposite, 0);
 	idx->label_id      =  label_id;
 	idx->language      =  NULL;
 	idx->stopwords     =  NULL;
 	idx->entity_type   =  entity_type;
+	idx->state         =  IDX_OPERATIONAL;
+	idx->pending       =  NULL;
+	idx->build_id      =  0;
+	idx->progress      =  100;
 
 	return idx;
 }
@@ -217,16 +368,227 @@ void Index_RemoveField
 			break;
 		}
 	}
+
+	// drop composites covering field
+	uint i = 0;
+	while(i < array_len(idx->composites)) {
+		IndexComposite *composite = idx->composites + i;
+		bool covers = false;
+		uint n = array_len(composite->ids);
+		for(uint j = 0; j < n && !covers; j++) {
+			covers = (composite->ids[j] == attribute_id);
+		}
+
+		if(covers) {
+			_IndexComposite_Free(composite);
+			array_del(idx->composites, i);
+		} else {
+			i++;
+		}
+	}
 }
 
-// constructs index
-void Index_Construct
+bool Index_AddComposite
 (
 	Index *idx,
-	Graph *g
+	const char **fields,
+	uint n
+) {
+	ASSERT(idx    != NULL);
+	ASSERT(fields != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	// resolve distinct field ids, in order of appearance
+	uint m = 0;
+	Attribute_ID ids[n];
+	const char *names[n];
+	for(uint i = 0; i < n; i++) {
+		const IndexField *field = NULL;
+		uint fields_count = array_len(idx->fields);
+		for(uint j = 0; j < fields_count; j++) {
+			if(strcmp(idx->fields[j].name, fields[i]) == 0) {
+				field = idx->fields + j;
+				break;
+			}
+		}
+		ASSERT(field != NULL);
+
+		bool dup = false;
+		for(uint j = 0; j < m && !dup; j++) dup = (ids[j] == field->id);
+		if(dup) continue;
+
+		ids[m]   = field->id;
+		names[m] = field->name;
+		m++;
+	}
+
+	if(m < 2) return false;
+
+	// make sure composite doesn't already exist
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		const IndexComposite *composite = idx->composites + i;
+		if(array_len(composite->ids) != m) continue;
+		if(memcmp(composite->ids, ids, sizeof(Attribute_ID) * m) == 0) {
+			return false;
+		}
+	}
+
+	IndexComposite composite;
+	composite.fields  = array_new(char *, m);
+	composite.ids     = array_new(Attribute_ID, m);
+	composite.ordered = NULL;  // created once index is constructed
+	for(uint i = 0; i < m; i++) {
+		array_append(composite.fields, rm_strdup(names[i]));
+		array_append(composite.ids, ids[i]);
+	}
+
+	array_append(idx->composites, composite);
+	return true;
+}
+
+uint Index_CompositeCount
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	return array_len(idx->composites);
+}
+
+const IndexComposite *Index_GetComposites
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	return (const IndexComposite *)idx->composites;
+}
+
+static IndexField *_GetField
+(
+	const Index *idx,
+	const char *field
+) {
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		if(strcmp(idx->fields[i].name, field) == 0) return idx->fields + i;
+	}
+
+	return NULL;
+}
+
+bool Index_SetUnique
+(
+	Index *idx,
+	const char *field,
+	bool unique
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	IndexField *f = _GetField(idx, field);
+	if(f == NULL) return false;
+
+	f->unique = unique;
+	return true;
+}
+
+bool Index_IsUnique
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	const IndexField *f = _GetField(idx, field);
+	return (f != NULL && f->unique);
+}
+
+uint Index_UniqueCount
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	uint count = 0;
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		if(idx->fields[i].unique) count++;
+	}
+
+	return count;
+}
+
+bool Index_HasDuplicates
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	const IndexField *f = _GetField(idx, field);
+	ASSERT(f != NULL && f->ordered != NULL);
+
+	return OrderedIndex_HasDuplicates(f->ordered);
+}
+
+const char *Index_UniqueViolation
+(
+	const Index *idx,
+	const GraphEntity *e,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(e   != NULL);
+	ASSERT(key != NULL);
+
+	// entity keys are at most an edge key long
+	unsigned char other[sizeof(EdgeIndexKey)];
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		const IndexField *field = idx->fields + i;
+		if(!field->unique) continue;
+
+		// constrained fields are always served by an operational ordered index
+		ASSERT(field->ordered != NULL);
+
+		// values which aren't indexable aren't constrained
+		SIValue *v = GraphEntity_GetProperty(e, field->id);
+		if(v == ATTRIBUTE_NOTFOUND) continue;
+
+		// at most a single entity holds a constrained value
+		if(OrderedIndex_Lookup(field->ordered, *v, other) != NULL &&
+		   memcmp(other, key, field->ordered->key_len) != 0) {
+			return field->name;
+		}
+	}
+
+	return NULL;
+}
+
+// creates an empty operational index
+// drops previous RediSearch index and ordered fields and aborts any
+// construction in progress
+void Index_Create
+(
+	Index *idx
 ) {
 	ASSERT(idx != NULL);
 
+	idx->build_id = __atomic_add_fetch(&_build_id, 1, __ATOMIC_RELAXED);
+	idx->progress = 100;
+	__atomic_store_n(&idx->state, IDX_OPERATIONAL, __ATOMIC_RELEASE);
+
+	if(idx->pending) {
+		raxFree(idx->pending);
+		idx->pending = NULL;
+	}
+
 	// RediSearch index already exists, re-construct
 	if(idx->idx) {
 		RediSearch_DropIndex(idx->idx);
@@ -280,6 +642,41 @@ void Index_Construct
 			RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
 		}
 
+		// exact-match lookups are served by a native ordered index per field
+		// internal fields e.g. _src_id aren't attributes and remain with
+		// RediSearch only
+		size_t key_len = (idx->entity_type == GETYPE_NODE) ?
+			sizeof(EntityID) : sizeof(EdgeIndexKey);
+		for(uint i = 0; i < fields_count; i++) {
+			IndexField *field = idx->fields + i;
+			if(field->ordered) OrderedIndex_Free(field->ordered);
+			if(field->spatial) SpatialIndex_Free(field->spatial);
+			if(field->adjacent) OrderedIndex_Free(field->adjacent);
+			if(field->members) OrderedIndex_Free(field->members);
+			field->ordered  = NULL;
+			field->spatial  = NULL;
+			field->adjacent = NULL;
+			field->members  = NULL;
+			if(field->id == ATTRIBUTE_ID_NONE) continue;
+			field->ordered = OrderedIndex_New(key_len);
+			field->members = OrderedIndex_NewMembers(key_len);
+
+			// points held by nodes are served by a native spatial index
+			// edges of a single source node are served by an adjacent index
+			if(idx->entity_type == GETYPE_NODE) {
+				field->spatial = SpatialIndex_New(key_len);
+			} else {
+				field->adjacent = OrderedIndex_New(key_len);
+			}
+		}
+
+		uint composite_count = array_len(idx->composites);
+		for(uint i = 0; i < composite_count; i++) {
+			IndexComposite *composite = idx->composites + i;
+			if(composite->ordered) OrderedIndex_Free(composite->ordered);
+			composite->ordered = OrderedIndex_New(key_len);
+		}
+
 		// for none indexable types e.g. Array introduce an additional field
 		// "none_indexable_fields" which will hold a list of attribute names
 		// that were not indexed
@@ -291,8 +688,40 @@ void Index_Construct
 	}
 
 	idx->idx = rsIdx;
-	if(idx->entity_type == GETYPE_NODE) populateNodeIndex(idx, g);
-	else populateEdgeIndex(idx, g);
+}
+
+// constructs index
+void Index_Construct
+(
+	Index *idx,
+	Graph *g
+) {
+	ASSERT(g   != NULL);
+	ASSERT(idx != NULL);
+
+	Index_Create(idx);
+
+	if(idx->entity_type == GETYPE_NODE) populateNodeIndex(idx, g, 0, UINT64_MAX);
+	else populateEdgeIndex(idx, g, 0, UINT64_MAX);
+}
+
+bool Index_Enabled
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	return __atomic_load_n(&idx->state, __ATOMIC_ACQUIRE) == IDX_OPERATIONAL;
+}
+
+uint Index_ConstructionProgress
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	if(Index_Enabled(idx)) return 100;
+	return __atomic_load_n(&idx->progress, __ATOMIC_RELAXED);
 }
 
 // query index
@@ -346,6 +775,74 @@ bool Index_ContainsAttribute
 	return false;
 }
 
+OrderedIndex *Index_GetOrderedIndex
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		const IndexField *f = idx->fields + i;
+		if(strcmp(f->name, field) == 0) return f->ordered;
+	}
+
+	return NULL;
+}
+
+OrderedIndex *Index_GetMemberIndex
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		const IndexField *f = idx->fields + i;
+		if(strcmp(f->name, field) == 0) return f->members;
+	}
+
+	return NULL;
+}
+
+OrderedIndex *Index_GetAdjacentIndex
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		const IndexField *f = idx->fields + i;
+		if(strcmp(f->name, field) == 0) return f->adjacent;
+	}
+
+	return NULL;
+}
+
+SpatialIndex *Index_GetSpatialIndex
+(
+	const Index *idx,
+	const char *field
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(field != NULL);
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		const IndexField *f = idx->fields + i;
+		if(strcmp(f->name, field) == 0) return f->spatial;
+	}
+
+	return NULL;
+}
+
 int Index_GetLabelID
 (
 	const Index *idx
@@ -404,6 +901,7 @@ void Index_Free(Index *idx) {
 	ASSERT(idx != NULL);
 
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
+	if(idx->pending) raxFree(idx->pending);
 
 	if(idx->language) rm_free(idx->language);
 
@@ -413,6 +911,12 @@ void Index_Free(Index *idx) {
 	}
 	array_free(idx->fields);
 
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		_IndexComposite_Free(idx->composites + i);
+	}
+	array_free(idx->composites);
+
 	if(idx->stopwords) {
 		uint stopwords_count = array_len(idx->stopwords);
 		for(uint i = 0; i < stopwords_count; i++) {
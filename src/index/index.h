@@ -10,6 +10,8 @@
 #include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
 #include "../graph/graph.h"
+#include "ordered_index.h"
+#include "spatial_index.h"
 #include "redisearch_api.h"
 
 #define INDEX_OK 1
@@ -17,6 +19,9 @@
 #define INDEX_SEPARATOR '\1'  // can't use '\0', RediSearch will terminate on \0
 #define INDEX_FIELD_NONE_INDEXED "NONE_INDEXABLE_FIELDS"
 
+// number of matrix rows populated by a single background construction step
+#define INDEX_CONSTRUCT_BATCH_SIZE 10000
+
 #define INDEX_FIELD_DEFAULT_WEIGHT 1.0
 #define INDEX_FIELD_DEFAULT_NOSTEM false
 #define INDEX_FIELD_DEFAULT_PHONETIC "no"
@@ -35,8 +40,21 @@ typedef enum {
 	IDX_ANY          =  0,
 	IDX_EXACT_MATCH  =  1,
 	IDX_FULLTEXT     =  2,
+	IDX_COMPOSITE    =  3,  // composite of exact-match fields, persistence only
+	IDX_UNIQUE       =  4,  // unique constraint over an exact-match field, persistence only
 } IndexType;
 
+typedef enum {
+	IDX_OPERATIONAL         =  0,  // index is populated and available for use
+	IDX_UNDER_CONSTRUCTION  =  1,  // index is populated in the background
+} IndexState;
+
+// change made to an entity while its index is under construction
+typedef enum {
+	IDX_CHANGE_UPDATE  =  1,  // entity was created or modified
+	IDX_CHANGE_REMOVE  =  2,  // entity was deleted or lost its label
+} IndexChange;
+
 typedef struct {
 	EntityID src_id;
 	EntityID dest_id;
@@ -49,17 +67,36 @@ typedef struct {
 	double weight;     // the importance of text
 	bool nostem;       // disable stemming of the text
 	char *phonetic;    // phonetic search of text
+	OrderedIndex *ordered;  // native ordered index, exact-match fields only
+	SpatialIndex *spatial;  // native spatial index over points, node exact-match fields only
+	OrderedIndex *adjacent; // native ordered index over (source node, value), edge exact-match fields only
+	OrderedIndex *members;  // native members index over array elements, exact-match fields only
+	bool unique;            // no two entities may hold the same indexed value
 } IndexField;
 
+// ordered index over a tuple of exact-match fields
+// entities are ordered by their first field, then by their second and so on
+// missing attributes are indexed as null
+typedef struct {
+	char **fields;          // field names, in tuple order
+	Attribute_ID *ids;      // field ids, in tuple order
+	OrderedIndex *ordered;  // native ordered index over tuples
+} IndexComposite;
+
 typedef struct {
 	char *label;                  // indexed label
 	int label_id;                 // indexed label ID
 	IndexField *fields;           // indexed fields
+	IndexComposite *composites;   // composites over indexed fields
 	char *language;               // language
 	char **stopwords;             // stopwords
 	GraphEntityType entity_type;  // entity type (node/edge) indexed
 	IndexType type;               // index type exact-match / fulltext
 	RSIndex *idx;                 // rediSearch index
+	IndexState state;             // operational / under construction
+	rax *pending;                 // entity key -> change, made during construction
+	uint64_t build_id;            // identifies latest construction
+	uint progress;                // construction progress, percentage
 } Index;
 
 // create new index field
@@ -87,13 +124,26 @@ Index *Index_New
 	GraphEntityType entity_type  // entity type been indexed
 );
 
-// constructs index
+// constructs index, populating it within the calling thread
+// see Index_ConstructAsync for background construction
 void Index_Construct
 (
 	Index *idx,
 	Graph *g
 );
 
+// returns true if index is populated and can be used by queries
+bool Index_Enabled
+(
+	const Index *idx
+);
+
+// returns construction progress as a percentage, 100 once operational
+uint Index_ConstructionProgress
+(
+	const Index *idx
+);
+
 // adds field to index
 void Index_AddField
 (
@@ -101,13 +151,73 @@ void Index_AddField
 	IndexField *field
 );
 
-// removes field from index
+// removes field from index, along with composites covering it
 void Index_RemoveField
 (
 	Index *idx,
 	const char *field  // field to remove
 );
 
+// adds a composite over 'fields', each of which must be indexed
+// returns false if 'fields' holds less than two distinct fields
+// or an identical composite exists
+bool Index_AddComposite
+(
+	Index *idx,
+	const char **fields,  // composite fields, in tuple order
+	uint n                // number of fields
+);
+
+// returns number of composites
+uint Index_CompositeCount
+(
+	const Index *idx
+);
+
+// returns index composites
+const IndexComposite *Index_GetComposites
+(
+	const Index *idx
+);
+
+// constrain 'field' values to be unique across indexed entities
+// returns false if 'field' isn't indexed
+bool Index_SetUnique
+(
+	Index *idx,
+	const char *field,  // constrained field
+	bool unique         // set or drop constraint
+);
+
+// returns true if 'field' values are constrained to be unique
+bool Index_IsUnique
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
+// returns number of unique constrained fields
+uint Index_UniqueCount
+(
+	const Index *idx
+);
+
+// returns true if two or more indexed entities share a value of 'field'
+bool Index_HasDuplicates
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
+// returns the first unique field whose value held by entity 'e'
+// is already held by another indexed entity, NULL if there's none
+const char *Index_UniqueViolation
+(
+	const Index *idx,
+	const GraphEntity *e,  // entity about to be indexed
+	const void *key        // entity key
+);
+
 // index node
 void Index_IndexNode
 (
@@ -161,6 +271,36 @@ bool Index_ContainsAttribute
 	Attribute_ID attribute_id  // attribute id to search
 );
 
+// returns the ordered index over 'field', NULL if field isn't ordered
+OrderedIndex *Index_GetOrderedIndex
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
+// returns the members index over elements of 'field' arrays
+// NULL if field has none
+OrderedIndex *Index_GetMemberIndex
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
+// returns the ordered index over 'field' grouping edges by their source node
+// NULL if field has none
+OrderedIndex *Index_GetAdjacentIndex
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
+// returns the spatial index over 'field', NULL if field has none
+SpatialIndex *Index_GetSpatialIndex
+(
+	const Index *idx,
+	const char *field  // field name
+);
+
 // returns indexed label ID
 int Index_GetLabelID
 (
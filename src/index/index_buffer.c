@@ -0,0 +1,85 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_buffer.h"
+#include "../util/rmalloc.h"
+
+IndexBuffer *IndexBuffer_New(void) {
+	IndexBuffer *buff = rm_malloc(sizeof(IndexBuffer));
+
+	buff->nodes = raxNew();
+	buff->edges = raxNew();
+
+	return buff;
+}
+
+void IndexBuffer_AddNode
+(
+	IndexBuffer *buff,
+	const Node *n
+) {
+	ASSERT(buff != NULL);
+	ASSERT(n    != NULL);
+
+	EntityID id = ENTITY_GET_ID(n);
+	raxTryInsert(buff->nodes, (unsigned char *)&id, sizeof(id), NULL, NULL);
+}
+
+void IndexBuffer_AddEdge
+(
+	IndexBuffer *buff,
+	const Edge *e
+) {
+	ASSERT(buff != NULL);
+	ASSERT(e    != NULL);
+
+	EntityID id = ENTITY_GET_ID(e);
+
+	// edge already buffered
+	if(raxFind(buff->edges, (unsigned char *)&id, sizeof(id)) != raxNotFound) {
+		return;
+	}
+
+	Edge *copy = rm_malloc(sizeof(Edge));
+	*copy = *e;
+	raxInsert(buff->edges, (unsigned char *)&id, sizeof(id), copy, NULL);
+}
+
+bool IndexBuffer_IsEmpty
+(
+	const IndexBuffer *buff
+) {
+	ASSERT(buff != NULL);
+
+	return raxSize(buff->nodes) == 0 && raxSize(buff->edges) == 0;
+}
+
+void IndexBuffer_Clear
+(
+	IndexBuffer *buff
+) {
+	ASSERT(buff != NULL);
+
+	if(IndexBuffer_IsEmpty(buff)) return;
+
+	raxFree(buff->nodes);
+	raxFreeWithCallback(buff->edges, rm_free);
+
+	buff->nodes = raxNew();
+	buff->edges = raxNew();
+}
+
+void IndexBuffer_Free
+(
+	IndexBuffer *buff
+) {
+	ASSERT(buff != NULL);
+
+	raxFree(buff->nodes);
+	raxFreeWithCallback(buff->edges, rm_free);
+	rm_free(buff);
+}
@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
+
+// entities whose index entries are out of date
+// index maintenance is deferred to the end of a commit, at which point
+// buffered entities are introduced to their indices in bulk
+// an entity modified multiple times within a commit is buffered once
+// and indexed as it is once the commit completes
+typedef struct {
+	rax *nodes;  // node id -> NULL
+	rax *edges;  // edge id -> copy of the edge, holds its endpoints and relation
+} IndexBuffer;
+
+// create a new empty index buffer
+IndexBuffer *IndexBuffer_New(void);
+
+// buffer node for indexing
+void IndexBuffer_AddNode
+(
+	IndexBuffer *buff,
+	const Node *n
+);
+
+// buffer edge for indexing
+void IndexBuffer_AddEdge
+(
+	IndexBuffer *buff,
+	const Edge *e
+);
+
+// returns true if no entities are buffered
+bool IndexBuffer_IsEmpty
+(
+	const IndexBuffer *buff
+);
+
+// discard all buffered entities
+void IndexBuffer_Clear
+(
+	IndexBuffer *buff
+);
+
+void IndexBuffer_Free
+(
+	IndexBuffer *buff
+);
@@ -0,0 +1,169 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_construct.h"
+#include "../util/rmalloc.h"
+#include "../schema/schema.h"
+#include "../util/thpool/pools.h"
+
+extern void Index_Create(Index *idx);
+extern void populateEdgeIndex(Index *idx, Graph *g, NodeID min_row,
+		NodeID max_row);
+extern void populateNodeIndex(Index *idx, Graph *g, NodeID min_row,
+		NodeID max_row);
+extern void applyEdgeChanges(Index *idx, Graph *g);
+extern void applyNodeChanges(Index *idx, Graph *g);
+
+// background construction state
+typedef struct {
+	GraphContext *gc;    // graph holding the index
+	SchemaType t;        // indexed schema type
+	int label_id;        // indexed label / relationship-type
+	uint64_t build_id;   // construction carried out
+	NodeID cursor;       // next matrix row to populate
+} IndexConstructCtx;
+
+// locate the index under construction
+// returns NULL if index was dropped or reconstructed since
+static Index *_ConstructedIndex
+(
+	const IndexConstructCtx *ctx
+) {
+	Schema *s = GraphContext_GetSchemaByID(ctx->gc, ctx->label_id, ctx->t);
+	if(s == NULL) return NULL;
+
+	Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+	if(idx == NULL || idx->build_id != ctx->build_id) return NULL;
+
+	return idx;
+}
+
+// populate a single batch of rows and catch up with buffered changes
+// returns true once construction is done
+static bool _ConstructStep
+(
+	IndexConstructCtx *ctx
+) {
+	bool   done  =  true;
+	Graph  *g    =  ctx->gc->g;
+
+	Graph_AcquireReadLock(g);
+
+	// set policy after lock acquisition,
+	// avoid resetting policies between readers and writers
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+
+	// index dropped or reconstructed, abort
+	Index *idx = _ConstructedIndex(ctx);
+	if(idx == NULL) goto cleanup;
+
+	bool node = (idx->entity_type == GETYPE_NODE);
+	RG_Matrix m = node
+		? Graph_GetLabelMatrix(g, ctx->label_id)
+		: Graph_GetRelationMatrix(g, ctx->label_id, false);
+
+	GrB_Index nrows;
+	GrB_Info info = RG_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(ctx->cursor < nrows) {
+		NodeID max_row = ctx->cursor + INDEX_CONSTRUCT_BATCH_SIZE - 1;
+		if(max_row >= nrows) max_row = nrows - 1;
+
+		if(node) populateNodeIndex(idx, g, ctx->cursor, max_row);
+		else populateEdgeIndex(idx, g, ctx->cursor, max_row);
+
+		ctx->cursor = max_row + 1;
+	}
+
+	// entities are read as they are now, changes made to rows which were
+	// already populated are caught up with while those made to rows ahead
+	// of the cursor are applied twice, which is harmless
+	if(node) applyNodeChanges(idx, g);
+	else applyEdgeChanges(idx, g);
+
+	if(ctx->cursor < nrows) {
+		uint progress = (ctx->cursor * 100) / nrows;
+		__atomic_store_n(&idx->progress, progress, __ATOMIC_RELAXED);
+		done = false;
+	} else {
+		// writers are held off by the read lock, no change can slip in
+		// between draining the buffer and enabling the index
+		raxFree(idx->pending);
+		idx->pending = NULL;
+		__atomic_store_n(&idx->state, IDX_OPERATIONAL, __ATOMIC_RELEASE);
+	}
+
+cleanup:
+	Graph_ReleaseLock(g);
+	return done;
+}
+
+static void _Construct
+(
+	void *arg
+) {
+	IndexConstructCtx *ctx = arg;
+
+	while(!_ConstructStep(ctx)) {
+		// re-queue, letting pending queries run in between batches
+		// carry on within this thread if the queue is full
+		if(ThreadPools_AddWorkReader(_Construct, ctx) == 0) return;
+	}
+
+	GraphContext_DecreaseRefCount(ctx->gc);
+	rm_free(ctx);
+}
+
+void Index_ConstructAsync
+(
+	Index *idx,
+	GraphContext *gc
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(idx != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	Graph *g = gc->g;
+	bool node = (idx->entity_type == GETYPE_NODE);
+	uint64_t entity_count = node
+		? Graph_LabeledNodeCount(g, idx->label_id)
+		: Graph_RelationEdgeCount(g, idx->label_id);
+
+	// plans may already refer to an operational index
+	// keep it complete throughout its reconstruction
+	bool operational = (idx->idx != NULL && Index_Enabled(idx));
+
+	if(entity_count <= INDEX_CONSTRUCT_BATCH_SIZE || operational) {
+		Index_Construct(idx, g);
+		return;
+	}
+
+	// create an empty index, hidden from the planner until populated
+	Index_Create(idx);
+	idx->progress = 0;
+	idx->pending  = raxNew();
+	__atomic_store_n(&idx->state, IDX_UNDER_CONSTRUCTION, __ATOMIC_RELEASE);
+
+	IndexConstructCtx *ctx = rm_malloc(sizeof(IndexConstructCtx));
+
+	ctx->gc        =  gc;
+	ctx->t         =  node ? SCHEMA_NODE : SCHEMA_EDGE;
+	ctx->cursor    =  0;
+	ctx->label_id  =  idx->label_id;
+	ctx->build_id  =  idx->build_id;
+
+	// keep graph alive throughout construction
+	GraphContext_IncreaseRefCount(gc);
+
+	if(ThreadPools_AddWorkReader(_Construct, ctx) != 0) {
+		// failed to dispatch, populate inline
+		GraphContext_DecreaseRefCount(gc);
+		rm_free(ctx);
+		Index_Construct(idx, g);
+	}
+}
@@ -0,0 +1,29 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "index.h"
+#include "../graph/graphcontext.h"
+
+// constructs an exact-match index without holding the graph's write lock
+//
+// the index is populated by a reader thread in batches of
+// INDEX_CONSTRUCT_BATCH_SIZE matrix rows, the read lock is released
+// between batches allowing writers to make progress
+// changes made to indexed entities in the meantime are buffered
+// and applied by the builder, once all rows are scanned and the buffer is
+// drained the index becomes operational
+//
+// small labels and operational indices which gained a field are populated
+// inline, as are indices which can't be handed to a reader thread
+//
+// expects the caller to hold the graph's write lock
+void Index_ConstructAsync
+(
+	Index *idx,       // index to construct
+	GraphContext *gc  // graph holding the index
+);
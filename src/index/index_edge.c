@@ -13,15 +13,26 @@
 
 extern RSDoc *Index_IndexGraphEntity(Index *idx,const GraphEntity *e,
 		const void *key, size_t key_len, uint *doc_field_count);
+extern void Index_IndexOrdered(Index *idx, const GraphEntity *e,
+		const void *key);
+extern void Index_RemoveOrdered(Index *idx, const void *key);
+extern bool Index_BufferChange(Index *idx, const void *key, size_t key_len,
+		IndexChange change);
 
-void Index_IndexEdge
+static void _RemoveEdge
 (
 	Index *idx,
-	const Edge *e
+	const EdgeIndexKey *key
 ) {
-	ASSERT(idx  !=  NULL);
-	ASSERT(e    !=  NULL);
+	Index_RemoveOrdered(idx, key);
+	RediSearch_DeleteDocument(idx->idx, key, sizeof(EdgeIndexKey));
+}
 
+static void _IndexEdge
+(
+	Index *idx,
+	const Edge *e
+) {
 	RSIndex   *rsIdx   =  idx->idx;
 	EntityID  src_id   =  Edge_GetSrcNodeID(e);
 	EntityID  dest_id  =  Edge_GetDestNodeID(e);
@@ -30,6 +41,8 @@ void Index_IndexEdge
 	EdgeIndexKey key = {.src_id = src_id, .dest_id = dest_id, .edge_id = edge_id};
 	size_t key_len = sizeof(EdgeIndexKey);
 
+	Index_IndexOrdered(idx, (const GraphEntity *)e, (const void *)&key);
+
 	uint doc_field_count = 0;
 	RSDoc *doc = Index_IndexGraphEntity(
 			idx, (const GraphEntity *)e, (const void *)&key, key_len,
@@ -47,18 +60,44 @@ void Index_IndexEdge
 	} else {
 		// entity doesn't possess any attributes which are indexed
 		// remove entity from index and delete document
-		Index_RemoveEdge(idx, e);
+		_RemoveEdge(idx, &key);
 		RediSearch_FreeDocument(doc);
 	}
 }
 
+void Index_IndexEdge
+(
+	Index *idx,
+	const Edge *e
+) {
+	ASSERT(idx  !=  NULL);
+	ASSERT(e    !=  NULL);
+
+	EdgeIndexKey key = {
+		.src_id  = Edge_GetSrcNodeID(e),
+		.dest_id = Edge_GetDestNodeID(e),
+		.edge_id = ENTITY_GET_ID(e)
+	};
+
+	if(Index_BufferChange(idx, &key, sizeof(EdgeIndexKey),
+				IDX_CHANGE_UPDATE)) {
+		return;
+	}
+
+	_IndexEdge(idx, e);
+}
+
+// index edges whose source node resides within rows [min_row, max_row]
 void populateEdgeIndex
 (
 	Index *idx,
-	Graph *g
+	Graph *g,
+	NodeID min_row,
+	NodeID max_row
 ) {
 	ASSERT(idx != NULL);
 	ASSERT(g != NULL);
+	ASSERT(min_row <= max_row);
 
 	const RG_Matrix m = Graph_GetRelationMatrix(g, idx->label_id, false);
 	ASSERT(m != NULL);
@@ -66,6 +105,11 @@ void populateEdgeIndex
 	RG_MatrixTupleIter it = {0};
 	RG_MatrixTupleIter_attach(&it, m);
 
+	// use range only when a subset of the matrix is populated
+	if(min_row > 0 || max_row < UINT64_MAX) {
+		RG_MatrixTupleIter_iterate_range(&it, min_row, max_row);
+	}
+
 	// iterate over each graph entity
 	EntityID  src_id;
 	EntityID  dest_id;
@@ -78,12 +122,50 @@ void populateEdgeIndex
 		e.destNodeID  =  dest_id;
 
 		Graph_GetEdge(g, edge_id, &e);
-		Index_IndexEdge(idx, &e);
+		_IndexEdge(idx, &e);
 	}
 
 	RG_MatrixTupleIter_detach(&it);
 }
 
+// apply edge changes buffered during construction
+void applyEdgeChanges
+(
+	Index *idx,
+	Graph *g
+) {
+	ASSERT(g            != NULL);
+	ASSERT(idx          != NULL);
+	ASSERT(idx->pending != NULL);
+
+	raxIterator it;
+	raxStart(&it, idx->pending);
+	raxSeek(&it, "^", NULL, 0);
+
+	while(raxNext(&it)) {
+		EdgeIndexKey key;
+		memcpy(&key, it.key, sizeof(EdgeIndexKey));
+
+		// index edge as it is now
+		Edge e;
+		e.relationID  =  idx->label_id;
+		e.srcNodeID   =  key.src_id;
+		e.destNodeID  =  key.dest_id;
+
+		if((IndexChange)(uintptr_t)it.data == IDX_CHANGE_UPDATE &&
+		   Graph_GetEdge(g, key.edge_id, &e)) {
+			_IndexEdge(idx, &e);
+		} else {
+			_RemoveEdge(idx, &key);
+		}
+	}
+
+	raxStop(&it);
+
+	raxFree(idx->pending);
+	idx->pending = raxNew();
+}
+
 void Index_RemoveEdge
 (
 	Index *idx,    // index to update
@@ -97,7 +179,11 @@ void Index_RemoveEdge
 	EntityID  edge_id  =  ENTITY_GET_ID(e);
 
 	EdgeIndexKey key = {.src_id = src_id, .dest_id = dest_id, .edge_id = edge_id};
-	size_t key_len = sizeof(EdgeIndexKey);
-	RediSearch_DeleteDocument(idx->idx, &key, key_len);
+	if(Index_BufferChange(idx, &key, sizeof(EdgeIndexKey),
+				IDX_CHANGE_REMOVE)) {
+		return;
+	}
+
+	_RemoveEdge(idx, &key);
 }
 
@@ -13,20 +13,33 @@
 
 extern RSDoc *Index_IndexGraphEntity(Index *idx,const GraphEntity *e,
 		const void *key, size_t key_len, uint *doc_field_count);
+extern void Index_IndexOrdered(Index *idx, const GraphEntity *e,
+		const void *key);
+extern void Index_RemoveOrdered(Index *idx, const void *key);
+extern bool Index_BufferChange(Index *idx, const void *key, size_t key_len,
+		IndexChange change);
 
-void Index_IndexNode
+static void _RemoveNode
 (
 	Index *idx,
-	const Node *n
+	EntityID id
 ) {
-	ASSERT(idx  !=  NULL);
-	ASSERT(n    !=  NULL);
+	Index_RemoveOrdered(idx, &id);
+	RediSearch_DeleteDocument(idx->idx, &id, sizeof(EntityID));
+}
 
+static void _IndexNode
+(
+	Index *idx,
+	const Node *n
+) {
 	RSIndex   *rsIdx           =  idx->idx;
 	EntityID  key              =  ENTITY_GET_ID(n);
 	size_t    key_len          =  sizeof(EntityID);
 	uint      doc_field_count  =  0;
 
+	Index_IndexOrdered(idx, (const GraphEntity *)n, (const void *)&key);
+
 	RSDoc *doc = Index_IndexGraphEntity(
 			idx, (const GraphEntity *)n, (const void *)&key, key_len,
 			&doc_field_count);
@@ -36,18 +49,38 @@ void Index_IndexNode
 	} else {
 		// entity doesn't poses any attributes which are indexed
 		// remove entity from index and delete document
-		Index_RemoveNode(idx, n);
+		_RemoveNode(idx, key);
 		RediSearch_FreeDocument(doc);
 	}
 }
 
+void Index_IndexNode
+(
+	Index *idx,
+	const Node *n
+) {
+	ASSERT(idx  !=  NULL);
+	ASSERT(n    !=  NULL);
+
+	EntityID key = ENTITY_GET_ID(n);
+	if(Index_BufferChange(idx, &key, sizeof(EntityID), IDX_CHANGE_UPDATE)) {
+		return;
+	}
+
+	_IndexNode(idx, n);
+}
+
+// index labeled nodes within rows [min_row, max_row]
 void populateNodeIndex
 (
 	Index *idx,
-	Graph *g
+	Graph *g,
+	NodeID min_row,
+	NodeID max_row
 ) {
 	ASSERT(idx != NULL);
 	ASSERT(g != NULL);
+	ASSERT(min_row <= max_row);
 
 	const RG_Matrix m = Graph_GetLabelMatrix(g, idx->label_id);
 	ASSERT(m != NULL);
@@ -55,17 +88,56 @@ void populateNodeIndex
 	RG_MatrixTupleIter it = {0};
 	RG_MatrixTupleIter_attach(&it, m);
 
+	// use range only when a subset of the matrix is populated
+	if(min_row > 0 || max_row < UINT64_MAX) {
+		RG_MatrixTupleIter_iterate_range(&it, min_row, max_row);
+	}
+
 	// iterate over each graph entity
 	EntityID id;
 	while(RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) == GrB_SUCCESS) {
 		Node n;
 		Graph_GetNode(g, id, &n);
-		Index_IndexNode(idx, &n);
+		_IndexNode(idx, &n);
 	}
 
 	RG_MatrixTupleIter_detach(&it);
 }
 
+// apply node changes buffered during construction
+void applyNodeChanges
+(
+	Index *idx,
+	Graph *g
+) {
+	ASSERT(g            != NULL);
+	ASSERT(idx          != NULL);
+	ASSERT(idx->pending != NULL);
+
+	raxIterator it;
+	raxStart(&it, idx->pending);
+	raxSeek(&it, "^", NULL, 0);
+
+	while(raxNext(&it)) {
+		EntityID id;
+		memcpy(&id, it.key, sizeof(EntityID));
+
+		// index node as it is now
+		Node n;
+		if((IndexChange)(uintptr_t)it.data == IDX_CHANGE_UPDATE &&
+		   Graph_GetNode(g, id, &n)) {
+			_IndexNode(idx, &n);
+		} else {
+			_RemoveNode(idx, id);
+		}
+	}
+
+	raxStop(&it);
+
+	raxFree(idx->pending);
+	idx->pending = raxNew();
+}
+
 void Index_RemoveNode
 (
 	Index *idx,    // index to update
@@ -75,6 +147,10 @@ void Index_RemoveNode
 	ASSERT(idx != NULL);
 
 	EntityID id = ENTITY_GET_ID(n);
-	RediSearch_DeleteDocument(idx->idx, &id, sizeof(EntityID));
+	if(Index_BufferChange(idx, &id, sizeof(EntityID), IDX_CHANGE_REMOVE)) {
+		return;
+	}
+
+	_RemoveNode(idx, id);
 }
 
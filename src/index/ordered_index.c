@@ -0,0 +1,609 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "ordered_index.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+
+// values stored along an index entry
+typedef struct {
+	uint n;            // number of values
+	SIValue values[];  // indexed values
+} _StoredValues;
+
+static void _FreeStoredValues
+(
+	void *data
+) {
+	_StoredValues *stored = data;
+	for(uint i = 0; i < stored->n; i++) SIValue_Free(stored->values[i]);
+	rm_free(stored);
+}
+
+OrderedIndex *OrderedIndex_New
+(
+	size_t key_len
+) {
+	ASSERT(key_len > 0);
+
+	OrderedIndex *idx = rm_malloc(sizeof(OrderedIndex));
+
+	idx->tree      =  raxNew();
+	idx->entities  =  raxNew();
+	idx->key_len   =  key_len;
+	idx->members   =  false;
+	idx->version   =  0;
+
+	return idx;
+}
+
+OrderedIndex *OrderedIndex_NewMembers
+(
+	size_t key_len
+) {
+	OrderedIndex *idx = OrderedIndex_New(key_len);
+	idx->members = true;
+
+	return idx;
+}
+
+bool OrderedIndex_Indexable
+(
+	SIValue v
+) {
+	return (SI_TYPE(v) & SI_INDEXABLE);
+}
+
+void OrderedIndex_Insert
+(
+	OrderedIndex *idx,
+	SIValue v,
+	const void *key
+) {
+	OrderedIndex_InsertTuple(idx, &v, 1, key);
+}
+
+void OrderedIndex_InsertTuple
+(
+	OrderedIndex *idx,
+	const SIValue *values,
+	uint n,
+	const void *key
+) {
+	ASSERT(n      > 0);
+	ASSERT(idx    != NULL);
+	ASSERT(key    != NULL);
+	ASSERT(values != NULL);
+	ASSERT(!idx->members);
+
+	sds tree_key = sdsempty();
+	for(uint i = 0; i < n; i++) {
+		tree_key = SortKey_Append(tree_key, values[i], false);
+	}
+	tree_key = sdscatlen(tree_key, key, idx->key_len);
+
+	_StoredValues *stored = rm_malloc(sizeof(_StoredValues) +
+			sizeof(SIValue) * n);
+	stored->n = n;
+	for(uint i = 0; i < n; i++) stored->values[i] = SI_CloneValue(values[i]);
+
+	// entity already indexed, drop its previous entry
+	sds old = NULL;
+	if(raxInsert(idx->entities, (unsigned char *)key, idx->key_len, tree_key,
+				(void **)&old) == 0) {
+		_StoredValues *old_stored = NULL;
+		raxRemove(idx->tree, (unsigned char *)old, sdslen(old),
+				(void **)&old_stored);
+		_FreeStoredValues(old_stored);
+		sdsfree(old);
+	}
+
+	raxInsert(idx->tree, (unsigned char *)tree_key, sdslen(tree_key), stored,
+			NULL);
+
+	idx->version++;
+}
+
+void OrderedIndex_InsertMembers
+(
+	OrderedIndex *idx,
+	SIValue array,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+	ASSERT(idx->members);
+	ASSERT(SI_TYPE(array) == T_ARRAY);
+
+	// drop previously indexed elements
+	OrderedIndex_Remove(idx, key);
+
+	uint n = SIArray_Length(array);
+	sds *tree_keys = array_new(sds, n);
+
+	for(uint i = 0; i < n; i++) {
+		SIValue v = SIArray_Get(array, i);
+		if(!OrderedIndex_Indexable(v)) continue;
+
+		sds tree_key = SortKey_Append(sdsempty(), v, false);
+		tree_key = sdscatlen(tree_key, key, idx->key_len);
+
+		_StoredValues *stored = rm_malloc(sizeof(_StoredValues) +
+				sizeof(SIValue));
+		stored->n = 1;
+		stored->values[0] = SI_CloneValue(v);
+
+		// elements repeated within the array are indexed once
+		if(raxTryInsert(idx->tree, (unsigned char *)tree_key,
+					sdslen(tree_key), stored, NULL) == 0) {
+			_FreeStoredValues(stored);
+			sdsfree(tree_key);
+			continue;
+		}
+
+		array_append(tree_keys, tree_key);
+	}
+
+	if(array_len(tree_keys) == 0) {
+		array_free(tree_keys);
+		return;
+	}
+
+	raxInsert(idx->entities, (unsigned char *)key, idx->key_len, tree_keys,
+			NULL);
+
+	idx->version++;
+}
+
+void OrderedIndex_Remove
+(
+	OrderedIndex *idx,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	void *old = NULL;
+	if(!raxRemove(idx->entities, (unsigned char *)key, idx->key_len, &old)) {
+		return;
+	}
+
+	// a members index holds an entry per element
+	uint n = (idx->members) ? array_len((sds *)old) : 1;
+	sds *tree_keys = (idx->members) ? (sds *)old : (sds *)&old;
+	for(uint i = 0; i < n; i++) {
+		_StoredValues *stored = NULL;
+		raxRemove(idx->tree, (unsigned char *)tree_keys[i],
+				sdslen(tree_keys[i]), (void **)&stored);
+		_FreeStoredValues(stored);
+		sdsfree(tree_keys[i]);
+	}
+	if(idx->members) array_free(tree_keys);
+
+	idx->version++;
+}
+
+bool OrderedIndex_Contains
+(
+	const OrderedIndex *idx,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	return raxFind(idx->entities, (unsigned char *)key, idx->key_len) !=
+		raxNotFound;
+}
+
+const SIValue *OrderedIndex_Lookup
+(
+	const OrderedIndex *idx,
+	SIValue v,
+	void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	if(!OrderedIndex_Indexable(v)) return NULL;
+
+	sds value = SortKey_Append(sdsempty(), v, false);
+	size_t len = sdslen(value);
+
+	// entries holding 'v' are keyed by its sort key followed by an entity key
+	const SIValue *values = NULL;
+	raxIterator it;
+	raxStart(&it, idx->tree);
+	raxSeek(&it, ">=", (unsigned char *)value, len);
+	if(raxNext(&it) && it.key_len == len + idx->key_len &&
+	   memcmp(it.key, value, len) == 0) {
+		memcpy(key, it.key + len, idx->key_len);
+		values = ((const _StoredValues *)it.data)->values;
+	}
+	raxStop(&it);
+
+	sdsfree(value);
+	return values;
+}
+
+bool OrderedIndex_HasDuplicates
+(
+	const OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	// entries holding the same value are adjacent
+	bool dup   = false;
+	bool first = true;
+	sds  prev  = sdsempty();
+
+	raxIterator it;
+	raxStart(&it, idx->tree);
+	raxSeek(&it, "^", NULL, 0);
+	while(!dup && raxNext(&it)) {
+		// entries which can't be looked up never conflict
+		const _StoredValues *stored = it.data;
+		if(!OrderedIndex_Indexable(stored->values[0])) continue;
+
+		size_t len = it.key_len - idx->key_len;
+		dup = (!first && sdslen(prev) == len && memcmp(prev, it.key, len) == 0);
+
+		sdsclear(prev);
+		prev  = sdscatlen(prev, it.key, len);
+		first = false;
+	}
+	raxStop(&it);
+
+	sdsfree(prev);
+	return dup;
+}
+
+uint64_t OrderedIndex_Count
+(
+	const OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	return raxSize(idx->entities);
+}
+
+static void _FreeTreeKey
+(
+	void *key
+) {
+	sdsfree(key);
+}
+
+static void _FreeTreeKeys
+(
+	void *keys
+) {
+	sds *tree_keys = keys;
+	uint n = array_len(tree_keys);
+	for(uint i = 0; i < n; i++) sdsfree(tree_keys[i]);
+	array_free(tree_keys);
+}
+
+void OrderedIndex_Free
+(
+	OrderedIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	raxFreeWithCallback(idx->tree, _FreeStoredValues);
+	raxFreeWithCallback(idx->entities,
+			(idx->members) ? _FreeTreeKeys : _FreeTreeKey);
+	rm_free(idx);
+}
+
+//------------------------------------------------------------------------------
+// ranges
+//------------------------------------------------------------------------------
+
+OrderedRange OrderedRange_New
+(
+	SIType t,
+	SIValue min,
+	bool include_min,
+	SIValue max,
+	bool include_max
+) {
+	OrderedRange range;
+
+	if(SIValue_IsNull(min)) {
+		range.min = SortKey_AppendTypeBound(sdsempty(), t, false);
+		range.include_min = true;
+	} else {
+		ASSERT(SI_TYPE(min) & t);
+		range.min = SortKey_Append(sdsempty(), min, false);
+		range.include_min = include_min;
+	}
+
+	if(SIValue_IsNull(max)) {
+		range.max = SortKey_AppendTypeBound(sdsempty(), t, true);
+		range.include_max = false;
+	} else {
+		ASSERT(SI_TYPE(max) & t);
+		range.max = SortKey_Append(sdsempty(), max, false);
+		range.include_max = include_max;
+	}
+
+	return range;
+}
+
+OrderedRange OrderedRange_NewPrefix
+(
+	const SIValue *prefix,
+	uint prefix_len,
+	SIType t,
+	SIValue min,
+	bool include_min,
+	SIValue max,
+	bool include_max
+) {
+	ASSERT(prefix != NULL || prefix_len == 0);
+
+	sds p = sdsempty();
+	for(uint i = 0; i < prefix_len; i++) {
+		p = SortKey_Append(p, prefix[i], false);
+	}
+
+	// encodings never open with 0xFF, it orders after every tuple
+	// continuing 'p'
+	static const unsigned char last = 0xFF;
+
+	OrderedRange range;
+	if(t == T_NULL) {
+		range.min          =  p;
+		range.max          =  sdscatlen(sdsdup(p), &last, 1);
+		range.include_min  =  true;
+		range.include_max  =  false;
+		return range;
+	}
+
+	OrderedRange r = OrderedRange_New(t, min, include_min, max, include_max);
+
+	range.min          =  sdscatsds(sdsdup(p), r.min);
+	range.max          =  sdscatsds(p, r.max);
+	range.include_min  =  r.include_min;
+	range.include_max  =  r.include_max;
+
+	// tuples may continue past the ranged value
+	// an inclusive upper bound must order after any such continuation
+	if(range.include_max) {
+		range.max = sdscatlen(range.max, &last, 1);
+		range.include_max = false;
+	}
+
+	OrderedRange_Free(&r);
+	return range;
+}
+
+OrderedRange OrderedRange_NewStringPrefix
+(
+	const char *prefix
+) {
+	ASSERT(prefix != NULL);
+
+	// strings are encoded as their bytes followed by a terminating null
+	// utf-8 never holds 0xFF, it orders after every string opening with prefix
+	static const unsigned char last = 0xFF;
+
+	OrderedRange range;
+	range.min          =  SortKey_AppendTypeBound(sdsempty(), T_STRING, false);
+	range.min          =  sdscat(range.min, prefix);
+	range.max          =  sdscatlen(sdsdup(range.min), &last, 1);
+	range.include_min  =  true;
+	range.include_max  =  false;
+
+	return range;
+}
+
+void OrderedRange_Free
+(
+	OrderedRange *range
+) {
+	ASSERT(range != NULL);
+
+	sdsfree(range->min);
+	sdsfree(range->max);
+}
+
+//------------------------------------------------------------------------------
+// iterator
+//------------------------------------------------------------------------------
+
+OrderedIndexIterator *OrderedIndexIterator_New
+(
+	const OrderedIndex *idx,
+	OrderedRange *ranges
+) {
+	ASSERT(idx    != NULL);
+	ASSERT(ranges != NULL);
+
+	OrderedIndexIterator *it = rm_malloc(sizeof(OrderedIndexIterator));
+
+	it->idx        =  idx;
+	it->ranges     =  ranges;
+	it->range_idx  =  0;
+	it->reverse    =  false;
+	it->seeked     =  false;
+	it->version    =  idx->version;
+
+	raxStart(&it->it, idx->tree);
+
+	return it;
+}
+
+void OrderedIndexIterator_Reverse
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+	ASSERT(it->range_idx == 0 && !it->seeked);
+
+	it->reverse = true;
+}
+
+// position iterator at the first entry of 'range'
+static void _SeekMin
+(
+	OrderedIndexIterator *it,
+	const OrderedRange *range
+) {
+	size_t key_len = it->idx->key_len;
+
+	if(range->include_min) {
+		raxSeek(&it->it, ">=", (unsigned char *)range->min,
+				sdslen(range->min));
+	} else {
+		// entity keys follow the indexed value
+		// skip past the greatest possible entity key holding 'min'
+		size_t len = sdslen(range->min);
+		unsigned char bound[len + key_len];
+		memcpy(bound, range->min, len);
+		memset(bound + len, 0xFF, key_len);
+		raxSeek(&it->it, ">", bound, len + key_len);
+	}
+
+	it->seeked  = true;
+	it->version = it->idx->version;
+}
+
+// position iterator at the last entry of 'range'
+static void _SeekMax
+(
+	OrderedIndexIterator *it,
+	const OrderedRange *range
+) {
+	size_t key_len = it->idx->key_len;
+
+	if(range->include_max) {
+		// entity keys follow the indexed value
+		// seek to the greatest possible entity key holding 'max'
+		size_t len = sdslen(range->max);
+		unsigned char bound[len + key_len];
+		memcpy(bound, range->max, len);
+		memset(bound + len, 0xFF, key_len);
+		raxSeek(&it->it, "<=", bound, len + key_len);
+	} else {
+		raxSeek(&it->it, "<", (unsigned char *)range->max,
+				sdslen(range->max));
+	}
+
+	it->seeked  = true;
+	it->version = it->idx->version;
+}
+
+// returns true if 'value' is within range's upper bound
+static bool _WithinMax
+(
+	const OrderedRange *range,
+	const unsigned char *value,
+	size_t len
+) {
+	size_t max_len = sdslen(range->max);
+	int rel = memcmp(value, range->max, (len < max_len) ? len : max_len);
+	if(rel == 0) rel = (len > max_len) - (len < max_len);
+
+	return (rel < 0 || (rel == 0 && range->include_max));
+}
+
+// returns true if 'value' is within range's lower bound
+static bool _WithinMin
+(
+	const OrderedRange *range,
+	const unsigned char *value,
+	size_t len
+) {
+	size_t min_len = sdslen(range->min);
+	int rel = memcmp(value, range->min, (len < min_len) ? len : min_len);
+	if(rel != 0) return rel > 0;
+
+	// value opens with 'min'
+	return (len >= min_len && range->include_min);
+}
+
+const void *OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	const OrderedIndex *idx = it->idx;
+	uint range_count = array_len(it->ranges);
+
+	while(it->range_idx < range_count) {
+		uint i = (it->reverse) ? range_count - 1 - it->range_idx : it->range_idx;
+		OrderedRange *range = it->ranges + i;
+
+		if(!it->seeked) {
+			if(it->reverse) _SeekMax(it, range);
+			else _SeekMin(it, range);
+		} else if(it->version != idx->version) {
+			// index modified since last call
+			// reposition right past the last returned entry
+			size_t len = it->it.key_len;
+			unsigned char last[len];
+			memcpy(last, it->it.key, len);
+			raxSeek(&it->it, (it->reverse) ? "<" : ">", last, len);
+			it->version = idx->version;
+		}
+
+		int found = (it->reverse) ? raxPrev(&it->it) : raxNext(&it->it);
+		if(found) {
+			size_t value_len = it->it.key_len - idx->key_len;
+			bool within = (it->reverse) ?
+				_WithinMin(range, it->it.key, value_len) :
+				_WithinMax(range, it->it.key, value_len);
+			if(within) return it->it.key + value_len;
+		}
+
+		// range depleted, advance to next range
+		it->range_idx++;
+		it->seeked = false;
+	}
+
+	return NULL;
+}
+
+const SIValue *OrderedIndexIterator_Values
+(
+	const OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+	ASSERT(it->it.data != NULL);
+
+	return ((const _StoredValues *)it->it.data)->values;
+}
+
+void OrderedIndexIterator_Reset
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	it->range_idx = 0;
+	it->seeked    = false;
+}
+
+void OrderedIndexIterator_Free
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	uint range_count = array_len(it->ranges);
+	for(uint i = 0; i < range_count; i++) {
+		OrderedRange_Free(it->ranges + i);
+	}
+	array_free(it->ranges);
+
+	raxStop(&it->it);
+	rm_free(it);
+}
+
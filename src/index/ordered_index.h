@@ -0,0 +1,224 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+#include "../util/sort_key.h"
+
+// native ordered index over a single attribute or a tuple of attributes
+// entries are kept in a radix tree keyed by the sort key of the indexed value
+// followed by the key of the entity holding it, such that entries are
+// ordered by value and lookups for equality and ranges are a seek away
+//
+// only numerics, booleans and strings are looked up by a single attribute index
+// other values, nulls included, are kept in order under their own type
+// such that a scan over the entire index produces every indexed entity in order
+// tuples are ordered attribute by attribute, as such a tuple index resolves
+// equality on a prefix of its attributes followed by a range on the next one
+//
+// indexed values are stored along each entry, such that scans can produce
+// them without accessing the indexed entity
+//
+// a members index holds an entry for each distinct element of an indexed
+// array, an entity is produced once by a scan over a single element
+typedef struct {
+	rax *tree;         // sort key followed by entity key -> stored values
+	rax *entities;     // entity key -> tree key(s), locates stale entries
+	size_t key_len;    // entity key length
+	bool members;      // entities are indexed under each of their elements
+	uint64_t version;  // incremented on every modification
+} OrderedIndex;
+
+// range of indexed values
+typedef struct {
+	sds min;           // lower bound sort key
+	sds max;           // upper bound sort key
+	bool include_min;  // lower bound is inclusive
+	bool include_max;  // upper bound is inclusive
+} OrderedRange;
+
+// iterates over entities within a set of ranges
+typedef struct {
+	const OrderedIndex *idx;  // iterated index
+	OrderedRange *ranges;     // ranges to scan, ascending and disjoint
+	uint range_idx;           // number of ranges depleted
+	bool reverse;             // iterate in descending order
+	bool seeked;              // current range been positioned
+	uint64_t version;         // index version iterator was positioned at
+	raxIterator it;           // position within current range
+} OrderedIndexIterator;
+
+// create a new ordered index
+OrderedIndex *OrderedIndex_New
+(
+	size_t key_len  // entity key length
+);
+
+// create a new members index
+OrderedIndex *OrderedIndex_NewMembers
+(
+	size_t key_len  // entity key length
+);
+
+// returns true if 'v' can be indexed
+bool OrderedIndex_Indexable
+(
+	SIValue v
+);
+
+// index entity 'key' under value 'v'
+// replaces any previous value indexed for 'key'
+// values which can't be looked up are only produced by scans
+// over the entire index
+void OrderedIndex_Insert
+(
+	OrderedIndex *idx,  // index to update
+	SIValue v,          // indexed value
+	const void *key     // entity key
+);
+
+// index entity 'key' under the tuple 'values'
+// replaces any previous tuple indexed for 'key'
+void OrderedIndex_InsertTuple
+(
+	OrderedIndex *idx,     // index to update
+	const SIValue *values, // indexed tuple
+	uint n,                // tuple length
+	const void *key        // entity key
+);
+
+// index entity 'key' under each distinct indexable element of 'array'
+// replaces any previous elements indexed for 'key'
+void OrderedIndex_InsertMembers
+(
+	OrderedIndex *idx,  // members index to update
+	SIValue array,      // indexed array
+	const void *key     // entity key
+);
+
+// remove entity 'key' from index
+void OrderedIndex_Remove
+(
+	OrderedIndex *idx,  // index to update
+	const void *key     // entity key
+);
+
+// returns true if entity 'key' is indexed
+bool OrderedIndex_Contains
+(
+	const OrderedIndex *idx,  // index to inspect
+	const void *key           // entity key
+);
+
+// looks up an entity indexed under value 'v'
+// returns the values stored along its entry and sets 'key' to its key
+// returns NULL if no entity is indexed under 'v'
+const SIValue *OrderedIndex_Lookup
+(
+	const OrderedIndex *idx,  // index to inspect
+	SIValue v,                // looked up value
+	void *key                 // [output] entity key
+);
+
+// returns true if two or more entities are indexed under the same value
+// values which can't be looked up are ignored
+bool OrderedIndex_HasDuplicates
+(
+	const OrderedIndex *idx  // index to inspect
+);
+
+// returns number of indexed entities
+uint64_t OrderedIndex_Count
+(
+	const OrderedIndex *idx
+);
+
+// free ordered index
+void OrderedIndex_Free
+(
+	OrderedIndex *idx
+);
+
+// create a range holding values of type 't'
+// which are bounded by 'min' and 'max', a null bound leaves range open
+// within 't'
+OrderedRange OrderedRange_New
+(
+	SIType t,          // type of ranged values
+	SIValue min,       // lower bound
+	bool include_min,  // lower bound is inclusive
+	SIValue max,       // upper bound
+	bool include_max   // upper bound is inclusive
+);
+
+// create a range over tuples opening with 'prefix'
+// whose following value is of type 't' and bounded by 'min' and 'max'
+// 't' is T_NULL when the range is bounded by the prefix alone
+OrderedRange OrderedRange_NewPrefix
+(
+	const SIValue *prefix,  // leading tuple values
+	uint prefix_len,        // number of leading values
+	SIType t,               // type of ranged values
+	SIValue min,            // lower bound
+	bool include_min,       // lower bound is inclusive
+	SIValue max,            // upper bound
+	bool include_max        // upper bound is inclusive
+);
+
+// create a range holding the strings opening with 'prefix'
+OrderedRange OrderedRange_NewStringPrefix
+(
+	const char *prefix  // string prefix
+);
+
+// free range
+void OrderedRange_Free
+(
+	OrderedRange *range
+);
+
+// create an iterator over 'ranges'
+// iterator takes ownership of 'ranges', an array of ascending disjoint ranges
+OrderedIndexIterator *OrderedIndexIterator_New
+(
+	const OrderedIndex *idx,  // index to iterate
+	OrderedRange *ranges      // ranges to iterate over
+);
+
+// iterate in descending order
+// must be called before the first call to OrderedIndexIterator_Next
+void OrderedIndexIterator_Reverse
+(
+	OrderedIndexIterator *it
+);
+
+// returns the next entity key, NULL once iterator is depleted
+const void *OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it
+);
+
+// returns the values indexed for the last entity returned by the iterator
+// valid until the next call to OrderedIndexIterator_Next
+const SIValue *OrderedIndexIterator_Values
+(
+	const OrderedIndexIterator *it
+);
+
+// restart iteration
+void OrderedIndexIterator_Reset
+(
+	OrderedIndexIterator *it
+);
+
+// free iterator
+void OrderedIndexIterator_Free
+(
+	OrderedIndexIterator *it
+);
+
@@ -0,0 +1,584 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "spatial_index.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/point.h"
+#include <math.h>
+
+// bits per coordinate of a geohash
+#define GEOHASH_BITS 32
+
+// finest grid scanned, cells of roughly 0.6 meters
+#define GEOHASH_MAX_STEP 26
+
+// length of an encoded geohash
+#define GEOHASH_LEN sizeof(uint64_t)
+
+// radius of the first nearest neighbour round, in meters
+#define NEAREST_INITIAL_RADIUS 1000.0
+
+// growth of the radius between nearest neighbour rounds
+#define NEAREST_RADIUS_GROWTH 4.0
+
+// widen scanned boxes to absorb floating point error of distance computations
+#define RADIUS_MARGIN(r) ((r) * 1.001 + 1.0)
+
+// the indexed point is stored as the value of its entry
+_Static_assert(sizeof(void *) >= 2 * sizeof(float),
+		"pointer can't hold a packed point");
+
+//------------------------------------------------------------------------------
+// geohash
+//------------------------------------------------------------------------------
+
+// spread the bits of 'x' such that a zero bit separates every two bits
+static inline uint64_t _Spread
+(
+	uint32_t x
+) {
+	uint64_t v = x;
+	v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+	v = (v | (v << 8))  & 0x00FF00FF00FF00FFULL;
+	v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+	v = (v | (v << 2))  & 0x3333333333333333ULL;
+	v = (v | (v << 1))  & 0x5555555555555555ULL;
+	return v;
+}
+
+// interleave quantized coordinates, longitude bits lead
+static inline uint64_t _Interleave
+(
+	uint32_t lat,
+	uint32_t lon
+) {
+	return (_Spread(lon) << 1) | _Spread(lat);
+}
+
+// map 'v' within [min, max] to a 32 bit cell coordinate
+static inline uint32_t _Quantize
+(
+	double v,
+	double min,
+	double max
+) {
+	double f = (v - min) / (max - min);
+	if(f <= 0) return 0;
+	if(f >= 1) return UINT32_MAX;
+	return (uint32_t)(f * 4294967296.0);
+}
+
+static inline uint64_t _Geohash
+(
+	float lat,
+	float lon
+) {
+	return _Interleave(_Quantize(lat, -90, 90), _Quantize(lon, -180, 180));
+}
+
+// encode geohash such that keys order by geohash
+static inline void _EncodeGeohash
+(
+	unsigned char *buf,
+	uint64_t hash
+) {
+	for(int i = GEOHASH_LEN - 1; i >= 0; i--) {
+		buf[i] = hash & 0xFF;
+		hash >>= 8;
+	}
+}
+
+static inline uint64_t _DecodeGeohash
+(
+	const unsigned char *buf
+) {
+	uint64_t hash = 0;
+	for(uint i = 0; i < GEOHASH_LEN; i++) hash = (hash << 8) | buf[i];
+	return hash;
+}
+
+static inline void *_PackPoint
+(
+	SIValue p
+) {
+	float coords[2] = {Point_lat(p), Point_lon(p)};
+	uintptr_t packed = 0;
+	memcpy(&packed, coords, sizeof(coords));
+	return (void *)packed;
+}
+
+static inline SIValue _UnpackPoint
+(
+	void *data
+) {
+	float coords[2];
+	uintptr_t packed = (uintptr_t)data;
+	memcpy(coords, &packed, sizeof(coords));
+	return SI_Point(coords[0], coords[1]);
+}
+
+//------------------------------------------------------------------------------
+// index
+//------------------------------------------------------------------------------
+
+SpatialIndex *SpatialIndex_New
+(
+	size_t key_len
+) {
+	ASSERT(key_len > 0);
+
+	SpatialIndex *idx = rm_malloc(sizeof(SpatialIndex));
+
+	idx->tree      =  raxNew();
+	idx->entities  =  raxNew();
+	idx->key_len   =  key_len;
+
+	return idx;
+}
+
+void SpatialIndex_Insert
+(
+	SpatialIndex *idx,
+	SIValue p,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+	ASSERT(SI_TYPE(p) == T_POINT);
+
+	// entity already indexed, drop its previous entry
+	SpatialIndex_Remove(idx, key);
+
+	uint64_t hash = _Geohash(Point_lat(p), Point_lon(p));
+	size_t len = GEOHASH_LEN + idx->key_len;
+	unsigned char tree_key[len];
+	_EncodeGeohash(tree_key, hash);
+	memcpy(tree_key + GEOHASH_LEN, key, idx->key_len);
+
+	raxInsert(idx->tree, tree_key, len, _PackPoint(p), NULL);
+	raxInsert(idx->entities, (unsigned char *)key, idx->key_len,
+			(void *)(uintptr_t)hash, NULL);
+}
+
+void SpatialIndex_Remove
+(
+	SpatialIndex *idx,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	void *hash;
+	if(!raxRemove(idx->entities, (unsigned char *)key, idx->key_len, &hash)) {
+		return;
+	}
+
+	size_t len = GEOHASH_LEN + idx->key_len;
+	unsigned char tree_key[len];
+	_EncodeGeohash(tree_key, (uint64_t)(uintptr_t)hash);
+	memcpy(tree_key + GEOHASH_LEN, key, idx->key_len);
+
+	raxRemove(idx->tree, tree_key, len, NULL);
+}
+
+bool SpatialIndex_Contains
+(
+	const SpatialIndex *idx,
+	const void *key
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	return raxFind(idx->entities, (unsigned char *)key, idx->key_len) !=
+		raxNotFound;
+}
+
+uint64_t SpatialIndex_Count
+(
+	const SpatialIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	return raxSize(idx->entities);
+}
+
+void SpatialIndex_Free
+(
+	SpatialIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	raxFree(idx->tree);
+	raxFree(idx->entities);
+	rm_free(idx);
+}
+
+//------------------------------------------------------------------------------
+// bounding boxes
+//------------------------------------------------------------------------------
+
+static const SpatialBox WORLD = {-90, 90, -180, 180};
+
+// split a box crossing the antimeridian into two
+// returns number of boxes
+static uint _SplitBox
+(
+	SpatialBox box,
+	SpatialBox *boxes
+) {
+	if(box.min_lon < -180) box.min_lon += 360;
+	if(box.max_lon > 180)  box.max_lon -= 360;
+
+	if(box.min_lon <= box.max_lon) {
+		boxes[0] = box;
+		return 1;
+	}
+
+	boxes[0] = box;
+	boxes[1] = box;
+	boxes[0].max_lon = 180;
+	boxes[1].min_lon = -180;
+	return 2;
+}
+
+// compute the boxes bounding all points within 'radius' meters from 'origin'
+// returns number of boxes
+static uint _RadiusBoxes
+(
+	SIValue origin,
+	double radius,
+	SpatialBox *boxes
+) {
+	double lat   = Point_lat(origin);
+	double lon   = Point_lon(origin);
+	double angle = radius / EARTH_RADIUS;  // angular radius
+	double dlat  = angle * 180.0 / M_PI;
+
+	SpatialBox box = {lat - dlat, lat + dlat, -180, 180};
+
+	// circle contains a pole, all longitudes are covered
+	if(box.min_lat <= -90 || box.max_lat >= 90) {
+		if(box.min_lat < -90) box.min_lat = -90;
+		if(box.max_lat > 90)  box.max_lat = 90;
+		boxes[0] = box;
+		return 1;
+	}
+
+	// widest longitude deviation is reached at the circle's tangent points
+	double s = sin(angle) / cos(lat * M_PI / 180.0);
+	if(s >= 1) {
+		boxes[0] = box;
+		return 1;
+	}
+
+	double dlon = asin(s) * 180.0 / M_PI;
+	box.min_lon = lon - dlon;
+	box.max_lon = lon + dlon;
+	return _SplitBox(box, boxes);
+}
+
+// pick the grid step scanned for 'box'
+// cells are at least half as wide as the box, such that the box
+// intersects no more than three cells along each coordinate
+static uint _Step
+(
+	const SpatialBox *box
+) {
+	double lat_span = box->max_lat - box->min_lat;
+	double lon_span = box->max_lon - box->min_lon;
+
+	int lat_step = (lat_span > 0) ? (int)floor(log2(180.0 / lat_span)) + 1 :
+		GEOHASH_MAX_STEP;
+	int lon_step = (lon_span > 0) ? (int)floor(log2(360.0 / lon_span)) + 1 :
+		GEOHASH_MAX_STEP;
+
+	int step = (lat_step < lon_step) ? lat_step : lon_step;
+	if(step < 1) step = 1;
+	if(step > GEOHASH_MAX_STEP) step = GEOHASH_MAX_STEP;
+	return step;
+}
+
+//------------------------------------------------------------------------------
+// iterator
+//------------------------------------------------------------------------------
+
+static SpatialIndexIterator *_Iterator_New
+(
+	const SpatialIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	SpatialIndexIterator *it = rm_calloc(1, sizeof(SpatialIndexIterator));
+
+	it->idx       =  idx;
+	it->origin    =  SI_NullVal();
+	it->radius    =  -1;
+	it->covered   =  -1;
+
+	return it;
+}
+
+// collect entity 'key'
+static void _Collect
+(
+	SpatialIndexIterator *it,
+	const unsigned char *key
+) {
+	size_t key_len = it->idx->key_len;
+	if(it->count == it->cap) {
+		it->cap  = (it->cap == 0) ? 16 : it->cap * 2;
+		it->keys = rm_realloc(it->keys, it->cap * key_len);
+	}
+
+	memcpy(it->keys + it->count * key_len, key, key_len);
+	it->count++;
+}
+
+// collect entities within 'box' whose distance from the iterator's origin
+// is within (min_dist, max_dist], a negative bound is ignored
+// distances of collected entities are appended to 'distances' if provided
+static void _CollectBox
+(
+	SpatialIndexIterator *it,
+	const SpatialBox *box,
+	double min_dist,
+	double max_dist,
+	double **distances
+) {
+	const SpatialIndex *idx = it->idx;
+	uint step  = _Step(box);
+	uint shift = GEOHASH_BITS - step;
+
+	// cells intersecting box
+	uint32_t min_lat = _Quantize(box->min_lat, -90, 90) >> shift;
+	uint32_t max_lat = _Quantize(box->max_lat, -90, 90) >> shift;
+	uint32_t min_lon = _Quantize(box->min_lon, -180, 180) >> shift;
+	uint32_t max_lon = _Quantize(box->max_lon, -180, 180) >> shift;
+
+	raxIterator rax_it;
+	raxStart(&rax_it, idx->tree);
+
+	for(uint32_t lat = min_lat; lat <= max_lat; lat++) {
+		for(uint32_t lon = min_lon; lon <= max_lon; lon++) {
+			// cell spans a contiguous range of geohashes
+			uint64_t first = _Interleave(lat, lon) << (2 * shift);
+			uint64_t last  = first + ((1ULL << (2 * shift)) - 1);
+
+			unsigned char seek[GEOHASH_LEN];
+			_EncodeGeohash(seek, first);
+			raxSeek(&rax_it, ">=", seek, GEOHASH_LEN);
+
+			while(raxNext(&rax_it)) {
+				if(_DecodeGeohash(rax_it.key) > last) break;
+
+				SIValue p = _UnpackPoint(rax_it.data);
+				double p_lat = Point_lat(p);
+				double p_lon = Point_lon(p);
+				if(p_lat < box->min_lat || p_lat > box->max_lat ||
+				   p_lon < box->min_lon || p_lon > box->max_lon) {
+					continue;
+				}
+
+				double d = 0;
+				if(SI_TYPE(it->origin) == T_POINT) {
+					d = Point_Distance(it->origin, p);
+					if(min_dist >= 0 && d <= min_dist) continue;
+					if(max_dist >= 0 && d > max_dist) continue;
+				}
+
+				_Collect(it, rax_it.key + GEOHASH_LEN);
+				if(distances != NULL) array_append(*distances, d);
+			}
+		}
+	}
+
+	raxStop(&rax_it);
+}
+
+// collected entity paired with its distance from origin
+typedef struct {
+	double distance;
+	uint pos;
+} _Neighbour;
+
+#define NEIGHBOUR_ISLT(a, b) ((a)->distance < (b)->distance)
+
+// collect the next round of nearest neighbours
+// ordered by ascending distance from origin
+static void _CollectNearest
+(
+	SpatialIndexIterator *it
+) {
+	size_t key_len = it->idx->key_len;
+	it->collected += it->count;
+	it->count = 0;
+	it->pos   = 0;
+
+	// every entity been collected
+	if(it->collected >= SpatialIndex_Count(it->idx)) {
+		it->covered = INFINITY;
+		return;
+	}
+
+	double radius = (it->covered < 0) ? NEAREST_INITIAL_RADIUS :
+		it->covered * NEAREST_RADIUS_GROWTH;
+
+	SpatialBox boxes[2];
+	uint box_count = 1;
+	double max_dist = radius;
+
+	if(radius >= M_PI * EARTH_RADIUS) {
+		// final round covers the entire globe
+		boxes[0] = WORLD;
+		max_dist = -1;
+		radius = INFINITY;
+	} else {
+		box_count = _RadiusBoxes(it->origin, RADIUS_MARGIN(radius), boxes);
+	}
+
+	double *distances = array_new(double, 0);
+	for(uint i = 0; i < box_count; i++) {
+		_CollectBox(it, boxes + i, it->covered, max_dist, &distances);
+	}
+	it->covered = radius;
+
+	// order round by distance
+	uint n = it->count;
+	if(n == 0) {
+		array_free(distances);
+		return;
+	}
+
+	_Neighbour *neighbours = rm_malloc(sizeof(_Neighbour) * n);
+	for(uint i = 0; i < n; i++) {
+		neighbours[i].distance = distances[i];
+		neighbours[i].pos = i;
+	}
+	QSORT(_Neighbour, neighbours, n, NEIGHBOUR_ISLT);
+
+	unsigned char *keys = rm_malloc(n * key_len);
+	for(uint i = 0; i < n; i++) {
+		memcpy(keys + i * key_len, it->keys + neighbours[i].pos * key_len,
+				key_len);
+	}
+
+	rm_free(it->keys);
+	it->keys = keys;
+	it->cap  = n;
+
+	rm_free(neighbours);
+	array_free(distances);
+}
+
+// collect matching entities
+static void _Position
+(
+	SpatialIndexIterator *it
+) {
+	it->count      = 0;
+	it->pos        = 0;
+	it->positioned = true;
+
+	if(it->nearest) {
+		it->covered   = -1;
+		it->collected = 0;
+		_CollectNearest(it);
+		return;
+	}
+
+	double max_dist = (it->radius < 0) ? -1 : RADIUS_MARGIN(it->radius);
+	for(uint i = 0; i < it->box_count; i++) {
+		_CollectBox(it, it->boxes + i, -1, max_dist, NULL);
+	}
+}
+
+SpatialIndexIterator *SpatialIndexIterator_NewBox
+(
+	const SpatialIndex *idx,
+	SpatialBox box
+) {
+	SpatialIndexIterator *it = _Iterator_New(idx);
+	it->box_count = _SplitBox(box, it->boxes);
+	return it;
+}
+
+SpatialIndexIterator *SpatialIndexIterator_NewRadius
+(
+	const SpatialIndex *idx,
+	SIValue origin,
+	double radius
+) {
+	ASSERT(SI_TYPE(origin) == T_POINT);
+
+	SpatialIndexIterator *it = _Iterator_New(idx);
+	it->origin = origin;
+	it->radius = (radius < 0) ? 0 : radius;
+
+	if(it->radius / EARTH_RADIUS >= M_PI) {
+		it->boxes[0]  = WORLD;
+		it->box_count = 1;
+	} else {
+		it->box_count = _RadiusBoxes(origin, RADIUS_MARGIN(it->radius),
+				it->boxes);
+	}
+
+	return it;
+}
+
+SpatialIndexIterator *SpatialIndexIterator_NewNearest
+(
+	const SpatialIndex *idx,
+	SIValue origin
+) {
+	ASSERT(SI_TYPE(origin) == T_POINT);
+
+	SpatialIndexIterator *it = _Iterator_New(idx);
+	it->origin  = origin;
+	it->nearest = true;
+
+	return it;
+}
+
+const void *SpatialIndexIterator_Next
+(
+	SpatialIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	if(!it->positioned) _Position(it);
+
+	// advance to the next nearest neighbour round
+	while(it->pos == it->count && it->nearest && it->covered != INFINITY) {
+		_CollectNearest(it);
+	}
+
+	if(it->pos == it->count) return NULL;
+
+	return it->keys + (it->pos++) * it->idx->key_len;
+}
+
+void SpatialIndexIterator_Reset
+(
+	SpatialIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	// entities are recollected, reflecting changes made to the index
+	it->positioned = false;
+}
+
+void SpatialIndexIterator_Free
+(
+	SpatialIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	if(it->keys != NULL) rm_free(it->keys);
+	rm_free(it);
+}
@@ -0,0 +1,132 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+
+// native spatial index over point values
+// points are placed on a geohash grid, each point is keyed by the interleaved
+// bits of its quantized longitude and latitude followed by the key of the
+// entity holding it, such that every grid cell spans a contiguous range of
+// keys and a bounding box is covered by scanning a handful of cells
+typedef struct {
+	rax *tree;         // geohash followed by entity key -> indexed point
+	rax *entities;     // entity key -> geohash, locates stale entries
+	size_t key_len;    // entity key length
+} SpatialIndex;
+
+// area bounded by latitudes and longitudes, in degrees
+// a box crossing the antimeridian has min_lon > max_lon
+typedef struct {
+	double min_lat;
+	double max_lat;
+	double min_lon;
+	double max_lon;
+} SpatialBox;
+
+// iterates over entities within a bounding box or a radius
+// or over all entities by ascending distance from an origin
+// matching entities are collected once the iterator is (re)positioned
+// nearest neighbours are collected in rounds of growing radius
+typedef struct {
+	const SpatialIndex *idx;  // iterated index
+	SpatialBox boxes[2];      // scanned boxes, split along the antimeridian
+	uint box_count;           // number of scanned boxes
+	SIValue origin;           // origin of a radius or nearest neighbour scan
+	double radius;            // radius in meters, negative if unbounded
+	bool nearest;             // produce entities by ascending distance
+	double covered;           // radius covered by previous nearest rounds
+	uint64_t collected;       // entities collected by previous nearest rounds
+	unsigned char *keys;      // keys of collected entities
+	uint count;               // number of collected entities
+	uint cap;                 // capacity of 'keys', in entities
+	uint pos;                 // next collected entity to produce
+	bool positioned;          // entities been collected
+} SpatialIndexIterator;
+
+// create a new spatial index
+SpatialIndex *SpatialIndex_New
+(
+	size_t key_len  // entity key length
+);
+
+// index entity 'key' under point 'p'
+// replaces any previous point indexed for 'key'
+void SpatialIndex_Insert
+(
+	SpatialIndex *idx,  // index to update
+	SIValue p,          // indexed point
+	const void *key     // entity key
+);
+
+// remove entity 'key' from index
+void SpatialIndex_Remove
+(
+	SpatialIndex *idx,  // index to update
+	const void *key     // entity key
+);
+
+// returns true if entity 'key' is indexed
+bool SpatialIndex_Contains
+(
+	const SpatialIndex *idx,  // index to inspect
+	const void *key           // entity key
+);
+
+// returns number of indexed entities
+uint64_t SpatialIndex_Count
+(
+	const SpatialIndex *idx
+);
+
+// free spatial index
+void SpatialIndex_Free
+(
+	SpatialIndex *idx
+);
+
+// create an iterator over entities within 'box'
+SpatialIndexIterator *SpatialIndexIterator_NewBox
+(
+	const SpatialIndex *idx,  // index to iterate
+	SpatialBox box            // bounding box
+);
+
+// create an iterator over entities within 'radius' meters from 'origin'
+// entities produced are within the radius, up to floating point error
+SpatialIndexIterator *SpatialIndexIterator_NewRadius
+(
+	const SpatialIndex *idx,  // index to iterate
+	SIValue origin,           // center point
+	double radius             // radius in meters
+);
+
+// create an iterator over all entities by ascending distance from 'origin'
+SpatialIndexIterator *SpatialIndexIterator_NewNearest
+(
+	const SpatialIndex *idx,  // index to iterate
+	SIValue origin            // point distances are measured from
+);
+
+// returns the next entity key, NULL once iterator is depleted
+const void *SpatialIndexIterator_Next
+(
+	SpatialIndexIterator *it
+);
+
+// restart iteration
+void SpatialIndexIterator_Reset
+(
+	SpatialIndexIterator *it
+);
+
+// free iterator
+void SpatialIndexIterator_Free
+(
+	SpatialIndexIterator *it
+);
@@ -16,6 +16,7 @@
 #include "redisearch_api.h"
 #include "arithmetic/funcs.h"
 #include "commands/commands.h"
+#include "util/storage_tier.h"
 #include "util/thpool/pools.h"
 #include "graph/graphcontext.h"
 #include "util/redis_version.h"
@@ -26,6 +27,7 @@
 #include "serializers/graphmeta_type.h"
 #include "configuration/reconf_handler.h"
 #include "serializers/graphcontext_type.h"
+#include "serializers/changelog/changelog.h"
 #include "arithmetic/arithmetic_expression.h"
 
 //------------------------------------------------------------------------------
@@ -113,6 +115,21 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	Config_Subscribe_Changes(reconf_handler);
 	if(Config_Init(ctx, argv, argc) != REDISMODULE_OK) return REDISMODULE_ERR;
 
+	// incremental persistence, enabled by INCREMENTAL_SAVE_INTERVAL
+	if(ChangeLog_Init(ctx) != REDISMODULE_OK) return REDISMODULE_ERR;
+
+	// memory-mapped storage tier, enabled by STORAGE_TIER
+	bool storage_tier;
+	Config_Option_get(Config_STORAGE_TIER, &storage_tier);
+	if(storage_tier) {
+		// redis-server's working directory is the RDB directory
+		if(!StorageTier_Init(".")) {
+			RedisModule_Log(ctx, "warning", "Failed to create storage tier file");
+			return REDISMODULE_ERR;
+		}
+		RedisModule_Log(ctx, "notice", "Storage tier enabled");
+	}
+
 	RegisterEventHandlers(ctx);
 	CypherWhitelist_Build(); // Build whitelist of supported Cypher elements.
 
@@ -163,11 +180,36 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.PREPARE", Graph_Prepare, "readonly deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXECUTE", CommandDispatch, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.DEALLOCATE", Graph_Deallocate, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.BULK", Graph_BulkInsert, "write deny-oom", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.EXPORT", Graph_Export, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.IMPORT", Graph_Import, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.SLOWLOG", CommandDispatch, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -183,6 +225,11 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.INFO", Graph_Info, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.DEBUG", Graph_Debug, "readonly", 0, 0,
 								 0) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -6,15 +6,19 @@
 
 #include "module_event_handlers.h"
 #include "RG.h"
+#include <stdio.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include "util/uuid.h"
+#include "util/storage_tier.h"
 #include "util/thpool/pools.h"
 #include "util/redis_version.h"
 #include "graph/graphcontext.h"
 #include "configuration/config.h"
 #include "serializers/graphmeta_type.h"
 #include "serializers/graphcontext_type.h"
+#include "serializers/changelog/changelog.h"
 
 // indicates the possibility of half-baked graphs in the keyspace
 #define INTERMEDIATE_GRAPHS (aux_field_counter > 0)
@@ -54,6 +58,8 @@ static int _RenameGraphHandler(RedisModuleCtx *ctx, int type, const char *event,
 			GraphContext *gc = RedisModule_ModuleTypeGetValue(key);
 			size_t len;
 			const char *new_name = RedisModule_StringPtrLen(key_name, &len);
+			// records logged under the previous name no longer apply
+			ChangeLog_DropGraph(gc->graph_name);
 			GraphContext_Rename(gc, new_name);
 		}
 		RedisModule_CloseKey(key);
@@ -209,6 +215,58 @@ static bool _IsEventPersistenceEnd(RedisModuleEvent eid, uint64_t subevent) {
 		   );
 }
 
+// inform the change log an RDB snapshot is being taken
+// BGSAVE's child inherits a checkpoint set by RG_ForkPrepare
+// SAVE runs on the main thread, flush pending changes and set the checkpoint
+static void _ChangeLogSnapshotStarted(uint64_t subevent) {
+	if(!ChangeLog_Enabled()) return;
+
+	if(subevent == REDISMODULE_SUBEVENT_PERSISTENCE_SYNC_RDB_START) {
+		uint graph_count = array_len(graphs_in_keyspace);
+		for(uint i = 0; i < graph_count; i++) {
+			GraphContext *gc = graphs_in_keyspace[i];
+			Graph_AcquireReadLock(gc->g);
+			ChangeLog_FlushGraph(gc);
+			Graph_ReleaseLock(gc->g);
+		}
+		ChangeLog_Checkpoint();
+	} else if(subevent != REDISMODULE_SUBEVENT_PERSISTENCE_RDB_START ||
+			  !process_is_child) {
+		// AOF rewrites don't produce a snapshot the log can rely on
+		return;
+	}
+
+	ChangeLog_SnapshotStarted();
+}
+
+// returns the number of private dirty bytes of the current process
+// for a forked child these are pages duplicated since the fork
+static size_t _PrivateDirtyBytes(void) {
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if(f == NULL) return 0;
+
+	char line[1024];
+	size_t total = 0;
+	while(fgets(line, sizeof(line), f) != NULL) {
+		size_t kb;
+		if(sscanf(line, "Private_Dirty: %zu kB", &kb) == 1) total += kb * 1024;
+	}
+
+	fclose(f);
+	return total;
+}
+
+// report snapshot's copy-on-write cost, called from the forked child
+static void _ReportCoW(void) {
+	size_t cow = _PrivateDirtyBytes();
+	if(cow == 0) return;
+
+	uint graph_count = array_len(graphs_in_keyspace);
+	RedisModule_Log(NULL, REDISMODULE_LOGLEVEL_NOTICE,
+			"RedisGraph - snapshot of %u graph(s) completed, copy-on-write: %zu MB",
+			graph_count, cow / (1024 * 1024));
+}
+
 // server persistence event handler
 static void _PersistenceEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
 		uint64_t subevent, void *data) {
@@ -232,14 +290,54 @@ static void _PersistenceEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
 
 	if(_IsEventPersistenceStart(eid, subevent)) {
 		_CreateKeySpaceMetaKeys(ctx);
+		_ChangeLogSnapshotStarted(subevent);
 	} else if(_IsEventPersistenceEnd(eid, subevent)) {
 		_ClearKeySpaceMetaKeys(ctx, false);
+		ChangeLog_SnapshotEnded(subevent == REDISMODULE_SUBEVENT_PERSISTENCE_ENDED);
+		if(process_is_child) _ReportCoW();
+	}
+}
+
+// fork child event handler, invoked at the parent
+// while a child is alive it shares memory pages with the server process
+// any page modified by the server is duplicated, as such matrix
+// synchronization and graph deletion are postponed until the child exits
+static void _ForkChildEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
+		uint64_t subevent, void *data) {
+	if(subevent == REDISMODULE_SUBEVENT_FORK_CHILD_BORN) {
+		RG_Matrix_DeferSync(true);
+		GraphContext_DeferFree(true);
+		return;
+	}
+
+	uint64_t deferred_syncs = RG_Matrix_DeferredSyncCount();
+	if(deferred_syncs > 0) {
+		RedisModule_Log(ctx, "notice",
+				"Deferred %" PRIu64 " matrix synchronizations during fork",
+				deferred_syncs);
+	}
+
+	// child no longer shares pages with us, resume normal behavior
+	RG_Matrix_DeferSync(false);
+	GraphContext_DeferFree(false);
+	StorageTier_ForkDone();
+}
+
+// server loading event handler
+static void _LoadingEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
+		uint64_t subevent, void *data) {
+	if(subevent == REDISMODULE_SUBEVENT_LOADING_RDB_START  ||
+	   subevent == REDISMODULE_SUBEVENT_LOADING_AOF_START  ||
+	   subevent == REDISMODULE_SUBEVENT_LOADING_REPL_START) {
+		ChangeLog_LoadingStarted(subevent);
 	}
 }
 
 // Perform clean-up upon server shutdown.
 static void _ShutdownEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
 		void *data) {
+	// write queued change log records
+	ChangeLog_Shutdown();
 	// Stop threads before finalize GraphBLAS.
 	ThreadPools_Destroy();
 	// Server is shutting down, finalize GraphBLAS.
@@ -258,6 +356,13 @@ static void _RegisterServerEvents(RedisModuleCtx *ctx) {
 
 	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Persistence,
 			_PersistenceEventHandler);
+
+	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Loading,
+			_LoadingEventHandler);
+
+	// available since Redis 6.2
+	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_ForkChild,
+			_ForkChildEventHandler);
 }
 
 //------------------------------------------------------------------------------
@@ -278,6 +383,9 @@ static void RG_ForkPrepare() {
 	//
 	// in the case of RediSearch GC fork, quickly return
 
+	// every child maps the storage tier file, regardless of fork origin
+	StorageTier_ForkPrepare();
+
 	// BGSAVE is invoked from Redis main thread
 	if(!pthread_equal(pthread_self(), redis_main_thread_id)) return;
 
@@ -296,7 +404,13 @@ static void RG_ForkPrepare() {
 		// synchronize all matrices, make sure they're in a consistent state
 		// do not force-flush as this can take awhile
 		Graph_ApplyAllPending(g, false);
+
+		// queue pending changes, the snapshot will cover them
+		// records are written by the change log writer, no I/O takes place
+		ChangeLog_FlushGraph(graphs_in_keyspace[i]);
 	}
+
+	ChangeLog_Checkpoint();
 }
 
 // after fork at parent
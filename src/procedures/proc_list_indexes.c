@@ -27,6 +27,10 @@ typedef struct {
 	SIValue *yield_stopwords;   // yield index stopwords
 	SIValue *yield_entity_type; // yield index entity type
 	SIValue *yield_info;        // yield info
+	SIValue *yield_status;      // yield index status
+	SIValue *yield_progress;    // yield construction progress
+	SIValue *yield_composites;  // yield composite properties
+	SIValue *yield_unique;      // yield unique constrained properties
 } IndexesContext;
 
 static void _process_yield
@@ -41,6 +45,10 @@ static void _process_yield
 	ctx->yield_stopwords   = NULL;
 	ctx->yield_entity_type = NULL;
 	ctx->yield_info        = NULL;
+	ctx->yield_status      = NULL;
+	ctx->yield_progress    = NULL;
+	ctx->yield_composites  = NULL;
+	ctx->yield_unique      = NULL;
 
 	int idx = 0;
 	for(uint i = 0; i < array_len(yield); i++) {
@@ -85,6 +93,30 @@ static void _process_yield
 			idx++;
 			continue;
 		}
+
+		if(strcasecmp("status", yield[i]) == 0) {
+			ctx->yield_status = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("progress", yield[i]) == 0) {
+			ctx->yield_progress = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("composites", yield[i]) == 0) {
+			ctx->yield_composites = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("unique", yield[i]) == 0) {
+			ctx->yield_unique = ctx->out + idx;
+			idx++;
+			continue;
+		}
 	}
 }
 
@@ -109,7 +141,7 @@ ProcedureResult Proc_IndexesInvoke
 
 	IndexesContext *pdata    = rm_malloc(sizeof(IndexesContext));
 	pdata->gc                = gc;
-	pdata->out               = array_new(SIValue, 7);
+	pdata->out               = array_new(SIValue, 11);
 	pdata->type              = IDX_EXACT_MATCH;
 	pdata->node_schema_id    = GraphContext_SchemaCount(gc, SCHEMA_NODE) - 1;
 	pdata->edge_schema_id    = GraphContext_SchemaCount(gc, SCHEMA_EDGE) - 1;
@@ -233,6 +265,47 @@ static bool _EmitIndex
 		RediSearch_IndexInfoFree(&info);
 	}
 
+	if(ctx->yield_status) {
+		if(Index_Enabled(idx)) {
+			*ctx->yield_status = SI_ConstStringVal("OPERATIONAL");
+		} else {
+			*ctx->yield_status = SI_ConstStringVal("UNDER CONSTRUCTION");
+		}
+	}
+
+	if(ctx->yield_progress) {
+		*ctx->yield_progress = SI_LongVal(Index_ConstructionProgress(idx));
+	}
+
+	if(ctx->yield_composites) {
+		uint composite_count = Index_CompositeCount(idx);
+		const IndexComposite *composites = Index_GetComposites(idx);
+		*ctx->yield_composites = SI_Array(composite_count);
+
+		for(uint i = 0; i < composite_count; i++) {
+			uint fields_count = array_len(composites[i].fields);
+			SIValue fields = SI_Array(fields_count);
+			for(uint j = 0; j < fields_count; j++) {
+				SIArray_Append(&fields,
+						SI_ConstStringVal(composites[i].fields[j]));
+			}
+			SIArray_Append(ctx->yield_composites, fields);
+			SIValue_Free(fields);
+		}
+	}
+
+	if(ctx->yield_unique) {
+		uint fields_count        = Index_FieldsCount(idx);
+		const IndexField *fields = Index_GetFields(idx);
+		*ctx->yield_unique       = SI_Array(Index_UniqueCount(idx));
+
+		for(uint i = 0; i < fields_count; i++) {
+			if(!fields[i].unique) continue;
+			SIArray_Append(ctx->yield_unique,
+						   SI_ConstStringVal((char *)fields[i].name));
+		}
+	}
+
 	return true;
 }
 
@@ -303,7 +376,7 @@ ProcedureResult Proc_IndexesFree
 ProcedureCtx *Proc_IndexesCtx() {
 	void *privateData = NULL;
 	ProcedureOutput output;
-	ProcedureOutput *outputs = array_new(ProcedureOutput, 7);
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 10);
 
 	// index type (exact-match / fulltext)
 	output = (ProcedureOutput) {
@@ -347,6 +420,30 @@ ProcedureCtx *Proc_IndexesCtx() {
 	};
 	array_append(outputs, output);
 
+	// index status (operational / under construction)
+	output = (ProcedureOutput) {
+		.name = "status", .type = T_STRING
+	};
+	array_append(outputs, output);
+
+	// construction progress, percentage of scanned rows
+	output = (ProcedureOutput) {
+		.name = "progress", .type = T_INT64
+	};
+	array_append(outputs, output);
+
+	// composite indexed properties, each ordered as specified at creation
+	output = (ProcedureOutput) {
+		.name = "composites", .type = T_ARRAY
+	};
+	array_append(outputs, output);
+
+	// properties constrained to hold unique values
+	output = (ProcedureOutput) {
+		.name = "unique", .type = T_ARRAY
+	};
+	array_append(outputs, output);
+
 	ProcedureCtx *ctx = ProcCtxNew("db.indexes",
 								   0,
 								   outputs,
@@ -24,6 +24,7 @@ static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 		// Set a new thread-local QueryCtx if one has not been created.
 		ctx = rm_calloc(1, sizeof(QueryCtx));
 		ctx->undo_log = UndoLog_New();
+		ctx->index_buffer = IndexBuffer_New();
 		pthread_setspecific(_tlsQueryCtxKey, ctx);
 	}
 	return ctx;
@@ -88,6 +89,12 @@ void QueryCtx_SetResultSet(ResultSet *result_set) {
 void QueryCtx_SetParams(rax *params) {
 	ASSERT(params != NULL);
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+
+	// replace previously set parameters
+	if(ctx->query_data.params) {
+		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
+	}
+
 	ctx->query_data.params = params;
 }
 
@@ -255,6 +262,7 @@ void QueryCtx_Free(void) {
 	ASSERT(ctx != NULL);
 
 	UndoLog_Free(ctx->undo_log);
+	IndexBuffer_Free(ctx->index_buffer);
 
 	if(ctx->query_data.params) {
 		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
@@ -14,6 +14,7 @@
 #include "resultset/resultset.h"
 #include "execution_plan/ops/op.h"
 #include "undo_log/undo_log.h"
+#include "index/index_buffer.h"
 #include <pthread.h>
 
 extern pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
@@ -45,6 +46,7 @@ typedef struct {
 	QueryCtx_GlobalExecCtx global_exec_ctx;     // The data rlated to global redis execution.
 	GraphContext *gc;                           // The GraphContext associated with this query's graph.
 	UndoLog undo_log;                           // Undo log for updates, used in the case of write query can fail and rollback is needed.
+	IndexBuffer *index_buffer;                  // Entities awaiting index maintenance, indexed once a commit completes.
 } QueryCtx;
 
 /* Instantiate the thread-local QueryCtx on module load. */
@@ -39,12 +39,49 @@ typedef void (*EmitHeaderFunc)(RedisModuleCtx *ctx, const char **columns,
 // Typedef for row formatters.
 typedef void (*EmitRowFunc)(RedisModuleCtx *ctx, GraphContext *gc,
 		SIValue **row, uint numcols);
-							   
+
+// Typedef for chunk formatters, emits a single reply element for a chunk
+// of rows, cells are laid out row after row.
+typedef void (*EmitChunkFunc)(RedisModuleCtx *ctx, GraphContext *gc,
+		SIValue **cells, uint nrows, uint numcols);
+
+// A formatter emits either individual rows or chunks of rows.
 typedef struct {
 	EmitRowFunc    EmitRow;
+	EmitChunkFunc  EmitChunk;
 	EmitHeaderFunc EmitHeader;
 } ResultSetFormatter;
 
+// maps an SIValue type to its reply value type
+static inline ValueType _ResultSet_MapValueType(const SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		return VALUE_NULL;
+	case T_STRING:
+		return VALUE_STRING;
+	case T_INT64:
+		return VALUE_INTEGER;
+	case T_BOOL:
+		return VALUE_BOOLEAN;
+	case T_DOUBLE:
+		return VALUE_DOUBLE;
+	case T_ARRAY:
+		return VALUE_ARRAY;
+	case T_NODE:
+		return VALUE_NODE;
+	case T_EDGE:
+		return VALUE_EDGE;
+	case T_PATH:
+		return VALUE_PATH;
+	case T_MAP:
+		return VALUE_MAP;
+	case T_POINT:
+		return VALUE_POINT;
+	default:
+		return VALUE_UNKNOWN;
+	}
+}
+
 /* Redis prints doubles with up to 17 digits of precision, which captures
  * the inaccuracy of many floating-point numbers (such as 0.1).
  * By using the %g format and a precision of 15 significant digits, we avoid many
@@ -18,6 +18,12 @@ ResultSetFormatter *ResultSetFormatter_GetFormatter(ResultSetFormatterType t) {
 	case FORMATTER_COMPACT:
 		formatter = &ResultSetFormatterCompact;
 		break;
+	case FORMATTER_RESP3:
+		formatter = &ResultSetFormatterRESP3;
+		break;
+	case FORMATTER_BINARY:
+		formatter = &ResultSetFormatterBinary;
+		break;
 	default:
 		RedisModule_Assert(false && "Unknown formatter");
 	}
@@ -10,11 +10,15 @@
 #include "resultset_replynop.h"
 #include "resultset_replycompact.h"
 #include "resultset_replyverbose.h"
+#include "resultset_replyresp3.h"
+#include "resultset_replybinary.h"
 
 typedef enum {
 	FORMATTER_NOP = 0,
 	FORMATTER_VERBOSE = 1,
 	FORMATTER_COMPACT = 2,
+	FORMATTER_RESP3 = 3,
+	FORMATTER_BINARY = 4,
 } ResultSetFormatterType;
 
 /* Retrieves result-set formatter.
@@ -40,3 +44,14 @@ static ResultSetFormatter ResultSetFormatterVerbose __attribute__((used)) = {
 	.EmitHeader = ResultSet_ReplyWithVerboseHeader
 };
 
+/* RESP3 reply formatter, used for verbose queries issued over RESP3. */
+static ResultSetFormatter ResultSetFormatterRESP3 __attribute__((used)) = {
+	.EmitRow = ResultSet_EmitRESP3Row,
+	.EmitHeader = ResultSet_ReplyWithVerboseHeader
+};
+
+/* Binary reply formatter, emits a single bulk string per chunk of rows. */
+static ResultSetFormatter ResultSetFormatterBinary __attribute__((used)) = {
+	.EmitChunk = ResultSet_EmitBinaryChunk,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader
+};
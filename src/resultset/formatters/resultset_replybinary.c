@@ -0,0 +1,259 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "resultset_formatters.h"
+#include "RG.h"
+#include "../../util/sds/sds.h"
+#include "../../util/rmalloc.h"
+#include "../../datatypes/datatypes.h"
+
+#include <endian.h>
+
+static inline void _Binary_WriteU8(sds *buf, uint8_t v) {
+	*buf = sdscatlen(*buf, &v, sizeof(v));
+}
+
+static inline void _Binary_WriteU32(sds *buf, uint32_t v) {
+	v = htole32(v);
+	*buf = sdscatlen(*buf, &v, sizeof(v));
+}
+
+static inline void _Binary_WriteU64(sds *buf, uint64_t v) {
+	v = htole64(v);
+	*buf = sdscatlen(*buf, &v, sizeof(v));
+}
+
+static inline void _Binary_WriteDouble(sds *buf, double d) {
+	uint64_t v;
+	memcpy(&v, &d, sizeof(v));
+	_Binary_WriteU64(buf, v);
+}
+
+static uint64_t _Binary_EncodeValue(sds *heap, GraphContext *gc, SIValue v);
+
+// encodes an entity's property values into the heap
+// returns the number of properties, their IDs, types and slots
+static uint64_t _Binary_EncodeProperties
+(
+	sds *heap,
+	GraphContext *gc,
+	const GraphEntity *e,
+	uint8_t **types,
+	uint64_t **slots,
+	Attribute_ID **ids
+) {
+	const AttributeSet set = GraphEntity_GetAttributes(e);
+	uint n = ATTRIBUTE_SET_COUNT(set);
+
+	*ids   = rm_malloc(sizeof(Attribute_ID) * n);
+	*types = rm_malloc(sizeof(uint8_t) * n);
+	*slots = rm_malloc(sizeof(uint64_t) * n);
+
+	for(uint i = 0; i < n; i++) {
+		SIValue value = AttributeSet_GetIdx(set, i, *ids + i);
+		(*types)[i] = _ResultSet_MapValueType(value);
+		(*slots)[i] = _Binary_EncodeValue(heap, gc, value);
+	}
+
+	return n;
+}
+
+// writes properties encoded by _Binary_EncodeProperties
+static void _Binary_WriteProperties
+(
+	sds *heap,
+	uint n,
+	uint8_t *types,
+	uint64_t *slots,
+	Attribute_ID *ids
+) {
+	_Binary_WriteU32(heap, n);
+	for(uint i = 0; i < n; i++) {
+		_Binary_WriteU32(heap, ids[i]);
+		_Binary_WriteU8(heap, types[i]);
+		_Binary_WriteU64(heap, slots[i]);
+	}
+
+	rm_free(ids);
+	rm_free(types);
+	rm_free(slots);
+}
+
+static uint64_t _Binary_EncodeNode(sds *heap, GraphContext *gc, Node *n) {
+	// nested values are encoded ahead of the node
+	uint8_t *types;
+	uint64_t *slots;
+	Attribute_ID *ids;
+	uint prop_count = _Binary_EncodeProperties(heap, gc, (GraphEntity *)n,
+			&types, &slots, &ids);
+
+	uint64_t offset = sdslen(*heap);
+	_Binary_WriteU64(heap, ENTITY_GET_ID(n));
+
+	uint lbls_count;
+	NODE_GET_LABELS(gc->g, n, lbls_count);
+	_Binary_WriteU32(heap, lbls_count);
+	for(uint i = 0; i < lbls_count; i++) _Binary_WriteU32(heap, labels[i]);
+
+	_Binary_WriteProperties(heap, prop_count, types, slots, ids);
+	return offset;
+}
+
+static uint64_t _Binary_EncodeEdge(sds *heap, GraphContext *gc, Edge *e) {
+	uint8_t *types;
+	uint64_t *slots;
+	Attribute_ID *ids;
+	uint prop_count = _Binary_EncodeProperties(heap, gc, (GraphEntity *)e,
+			&types, &slots, &ids);
+
+	int reltype_id = Graph_GetEdgeRelation(gc->g, e);
+	ASSERT(reltype_id != GRAPH_NO_RELATION);
+
+	uint64_t offset = sdslen(*heap);
+	_Binary_WriteU64(heap, ENTITY_GET_ID(e));
+	_Binary_WriteU32(heap, reltype_id);
+	_Binary_WriteU64(heap, Edge_GetSrcNodeID(e));
+	_Binary_WriteU64(heap, Edge_GetDestNodeID(e));
+
+	_Binary_WriteProperties(heap, prop_count, types, slots, ids);
+	return offset;
+}
+
+static uint64_t _Binary_EncodeArray(sds *heap, GraphContext *gc, SIValue array) {
+	uint n = SIArray_Length(array);
+	uint8_t *types  = rm_malloc(sizeof(uint8_t) * n);
+	uint64_t *slots = rm_malloc(sizeof(uint64_t) * n);
+	for(uint i = 0; i < n; i++) {
+		SIValue elem = SIArray_Get(array, i);
+		types[i] = _ResultSet_MapValueType(elem);
+		slots[i] = _Binary_EncodeValue(heap, gc, elem);
+	}
+
+	uint64_t offset = sdslen(*heap);
+	_Binary_WriteU32(heap, n);
+	for(uint i = 0; i < n; i++) {
+		_Binary_WriteU8(heap, types[i]);
+		_Binary_WriteU64(heap, slots[i]);
+	}
+
+	rm_free(types);
+	rm_free(slots);
+	return offset;
+}
+
+static uint64_t _Binary_EncodeMap(sds *heap, GraphContext *gc, SIValue map) {
+	uint n = Map_KeyCount(map);
+	uint8_t *types  = rm_malloc(sizeof(uint8_t) * n);
+	uint64_t *slots = rm_malloc(sizeof(uint64_t) * n);
+	for(uint i = 0; i < n; i++) {
+		SIValue val = map.map[i].val;
+		types[i] = _ResultSet_MapValueType(val);
+		slots[i] = _Binary_EncodeValue(heap, gc, val);
+	}
+
+	uint64_t offset = sdslen(*heap);
+	_Binary_WriteU32(heap, n);
+	for(uint i = 0; i < n; i++) {
+		const char *key = map.map[i].key.stringval;
+		uint32_t len = strlen(key);
+		_Binary_WriteU32(heap, len);
+		*heap = sdscatlen(*heap, key, len);
+		_Binary_WriteU8(heap, types[i]);
+		_Binary_WriteU64(heap, slots[i]);
+	}
+
+	rm_free(types);
+	rm_free(slots);
+	return offset;
+}
+
+static uint64_t _Binary_EncodePath(sds *heap, GraphContext *gc, SIValue path) {
+	SIValue nodes = SIPath_Nodes(path);
+	SIValue edges = SIPath_Relationships(path);
+	uint64_t nodes_offset = _Binary_EncodeArray(heap, gc, nodes);
+	uint64_t edges_offset = _Binary_EncodeArray(heap, gc, edges);
+	SIValue_Free(nodes);
+	SIValue_Free(edges);
+
+	uint64_t offset = sdslen(*heap);
+	_Binary_WriteU64(heap, nodes_offset);
+	_Binary_WriteU64(heap, edges_offset);
+	return offset;
+}
+
+// returns the value's slot, encoding it into the heap if it isn't inlined
+static uint64_t _Binary_EncodeValue(sds *heap, GraphContext *gc, SIValue v) {
+	uint64_t slot = 0;
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		return 0;
+	case T_INT64:
+		return (uint64_t)v.longval;
+	case T_BOOL:
+		return (v.longval != 0);
+	case T_DOUBLE:
+		memcpy(&slot, &v.doubleval, sizeof(slot));
+		return slot;
+	case T_STRING: {
+		uint32_t len = strlen(v.stringval);
+		slot = sdslen(*heap);
+		_Binary_WriteU32(heap, len);
+		*heap = sdscatlen(*heap, v.stringval, len);
+		return slot;
+	}
+	case T_POINT:
+		slot = sdslen(*heap);
+		_Binary_WriteDouble(heap, Point_lat(v));
+		_Binary_WriteDouble(heap, Point_lon(v));
+		return slot;
+	case T_ARRAY:
+		return _Binary_EncodeArray(heap, gc, v);
+	case T_MAP:
+		return _Binary_EncodeMap(heap, gc, v);
+	case T_NODE:
+		return _Binary_EncodeNode(heap, gc, v.ptrval);
+	case T_EDGE:
+		return _Binary_EncodeEdge(heap, gc, v.ptrval);
+	case T_PATH:
+		return _Binary_EncodePath(heap, gc, v);
+	default:
+		RedisModule_Assert("Unhandled value type" && false);
+		return 0;
+	}
+}
+
+void ResultSet_EmitBinaryChunk(RedisModuleCtx *ctx, GraphContext *gc,
+							   SIValue **cells, uint nrows, uint numcols) {
+	sds heap  = sdsempty();
+	sds chunk = sdsMakeRoomFor(sdsempty(), 8 + (size_t)nrows * numcols * 9);
+
+	_Binary_WriteU32(&chunk, nrows);
+	_Binary_WriteU32(&chunk, numcols);
+
+	uint8_t *types  = rm_malloc(sizeof(uint8_t) * nrows);
+	uint64_t *slots = rm_malloc(sizeof(uint64_t) * nrows);
+
+	for(uint j = 0; j < numcols; j++) {
+		for(uint i = 0; i < nrows; i++) {
+			SIValue v = *cells[i * numcols + j];
+			types[i] = _ResultSet_MapValueType(v);
+			slots[i] = htole64(_Binary_EncodeValue(&heap, gc, v));
+		}
+
+		chunk = sdscatlen(chunk, types, sizeof(uint8_t) * nrows);
+		chunk = sdscatlen(chunk, slots, sizeof(uint64_t) * nrows);
+	}
+
+	_Binary_WriteU64(&chunk, sdslen(heap));
+	chunk = sdscatsds(chunk, heap);
+
+	RedisModule_ReplyWithStringBuffer(ctx, chunk, sdslen(chunk));
+
+	rm_free(types);
+	rm_free(slots);
+	sdsfree(heap);
+	sdsfree(chunk);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+// Formatter for binary replies, each chunk of rows is emitted as a single
+// bulk string, columnar within the chunk
+// the header is shared with the compact formatter
+//
+// Chunk layout, numbers are little-endian:
+//  #rows (uint32), #columns (uint32)
+//  (types X #rows, slots X #rows) X #columns
+//  heap length (uint64), heap
+//
+// types are single bytes holding a ValueType
+// slots are 8 bytes:
+//  NULL: 0
+//  INTEGER: int64
+//  BOOLEAN: 0 or 1
+//  DOUBLE: IEEE 754 double
+//  any other type: offset of the value's encoding within the heap
+//
+// heap encodings:
+//  STRING: length (uint32), bytes
+//  POINT: latitude (double), longitude (double)
+//  ARRAY: #elements (uint32), (type, slot) X #elements
+//  MAP: #keys (uint32), (key length (uint32), key, type, slot) X #keys
+//  NODE: ID (uint64), #labels (uint32), label ID (uint32) X #labels,
+//        #properties (uint32), (attribute ID (uint32), type, slot) X #properties
+//  EDGE: ID (uint64), relation type ID (uint32), source ID (uint64),
+//        destination ID (uint64),
+//        #properties (uint32), (attribute ID (uint32), type, slot) X #properties
+//  PATH: nodes array offset (uint64), edges array offset (uint64)
+void ResultSet_EmitBinaryChunk(RedisModuleCtx *ctx, GraphContext *gc,
+		SIValue **cells, uint nrows, uint numcols);
@@ -17,37 +17,8 @@ static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *g
 static void _ResultSet_CompactReplyWithMap(RedisModuleCtx *ctx, GraphContext *gc, SIValue v);
 static void _ResultSet_CompactReplyWithPoint(RedisModuleCtx *ctx, GraphContext *gc, SIValue v);
 
-static inline ValueType _mapValueType(const SIValue v) {
-	switch(SI_TYPE(v)) {
-	case T_NULL:
-		return VALUE_NULL;
-	case T_STRING:
-		return VALUE_STRING;
-	case T_INT64:
-		return VALUE_INTEGER;
-	case T_BOOL:
-		return VALUE_BOOLEAN;
-	case T_DOUBLE:
-		return VALUE_DOUBLE;
-	case T_ARRAY:
-		return VALUE_ARRAY;
-	case T_NODE:
-		return VALUE_NODE;
-	case T_EDGE:
-		return VALUE_EDGE;
-	case T_PATH:
-		return VALUE_PATH;
-	case T_MAP:
-		return VALUE_MAP;
-	case T_POINT:
-		return VALUE_POINT;
-	default:
-		return VALUE_UNKNOWN;
-	}
-}
-
 static inline void _ResultSet_ReplyWithValueType(RedisModuleCtx *ctx, const SIValue v) {
-	RedisModule_ReplyWithLongLong(ctx, _mapValueType(v));
+	RedisModule_ReplyWithLongLong(ctx, _ResultSet_MapValueType(v));
 }
 
 static void _ResultSet_CompactReplyWithSIValue(RedisModuleCtx *ctx, GraphContext *gc,
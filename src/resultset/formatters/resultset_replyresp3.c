@@ -0,0 +1,194 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "resultset_formatters.h"
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../datatypes/datatypes.h"
+
+// Forward declarations.
+static void _ResultSet_RESP3ReplyWithMap(RedisModuleCtx *ctx, GraphContext *gc, SIValue map);
+static void _ResultSet_RESP3ReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc, SIValue path);
+static void _ResultSet_RESP3ReplyWithPoint(RedisModuleCtx *ctx, SIValue point);
+static void _ResultSet_RESP3ReplyWithArray(RedisModuleCtx *ctx, GraphContext *gc, SIValue array);
+static void _ResultSet_RESP3ReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n);
+static void _ResultSet_RESP3ReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e);
+
+// RESP3 has native doubles, booleans, nulls and maps
+// as such values are emitted without a type annotation
+static void _ResultSet_RESP3ReplyWithSIValue(RedisModuleCtx *ctx, GraphContext *gc,
+											 const SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_STRING:
+		RedisModule_ReplyWithStringBuffer(ctx, v.stringval, strlen(v.stringval));
+		return;
+	case T_INT64:
+		RedisModule_ReplyWithLongLong(ctx, v.longval);
+		return;
+	case T_DOUBLE:
+		RedisModule_ReplyWithDouble(ctx, v.doubleval);
+		return;
+	case T_BOOL:
+		RedisModule_ReplyWithBool(ctx, v.longval != 0);
+		return;
+	case T_NULL:
+		RedisModule_ReplyWithNull(ctx);
+		return;
+	case T_NODE:
+		_ResultSet_RESP3ReplyWithNode(ctx, gc, v.ptrval);
+		return;
+	case T_EDGE:
+		_ResultSet_RESP3ReplyWithEdge(ctx, gc, v.ptrval);
+		return;
+	case T_ARRAY:
+		_ResultSet_RESP3ReplyWithArray(ctx, gc, v);
+		return;
+	case T_PATH:
+		_ResultSet_RESP3ReplyWithPath(ctx, gc, v);
+		return;
+	case T_MAP:
+		_ResultSet_RESP3ReplyWithMap(ctx, gc, v);
+		return;
+	case T_POINT:
+		_ResultSet_RESP3ReplyWithPoint(ctx, v);
+		return;
+	default:
+		RedisModule_Assert("Unhandled value type" && false);
+	}
+}
+
+static void _ResultSet_RESP3ReplyWithProperties(RedisModuleCtx *ctx, GraphContext *gc,
+												const GraphEntity *e) {
+	const AttributeSet set = GraphEntity_GetAttributes(e);
+	int prop_count = ATTRIBUTE_SET_COUNT(set);
+	RedisModule_ReplyWithMap(ctx, prop_count);
+	// Iterate over all properties stored on entity
+	for(int i = 0; i < prop_count; i ++) {
+		Attribute_ID attr_id;
+		SIValue value = AttributeSet_GetIdx(set, i, &attr_id);
+		// Emit the attribute name
+		const char *prop_str = GraphContext_GetAttributeString(gc, attr_id);
+		RedisModule_ReplyWithStringBuffer(ctx, prop_str, strlen(prop_str));
+		// Emit the value
+		_ResultSet_RESP3ReplyWithSIValue(ctx, gc, value);
+	}
+}
+
+static void _ResultSet_RESP3ReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n) {
+	/*  RESP3 node reply format:
+	 *  {
+	 *      "id": Node ID (integer),
+	 *      "labels": [label (string) X N],
+	 *      "properties": {name: value X N}
+	 *  }
+	 */
+	RedisModule_ReplyWithMap(ctx, 3);
+
+	RedisModule_ReplyWithStringBuffer(ctx, "id", 2);
+	RedisModule_ReplyWithLongLong(ctx, ENTITY_GET_ID(n));
+
+	RedisModule_ReplyWithStringBuffer(ctx, "labels", 6);
+	uint lbls_count;
+	NODE_GET_LABELS(gc->g, n, lbls_count);
+	RedisModule_ReplyWithArray(ctx, lbls_count);
+	for(int i = 0; i < lbls_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		const char *lbl_name = Schema_GetName(s);
+		RedisModule_ReplyWithStringBuffer(ctx, lbl_name, strlen(lbl_name));
+	}
+
+	RedisModule_ReplyWithStringBuffer(ctx, "properties", 10);
+	_ResultSet_RESP3ReplyWithProperties(ctx, gc, (GraphEntity *)n);
+}
+
+static void _ResultSet_RESP3ReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e) {
+	/*  RESP3 edge reply format:
+	 *  {
+	 *      "id": Edge ID (integer),
+	 *      "type": relation type (string),
+	 *      "src_node": source node ID (integer),
+	 *      "dest_node": destination node ID (integer),
+	 *      "properties": {name: value X N}
+	 *  }
+	 */
+	RedisModule_ReplyWithMap(ctx, 5);
+
+	RedisModule_ReplyWithStringBuffer(ctx, "id", 2);
+	RedisModule_ReplyWithLongLong(ctx, ENTITY_GET_ID(e));
+
+	RedisModule_ReplyWithStringBuffer(ctx, "type", 4);
+	Schema *s = GraphContext_GetSchemaByID(gc, Edge_GetRelationID(e), SCHEMA_EDGE);
+	const char *reltype = Schema_GetName(s);
+	RedisModule_ReplyWithStringBuffer(ctx, reltype, strlen(reltype));
+
+	RedisModule_ReplyWithStringBuffer(ctx, "src_node", 8);
+	RedisModule_ReplyWithLongLong(ctx, Edge_GetSrcNodeID(e));
+
+	RedisModule_ReplyWithStringBuffer(ctx, "dest_node", 9);
+	RedisModule_ReplyWithLongLong(ctx, Edge_GetDestNodeID(e));
+
+	RedisModule_ReplyWithStringBuffer(ctx, "properties", 10);
+	_ResultSet_RESP3ReplyWithProperties(ctx, gc, (GraphEntity *)e);
+}
+
+static void _ResultSet_RESP3ReplyWithArray(RedisModuleCtx *ctx, GraphContext *gc,
+										   SIValue array) {
+	uint len = SIArray_Length(array);
+	RedisModule_ReplyWithArray(ctx, len);
+	for(uint i = 0; i < len; i++) {
+		_ResultSet_RESP3ReplyWithSIValue(ctx, gc, SIArray_Get(array, i));
+	}
+}
+
+static void _ResultSet_RESP3ReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc,
+										  SIValue path) {
+	// {"nodes": [node X N], "edges": [edge X N - 1]}
+	RedisModule_ReplyWithMap(ctx, 2);
+
+	RedisModule_ReplyWithStringBuffer(ctx, "nodes", 5);
+	SIValue nodes = SIPath_Nodes(path);
+	_ResultSet_RESP3ReplyWithArray(ctx, gc, nodes);
+	SIValue_Free(nodes);
+
+	RedisModule_ReplyWithStringBuffer(ctx, "edges", 5);
+	SIValue edges = SIPath_Relationships(path);
+	_ResultSet_RESP3ReplyWithArray(ctx, gc, edges);
+	SIValue_Free(edges);
+}
+
+static void _ResultSet_RESP3ReplyWithMap(RedisModuleCtx *ctx, GraphContext *gc,
+										 SIValue v) {
+	uint key_count = Map_KeyCount(v);
+	Map m = v.map;
+
+	RedisModule_ReplyWithMap(ctx, key_count);
+	for(uint i = 0; i < key_count; i++) {
+		Pair p = m[i];
+		RedisModule_ReplyWithCString(ctx, p.key.stringval);
+		_ResultSet_RESP3ReplyWithSIValue(ctx, gc, p.val);
+	}
+}
+
+static void _ResultSet_RESP3ReplyWithPoint(RedisModuleCtx *ctx, SIValue point) {
+	ASSERT(SI_TYPE(point) == T_POINT);
+
+	// {"latitude": double, "longitude": double}
+	RedisModule_ReplyWithMap(ctx, 2);
+	RedisModule_ReplyWithStringBuffer(ctx, "latitude", 8);
+	RedisModule_ReplyWithDouble(ctx, Point_lat(point));
+	RedisModule_ReplyWithStringBuffer(ctx, "longitude", 9);
+	RedisModule_ReplyWithDouble(ctx, Point_lon(point));
+}
+
+void ResultSet_EmitRESP3Row(RedisModuleCtx *ctx, GraphContext *gc,
+							SIValue **row, uint numcols) {
+	// Prepare return array sized to the number of RETURN entities
+	RedisModule_ReplyWithArray(ctx, numcols);
+
+	for(uint i = 0; i < numcols; i++) {
+		_ResultSet_RESP3ReplyWithSIValue(ctx, gc, *row[i]);
+	}
+}
@@ -0,0 +1,12 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+// Formatter for RESP3 replies, values are emitted using native RESP3 types
+// the header is shared with the verbose formatter
+void ResultSet_EmitRESP3Row(RedisModuleCtx *ctx, GraphContext *gc,
+		SIValue **row, uint numcols);
@@ -13,6 +13,9 @@
 #include "../util/rmalloc.h"
 #include "../grouping/group_cache.h"
 
+// number of rows accumulated before a streamable resultset starts streaming
+#define RESULTSET_CHUNK_SIZE 1024
+
 static void _ResultSet_ReplyWithPreamble
 (
 	ResultSet *set
@@ -29,6 +32,127 @@ static void _ResultSet_ReplyWithPreamble
 	}
 }
 
+// number of reply elements holding 'nrows' rows
+static uint64_t _ResultSet_ReplyLength
+(
+	const ResultSet *set,
+	uint64_t nrows
+) {
+	if(set->formatter->EmitChunk == NULL) return nrows;
+	// chunk formatters emit a single element per chunk
+	return (nrows + RESULTSET_CHUNK_SIZE - 1) / RESULTSET_CHUNK_SIZE;
+}
+
+// emit accumulated rows
+// returns number of emitted reply elements
+static uint64_t _ResultSet_EmitCells
+(
+	ResultSet *set
+) {
+	if(set->cells == NULL) return 0;
+
+	uint ncols = set->column_count;
+	uint64_t nrows = DataBlock_ItemCount(set->cells) / ncols;
+
+	if(set->formatter->EmitChunk == NULL) {
+		SIValue *row[ncols];
+		// for each row
+		for(uint64_t i = 0; i < nrows; i++) {
+			// for each column
+			for(uint j = 0; j < ncols; j++) {
+				row[j] = DataBlock_GetItem(set->cells, i * ncols + j);
+			}
+
+			set->formatter->EmitRow(set->ctx, set->gc, row, ncols);
+		}
+		return nrows;
+	}
+
+	if(nrows == 0) return 0;
+
+	// emit rows a chunk at a time
+	uint64_t chunk_size = MIN(nrows, RESULTSET_CHUNK_SIZE);
+	SIValue **cells = rm_malloc(sizeof(SIValue *) * chunk_size * ncols);
+	for(uint64_t i = 0; i < nrows; i += chunk_size) {
+		uint n = MIN(chunk_size, nrows - i);
+		for(uint64_t j = 0; j < n * ncols; j++) {
+			cells[j] = DataBlock_GetItem(set->cells, i * ncols + j);
+		}
+
+		set->formatter->EmitChunk(set->ctx, set->gc, cells, n, ncols);
+	}
+	rm_free(cells);
+
+	return _ResultSet_ReplyLength(set, nrows);
+}
+
+static void _ResultSet_FreeCells
+(
+	ResultSet *set
+) {
+	// NOTE: for large result-set containing only NONE heap allocated values
+	// the following is a bit of a waste as there's no real memory to free
+	// at the moment we can't tell rather or not
+	// calling SIValue_Free is required
+	if(set->cells == NULL) return;
+
+	// free individual cells if resultset encountered a heap allocated value
+	if(set->cells_allocation & M_SELF) {
+		uint64_t n = DataBlock_ItemCount(set->cells);
+		for(uint64_t i = 0; i < n; i++) {
+			SIValue *v = DataBlock_GetItem(set->cells, i);
+			SIValue_Free(*v);
+		}
+	}
+
+	DataBlock_Free(set->cells);
+	set->cells = NULL;
+}
+
+static void _ResultSet_AllocateCells
+(
+	ResultSet *set
+) {
+	ASSERT(set->cells == NULL);
+
+	// allocate enough space for at least 10 rows
+	uint64_t nrows = set->column_count * 10;
+	set->cells = DataBlock_New(16384, nrows, sizeof(SIValue), NULL);
+	set->cells_allocation = M_NONE;
+}
+
+// emit accumulated rows to a streaming resultset
+static void _ResultSet_FlushCells
+(
+	ResultSet *set
+) {
+	ASSERT(set->streaming == true);
+
+	if(set->cells == NULL) return;
+
+	set->streamed += DataBlock_ItemCount(set->cells) / set->column_count;
+	set->replied  += _ResultSet_EmitCells(set);
+	_ResultSet_FreeCells(set);
+}
+
+// emit header and accumulated rows
+// from this point on rows are emitted as soon as they're added
+// or once a chunk is accumulated for chunk formatters
+static void _ResultSet_StartStreaming
+(
+	ResultSet *set
+) {
+	ASSERT(set->streaming == false);
+
+	_ResultSet_ReplyWithPreamble(set);
+
+	// number of rows is unknown at this point
+	RedisModule_ReplyWithArray(set->ctx, REDISMODULE_POSTPONED_LEN);
+
+	set->streaming = true;
+	_ResultSet_FlushCells(set);
+}
+
 static void _ResultSet_SetColumns
 (
 	ResultSet *set
@@ -74,6 +198,10 @@ ResultSet *NewResultSet
 	set->column_count        =  0;
 	set->cells_allocation    =  M_NONE;
 	set->columns_record_map  =  NULL;
+	set->streamable          =  false;
+	set->streaming           =  false;
+	set->streamed            =  0;
+	set->replied             =  0;
 
 	// init resultset statistics
 	ResultSetStat_init(&set->stats);
@@ -86,9 +214,7 @@ ResultSet *NewResultSet
 	// allocate space for resultset entries only if data is expected
 	if(set->column_count > 0) {
 		// none empty result-set
-		// allocate enough space for at least 10 rows
-		uint64_t nrows = set->column_count * 10;
-		set->cells = DataBlock_New(16384, nrows, sizeof(SIValue), NULL);
+		_ResultSet_AllocateCells(set);
 	}
 
 	return set;
@@ -125,7 +251,12 @@ uint64_t ResultSet_RowCount
 	ASSERT(set != NULL);
 
 	if(set->column_count == 0) return 0;
-	return DataBlock_ItemCount(set->cells) / set->column_count;
+
+	uint64_t buffered = (set->cells == NULL)
+		? 0
+		: DataBlock_ItemCount(set->cells) / set->column_count;
+
+	return set->streamed + buffered;
 }
 
 // add a new row to resultset
@@ -137,13 +268,30 @@ int ResultSet_AddRecord
 	ASSERT(r   != NULL);
 	ASSERT(set != NULL);
 
-	// copy projected values from record to resultset
-	for(int i = 0; i < set->column_count; i++) {
-		int idx = set->columns_record_map[i];
-		SIValue *cell = DataBlock_AllocateItem(set->cells, NULL);
-		*cell = Record_Get(r, idx);
-		SIValue_Persist(cell);
-		set->cells_allocation |= SI_ALLOCATION(cell);
+	if(set->streaming && set->formatter->EmitRow != NULL) {
+		// emit row directly from record
+		SIValue values[set->column_count];
+		SIValue *row[set->column_count];
+		for(int i = 0; i < set->column_count; i++) {
+			int idx = set->columns_record_map[i];
+			values[i] = Record_Get(r, idx);
+			row[i] = values + i;
+		}
+
+		set->formatter->EmitRow(set->ctx, set->gc, row, set->column_count);
+		set->streamed++;
+		set->replied++;
+	} else {
+		if(set->cells == NULL) _ResultSet_AllocateCells(set);
+
+		// copy projected values from record to resultset
+		for(int i = 0; i < set->column_count; i++) {
+			int idx = set->columns_record_map[i];
+			SIValue *cell = DataBlock_AllocateItem(set->cells, NULL);
+			*cell = Record_Get(r, idx);
+			SIValue_Persist(cell);
+			set->cells_allocation |= SI_ALLOCATION(cell);
+		}
 	}
 
 	// remove entry from record in a second pass
@@ -154,6 +302,16 @@ int ResultSet_AddRecord
 		Record_Remove(r, idx);
 	}
 
+	// switch to streaming once a full chunk has been accumulated
+	if(set->streamable && set->cells != NULL &&
+	   DataBlock_ItemCount(set->cells) >= RESULTSET_CHUNK_SIZE * set->column_count) {
+		if(set->streaming) {
+			_ResultSet_FlushCells(set);
+		} else {
+			_ResultSet_StartStreaming(set);
+		}
+	}
+
 	return RESULTSET_OK;
 }
 
@@ -203,6 +361,18 @@ void ResultSet_CachedExecution
 	set->stats.cached = true;
 }
 
+// allow resultset to stream rows to the client once a chunk is accumulated
+void ResultSet_EnableStreaming
+(
+	ResultSet *set  // resultset to update
+) {
+	ASSERT(set != NULL);
+
+	// statistics only and profiled queries have no rows to stream
+	set->streamable = (set->column_count > 0 &&
+					   set->format != FORMATTER_NOP);
+}
+
 // flush resultset to network
 void ResultSet_Reply
 (
@@ -210,6 +380,20 @@ void ResultSet_Reply
 ) {
 	ASSERT(set != NULL);
 
+	if(set->streaming) {
+		// emit remaining rows and close the rows array
+		_ResultSet_FlushCells(set);
+		RedisModule_ReplySetArrayLength(set->ctx, set->replied);
+
+		// header and rows are out, an error takes the place of statistics
+		if(ErrorCtx_EncounteredError()) {
+			ErrorCtx_EmitException();
+		} else {
+			ResultSetStat_emit(set->ctx, &set->stats);
+		}
+		return;
+	}
+
 	uint64_t row_count = ResultSet_RowCount(set);
 
 	// check to see if we've encountered a run-time error
@@ -224,18 +408,9 @@ void ResultSet_Reply
 
 	// emit resultset
 	if(set->column_count > 0) {
-		RedisModule_ReplyWithArray(set->ctx, row_count);
-		SIValue *row[set->column_count];
-		uint64_t cells = DataBlock_ItemCount(set->cells);
-		// for each row
-		for(uint64_t i = 0; i < cells; i += set->column_count) {
-			// for each column
-			for(uint j = 0; j < set->column_count; j++) {
-				row[j] = DataBlock_GetItem(set->cells, i + j);
-			}
-
-			set->formatter->EmitRow(set->ctx, set->gc, row, set->column_count);
-		}
+		RedisModule_ReplyWithArray(set->ctx,
+				_ResultSet_ReplyLength(set, row_count));
+		_ResultSet_EmitCells(set);
 	}
 
 	ResultSetStat_emit(set->ctx, &set->stats); // response with statistics
@@ -262,21 +437,7 @@ void ResultSet_Free
 	}
 
 	// free resultset cells
-	// NOTE: for large result-set containing only NONE heap allocated values
-	// the following is a bit of a waste as there's no real memory to free
-	// at the moment we can't tell rather or not
-	// calling SIValue_Free is required
-	if(set->cells) {
-		// free individual cells if resultset encountered a heap allocated value
-		if(set->cells_allocation & M_SELF) {
-			uint64_t n = DataBlock_ItemCount(set->cells);
-			for(uint64_t i = 0; i < n; i++) {
-				SIValue *v = DataBlock_GetItem(set->cells, i);
-				SIValue_Free(*v);
-			}
-		}
-		DataBlock_Free(set->cells);
-	}
+	_ResultSet_FreeCells(set);
 
 	rm_free(set);
 }
@@ -27,6 +27,10 @@ typedef struct {
 	ResultSetFormatterType format;  // result set format; compact/verbose/nop
 	ResultSetFormatter *formatter;  // result set data formatter
 	SIAllocation cells_allocation;  // encountered values allocation
+	bool streamable;                // rows may be emitted as they're produced
+	bool streaming;                 // header emitted, rows are being streamed
+	uint64_t streamed;              // number of rows streamed
+	uint64_t replied;               // number of reply elements streamed
 } ResultSet;
 
 // map each column to a record index
@@ -78,6 +82,13 @@ void ResultSet_CachedExecution
 	ResultSet *set  // resultset to update
 );
 
+// allow resultset to stream rows to the client once a chunk is accumulated
+// an error encountered after streaming began replaces the statistics
+void ResultSet_EnableStreaming
+(
+	ResultSet *set  // resultset to update
+);
+
 // flush resultset to network
 void ResultSet_Reply
 (
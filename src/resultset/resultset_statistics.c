@@ -23,7 +23,9 @@ bool ResultSetStat_IndicateModification
 			stats->relationships_deleted > 0  ||
 			stats->labels_added > 0           ||
 			stats->indices_created > 0        ||
-			stats->indices_deleted > 0
+			stats->indices_deleted > 0        ||
+			stats->constraints_created > 0    ||
+			stats->constraints_deleted > 0
 			);
 }
 
@@ -58,6 +60,8 @@ void ResultSetStat_emit
 	if(stats->properties_set        > 0) resultset_size++;
 	if(stats->relationships_deleted > 0) resultset_size++;
 	if(stats->relationships_created > 0) resultset_size++;
+	if(stats->constraints_created   > 0) resultset_size++;
+	if(stats->constraints_deleted   > 0) resultset_size++;
 
 	if(stats->indices_created != STAT_NOT_SET) resultset_size++;
 	if(stats->indices_deleted != STAT_NOT_SET) resultset_size++;
@@ -104,6 +108,16 @@ void ResultSetStat_emit
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 	}
 
+	if(stats->constraints_created > 0) {
+		buflen = sprintf(buff, "Constraints created: %d", stats->constraints_created);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
+	if(stats->constraints_deleted > 0) {
+		buflen = sprintf(buff, "Constraints deleted: %d", stats->constraints_deleted);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
 	buflen = sprintf(buff, "Cached execution: %d", stats->cached ? 1 : 0);
 	RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 
@@ -124,4 +138,6 @@ void ResultSetStat_Clear(ResultSetStatistics *stats) {
 	stats->indices_deleted        =  STAT_NOT_SET;
 	stats->relationships_created  =  0;
 	stats->relationships_deleted  =  0;
+	stats->constraints_created    =  0;
+	stats->constraints_deleted    =  0;
 }
@@ -20,6 +20,8 @@ typedef struct {
 	int relationships_deleted;  // number of edges removed as part of a delete query
 	int indices_created;        // number of indices created
 	int indices_deleted;        // number of indices deleted
+	int constraints_created;    // number of constraints created
+	int constraints_deleted;    // number of constraints deleted
 	bool cached;                // indication for a cached query execution
 } ResultSetStatistics;
 
@@ -63,7 +63,9 @@ unsigned short Schema_IndexCount
 	ASSERT(s != NULL);
 	unsigned short n = 0;
 
-	if(s->index) n += 1;
+	if(s->index) {
+		n += 1 + Index_CompositeCount(s->index) + Index_UniqueCount(s->index);
+	}
 	if(s->fulltextIdx) n += 1;
 
 	return n;
@@ -0,0 +1,858 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "changelog.h"
+#include "changelog_format.h"
+#include "../../RG.h"
+#include "../../util/arr.h"
+#include "../../util/cron.h"
+#include "../../util/rmalloc.h"
+#include "../../util/sds/sds.h"
+#include "../../configuration/config.h"
+#include "../../datatypes/datatypes.h"
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/param.h>
+
+// request a full snapshot once the log exceeds this size and covers more
+// than half of the entities in the keyspace
+#define CHANGELOG_COMPACT_MIN_SIZE (64 * 1024 * 1024)
+
+// append a fixed size value to buffer
+#define WRITE(buf, v) (buf) = sdscatlen((buf), &(v), sizeof(v))
+
+// global array tracking all extant GraphContexts
+extern GraphContext **graphs_in_keyspace;
+// holds the number of aux fields encountered during decoding of RDB file
+extern uint aux_field_counter;
+
+// records are encoded on the main thread into a pending buffer
+// a background writer swaps the buffer out, writes and syncs it to disk
+// such that no file I/O is performed while holding the GIL
+typedef struct {
+	FILE *f;                    // change log file
+	char *path;                 // change log file path
+	char *checkpoint_path;      // path of file holding last snapshot checkpoint
+	uint64_t base;              // logical offset of the first record in file
+	uint64_t written;           // logical offset past the last record in file
+	uint64_t end;               // logical offset past the last queued record
+	uint64_t discard;           // records preceding offset are in a snapshot
+	uint64_t checkpoint;        // logical offset covered by the next snapshot
+	uint64_t slots;             // entities logged since the last snapshot
+	uint64_t interval;          // flush interval in ms
+	sds pending;                // records yet to be written
+	bool startup;               // log has yet to be replayed
+	bool snapshot;              // this process is taking an RDB snapshot
+	bool compact;               // full snapshot requested
+	uint64_t compact_offset;    // logical offset the requested snapshot must cover
+	rax *versions;              // graph name -> schema version at last flush
+	bool wakeup;                // writer has work to do
+	bool stop;                  // writer should exit
+	pthread_t writer;           // background writer thread
+	pthread_cond_t cond;        // wakes writer
+	pthread_mutex_t mutex;      // guards pending buffer and offsets
+	pthread_mutex_t io_mutex;   // guards file access
+} ChangeLog;
+
+static ChangeLog *changelog = NULL;
+
+// request a snapshot covering the log up to its current end
+// caller is expected to hold the mutex
+static inline void _RequestCompaction(void) {
+	changelog->compact        = true;
+	changelog->compact_offset = changelog->end;
+}
+
+//------------------------------------------------------------------------------
+// record encoding
+//------------------------------------------------------------------------------
+
+static sds _WriteValue
+(
+	sds buf,
+	SIValue v
+) {
+	uint64_t t = SI_TYPE(v);
+	WRITE(buf, t);
+
+	switch(t) {
+		case T_BOOL:
+		case T_INT64:
+			WRITE(buf, v.longval);
+			break;
+		case T_DOUBLE:
+			WRITE(buf, v.doubleval);
+			break;
+		case T_STRING: {
+			uint32_t len = strlen(v.stringval) + 1;
+			WRITE(buf, len);
+			buf = sdscatlen(buf, v.stringval, len);
+			break;
+		}
+		case T_ARRAY: {
+			uint32_t len = SIArray_Length(v);
+			WRITE(buf, len);
+			for(uint32_t i = 0; i < len; i++) {
+				buf = _WriteValue(buf, SIArray_Get(v, i));
+			}
+			break;
+		}
+		case T_POINT: {
+			float lat = Point_lat(v);
+			float lon = Point_lon(v);
+			WRITE(buf, lat);
+			WRITE(buf, lon);
+			break;
+		}
+		case T_NULL:
+			break;
+		default:
+			ASSERT(false && "Attempted to log value of invalid type.");
+	}
+
+	return buf;
+}
+
+static sds _WriteAttributes
+(
+	sds buf,
+	const AttributeSet set
+) {
+	uint32_t n = ATTRIBUTE_SET_COUNT(set);
+	WRITE(buf, n);
+
+	for(uint32_t i = 0; i < n; i++) {
+		Attribute_ID id;
+		SIValue v = AttributeSet_GetIdx(set, i, &id);
+		uint32_t attr_id = id;
+		WRITE(buf, attr_id);
+		buf = _WriteValue(buf, v);
+	}
+
+	return buf;
+}
+
+// writes record header, the payload length is set by _EndRecord
+static sds _BeginRecord
+(
+	sds buf,
+	ChangeLogRecordType type,
+	const char *graph_name
+) {
+	uint64_t len     = 0;
+	uint8_t  t       = type;
+	uint32_t name_len = strlen(graph_name);
+
+	WRITE(buf, len);
+	WRITE(buf, t);
+	WRITE(buf, name_len);
+	buf = sdscatlen(buf, graph_name, name_len);
+
+	return buf;
+}
+
+static void _EndRecord
+(
+	sds buf,
+	size_t start  // record offset within buffer
+) {
+	uint64_t len = sdslen(buf) - start - sizeof(uint64_t);
+	memcpy(buf + start, &len, sizeof(len));
+}
+
+static sds _WriteSchema
+(
+	sds buf,
+	GraphContext *gc
+) {
+	uint32_t label_count     = Graph_LabelTypeCount(gc->g);
+	uint32_t relation_count  = Graph_RelationTypeCount(gc->g);
+	uint32_t attribute_count = GraphContext_AttributeCount(gc);
+
+	WRITE(buf, label_count);
+	WRITE(buf, relation_count);
+	WRITE(buf, attribute_count);
+
+	return buf;
+}
+
+// log every slot within dirty node ranges
+static sds _WriteNodes
+(
+	sds buf,
+	GraphContext *gc,
+	uint64_t *slots  // [output] number of logged entities
+) {
+	Graph     *g      = gc->g;
+	DataBlock *nodes  = g->nodes;
+	uint64_t  n       = Graph_NodeCount(g) + Graph_DeletedNodeCount(g);
+	uint64_t  ranges  = DataBlock_RangeCount(nodes);
+
+	for(uint64_t r = 0; r < ranges; r++) {
+		if(!DataBlock_RangeIsDirty(nodes, r)) continue;
+
+		uint64_t first = r * DATABLOCK_DIRTY_RANGE;
+		uint64_t count = MIN(DATABLOCK_DIRTY_RANGE, n - first);
+		size_t   start = sdslen(buf);
+
+		buf = _BeginRecord(buf, CHANGELOG_RECORD_NODES, gc->graph_name);
+		buf = _WriteSchema(buf, gc);
+		WRITE(buf, first);
+		WRITE(buf, count);
+
+		for(NodeID id = first; id < first + count; id++) {
+			Node node = GE_NEW_NODE();
+			uint8_t alive = Graph_GetNode(g, id, &node);
+			WRITE(buf, alive);
+			if(!alive) continue;
+
+			uint label_count;
+			NODE_GET_LABELS(g, &node, label_count);
+			uint32_t n_labels = label_count;
+			WRITE(buf, n_labels);
+			for(uint i = 0; i < label_count; i++) {
+				uint32_t l = labels[i];
+				WRITE(buf, l);
+			}
+
+			buf = _WriteAttributes(buf,
+					GraphEntity_GetAttributes((GraphEntity *)&node));
+		}
+
+		_EndRecord(buf, start);
+		*slots += count;
+	}
+
+	return buf;
+}
+
+// log the latest state of every modified edge
+static sds _WriteEdges
+(
+	sds buf,
+	GraphContext *gc,
+	uint64_t *slots  // [output] number of logged entities
+) {
+	Graph      *g        = gc->g;
+	const Edge *changes  = Graph_EdgeChanges(g);
+	uint       n         = array_len((Edge *)changes);
+
+	if(n == 0) return buf;
+
+	size_t   start = sdslen(buf);
+	uint64_t count = 0;
+
+	buf = _BeginRecord(buf, CHANGELOG_RECORD_EDGES, gc->graph_name);
+	buf = _WriteSchema(buf, gc);
+	size_t count_offset = sdslen(buf);
+	WRITE(buf, count);
+
+	// scan changes from newest to oldest, logging each edge once
+	rax *logged = raxNew();
+	for(int i = n - 1; i >= 0; i--) {
+		const Edge *e = changes + i;
+		EdgeID id = ENTITY_GET_ID(e);
+		if(!raxTryInsert(logged, (unsigned char *)&id, sizeof(id), NULL, NULL)) {
+			continue;
+		}
+
+		// edge connection isn't stored in the datablock
+		// rely on the captured modification for it
+		Edge edge;
+		uint8_t alive = Graph_GetEdge(g, id, &edge);
+		WRITE(buf, id);
+		WRITE(buf, alive);
+		if(alive) {
+			uint64_t src  = Edge_GetSrcNodeID(e);
+			uint64_t dest = Edge_GetDestNodeID(e);
+			uint32_t r    = Edge_GetRelationID(e);
+			WRITE(buf, src);
+			WRITE(buf, dest);
+			WRITE(buf, r);
+			buf = _WriteAttributes(buf,
+					GraphEntity_GetAttributes((GraphEntity *)&edge));
+		}
+		count++;
+	}
+	raxFree(logged);
+
+	memcpy(buf + count_offset, &count, sizeof(count));
+	_EndRecord(buf, start);
+	*slots += count;
+
+	return buf;
+}
+
+//------------------------------------------------------------------------------
+// file management
+//------------------------------------------------------------------------------
+
+static bool _WriteHeader
+(
+	FILE *f,
+	uint64_t base
+) {
+	return fwrite(CHANGELOG_MAGIC, CHANGELOG_MAGIC_LEN, 1, f) == 1 &&
+		   fwrite(&base, sizeof(base), 1, f) == 1;
+}
+
+// append buffer to log, on failure the log is restored to its previous size
+// caller is expected to hold the io mutex
+static bool _Append
+(
+	const char *buf,
+	size_t len
+) {
+	if(len == 0) return true;
+
+	if(fwrite(buf, len, 1, changelog->f) == 1 &&
+	   fflush(changelog->f) == 0 &&
+	   fsync(fileno(changelog->f)) == 0) {
+		changelog->written += len;
+		return true;
+	}
+
+	RedisModule_Log(NULL, "warning",
+			"Failed writing change log %s: %s", changelog->path,
+			strerror(errno));
+
+	// drop partially written records
+	off_t size = CHANGELOG_HEADER_SIZE + (changelog->written - changelog->base);
+	clearerr(changelog->f);
+	if(ftruncate(fileno(changelog->f), size) != 0) {
+		RedisModule_Log(NULL, "warning",
+				"Failed restoring change log %s: %s",
+				changelog->path, strerror(errno));
+	}
+	fseeko(changelog->f, size, SEEK_SET);
+
+	return false;
+}
+
+// discard records covered by a snapshot, offset is a logical offset
+// an offset past the written records empties the log, records up to offset
+// are expected to be dropped by the caller
+// caller is expected to hold the io mutex
+static void _Truncate
+(
+	uint64_t offset
+) {
+	if(offset <= changelog->base) return;
+
+	// copy the remaining records into a new file, then replace the log
+	char *tmp_path;
+	asprintf(&tmp_path, "%s.tmp", changelog->path);
+
+	FILE *tmp = fopen(tmp_path, "w+b");
+	bool ok = (tmp != NULL) && _WriteHeader(tmp, offset);
+
+	uint64_t remaining = (offset < changelog->written) ?
+		changelog->written - offset : 0;
+	fseeko(changelog->f, CHANGELOG_HEADER_SIZE + (offset - changelog->base),
+			SEEK_SET);
+
+	char chunk[65536];
+	while(ok && remaining > 0) {
+		size_t n = MIN(remaining, sizeof(chunk));
+		ok = fread(chunk, n, 1, changelog->f) == 1 &&
+			 fwrite(chunk, n, 1, tmp) == 1;
+		remaining -= n;
+	}
+
+	ok = ok && fflush(tmp) == 0 && fsync(fileno(tmp)) == 0;
+	ok = ok && rename(tmp_path, changelog->path) == 0;
+
+	if(ok) {
+		fclose(changelog->f);
+		changelog->f       = tmp;
+		changelog->written = MAX(changelog->written, offset);
+
+		pthread_mutex_lock(&changelog->mutex);
+		changelog->base  = offset;
+		changelog->slots = 0;
+		pthread_mutex_unlock(&changelog->mutex);
+	} else {
+		RedisModule_Log(NULL, "warning",
+				"Failed truncating change log %s: %s",
+				changelog->path, strerror(errno));
+		if(tmp) fclose(tmp);
+		unlink(tmp_path);
+	}
+
+	fseeko(changelog->f, 0, SEEK_END);
+	free(tmp_path);
+}
+
+// returns the offset covered by the last completed snapshot
+// 0 if no snapshot completed since the last call
+static uint64_t _ConsumeCheckpoint(void) {
+	FILE *f = fopen(changelog->checkpoint_path, "rb");
+	if(f == NULL) return 0;
+
+	uint64_t offset;
+	bool read = fread(&offset, sizeof(offset), 1, f) == 1;
+	fclose(f);
+	unlink(changelog->checkpoint_path);
+
+	return read ? offset : 0;
+}
+
+// write records to the log, discarding the prefix covered by the last
+// completed snapshot
+// caller is expected to hold the io mutex
+static void _Write
+(
+	const char *buf,  // records starting at the written offset
+	size_t len        // buffer length
+) {
+	uint64_t offset = _ConsumeCheckpoint();
+	changelog->discard = MAX(changelog->discard, offset);
+
+	// records covered by the snapshot needn't be written
+	uint64_t start = changelog->written;
+	_Truncate(MIN(changelog->discard, start + len));
+	size_t skip = changelog->written - start;
+
+	bool written = _Append(buf + skip, len - skip);
+
+	pthread_mutex_lock(&changelog->mutex);
+
+	if(!written) {
+		// requeue records and get back on track with a full snapshot
+		sds pending = sdscatsds(sdsnewlen(buf + skip, len - skip),
+				changelog->pending);
+		sdsfree(changelog->pending);
+		changelog->pending = pending;
+		_RequestCompaction();
+	}
+
+	// requested snapshot completed
+	if(offset > 0 && changelog->compact && offset >= changelog->compact_offset) {
+		changelog->compact = false;
+	}
+
+	pthread_mutex_unlock(&changelog->mutex);
+}
+
+// background writer, writes pending records whenever woken up
+static void *_Writer
+(
+	void *arg
+) {
+	UNUSED(arg);
+
+	bool stop = false;
+	while(!stop) {
+		pthread_mutex_lock(&changelog->mutex);
+		while(!changelog->wakeup && !changelog->stop) {
+			pthread_cond_wait(&changelog->cond, &changelog->mutex);
+		}
+		changelog->wakeup = false;
+		stop = changelog->stop;
+		pthread_mutex_unlock(&changelog->mutex);
+
+		pthread_mutex_lock(&changelog->io_mutex);
+
+		// swap out pending records
+		pthread_mutex_lock(&changelog->mutex);
+		sds buf = changelog->pending;
+		changelog->pending = sdsempty();
+		pthread_mutex_unlock(&changelog->mutex);
+
+		_Write(buf, sdslen(buf));
+
+		pthread_mutex_unlock(&changelog->io_mutex);
+
+		sdsfree(buf);
+	}
+
+	return NULL;
+}
+
+// open or create change log
+// records partially written due to a crash are dropped
+static bool _Open(void) {
+	FILE *f = fopen(changelog->path, "r+b");
+
+	if(f == NULL) {
+		f = fopen(changelog->path, "w+b");
+		if(f == NULL || !_WriteHeader(f, 0) || fflush(f) != 0) {
+			if(f) fclose(f);
+			return false;
+		}
+		changelog->f       = f;
+		changelog->base    = 0;
+		changelog->written = 0;
+		changelog->end     = 0;
+		return true;
+	}
+
+	char magic[CHANGELOG_MAGIC_LEN];
+	uint64_t base;
+	if(fread(magic, CHANGELOG_MAGIC_LEN, 1, f) != 1 ||
+	   memcmp(magic, CHANGELOG_MAGIC, CHANGELOG_MAGIC_LEN) != 0 ||
+	   fread(&base, sizeof(base), 1, f) != 1) {
+		fclose(f);
+		return false;
+	}
+
+	// skip complete records
+	off_t pos = CHANGELOG_HEADER_SIZE;
+	fseeko(f, 0, SEEK_END);
+	off_t size = ftello(f);
+	while(pos + (off_t)sizeof(uint64_t) <= size) {
+		uint64_t len;
+		fseeko(f, pos, SEEK_SET);
+		if(fread(&len, sizeof(len), 1, f) != 1) break;
+		if(pos + (off_t)sizeof(len) + (off_t)len > size) break;
+		pos += sizeof(len) + len;
+	}
+
+	if(pos != size) {
+		RedisModule_Log(NULL, "warning",
+				"Dropping incomplete change log record");
+		if(ftruncate(fileno(f), pos) != 0) {
+			fclose(f);
+			return false;
+		}
+	}
+
+	fseeko(f, pos, SEEK_SET);
+	changelog->f       =  f;
+	changelog->base    =  base;
+	changelog->written =  base + (pos - CHANGELOG_HEADER_SIZE);
+	changelog->end     =  changelog->written;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// periodic flush
+//------------------------------------------------------------------------------
+
+// request a full snapshot if graph isn't represented by the last snapshot
+// in its current form
+// caller is expected to hold the mutex
+static void _TrackSchema
+(
+	GraphContext *gc
+) {
+	unsigned char *name = (unsigned char *)gc->graph_name;
+	size_t len = strlen(gc->graph_name);
+	uintptr_t version = GraphContext_GetVersion(gc);
+
+	void *prev = raxFind(changelog->versions, name, len);
+	if(prev == raxNotFound || (uintptr_t)prev != version) {
+		raxInsert(changelog->versions, name, len, (void *)version, NULL);
+		_RequestCompaction();
+	}
+}
+
+static void _Flush
+(
+	void *pdata
+) {
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+
+	// skip while loading or while half-baked graphs reside in the keyspace
+	bool loading = RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_LOADING;
+	if(!loading && aux_field_counter == 0) {
+		// the startup dataset was loaded
+		changelog->startup = false;
+
+		uint64_t entity_count = 0;
+		uint graph_count = array_len(graphs_in_keyspace);
+		for(uint i = 0; i < graph_count; i++) {
+			GraphContext *gc = graphs_in_keyspace[i];
+			Graph_AcquireReadLock(gc->g);
+			ChangeLog_FlushGraph(gc);
+			Graph_ReleaseLock(gc->g);
+
+			entity_count += Graph_NodeCount(gc->g) + Graph_EdgeCount(gc->g);
+		}
+
+		pthread_mutex_lock(&changelog->mutex);
+
+		// replaying the log costs as much as loading a snapshot
+		if(!changelog->compact &&
+		   changelog->end - changelog->base > CHANGELOG_COMPACT_MIN_SIZE &&
+		   changelog->slots > entity_count / 2) {
+			_RequestCompaction();
+		}
+		bool compact = changelog->compact;
+
+		// write queued records and pick up completed snapshots
+		changelog->wakeup = true;
+		pthread_cond_signal(&changelog->cond);
+
+		pthread_mutex_unlock(&changelog->mutex);
+
+		// the request holds until a snapshot completes, reissue it as long
+		// as no snapshot is in progress
+		bool child = RedisModule_GetContextFlags(ctx) &
+			REDISMODULE_CTX_FLAGS_ACTIVE_CHILD;
+		if(compact && !child) {
+			RedisModuleCallReply *reply =
+				RedisModule_Call(ctx, "BGSAVE", "c", "SCHEDULE");
+			if(reply != NULL) RedisModule_FreeCallReply(reply);
+		}
+	}
+
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	Cron_AddTask(changelog->interval, _Flush, NULL);
+}
+
+//------------------------------------------------------------------------------
+// change log API
+//------------------------------------------------------------------------------
+
+int ChangeLog_Init
+(
+	RedisModuleCtx *ctx
+) {
+	uint64_t interval;
+	Config_Option_get(Config_INCREMENTAL_SAVE_INTERVAL, &interval);
+	if(interval == INCREMENTAL_SAVE_DISABLED) return REDISMODULE_OK;
+
+	// place the change log next to the RDB file
+	// redis-server's working directory is the RDB directory
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "CONFIG", "cc", "GET",
+			"dbfilename");
+	if(reply == NULL || RedisModule_CallReplyLength(reply) != 2) {
+		if(reply) RedisModule_FreeCallReply(reply);
+		RedisModule_Log(ctx, "warning", "Failed to retrieve RDB file name");
+		return REDISMODULE_ERR;
+	}
+
+	size_t len;
+	RedisModuleCallReply *name = RedisModule_CallReplyArrayElement(reply, 1);
+	const char *dbfilename = RedisModule_CallReplyStringPtr(name, &len);
+
+	changelog = rm_calloc(1, sizeof(ChangeLog));
+	changelog->interval = interval;
+	changelog->startup  = true;
+	changelog->versions = raxNew();
+	changelog->pending  = sdsempty();
+	asprintf(&changelog->path, "%.*s.graphlog", (int)len, dbfilename);
+	asprintf(&changelog->checkpoint_path, "%s.checkpoint", changelog->path);
+	RedisModule_FreeCallReply(reply);
+
+	int res = pthread_mutex_init(&changelog->mutex, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+	res = pthread_mutex_init(&changelog->io_mutex, NULL);
+	ASSERT(res == 0);
+	res = pthread_cond_init(&changelog->cond, NULL);
+	ASSERT(res == 0);
+
+	if(!_Open()) {
+		RedisModule_Log(ctx, "warning", "Failed to open change log %s",
+				changelog->path);
+		return REDISMODULE_ERR;
+	}
+
+	// a snapshot might have completed after the log was last written to
+	_Write(NULL, 0);
+
+	if(pthread_create(&changelog->writer, NULL, _Writer, NULL) != 0) {
+		RedisModule_Log(ctx, "warning", "Failed to start change log writer");
+		return REDISMODULE_ERR;
+	}
+
+	RedisModule_Log(ctx, "notice", "Incremental save enabled, change log: %s",
+			changelog->path);
+
+	Cron_AddTask(changelog->interval, _Flush, NULL);
+
+	return REDISMODULE_OK;
+}
+
+inline bool ChangeLog_Enabled(void) {
+	return changelog != NULL;
+}
+
+void ChangeLog_FlushGraph
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	if(!ChangeLog_Enabled()) return;
+
+	uint64_t slots = 0;
+	sds buf = sdsempty();
+	buf = _WriteNodes(buf, gc, &slots);
+	buf = _WriteEdges(buf, gc, &slots);
+
+	// queue records, the writer retries them on failure
+	pthread_mutex_lock(&changelog->mutex);
+	_TrackSchema(gc);
+	changelog->pending = sdscatsds(changelog->pending, buf);
+	changelog->end    += sdslen(buf);
+	changelog->slots  += slots;
+	pthread_mutex_unlock(&changelog->mutex);
+
+	Graph_ClearChanges(gc->g);
+
+	sdsfree(buf);
+}
+
+void ChangeLog_DropGraph
+(
+	const char *graph_name
+) {
+	ASSERT(graph_name != NULL);
+	if(!ChangeLog_Enabled()) return;
+
+	sds buf = sdsempty();
+	buf = _BeginRecord(buf, CHANGELOG_RECORD_DROP, graph_name);
+	_EndRecord(buf, 0);
+
+	pthread_mutex_lock(&changelog->mutex);
+	changelog->pending = sdscatsds(changelog->pending, buf);
+	changelog->end    += sdslen(buf);
+	raxRemove(changelog->versions, (unsigned char *)graph_name,
+			strlen(graph_name), NULL);
+	// graph removal should reach the snapshot
+	_RequestCompaction();
+	pthread_mutex_unlock(&changelog->mutex);
+
+	sdsfree(buf);
+}
+
+void ChangeLog_RequestCompaction(void) {
+	if(!ChangeLog_Enabled()) return;
+
+	pthread_mutex_lock(&changelog->mutex);
+	_RequestCompaction();
+	pthread_mutex_unlock(&changelog->mutex);
+}
+
+void ChangeLog_Checkpoint(void) {
+	if(!ChangeLog_Enabled()) return;
+
+	pthread_mutex_lock(&changelog->mutex);
+	changelog->checkpoint = changelog->end;
+	pthread_mutex_unlock(&changelog->mutex);
+}
+
+void ChangeLog_SnapshotStarted(void) {
+	if(!ChangeLog_Enabled()) return;
+	changelog->snapshot = true;
+}
+
+void ChangeLog_SnapshotEnded
+(
+	bool success
+) {
+	if(!ChangeLog_Enabled() || !changelog->snapshot) return;
+	changelog->snapshot = false;
+	if(!success) return;
+
+	// this might be a forked child, avoid locks and leave the actual
+	// truncation to the server process
+	char *tmp_path;
+	asprintf(&tmp_path, "%s.tmp", changelog->checkpoint_path);
+
+	FILE *f = fopen(tmp_path, "wb");
+	bool ok = f != NULL &&
+		fwrite(&changelog->checkpoint, sizeof(uint64_t), 1, f) == 1;
+	ok = (f != NULL && fclose(f) == 0) && ok;
+	ok = ok && rename(tmp_path, changelog->checkpoint_path) == 0;
+	if(!ok) unlink(tmp_path);
+
+	free(tmp_path);
+}
+
+void ChangeLog_LoadingStarted
+(
+	uint64_t subevent
+) {
+	if(!ChangeLog_Enabled()) return;
+
+	// replay on top of the RDB loaded at startup
+	if(changelog->startup && subevent == REDISMODULE_SUBEVENT_LOADING_RDB_START) {
+		return;
+	}
+
+	// dataset is replaced, e.g. replication or AOF
+	// logged changes no longer apply
+	pthread_mutex_lock(&changelog->io_mutex);
+
+	pthread_mutex_lock(&changelog->mutex);
+	sdsclear(changelog->pending);
+	uint64_t end = changelog->end;
+	pthread_mutex_unlock(&changelog->mutex);
+
+	_Truncate(end);
+
+	pthread_mutex_lock(&changelog->mutex);
+	// on failure, queued records are lost, restart from the log's end
+	changelog->end = changelog->written;
+	_RequestCompaction();
+	pthread_mutex_unlock(&changelog->mutex);
+
+	pthread_mutex_unlock(&changelog->io_mutex);
+
+	changelog->startup = false;
+}
+
+void ChangeLog_GraphLoaded
+(
+	GraphContext *gc
+) {
+	if(!ChangeLog_Enabled()) return;
+
+	// graph is represented by the snapshot in its current form
+	uintptr_t version = GraphContext_GetVersion(gc);
+	raxInsert(changelog->versions, (unsigned char *)gc->graph_name,
+			strlen(gc->graph_name), (void *)version, NULL);
+}
+
+char *ChangeLog_ReadRecords
+(
+	size_t *len
+) {
+	ASSERT(ChangeLog_Enabled());
+	ASSERT(len != NULL);
+
+	pthread_mutex_lock(&changelog->io_mutex);
+
+	*len = changelog->written - changelog->base;
+	char *buf = rm_malloc(*len);
+
+	fseeko(changelog->f, CHANGELOG_HEADER_SIZE, SEEK_SET);
+	if(*len > 0 && fread(buf, *len, 1, changelog->f) != 1) {
+		RedisModule_Log(NULL, "warning",
+				"Failed reading change log %s", changelog->path);
+		*len = 0;
+	}
+	fseeko(changelog->f, 0, SEEK_END);
+
+	pthread_mutex_unlock(&changelog->io_mutex);
+
+	return buf;
+}
+
+inline bool ChangeLog_ShouldReplay(void) {
+	return ChangeLog_Enabled() && changelog->startup;
+}
+
+void ChangeLog_Shutdown(void) {
+	if(!ChangeLog_Enabled()) return;
+
+	// write remaining records and wait for the writer to exit
+	pthread_mutex_lock(&changelog->mutex);
+	changelog->stop = true;
+	pthread_cond_signal(&changelog->cond);
+	pthread_mutex_unlock(&changelog->mutex);
+
+	pthread_join(changelog->writer, NULL);
+}
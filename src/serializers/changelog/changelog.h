@@ -0,0 +1,129 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../redismodule.h"
+#include "../../graph/graphcontext.h"
+
+// the change log implements incremental persistence
+//
+// when INCREMENTAL_SAVE_INTERVAL is set, modified node ranges and edges are
+// periodically appended to a change log file residing next to the RDB file
+// records are encoded while holding the GIL, writing and syncing them to disk
+// is left to a background thread
+// upon server start the change log is replayed on top of the loaded snapshot
+//
+// once a snapshot is written, the portion of the log it covers is discarded
+// the log is compacted by requesting a full snapshot (BGSAVE) once it
+// accumulates a significant portion of the keyspace
+// or when a change can't be represented by the log (schema and index
+// modifications, graph creation, rename and deletion)
+
+typedef struct ChangeLogOverlay ChangeLogOverlay;
+
+//------------------------------------------------------------------------------
+// change log writer
+//------------------------------------------------------------------------------
+
+// initialize the change log, no-op if incremental save is disabled
+int ChangeLog_Init
+(
+	RedisModuleCtx *ctx
+);
+
+// returns true if incremental save is enabled
+bool ChangeLog_Enabled(void);
+
+// queue graph modifications made since the last flush for writing
+// caller is expected to hold the graph's read lock
+void ChangeLog_FlushGraph
+(
+	GraphContext *gc
+);
+
+// queue a record discarding every previous record and snapshot entity
+// of the given graph
+void ChangeLog_DropGraph
+(
+	const char *graph_name
+);
+
+// request a full snapshot
+void ChangeLog_RequestCompaction(void);
+
+// remember the log offset a snapshot taken right now would cover
+// expected to be called once all graphs were flushed
+void ChangeLog_Checkpoint(void);
+
+// an RDB snapshot is being taken by the current process
+void ChangeLog_SnapshotStarted(void);
+
+// RDB snapshot completed, if successful, records the checkpoint it covers
+// the checkpoint is picked up by the server process which discards
+// the log prefix covered by the snapshot
+void ChangeLog_SnapshotEnded
+(
+	bool success
+);
+
+// server started loading its dataset
+// the log is replayed only on top of the dataset loaded at startup
+// any other dataset makes the log obsolete
+void ChangeLog_LoadingStarted
+(
+	uint64_t subevent
+);
+
+// graph decoding completed
+void ChangeLog_GraphLoaded
+(
+	GraphContext *gc
+);
+
+// write queued records and stop the background writer
+void ChangeLog_Shutdown(void);
+
+//------------------------------------------------------------------------------
+// change log replay
+//------------------------------------------------------------------------------
+
+// returns true if the log was loaded at startup and should be replayed
+bool ChangeLog_ShouldReplay(void);
+
+// collects the change log records of the graph being decoded
+// returns NULL if there's nothing to replay
+ChangeLogOverlay *ChangeLogOverlay_Load
+(
+	GraphContext *gc
+);
+
+// returns true if snapshot's node should be discarded
+bool ChangeLogOverlay_ContainsNode
+(
+	const ChangeLogOverlay *overlay,
+	NodeID id
+);
+
+// returns true if snapshot's edge should be discarded
+bool ChangeLogOverlay_ContainsEdge
+(
+	const ChangeLogOverlay *overlay,
+	EdgeID id
+);
+
+// introduce logged nodes and edges into the graph being decoded
+void ChangeLogOverlay_Apply
+(
+	ChangeLogOverlay *overlay,
+	GraphContext *gc
+);
+
+// free overlay
+void ChangeLogOverlay_Free
+(
+	ChangeLogOverlay *overlay
+);
@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// change log file format, shared by the writer and the replay logic
+//
+// File format:
+//  magic
+//  base - logical offset of the first record
+//  record X N
+//
+// Record format:
+//  payload length
+//  record type
+//  graph name length, graph name
+//  NODES & EDGES:
+//      #labels, #relationship-types, #attributes at the time of writing
+//  NODES:
+//      first node ID, #slots
+//      (alive, [#labels, labels X #labels, attributes]) X #slots
+//  EDGES:
+//      #edges
+//      (edge ID, alive, [source ID, destination ID, relation, attributes])
+//      X #edges
+//
+// attributes: #attributes, (attribute ID, value) X #attributes
+// value: type, payload
+//
+// numbers are stored in host byte order, the file isn't portable across
+// architectures
+
+#define CHANGELOG_MAGIC        "RGCLOG01"
+#define CHANGELOG_MAGIC_LEN    8
+#define CHANGELOG_HEADER_SIZE  (CHANGELOG_MAGIC_LEN + sizeof(uint64_t))
+
+typedef enum {
+	CHANGELOG_RECORD_NODES = 0,  // range of node slots
+	CHANGELOG_RECORD_EDGES = 1,  // modified edges
+	CHANGELOG_RECORD_DROP  = 2,  // graph deleted
+} ChangeLogRecordType;
+
+// returns a copy of all complete records in the change log
+// caller is responsible for freeing the returned buffer
+char *ChangeLog_ReadRecords
+(
+	size_t *len  // [output] number of bytes returned
+);
@@ -0,0 +1,468 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "changelog.h"
+#include "changelog_format.h"
+#include "../../RG.h"
+#include "../../util/rmalloc.h"
+#include "../graph_extensions.h"
+#include "../../datatypes/datatypes.h"
+#include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
+
+// changes logged for a graph since its last snapshot
+struct ChangeLogOverlay {
+	char *buf;      // change log records
+	size_t len;     // buffer length
+	bool dropped;   // graph was deleted after the snapshot was taken
+	rax *nodes;     // node ID -> latest logged node slot
+	rax *edges;     // edge ID -> latest logged edge
+};
+
+// bounded cursor over change log records
+typedef struct {
+	const char *p;
+	const char *end;
+} Reader;
+
+static inline bool _Read
+(
+	Reader *r,
+	void *v,
+	size_t n
+) {
+	if(r->end - r->p < (ptrdiff_t)n) return false;
+	memcpy(v, r->p, n);
+	r->p += n;
+	return true;
+}
+
+#define READ(r, v) _Read((r), &(v), sizeof(v))
+
+//------------------------------------------------------------------------------
+// parsing
+//------------------------------------------------------------------------------
+
+// reads a single value, 'v' is NULL when value is skipped
+static bool _ReadValue
+(
+	Reader *r,
+	SIValue *v
+) {
+	uint64_t t;
+	if(!READ(r, t)) return false;
+
+	switch(t) {
+		case T_BOOL:
+		case T_INT64: {
+			int64_t l;
+			if(!READ(r, l)) return false;
+			if(v) *v = (t == T_BOOL) ? SI_BoolVal(l) : SI_LongVal(l);
+			return true;
+		}
+		case T_DOUBLE: {
+			double d;
+			if(!READ(r, d)) return false;
+			if(v) *v = SI_DoubleVal(d);
+			return true;
+		}
+		case T_STRING: {
+			uint32_t len;
+			if(!READ(r, len)) return false;
+			if(len == 0 || r->end - r->p < len || r->p[len - 1] != '\0') {
+				return false;
+			}
+			// string lives within the overlay's buffer
+			if(v) *v = SI_ConstStringVal((char *)r->p);
+			r->p += len;
+			return true;
+		}
+		case T_ARRAY: {
+			uint32_t len;
+			if(!READ(r, len)) return false;
+			if(v) *v = SI_Array(len);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue elem;
+				if(!_ReadValue(r, v ? &elem : NULL)) {
+					if(v) SIValue_Free(*v);
+					return false;
+				}
+				if(v) {
+					SIArray_Append(v, elem);
+					SIValue_Free(elem);
+				}
+			}
+			return true;
+		}
+		case T_POINT: {
+			float lat;
+			float lon;
+			if(!READ(r, lat) || !READ(r, lon)) return false;
+			if(v) *v = SI_Point(lat, lon);
+			return true;
+		}
+		case T_NULL:
+			if(v) *v = SI_NullVal();
+			return true;
+		default:
+			return false;
+	}
+}
+
+// reads entity attributes, 'e' is NULL when attributes are skipped
+static bool _ReadAttributes
+(
+	Reader *r,
+	GraphEntity *e
+) {
+	uint32_t n;
+	if(!READ(r, n)) return false;
+
+	for(uint32_t i = 0; i < n; i++) {
+		uint32_t attr_id;
+		SIValue v;
+		if(!READ(r, attr_id)) return false;
+		if(!_ReadValue(r, e ? &v : NULL)) return false;
+		if(e) {
+			GraphEntity_AddProperty(e, attr_id, v);
+			SIValue_Free(v);
+		}
+	}
+
+	return true;
+}
+
+// skips a logged node slot, returns false on malformed input
+static bool _SkipNode
+(
+	Reader *r
+) {
+	uint8_t alive;
+	if(!READ(r, alive)) return false;
+	if(!alive) return true;
+
+	uint32_t n_labels;
+	if(!READ(r, n_labels)) return false;
+	if(r->end - r->p < (ptrdiff_t)(n_labels * sizeof(uint32_t))) return false;
+	r->p += n_labels * sizeof(uint32_t);
+
+	return _ReadAttributes(r, NULL);
+}
+
+// skips a logged edge, returns false on malformed input
+static bool _SkipEdge
+(
+	Reader *r
+) {
+	uint8_t alive;
+	if(!READ(r, alive)) return false;
+	if(!alive) return true;
+
+	uint64_t src;
+	uint64_t dest;
+	uint32_t relation;
+	if(!READ(r, src) || !READ(r, dest) || !READ(r, relation)) return false;
+
+	return _ReadAttributes(r, NULL);
+}
+
+// make sure record doesn't refer to schema missing from the snapshot
+static bool _ValidateSchema
+(
+	Reader *r,
+	GraphContext *gc
+) {
+	uint32_t label_count;
+	uint32_t relation_count;
+	uint32_t attribute_count;
+	if(!READ(r, label_count) || !READ(r, relation_count) ||
+	   !READ(r, attribute_count)) {
+		return false;
+	}
+
+	return label_count     <= Graph_LabelTypeCount(gc->g)    &&
+		   relation_count  <= Graph_RelationTypeCount(gc->g) &&
+		   attribute_count <= GraphContext_AttributeCount(gc);
+}
+
+static bool _LoadNodes
+(
+	ChangeLogOverlay *overlay,
+	Reader *r,
+	GraphContext *gc
+) {
+	if(!_ValidateSchema(r, gc)) return false;
+
+	uint64_t first;
+	uint64_t count;
+	if(!READ(r, first) || !READ(r, count)) return false;
+
+	for(NodeID id = first; id < first + count; id++) {
+		void *slot = (void *)r->p;
+		if(!_SkipNode(r)) return false;
+		raxInsert(overlay->nodes, (unsigned char *)&id, sizeof(id), slot, NULL);
+	}
+
+	return true;
+}
+
+static bool _LoadEdges
+(
+	ChangeLogOverlay *overlay,
+	Reader *r,
+	GraphContext *gc
+) {
+	if(!_ValidateSchema(r, gc)) return false;
+
+	uint64_t count;
+	if(!READ(r, count)) return false;
+
+	for(uint64_t i = 0; i < count; i++) {
+		EdgeID id;
+		if(!READ(r, id)) return false;
+		void *slot = (void *)r->p;
+		if(!_SkipEdge(r)) return false;
+		raxInsert(overlay->edges, (unsigned char *)&id, sizeof(id), slot, NULL);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// overlay API
+//------------------------------------------------------------------------------
+
+ChangeLogOverlay *ChangeLogOverlay_Load
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	ASSERT(ChangeLog_ShouldReplay());
+
+	ChangeLogOverlay *overlay = rm_calloc(1, sizeof(ChangeLogOverlay));
+	overlay->buf   = ChangeLog_ReadRecords(&overlay->len);
+	overlay->nodes = raxNew();
+	overlay->edges = raxNew();
+
+	size_t name_len = strlen(gc->graph_name);
+	Reader r = {overlay->buf, overlay->buf + overlay->len};
+	bool valid = true;
+
+	while(valid && r.p < r.end) {
+		uint64_t record_len;
+		uint8_t  type;
+		uint32_t record_name_len;
+
+		valid = READ(&r, record_len) && r.end - r.p >= (ptrdiff_t)record_len;
+		if(!valid) break;
+
+		// restrict reader to the current record
+		Reader record = {r.p, r.p + record_len};
+		r.p += record_len;
+
+		valid = READ(&record, type) && READ(&record, record_name_len) &&
+			record.end - record.p >= (ptrdiff_t)record_name_len;
+		if(!valid) break;
+
+		// skip records logged for other graphs
+		bool match = record_name_len == name_len &&
+			memcmp(record.p, gc->graph_name, name_len) == 0;
+		record.p += record_name_len;
+		if(!match) continue;
+
+		switch(type) {
+			case CHANGELOG_RECORD_NODES:
+				valid = _LoadNodes(overlay, &record, gc);
+				break;
+			case CHANGELOG_RECORD_EDGES:
+				valid = _LoadEdges(overlay, &record, gc);
+				break;
+			case CHANGELOG_RECORD_DROP:
+				// entities logged prior to the drop are irrelevant
+				raxFree(overlay->nodes);
+				raxFree(overlay->edges);
+				overlay->nodes   = raxNew();
+				overlay->edges   = raxNew();
+				overlay->dropped = true;
+				break;
+			default:
+				valid = false;
+				break;
+		}
+	}
+
+	if(!valid) {
+		RedisModule_Log(NULL, "warning",
+				"Change log of graph %s doesn't match its snapshot, "
+				"loading snapshot as is", gc->graph_name);
+		ChangeLogOverlay_Free(overlay);
+		return NULL;
+	}
+
+	if(!overlay->dropped && raxSize(overlay->nodes) == 0 &&
+	   raxSize(overlay->edges) == 0) {
+		ChangeLogOverlay_Free(overlay);
+		return NULL;
+	}
+
+	return overlay;
+}
+
+bool ChangeLogOverlay_ContainsNode
+(
+	const ChangeLogOverlay *overlay,
+	NodeID id
+) {
+	if(overlay == NULL) return false;
+	return overlay->dropped ||
+		raxFind(overlay->nodes, (unsigned char *)&id, sizeof(id)) != raxNotFound;
+}
+
+bool ChangeLogOverlay_ContainsEdge
+(
+	const ChangeLogOverlay *overlay,
+	EdgeID id
+) {
+	if(overlay == NULL) return false;
+	return overlay->dropped ||
+		raxFind(overlay->edges, (unsigned char *)&id, sizeof(id)) != raxNotFound;
+}
+
+static void _ApplyNode
+(
+	GraphContext *gc,
+	NodeID id,
+	Reader *r
+) {
+	uint8_t alive;
+	READ(r, alive);
+
+	if(!alive) {
+		Serializer_Graph_MarkNodeDeleted(gc->g, id);
+		return;
+	}
+
+	uint32_t label_count;
+	READ(r, label_count);
+	LabelID labels[label_count];
+	for(uint32_t i = 0; i < label_count; i++) {
+		uint32_t l;
+		READ(r, l);
+		labels[i] = l;
+	}
+
+	Node n;
+	Serializer_Graph_SetNode(gc->g, id, labels, label_count, &n);
+	_ReadAttributes(r, (GraphEntity *)&n);
+
+	// introduce n to each relevant index
+	for(uint32_t i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		if(s->index) Index_IndexNode(s->index, &n);
+		if(s->fulltextIdx) Index_IndexNode(s->fulltextIdx, &n);
+	}
+}
+
+static void _ApplyEdge
+(
+	GraphContext *gc,
+	EdgeID id,
+	Reader *r
+) {
+	uint8_t alive;
+	READ(r, alive);
+
+	if(!alive) {
+		Serializer_Graph_MarkEdgeDeleted(gc->g, id);
+		return;
+	}
+
+	uint64_t src;
+	uint64_t dest;
+	uint32_t relation;
+	READ(r, src);
+	READ(r, dest);
+	READ(r, relation);
+
+	// entry might already hold an edge loaded from the snapshot
+	Edge e;
+	Serializer_Graph_SetEdge(gc->g, true, id, src, dest, relation, &e);
+	_ReadAttributes(r, (GraphEntity *)&e);
+
+	Schema *s = GraphContext_GetSchemaByID(gc, relation, SCHEMA_EDGE);
+	ASSERT(s != NULL);
+	if(s->index) Index_IndexEdge(s->index, &e);
+	if(s->fulltextIdx) Index_IndexEdge(s->fulltextIdx, &e);
+}
+
+void ChangeLogOverlay_Apply
+(
+	ChangeLogOverlay *overlay,
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	ASSERT(overlay != NULL);
+
+	Graph       *g    =  gc->g;
+	const char  *end  =  overlay->buf + overlay->len;
+	raxIterator it;
+
+	// rax keys are in host byte order, don't rely on iteration order
+	NodeID max_id = 0;
+	raxStart(&it, overlay->nodes);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		NodeID id;
+		memcpy(&id, it.key, sizeof(id));
+		max_id = MAX(max_id, id);
+	}
+
+	// grow matrices to accommodate logged nodes
+	if(raxSize(overlay->nodes) > 0) {
+		DataBlock_Ensure(g->nodes, max_id);
+		Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+		Graph_ApplyAllPending(g, false);
+		Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+	}
+
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		NodeID id;
+		memcpy(&id, it.key, sizeof(id));
+		Reader r = {it.data, end};
+		_ApplyNode(gc, id, &r);
+	}
+	raxStop(&it);
+
+	raxStart(&it, overlay->edges);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		EdgeID id;
+		memcpy(&id, it.key, sizeof(id));
+		Reader r = {it.data, end};
+		_ApplyEdge(gc, id, &r);
+	}
+	raxStop(&it);
+
+	RedisModule_Log(NULL, "notice",
+			"Replayed %" PRIu64 " nodes and %" PRIu64
+			" edges of graph %s from change log", raxSize(overlay->nodes),
+			raxSize(overlay->edges), gc->graph_name);
+}
+
+void ChangeLogOverlay_Free
+(
+	ChangeLogOverlay *overlay
+) {
+	ASSERT(overlay != NULL);
+
+	raxFree(overlay->nodes);
+	raxFree(overlay->edges);
+	rm_free(overlay->buf);
+	rm_free(overlay);
+}
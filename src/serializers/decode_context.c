@@ -9,6 +9,7 @@
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "../util/rax_extensions.h"
+#include "changelog/changelog.h"
 
 GraphDecodeContext *GraphDecodeContext_New() {
 	GraphDecodeContext *ctx = rm_malloc(sizeof(GraphDecodeContext));
@@ -16,6 +17,7 @@ GraphDecodeContext *GraphDecodeContext_New() {
 	ctx->graph_keys_count = 1;
 	ctx->meta_keys = raxNew();
 	ctx->multi_edge = NULL;
+	ctx->changes = NULL;
 	return ctx;
 }
 
@@ -82,6 +84,8 @@ void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 			ctx->multi_edge = NULL;
 		}
 
+		if(ctx->changes) ChangeLogOverlay_Free(ctx->changes);
+
 		rm_free(ctx);
 	}
 }
@@ -17,6 +17,7 @@ typedef struct {
 	uint64_t graph_keys_count;  // The number of keys representing the graph.
 	rax *meta_keys;             // The meta keys encountered so far in the decode process.
 	uint64_t *multi_edge;       // Is relation contains multi edge values.
+	struct ChangeLogOverlay *changes;  // Logged changes to apply on top of the decoded graph.
 } GraphDecodeContext;
 
 // Creates a new graph decoding context.
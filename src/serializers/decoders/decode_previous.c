@@ -15,6 +15,8 @@ GraphContext *Decode_Previous(RedisModuleIO *rdb, int encver) {
 		return RdbLoadGraphContext_v9(rdb);
 	case 10:
 		return RdbLoadGraphContext_v10(rdb);
+	case 11:
+		return RdbLoadGraphContext_v11(rdb);
 	default:
 		ASSERT(false && "attempted to read unsupported RedisGraph version from RDB file.");
 		return NULL;
@@ -7,3 +7,4 @@
 #include "v8/decode_v8.h"
 #include "v9/decode_v9.h"
 #include "v10/decode_v10.h"
+#include "v11/decode_v11.h"
@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
 #include "../../../datatypes/datatypes.h"
 
 // forword decleration
@@ -119,7 +119,7 @@ static void _RdbSaveEdge
 	_RdbSaveEntity(rdb, (GraphEntity *)e);
 }
 
-static void _RdbSaveNode_v11
+static void _RdbSaveNode_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -149,7 +149,7 @@ static void _RdbSaveNode_v11
 	_RdbSaveEntity(rdb, (GraphEntity *)n);
 }
 
-static void _RdbSaveDeletedEntities_v11
+static void _RdbSaveDeletedEntities_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -165,7 +165,7 @@ static void _RdbSaveDeletedEntities_v11
 	}
 }
 
-void RdbSaveDeletedNodes_v11
+void RdbSaveDeletedNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -177,10 +177,10 @@ void RdbSaveDeletedNodes_v11
 	if(deleted_nodes_to_encode == 0) return;
 	// get deleted nodes list
 	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
-	_RdbSaveDeletedEntities_v11(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
 }
 
-void RdbSaveDeletedEdges_v11
+void RdbSaveDeletedEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -193,10 +193,10 @@ void RdbSaveDeletedEdges_v11
 
 	// get deleted edges list
 	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
-	_RdbSaveDeletedEntities_v11(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
 }
 
-void RdbSaveNodes_v11
+void RdbSaveNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -227,7 +227,7 @@ void RdbSaveNodes_v11
 	for(uint64_t i = 0; i < nodes_to_encode; i++) {
 		GraphEntity e;
 		e.attributes = (AttributeSet *)DataBlockIterator_Next(iter, &e.id);
-		_RdbSaveNode_v11(rdb, gc, &e);
+		_RdbSaveNode_v12(rdb, gc, &e);
 	}
 
 	// check if done encodeing nodes
@@ -276,7 +276,7 @@ static void _RdbSaveMultipleEdges
 	*multiple_edges_current_index = i;
 }
 
-void RdbSaveEdges_v11
+void RdbSaveEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
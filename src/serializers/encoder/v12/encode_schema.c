@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
 
 static void _RdbSaveAttributeKeys
 (
@@ -98,6 +98,56 @@ static inline void _RdbSaveExactMatchIndex
 	}
 }
 
+static inline void _RdbSaveCompositeIndices
+(
+	RedisModuleIO *rdb,
+	Index *idx
+) {
+	/* Format, per composite:
+	 * type
+	 * #properties - M
+	 * M * property */
+
+	if(!idx) return;
+
+	uint composite_count = Index_CompositeCount(idx);
+	const IndexComposite *composites = Index_GetComposites(idx);
+	for(uint i = 0; i < composite_count; i++) {
+		const IndexComposite *composite = composites + i;
+		uint fields_count = array_len(composite->fields);
+
+		RedisModule_SaveUnsigned(rdb, IDX_COMPOSITE);
+		RedisModule_SaveUnsigned(rdb, fields_count);
+		for(uint j = 0; j < fields_count; j++) {
+			const char *field_name = composite->fields[j];
+			RedisModule_SaveStringBuffer(rdb, field_name,
+					strlen(field_name) + 1);
+		}
+	}
+}
+
+static inline void _RdbSaveUniqueConstraints
+(
+	RedisModuleIO *rdb,
+	Index *idx
+) {
+	/* Format, per constrained field:
+	 * type
+	 * property */
+
+	if(!idx) return;
+
+	uint fields_count = Index_FieldsCount(idx);
+	const IndexField *fields = Index_GetFields(idx);
+	for(uint i = 0; i < fields_count; i++) {
+		if(!fields[i].unique) continue;
+
+		const char *field_name = fields[i].name;
+		RedisModule_SaveUnsigned(rdb, IDX_UNIQUE);
+		RedisModule_SaveStringBuffer(rdb, field_name, strlen(field_name) + 1);
+	}
+}
+
 static inline void _RdbSaveIndexData
 (
 	RedisModuleIO *rdb,
@@ -136,11 +186,17 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	// Exact match indices.
 	_RdbSaveIndexData(rdb, s->type, s->index);
 
+	// Composites, following the exact match index they're part of.
+	_RdbSaveCompositeIndices(rdb, s->index);
+
+	// Unique constraints, following the exact match index backing them.
+	_RdbSaveUniqueConstraints(rdb, s->index);
+
 	// Fulltext indices.
 	_RdbSaveIndexData(rdb, s->type, s->fulltextIdx);
 }
 
-void RdbSaveGraphSchema_v11(RedisModuleIO *rdb, GraphContext *gc) {
+void RdbSaveGraphSchema_v12(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
 	 * attribute keys (unified schema)
 	 * #node schemas
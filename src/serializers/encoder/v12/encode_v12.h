@@ -8,41 +8,41 @@
 
 #include "../../serializers_include.h"
 
-void RdbSaveGraph_v11
+void RdbSaveGraph_v12
 (
 	RedisModuleIO *rdb,
 	void *value
 );
 
-void RdbSaveNodes_v11
+void RdbSaveNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t nodes_to_encode
 );
 
-void RdbSaveDeletedNodes_v11
+void RdbSaveDeletedNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t deleted_nodes_to_encode
 );
 
-void RdbSaveEdges_v11
+void RdbSaveEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t edges_to_encode
 );
 
-void RdbSaveDeletedEdges_v11
+void RdbSaveDeletedEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t deleted_edges_to_encode
 );
 
-void RdbSaveGraphSchema_v11
+void RdbSaveGraphSchema_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc
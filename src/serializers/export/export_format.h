@@ -0,0 +1,67 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// columnar graph export format, shared by GRAPH.EXPORT and GRAPH.IMPORT
+//
+// File format:
+//  magic
+//  attribute names
+//  label names
+//  relationship type names
+//  nodes section
+//  edges section X #relationship types
+//
+// names: #names, (length, name) X #names, names are NULL terminated
+//
+// nodes section:
+//  #nodes
+//  (#members, member positions X #members) X #labels
+//  #columns, column X #columns
+//
+// edges section:
+//  #edges
+//  source positions X #edges
+//  destination positions X #edges
+//  #columns, column X #columns
+//
+// entities are identified by their position within their section
+// nodes are exported in ID order, as such importing nodes in order
+// assigns each node an ID equal to its position
+//
+// column, a single attribute across a section:
+//  attribute ID
+//  #values
+//  rows X #values   positions of the entities holding the attribute, ascending
+//  types X #values  one byte per value, ExportValueType
+//  fixed X #values  8 bytes per value
+//                   booleans, integers, doubles and points are inlined
+//                   strings and arrays hold an offset into the heap
+//  heap length, heap
+//
+// heap:
+//  string: length, string, NULL terminated
+//  array: #elements, (type, payload) X #elements
+//   where payload is 8 bytes for inlined types and a heap encoding otherwise
+//
+// numbers are stored in host byte order, files aren't portable across
+// architectures
+
+#define EXPORT_MAGIC      "RGEXPRT1"
+#define EXPORT_MAGIC_LEN  8
+
+typedef enum {
+	EXPORT_BOOL   = 0,
+	EXPORT_INT64  = 1,
+	EXPORT_DOUBLE = 2,
+	EXPORT_POINT  = 3,
+	EXPORT_STRING = 4,
+	EXPORT_ARRAY  = 5,
+	EXPORT_NULL   = 6,  // array elements only
+} ExportValueType;
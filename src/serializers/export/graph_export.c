@@ -0,0 +1,503 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "graph_export.h"
+#include "export_format.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../util/qsort.h"
+#include "../../util/sds/sds.h"
+#include "../../datatypes/array.h"
+#include "../../datatypes/point.h"
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+
+// attribute values of a single section, see export_format.h
+typedef struct {
+	uint64_t *rows;   // entity positions
+	uint8_t *types;   // value types
+	uint64_t *fixed;  // inlined values or heap offsets
+	sds heap;         // variable length values
+} Column;
+
+typedef struct {
+	FILE *f;          // output file
+	Graph *g;         // exported graph
+	uint64_t *map;    // node ID to node position
+} Exporter;
+
+#define ISLT(a, b) ((*a) < (*b))
+#define WRITE(f, v) fwrite(&(v), sizeof(v), 1, (f))
+#define HEAP_WRITE(heap, v) (heap) = sdscatlen((heap), &(v), sizeof(v))
+
+//------------------------------------------------------------------------------
+// values
+//------------------------------------------------------------------------------
+
+static sds _HeapWriteValue
+(
+	sds heap,
+	SIValue v
+);
+
+static ExportValueType _ValueType
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_BOOL:
+			return EXPORT_BOOL;
+		case T_INT64:
+			return EXPORT_INT64;
+		case T_DOUBLE:
+			return EXPORT_DOUBLE;
+		case T_POINT:
+			return EXPORT_POINT;
+		case T_STRING:
+			return EXPORT_STRING;
+		case T_ARRAY:
+			return EXPORT_ARRAY;
+		case T_NULL:
+			return EXPORT_NULL;
+		default:
+			ASSERT(false && "Attempted to export value of invalid type.");
+			return EXPORT_NULL;
+	}
+}
+
+// returns the 8 bytes representation of an inlined value
+static uint64_t _InlineValue
+(
+	SIValue v
+) {
+	uint64_t x = 0;
+	switch(SI_TYPE(v)) {
+		case T_BOOL:
+		case T_INT64:
+			memcpy(&x, &v.longval, sizeof(x));
+			break;
+		case T_DOUBLE:
+			memcpy(&x, &v.doubleval, sizeof(x));
+			break;
+		case T_POINT: {
+			float coords[2] = {Point_lat(v), Point_lon(v)};
+			memcpy(&x, coords, sizeof(x));
+			break;
+		}
+		default:
+			break;
+	}
+	return x;
+}
+
+static inline bool _IsInlined
+(
+	ExportValueType t
+) {
+	return t != EXPORT_STRING && t != EXPORT_ARRAY;
+}
+
+// writes a string or an array to the heap
+static sds _HeapWriteValue
+(
+	sds heap,
+	SIValue v
+) {
+	if(SI_TYPE(v) == T_STRING) {
+		uint32_t len = strlen(v.stringval) + 1;
+		HEAP_WRITE(heap, len);
+		return sdscatlen(heap, v.stringval, len);
+	}
+
+	ASSERT(SI_TYPE(v) == T_ARRAY);
+
+	uint32_t len = SIArray_Length(v);
+	HEAP_WRITE(heap, len);
+	for(uint32_t i = 0; i < len; i++) {
+		SIValue elem = SIArray_Get(v, i);
+		uint8_t t = _ValueType(elem);
+		HEAP_WRITE(heap, t);
+		if(_IsInlined(t)) {
+			uint64_t x = _InlineValue(elem);
+			HEAP_WRITE(heap, x);
+		} else {
+			heap = _HeapWriteValue(heap, elem);
+		}
+	}
+
+	return heap;
+}
+
+//------------------------------------------------------------------------------
+// columns
+//------------------------------------------------------------------------------
+
+static void _Column_Init
+(
+	Column *c
+) {
+	c->rows  = array_new(uint64_t, 0);
+	c->types = array_new(uint8_t, 0);
+	c->fixed = array_new(uint64_t, 0);
+	c->heap  = sdsempty();
+}
+
+static void _Column_Clear
+(
+	Column *c
+) {
+	array_clear(c->rows);
+	array_clear(c->types);
+	array_clear(c->fixed);
+	sdsclear(c->heap);
+}
+
+static void _Column_Free
+(
+	Column *c
+) {
+	array_free(c->rows);
+	array_free(c->types);
+	array_free(c->fixed);
+	sdsfree(c->heap);
+}
+
+// adds entity's value of attribute 'attr' to the column, if it has one
+static void _Column_Add
+(
+	Column *c,
+	uint64_t row,
+	const AttributeSet set,
+	Attribute_ID attr
+) {
+	SIValue *v = AttributeSet_Get(set, attr);
+	if(v == ATTRIBUTE_NOTFOUND) return;
+
+	uint8_t t = _ValueType(*v);
+	uint64_t x;
+	if(_IsInlined(t)) {
+		x = _InlineValue(*v);
+	} else {
+		x = sdslen(c->heap);
+		c->heap = _HeapWriteValue(c->heap, *v);
+	}
+
+	array_append(c->rows, row);
+	array_append(c->types, t);
+	array_append(c->fixed, x);
+}
+
+static void _Column_Write
+(
+	FILE *f,
+	const Column *c,
+	Attribute_ID attr
+) {
+	uint32_t  attr_id  =  attr;
+	uint64_t  n        =  array_len(c->rows);
+	uint64_t  heap_len =  sdslen(c->heap);
+
+	WRITE(f, attr_id);
+	WRITE(f, n);
+	fwrite(c->rows, sizeof(uint64_t), n, f);
+	fwrite(c->types, sizeof(uint8_t), n, f);
+	fwrite(c->fixed, sizeof(uint64_t), n, f);
+	WRITE(f, heap_len);
+	fwrite(c->heap, 1, heap_len, f);
+}
+
+// marks attributes in use by 'set'
+static void _MarkAttributes
+(
+	bool *present,
+	const AttributeSet set
+) {
+	uint n = ATTRIBUTE_SET_COUNT(set);
+	for(uint i = 0; i < n; i++) {
+		Attribute_ID id;
+		AttributeSet_GetIdx(set, i, &id);
+		present[id] = true;
+	}
+}
+
+static uint32_t _CountPresent
+(
+	const bool *present,
+	uint attr_count
+) {
+	uint32_t n = 0;
+	for(uint i = 0; i < attr_count; i++) n += present[i];
+	return n;
+}
+
+//------------------------------------------------------------------------------
+// sections
+//------------------------------------------------------------------------------
+
+static void _WriteNames
+(
+	FILE *f,
+	const char **names
+) {
+	uint32_t n = array_len(names);
+	WRITE(f, n);
+	for(uint32_t i = 0; i < n; i++) {
+		uint32_t len = strlen(names[i]) + 1;
+		WRITE(f, len);
+		fwrite(names[i], 1, len, f);
+	}
+}
+
+static void _WriteSchemaNames
+(
+	FILE *f,
+	GraphContext *gc,
+	SchemaType t
+) {
+	uint n = GraphContext_SchemaCount(gc, t);
+	const char **names = array_new(const char *, n);
+	for(uint i = 0; i < n; i++) {
+		array_append(names, Schema_GetName(GraphContext_GetSchemaByID(gc, i, t)));
+	}
+	_WriteNames(f, names);
+	array_free(names);
+}
+
+static uint64_t _WriteNodes
+(
+	Exporter *exp,
+	uint attr_count
+) {
+	FILE     *f     =  exp->f;
+	Graph    *g     =  exp->g;
+	uint64_t n      =  Graph_NodeCount(g);
+	bool     *present = rm_calloc(attr_count, sizeof(bool));
+
+	WRITE(f, n);
+
+	// map node IDs to positions
+	uint64_t id;
+	uint64_t pos = 0;
+	AttributeSet *set;
+	DataBlockIterator *it = Graph_ScanNodes(g);
+	while((set = DataBlockIterator_Next(it, &id)) != NULL) {
+		exp->map[id] = pos++;
+		_MarkAttributes(present, *set);
+	}
+	DataBlockIterator_Free(it);
+	ASSERT(pos == n);
+
+	// label members
+	// pending additions are visited after the matrix itself, sort members
+	uint64_t *members = array_new(uint64_t, 0);
+	uint label_count = Graph_LabelTypeCount(g);
+	for(uint l = 0; l < label_count; l++) {
+		RG_Matrix L = Graph_GetLabelMatrix(g, l);
+
+		GrB_Index row;
+		RG_MatrixTupleIter iter = {0};
+		RG_MatrixTupleIter_attach(&iter, L);
+		while(RG_MatrixTupleIter_next_BOOL(&iter, &row, NULL, NULL) ==
+				GrB_SUCCESS) {
+			array_append(members, exp->map[row]);
+		}
+		RG_MatrixTupleIter_detach(&iter);
+
+		uint64_t member_count = array_len(members);
+		QSORT(uint64_t, members, member_count, ISLT);
+
+		WRITE(f, member_count);
+		fwrite(members, sizeof(uint64_t), member_count, f);
+		array_clear(members);
+	}
+	array_free(members);
+
+	// property columns
+	uint32_t column_count = _CountPresent(present, attr_count);
+	WRITE(f, column_count);
+
+	Column c;
+	_Column_Init(&c);
+	for(uint a = 0; a < attr_count; a++) {
+		if(!present[a]) continue;
+
+		_Column_Clear(&c);
+		pos = 0;
+		it = Graph_ScanNodes(g);
+		while((set = DataBlockIterator_Next(it, &id)) != NULL) {
+			_Column_Add(&c, pos++, *set, a);
+		}
+		DataBlockIterator_Free(it);
+
+		_Column_Write(f, &c, a);
+	}
+	_Column_Free(&c);
+
+	rm_free(present);
+	return n;
+}
+
+static uint64_t _WriteEdges
+(
+	Exporter *exp,
+	int r,
+	uint attr_count
+) {
+	FILE      *f       =  exp->f;
+	Graph     *g       =  exp->g;
+	RG_Matrix R        =  Graph_GetRelationMatrix(g, r, false);
+	NodeID    *src     =  array_new(NodeID, 0);
+	NodeID    *dest    =  array_new(NodeID, 0);
+	EdgeID    *ids     =  array_new(EdgeID, 0);
+	bool      *present =  rm_calloc(attr_count, sizeof(bool));
+
+	// collect edges, ordered by source
+	NodeID s;
+	NodeID d;
+	EdgeID x;
+	RG_MatrixTupleIter iter = {0};
+	RG_MatrixTupleIter_attach(&iter, R);
+	while(RG_MatrixTupleIter_next_UINT64(&iter, &s, &d, &x) == GrB_SUCCESS) {
+		if(SINGLE_EDGE(x)) {
+			array_append(src, exp->map[s]);
+			array_append(dest, exp->map[d]);
+			array_append(ids, x);
+		} else {
+			EdgeID *multi = (EdgeID *)(CLEAR_MSB(x));
+			uint k = array_len(multi);
+			for(uint i = 0; i < k; i++) {
+				array_append(src, exp->map[s]);
+				array_append(dest, exp->map[d]);
+				array_append(ids, multi[i]);
+			}
+		}
+	}
+	RG_MatrixTupleIter_detach(&iter);
+
+	uint64_t n = array_len(ids);
+	WRITE(f, n);
+	fwrite(src, sizeof(NodeID), n, f);
+	fwrite(dest, sizeof(NodeID), n, f);
+
+	Edge e;
+	for(uint64_t i = 0; i < n; i++) {
+		Graph_GetEdge(g, ids[i], &e);
+		_MarkAttributes(present, *e.attributes);
+	}
+
+	// property columns
+	uint32_t column_count = _CountPresent(present, attr_count);
+	WRITE(f, column_count);
+
+	Column c;
+	_Column_Init(&c);
+	for(uint a = 0; a < attr_count; a++) {
+		if(!present[a]) continue;
+
+		_Column_Clear(&c);
+		for(uint64_t i = 0; i < n; i++) {
+			Graph_GetEdge(g, ids[i], &e);
+			_Column_Add(&c, i, *e.attributes, a);
+		}
+
+		_Column_Write(f, &c, a);
+	}
+	_Column_Free(&c);
+
+	array_free(src);
+	array_free(dest);
+	array_free(ids);
+	rm_free(present);
+
+	return n;
+}
+
+//------------------------------------------------------------------------------
+// export API
+//------------------------------------------------------------------------------
+
+bool GraphExport_ValidFilename
+(
+	const char *filename
+) {
+	ASSERT(filename != NULL);
+
+	return filename[0] != '\0'           &&
+		   strchr(filename, '/') == NULL &&
+		   strstr(filename, "..") == NULL;
+}
+
+bool GraphExport_Write
+(
+	GraphContext *gc,
+	const char *path,
+	uint64_t *nodes,
+	uint64_t *edges,
+	char **err
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(err   != NULL);
+	ASSERT(path  != NULL);
+	ASSERT(nodes != NULL);
+	ASSERT(edges != NULL);
+
+	// write to a temporary file, replace destination once complete
+	char *tmp_path;
+	asprintf(&tmp_path, "%s.tmp", path);
+
+	FILE *f = fopen(tmp_path, "wb");
+	if(f == NULL) {
+		asprintf(err, "Failed to create file '%s': %s", tmp_path,
+				strerror(errno));
+		free(tmp_path);
+		return false;
+	}
+
+	Graph *g = gc->g;
+	uint attr_count = GraphContext_AttributeCount(gc);
+	Exporter exp = {
+		.f   = f,
+		.g   = g,
+		.map = rm_malloc(sizeof(uint64_t) * (Graph_UncompactedNodeCount(g) + 1))
+	};
+
+	fwrite(EXPORT_MAGIC, 1, EXPORT_MAGIC_LEN, f);
+
+	// schema
+	const char **attrs = array_new(const char *, attr_count);
+	for(uint i = 0; i < attr_count; i++) {
+		array_append(attrs, GraphContext_GetAttributeString(gc, i));
+	}
+	_WriteNames(f, attrs);
+	array_free(attrs);
+
+	_WriteSchemaNames(f, gc, SCHEMA_NODE);
+	_WriteSchemaNames(f, gc, SCHEMA_EDGE);
+
+	// entities
+	*nodes = _WriteNodes(&exp, attr_count);
+	*edges = 0;
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		*edges += _WriteEdges(&exp, r, attr_count);
+	}
+
+	rm_free(exp.map);
+
+	bool failed = ferror(f);
+	failed |= (fclose(f) != 0);
+	if(!failed) failed = (rename(tmp_path, path) != 0);
+
+	if(failed) {
+		asprintf(err, "Failed to write file '%s': %s", path, strerror(errno));
+		remove(tmp_path);
+	}
+
+	free(tmp_path);
+	return !failed;
+}
@@ -0,0 +1,83 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../graph/graphcontext.h"
+
+// columnar export and import of a graph to and from a local file
+// see export_format.h for the file layout
+
+typedef struct GraphImport GraphImport;
+
+// files are resolved relative to the server's working directory
+// returns false if 'filename' refers to a path outside of it
+bool GraphExport_ValidFilename
+(
+	const char *filename
+);
+
+// writes graph to 'path'
+// caller is expected to hold the graph's read lock
+// returns false on failure, 'err' is set and should be freed by the caller
+bool GraphExport_Write
+(
+	GraphContext *gc,     // graph to export
+	const char *path,     // file to write
+	uint64_t *nodes,      // [output] number of exported nodes
+	uint64_t *edges,      // [output] number of exported edges
+	char **err            // [output] error message
+);
+
+// opens and validates an exported graph file
+// returns NULL on failure, 'err' is set and should be freed by the caller
+GraphImport *GraphImport_Open
+(
+	const char *path,  // file to read
+	char **err         // [output] error message
+);
+
+// opens and validates an exported graph held in memory
+// 'data' must outlive the returned import
+// returns NULL on failure, 'err' is set and should be freed by the caller
+GraphImport *GraphImport_OpenBuffer
+(
+	const char *data,  // exported graph
+	size_t len,        // content length
+	char **err         // [output] error message
+);
+
+// raw content of the exported graph
+const char *GraphImport_Content
+(
+	const GraphImport *imp,  // opened file
+	size_t *len              // [output] content length
+);
+
+// number of nodes held by file
+uint64_t GraphImport_NodeCount
+(
+	const GraphImport *imp
+);
+
+// number of edges held by file
+uint64_t GraphImport_EdgeCount
+(
+	const GraphImport *imp
+);
+
+// populates an empty graph with the file's content
+void GraphImport_Load
+(
+	GraphImport *imp,  // opened file
+	GraphContext *gc   // graph to populate
+);
+
+// closes file
+void GraphImport_Free
+(
+	GraphImport *imp
+);
@@ -0,0 +1,621 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "graph_export.h"
+#include "export_format.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../datatypes/array.h"
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// number of edges created at once
+#define EDGE_BATCH_SIZE 1048576
+
+// bounded cursor over the mapped file
+typedef struct {
+	const char *p;
+	const char *end;
+} Reader;
+
+// a single attribute across a section, pointing into the mapped file
+// arrays might be unaligned and are accessed via memcpy
+typedef struct {
+	uint32_t attr;       // attribute position within file
+	uint64_t n;          // number of values
+	const char *rows;    // entity positions
+	const char *types;   // value types
+	const char *fixed;   // inlined values or heap offsets
+	const char *heap;    // variable length values
+	uint64_t heap_len;   // heap size
+} ColumnView;
+
+typedef struct {
+	uint64_t n;           // number of entities
+	const char *src;      // edge source positions
+	const char *dest;     // edge destination positions
+	ColumnView *columns;  // property columns
+} Section;
+
+struct GraphImport {
+	char *data;                // mapped file or in memory content
+	size_t len;                // file size
+	bool mapped;               // data is a mapped file
+	const char **attrs;        // attribute names
+	const char **labels;       // label names
+	const char **relations;    // relationship type names
+	const char **members;      // label members, per label
+	uint64_t *member_counts;   // number of members, per label
+	Section nodes;             // nodes section
+	Section *edges;            // edges section, per relationship type
+	uint64_t edge_count;       // total number of edges
+};
+
+static inline bool _Read
+(
+	Reader *r,
+	void *v,
+	size_t n
+) {
+	if((size_t)(r->end - r->p) < n) return false;
+	memcpy(v, r->p, n);
+	r->p += n;
+	return true;
+}
+
+#define READ(r, v) _Read((r), &(v), sizeof(v))
+
+// skips an array of 'n' elements of 'size' bytes, returns its start
+static inline const char *_Skip
+(
+	Reader *r,
+	uint64_t n,
+	size_t size
+) {
+	if(n > (uint64_t)(r->end - r->p) / size) return NULL;
+	const char *start = r->p;
+	r->p += n * size;
+	return start;
+}
+
+static inline uint64_t _Get64
+(
+	const char *arr,
+	uint64_t i
+) {
+	uint64_t x;
+	memcpy(&x, arr + i * sizeof(uint64_t), sizeof(x));
+	return x;
+}
+
+//------------------------------------------------------------------------------
+// values
+//------------------------------------------------------------------------------
+
+static SIValue _InlinedValue
+(
+	uint8_t t,
+	uint64_t x
+) {
+	switch(t) {
+		case EXPORT_BOOL:
+			return SI_BoolVal(x);
+		case EXPORT_INT64: {
+			int64_t l;
+			memcpy(&l, &x, sizeof(l));
+			return SI_LongVal(l);
+		}
+		case EXPORT_DOUBLE: {
+			double d;
+			memcpy(&d, &x, sizeof(d));
+			return SI_DoubleVal(d);
+		}
+		case EXPORT_POINT: {
+			float coords[2];
+			memcpy(coords, &x, sizeof(coords));
+			return SI_Point(coords[0], coords[1]);
+		}
+		default:
+			return SI_NullVal();
+	}
+}
+
+// reads a heap encoded value, 'v' is NULL when value is validated only
+static bool _HeapReadValue
+(
+	Reader *r,
+	uint8_t t,
+	SIValue *v
+) {
+	uint32_t len;
+	if(!READ(r, len)) return false;
+
+	if(t == EXPORT_STRING) {
+		const char *s = _Skip(r, len, 1);
+		if(len == 0 || s == NULL || s[len - 1] != '\0') return false;
+		// string is cloned once added to an entity
+		if(v) *v = SI_ConstStringVal((char *)s);
+		return true;
+	}
+
+	if(t != EXPORT_ARRAY) return false;
+
+	if(v) *v = SI_Array(len);
+	for(uint32_t i = 0; i < len; i++) {
+		uint8_t elem_t;
+		SIValue elem = SI_NullVal();
+		bool valid = READ(r, elem_t) && elem_t <= EXPORT_NULL;
+		if(valid && elem_t != EXPORT_STRING && elem_t != EXPORT_ARRAY) {
+			uint64_t x;
+			valid = READ(r, x);
+			elem = _InlinedValue(elem_t, x);
+		} else if(valid) {
+			valid = _HeapReadValue(r, elem_t, v ? &elem : NULL);
+		}
+
+		if(!valid) {
+			if(v) SIValue_Free(*v);
+			return false;
+		}
+
+		if(v) {
+			SIArray_Append(v, elem);
+			SIValue_Free(elem);
+		}
+	}
+
+	return true;
+}
+
+// reads the k'th value of column, 'v' is NULL when value is validated only
+static bool _ColumnValue
+(
+	const ColumnView *c,
+	uint64_t k,
+	SIValue *v
+) {
+	uint8_t t = c->types[k];
+	uint64_t x = _Get64(c->fixed, k);
+
+	if(t > EXPORT_ARRAY) return false;
+
+	if(t != EXPORT_STRING && t != EXPORT_ARRAY) {
+		if(v) *v = _InlinedValue(t, x);
+		return true;
+	}
+
+	if(x >= c->heap_len) return false;
+	Reader r = {.p = c->heap + x, .end = c->heap + c->heap_len};
+	return _HeapReadValue(&r, t, v);
+}
+
+//------------------------------------------------------------------------------
+// parsing
+//------------------------------------------------------------------------------
+
+static bool _ReadNames
+(
+	Reader *r,
+	const char ***names
+) {
+	uint32_t n;
+	if(!READ(r, n)) return false;
+
+	*names = array_new(const char *, 0);
+	for(uint32_t i = 0; i < n; i++) {
+		uint32_t len;
+		if(!READ(r, len)) return false;
+		const char *name = _Skip(r, len, 1);
+		if(len < 2 || name == NULL || name[len - 1] != '\0') return false;
+		array_append(*names, name);
+	}
+
+	return true;
+}
+
+static bool _ReadColumns
+(
+	Reader *r,
+	Section *s,
+	uint attr_count
+) {
+	uint32_t n;
+	if(!READ(r, n)) return false;
+	if(n > attr_count) return false;
+
+	bool valid = true;
+	bool *seen = rm_calloc(attr_count, sizeof(bool));
+	s->columns = array_new(ColumnView, n);
+
+	for(uint32_t i = 0; i < n && valid; i++) {
+		ColumnView c;
+		valid = READ(r, c.attr) && c.attr < attr_count && !seen[c.attr] &&
+			READ(r, c.n) && c.n <= s->n &&
+			(c.rows  = _Skip(r, c.n, sizeof(uint64_t))) != NULL &&
+			(c.types = _Skip(r, c.n, sizeof(uint8_t)))  != NULL &&
+			(c.fixed = _Skip(r, c.n, sizeof(uint64_t))) != NULL &&
+			READ(r, c.heap_len) &&
+			(c.heap  = _Skip(r, c.heap_len, 1)) != NULL;
+		if(!valid) break;
+
+		seen[c.attr] = true;
+		array_append(s->columns, c);
+
+		// rows are strictly ascending, each entity holds a single value
+		for(uint64_t k = 0; k < c.n && valid; k++) {
+			uint64_t row = _Get64(c.rows, k);
+			valid = row < s->n && (k == 0 || row > _Get64(c.rows, k - 1)) &&
+				_ColumnValue(&c, k, NULL);
+		}
+	}
+
+	rm_free(seen);
+	return valid;
+}
+
+static bool _Parse
+(
+	GraphImport *imp
+) {
+	Reader r = {.p = imp->data, .end = imp->data + imp->len};
+
+	const char *magic = _Skip(&r, EXPORT_MAGIC_LEN, 1);
+	if(magic == NULL || memcmp(magic, EXPORT_MAGIC, EXPORT_MAGIC_LEN) != 0) {
+		return false;
+	}
+
+	if(!_ReadNames(&r, &imp->attrs))     return false;
+	if(!_ReadNames(&r, &imp->labels))    return false;
+	if(!_ReadNames(&r, &imp->relations)) return false;
+
+	uint attr_count     = array_len(imp->attrs);
+	uint label_count    = array_len(imp->labels);
+	uint relation_count = array_len(imp->relations);
+
+	//--------------------------------------------------------------------------
+	// nodes
+	//--------------------------------------------------------------------------
+
+	uint64_t node_count;
+	if(!READ(&r, node_count)) return false;
+	imp->nodes.n = node_count;
+
+	imp->members       = array_new(const char *, label_count);
+	imp->member_counts = array_new(uint64_t, label_count);
+	for(uint l = 0; l < label_count; l++) {
+		uint64_t n;
+		if(!READ(&r, n) || n > node_count) return false;
+		const char *members = _Skip(&r, n, sizeof(uint64_t));
+		if(members == NULL) return false;
+
+		// members are strictly ascending
+		for(uint64_t k = 0; k < n; k++) {
+			uint64_t m = _Get64(members, k);
+			if(m >= node_count) return false;
+			if(k > 0 && m <= _Get64(members, k - 1)) return false;
+		}
+
+		array_append(imp->members, members);
+		array_append(imp->member_counts, n);
+	}
+
+	if(!_ReadColumns(&r, &imp->nodes, attr_count)) return false;
+
+	//--------------------------------------------------------------------------
+	// edges
+	//--------------------------------------------------------------------------
+
+	imp->edges = rm_calloc(relation_count, sizeof(Section));
+	for(uint i = 0; i < relation_count; i++) {
+		Section *s = imp->edges + i;
+		if(!READ(&r, s->n)) return false;
+		s->src  = _Skip(&r, s->n, sizeof(uint64_t));
+		s->dest = _Skip(&r, s->n, sizeof(uint64_t));
+		if(s->src == NULL || s->dest == NULL) return false;
+
+		for(uint64_t k = 0; k < s->n; k++) {
+			if(_Get64(s->src, k)  >= node_count) return false;
+			if(_Get64(s->dest, k) >= node_count) return false;
+		}
+
+		if(!_ReadColumns(&r, s, attr_count)) return false;
+		imp->edge_count += s->n;
+	}
+
+	// trailing bytes indicate a malformed file
+	return r.p == r.end;
+}
+
+//------------------------------------------------------------------------------
+// loading
+//------------------------------------------------------------------------------
+
+static void _LoadColumns
+(
+	Graph *g,
+	const Section *s,
+	const Attribute_ID *attr_ids,
+	const EdgeID *edge_ids  // NULL for nodes
+) {
+	uint n = array_len(s->columns);
+	for(uint i = 0; i < n; i++) {
+		const ColumnView *c = s->columns + i;
+		Attribute_ID attr = attr_ids[c->attr];
+
+		for(uint64_t k = 0; k < c->n; k++) {
+			uint64_t row = _Get64(c->rows, k);
+
+			GraphEntity *e;
+			Node node;
+			Edge edge;
+			if(edge_ids) {
+				Graph_GetEdge(g, edge_ids[row], &edge);
+				e = (GraphEntity *)&edge;
+			} else {
+				Graph_GetNode(g, row, &node);
+				e = (GraphEntity *)&node;
+			}
+
+			SIValue v;
+			bool valid = _ColumnValue(c, k, &v);
+			UNUSED(valid);
+			ASSERT(valid);
+
+			GraphEntity_AddProperty(e, attr, v);
+			SIValue_Free(v);
+		}
+	}
+}
+
+static void _LoadEdges
+(
+	Graph *g,
+	const Section *s,
+	int r,
+	const Attribute_ID *attr_ids
+) {
+	if(s->n == 0) return;
+
+	EdgeID *ids  = rm_malloc(sizeof(EdgeID) * s->n);
+	uint64_t batch_size = MIN(s->n, EDGE_BATCH_SIZE);
+	Edge *batch  = rm_malloc(sizeof(Edge) * batch_size);
+	Edge **edges = array_new(Edge *, batch_size);
+
+	for(uint64_t offset = 0; offset < s->n; offset += batch_size) {
+		uint64_t n = MIN(batch_size, s->n - offset);
+
+		array_clear(edges);
+		for(uint64_t k = 0; k < n; k++) {
+			Edge *e = batch + k;
+			e->srcNodeID  = _Get64(s->src, offset + k);
+			e->destNodeID = _Get64(s->dest, offset + k);
+			array_append(edges, e);
+		}
+
+		Graph_CreateEdges(g, r, edges);
+
+		for(uint64_t k = 0; k < n; k++) ids[offset + k] = batch[k].id;
+	}
+
+	_LoadColumns(g, s, attr_ids, ids);
+
+	array_free(edges);
+	rm_free(batch);
+	rm_free(ids);
+}
+
+//------------------------------------------------------------------------------
+// import API
+//------------------------------------------------------------------------------
+
+GraphImport *GraphImport_Open
+(
+	const char *path,
+	char **err
+) {
+	ASSERT(err  != NULL);
+	ASSERT(path != NULL);
+
+	int fd = open(path, O_RDONLY);
+	if(fd == -1) {
+		asprintf(err, "Failed to open file '%s': %s", path, strerror(errno));
+		return NULL;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0) {
+		asprintf(err, "Failed to read file '%s'", path);
+		close(fd);
+		return NULL;
+	}
+
+	char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) {
+		asprintf(err, "Failed to read file '%s': %s", path, strerror(errno));
+		return NULL;
+	}
+
+	GraphImport *imp = rm_calloc(1, sizeof(GraphImport));
+	imp->data   = data;
+	imp->len    = st.st_size;
+	imp->mapped = true;
+
+	if(!_Parse(imp)) {
+		asprintf(err, "File '%s' is not a valid graph export", path);
+		GraphImport_Free(imp);
+		return NULL;
+	}
+
+	return imp;
+}
+
+GraphImport *GraphImport_OpenBuffer
+(
+	const char *data,
+	size_t len,
+	char **err
+) {
+	ASSERT(err  != NULL);
+	ASSERT(data != NULL);
+
+	GraphImport *imp = rm_calloc(1, sizeof(GraphImport));
+	imp->data   = (char *)data;
+	imp->len    = len;
+	imp->mapped = false;
+
+	if(!_Parse(imp)) {
+		asprintf(err, "Content is not a valid graph export");
+		GraphImport_Free(imp);
+		return NULL;
+	}
+
+	return imp;
+}
+
+const char *GraphImport_Content
+(
+	const GraphImport *imp,
+	size_t *len
+) {
+	ASSERT(imp != NULL);
+	ASSERT(len != NULL);
+
+	*len = imp->len;
+	return imp->data;
+}
+
+uint64_t GraphImport_NodeCount
+(
+	const GraphImport *imp
+) {
+	ASSERT(imp != NULL);
+	return imp->nodes.n;
+}
+
+uint64_t GraphImport_EdgeCount
+(
+	const GraphImport *imp
+) {
+	ASSERT(imp != NULL);
+	return imp->edge_count;
+}
+
+void GraphImport_Load
+(
+	GraphImport *imp,
+	GraphContext *gc
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(imp != NULL);
+
+	Graph *g = gc->g;
+	ASSERT(Graph_NodeCount(g) == 0);
+
+	//--------------------------------------------------------------------------
+	// schema
+	//--------------------------------------------------------------------------
+
+	uint attr_count     = array_len(imp->attrs);
+	uint label_count    = array_len(imp->labels);
+	uint relation_count = array_len(imp->relations);
+
+	Attribute_ID *attr_ids = rm_malloc(sizeof(Attribute_ID) * (attr_count + 1));
+	for(uint i = 0; i < attr_count; i++) {
+		attr_ids[i] = GraphContext_FindOrAddAttribute(gc, imp->attrs[i]);
+	}
+
+	int *label_ids = rm_malloc(sizeof(int) * (label_count + 1));
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchema(gc, imp->labels[i], SCHEMA_NODE);
+		if(s == NULL) s = GraphContext_AddSchema(gc, imp->labels[i], SCHEMA_NODE);
+		label_ids[i] = Schema_GetID(s);
+	}
+
+	int *relation_ids = rm_malloc(sizeof(int) * (relation_count + 1));
+	for(uint i = 0; i < relation_count; i++) {
+		Schema *s = GraphContext_GetSchema(gc, imp->relations[i], SCHEMA_EDGE);
+		if(s == NULL) s = GraphContext_AddSchema(gc, imp->relations[i], SCHEMA_EDGE);
+		relation_ids[i] = Schema_GetID(s);
+	}
+
+	//--------------------------------------------------------------------------
+	// entities
+	//--------------------------------------------------------------------------
+
+	// lock graph under write lock
+	// allocate space for new nodes and edges
+	// set graph sync policy to resize only
+	Graph_AcquireWriteLock(g);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	Graph_AllocateNodes(g, imp->nodes.n);
+	Graph_AllocateEdges(g, imp->edge_count);
+
+	// nodes are created in order, node IDs match their positions
+	for(uint64_t i = 0; i < imp->nodes.n; i++) {
+		Node n;
+		Graph_CreateNode(g, &n, NULL, 0);
+		ASSERT(n.id == i);
+	}
+
+	// label matrices are built one label at a time
+	for(uint l = 0; l < label_count; l++) {
+		uint64_t n = imp->member_counts[l];
+		if(n == 0) continue;
+
+		NodeID *ids = rm_malloc(sizeof(NodeID) * n);
+		memcpy(ids, imp->members[l], sizeof(NodeID) * n);
+		Graph_LabelNodes(g, label_ids[l], ids, n);
+		rm_free(ids);
+	}
+
+	_LoadColumns(g, &imp->nodes, attr_ids, NULL);
+
+	for(uint r = 0; r < relation_count; r++) {
+		_LoadEdges(g, imp->edges + r, relation_ids[r], attr_ids);
+	}
+
+	// back populated entity blocks by the storage tier
+	Graph_SealStorage(g);
+
+	// reset graph sync policy
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+	Graph_ReleaseLock(g);
+
+	rm_free(attr_ids);
+	rm_free(label_ids);
+	rm_free(relation_ids);
+}
+
+void GraphImport_Free
+(
+	GraphImport *imp
+) {
+	ASSERT(imp != NULL);
+
+	if(imp->attrs)         array_free(imp->attrs);
+	if(imp->labels)        array_free(imp->labels);
+	if(imp->relations)     array_free(imp->relations);
+	if(imp->members)       array_free(imp->members);
+	if(imp->member_counts) array_free(imp->member_counts);
+
+	if(imp->nodes.columns) array_free(imp->nodes.columns);
+	if(imp->edges) {
+		uint relation_count = array_len(imp->relations);
+		for(uint i = 0; i < relation_count; i++) {
+			if(imp->edges[i].columns) array_free(imp->edges[i].columns);
+		}
+		rm_free(imp->edges);
+	}
+
+	if(imp->mapped) munmap(imp->data, imp->len);
+	rm_free(imp);
+}
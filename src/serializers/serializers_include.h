@@ -26,6 +26,8 @@
 #include "graph_extensions.h"
 // Module configuration
 #include "../configuration/config.h"
+// Incremental persistence.
+#include "changelog/changelog.h"
 
 // This struct is used to describe the payload content of a key.
 // It contains the type and the number of entities that were encoded.
@@ -75,7 +75,7 @@ static void _UndoLog_Rollback_Update_Entity
 	for(int i = seq_start; i > seq_end; --i) {
 		UndoOp *op = undo_list + i;
 		UndoUpdateOp update_op = op->update_op;
-		Graph_UpdateEntity(update_op.ge, update_op.attr_id,
+		Graph_UpdateEntity(ctx->gc->g, update_op.ge, update_op.attr_id,
 				update_op.orig_value, update_op.entity_type);
 
 		// update indices
@@ -284,6 +284,9 @@ void UndoLog_Rollback
 	QueryCtx *ctx  = QueryCtx_GetQueryCtx();
 	uint64_t count = array_len(log);
 
+	// discard index maintenance deferred by the failed commit
+	IndexBuffer_Clear(ctx->index_buffer);
+
 	if(count == 0) return;
 
 	// apply undo operations in reverse order for rollback correctness
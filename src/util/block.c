@@ -7,16 +7,74 @@
 #include "block.h"
 #include "RG.h"
 #include "rmalloc.h"
+#include "storage_tier.h"
 
 Block *Block_New(uint itemSize, uint capacity) {
 	ASSERT(itemSize > 0);
 	Block *block = rm_calloc(1, sizeof(Block) + (capacity * itemSize));
 	block->itemSize = itemSize;
+	block->offset = -1;
+	block->payloadOffset = -1;
 	return block;
 }
 
-void Block_Free(Block *block) {
+Block *Block_NewMapped(uint itemSize, uint capacity) {
+	ASSERT(itemSize > 0);
+	ASSERT(StorageTier_Enabled());
+
+	size_t size = StorageTier_MappingSize(sizeof(Block) + (capacity * itemSize));
+	Block *block = (size > 0) ? StorageTier_Alloc(size) : NULL;
+	if(block == NULL) return Block_New(itemSize, capacity);
+
+	// mapping is zeroed
+	block->itemSize = itemSize;
+	block->mappedSize = size;
+	block->offset = -1;
+	block->payloadOffset = -1;
+	return block;
+}
+
+void *Block_AllocatePayload(Block *block, size_t size) {
+	ASSERT(block != NULL);
+	ASSERT(size > 0);
+
+	if(block->mappedSize == 0 || block->payload != NULL) return NULL;
+
+	size_t mappingSize = StorageTier_MappingSize(size);
+	void *payload = (mappingSize > 0) ? StorageTier_Alloc(mappingSize) : NULL;
+	if(payload == NULL) return NULL;
+
+	block->payload = payload;
+	block->payloadSize = mappingSize;
+	return payload;
+}
+
+bool Block_Seal(Block *block) {
 	ASSERT(block != NULL);
-	rm_free(block);
+
+	if(block->mappedSize == 0) return false;  // heap allocated
+
+	// best effort, an anonymous payload remains valid
+	if(block->payload != NULL && block->payloadOffset == -1) {
+		StorageTier_Seal(block->payload, block->payloadSize,
+				&block->payloadOffset);
+	}
+
+	if(block->offset != -1) return true;      // already sealed
+
+	return StorageTier_Seal(block, block->mappedSize, &block->offset);
 }
 
+void Block_Free(Block *block) {
+	ASSERT(block != NULL);
+	if(block->payload != NULL) {
+		StorageTier_Free(block->payload, block->payloadSize,
+				block->payloadOffset);
+	}
+
+	if(block->mappedSize > 0) {
+		StorageTier_Free(block, block->mappedSize, block->offset);
+	} else {
+		rm_free(block);
+	}
+}
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <sys/types.h>
 
 /* The Block is a type-agnostic block of continuous memory used to hold items of the same type.
@@ -14,9 +16,29 @@
 typedef struct Block {
 	size_t itemSize;        // Size of a single item in bytes.
 	struct Block *next;     // Pointer to next block.
+	size_t mappedSize;      // Size of block's mapping, 0 if heap allocated.
+	int64_t offset;         // Position within storage tier file, -1 if not sealed.
+	void *payload;          // Region holding items' out of line content, NULL if none.
+	size_t payloadSize;     // Size of payload region.
+	int64_t payloadOffset;  // Payload position within storage tier file, -1 if not sealed.
 	unsigned char data[];   // Item array. MUST BE LAST MEMBER OF THE STRUCT!
 } Block;
 
 Block *Block_New(uint itemSize, uint capacity);
+
+// Allocates a block as a storage tier mapping, falls back to Block_New
+// if the block is too small for a dedicated mapping.
+Block *Block_NewMapped(uint itemSize, uint capacity);
+
+// Allocates a zeroed storage tier region of at least 'size' bytes holding
+// content referenced by the block's items, the region is sealed and freed
+// along with the block. Returns NULL if the block is heap allocated,
+// already has a payload or 'size' is too small for a dedicated region.
+void *Block_AllocatePayload(Block *block, size_t size);
+
+// Backs a mapped block and its payload by the storage tier file,
+// addresses are retained. Returns true if block is sealed.
+bool Block_Seal(Block *block);
+
 void Block_Free(Block *block);
 
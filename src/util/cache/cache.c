@@ -6,50 +6,150 @@
 
 #include "cache.h"
 #include "RG.h"
+#include "xxhash.h"
+#include "cache_rcu.h"
 #include "../rmalloc.h"
-#include "cache_array.h"
-#include <pthread.h>
 
-static CacheEntry *_CacheEvictLRU(Cache *cache) {
-	CacheEntry *entry = CacheArray_FindMinLRU(cache->arr, cache->cap);
-	// Remove evicted element from the rax.
-	raxRemove(cache->lookup, (unsigned  char *)entry->key,
-	  strlen(entry->key), NULL);
-	CacheArray_CleanEntry(entry, cache->free_item);
+#include <string.h>
+
+// marks a bucket whose entry had been removed
+#define CACHE_TOMBSTONE ((CacheEntry *)1)
+
+// lookup table, open addressing with linear probing
+// buckets are only ever modified by writers, under the cache write lock
+// at least a quarter of the buckets are kept empty, such that probing
+// always terminates
+struct CacheTable {
+	uint64_t mask;           // number of buckets - 1
+	uint64_t used;           // number of non-empty buckets, including tombstones
+	CacheEntry *buckets[];   // entries
+};
+
+static CacheTable *_CacheTable_New
+(
+	uint cap  // number of entries table should accommodate
+) {
+	// keep load factor at or below 0.5
+	uint64_t n = 4;
+	while(n < (uint64_t)cap * 2) n <<= 1;
+
+	CacheTable *t = rm_calloc(1, sizeof(CacheTable) + n * sizeof(CacheEntry *));
+	t->mask = n - 1;
+
+	return t;
+}
+
+// table must be rebuilt before inserting another entry
+static inline bool _CacheTable_Full
+(
+	const CacheTable *t
+) {
+	return (t->used + 1) * 4 > (t->mask + 1) * 3;
+}
+
+static CacheEntry *_CacheTable_Find
+(
+	CacheTable *t,
+	const char *key,
+	size_t key_len,
+	uint64_t hash
+) {
+	for(uint64_t i = hash & t->mask;; i = (i + 1) & t->mask) {
+		CacheEntry *entry = __atomic_load_n(t->buckets + i, __ATOMIC_ACQUIRE);
+		if(entry == NULL) return NULL;
+		if(entry == CACHE_TOMBSTONE) continue;
+
+		if(entry->hash == hash && entry->key_len == key_len &&
+		   memcmp(entry->key, key, key_len) == 0) {
+			return entry;
+		}
+	}
+}
 
-	return entry;
+static void _CacheTable_Insert
+(
+	CacheTable *t,
+	CacheEntry *entry
+) {
+	for(uint64_t i = entry->hash & t->mask;; i = (i + 1) & t->mask) {
+		CacheEntry *current = t->buckets[i];
+		if(current != NULL && current != CACHE_TOMBSTONE) continue;
+
+		if(current == NULL) t->used++;
+		// publish entry, readers observe it fully initialized
+		__atomic_store_n(t->buckets + i, entry, __ATOMIC_RELEASE);
+		return;
+	}
+}
+
+static void _CacheTable_Remove
+(
+	CacheTable *t,
+	const CacheEntry *entry
+) {
+	for(uint64_t i = entry->hash & t->mask;; i = (i + 1) & t->mask) {
+		ASSERT(t->buckets[i] != NULL);
+		if(t->buckets[i] != entry) continue;
+
+		// keep probe sequences passing through this bucket intact
+		__atomic_store_n(t->buckets + i, CACHE_TOMBSTONE, __ATOMIC_RELEASE);
+		return;
+	}
 }
 
-static bool _Cache_SetValue(Cache *cache, const char *key, void *value,
-  		size_t key_len) {
+// inserts value under key, caller holds the write lock
+// returns false if key is already cached
+static bool _Cache_SetValue
+(
+	Cache *cache,
+	const char *key,
+	void *value,
+	size_t key_len
+) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
 
+	uint64_t hash = XXH64(key, key_len, 0);
+	CacheTable *t = cache->table;
+
 	/* in case that another working thread had already inserted the item to the
 	 * cache, no need to re-insert it */
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
-	if(entry != raxNotFound) {
-		return false;
-	}
+	if(_CacheTable_Find(t, key, key_len, hash) != NULL) return false;
+
+	CacheEntry *entry   = CacheEntry_New(key, key_len, hash, value);
+	CacheEntry *evicted = NULL;
+	CacheTable *retired = NULL;
 
-	// key is not in cache! test to see if cache is full?
 	if(cache->size == cache->cap) {
-		/* the cache is full, evict the least-recently-used element
-		 * and reuse its space for the new element */
-		entry = _CacheEvictLRU(cache);
+		// the cache is full, evict an entry chosen by the CLOCK hand
+		// and reuse its position for the new entry
+		uint pos = CacheArray_ClockEvict(cache->arr, cache->cap, &cache->hand);
+		evicted = cache->arr[pos];
+		_CacheTable_Remove(t, evicted);
+		cache->arr[pos] = entry;
+		cache->evictions++;
 	} else {
-		// the array has space left in it, use the next available entry
-		entry = cache->arr + cache->size++;
+		cache->arr[cache->size++] = entry;
 	}
 
-	// populate the entry
-	char *k = rm_strdup(key);
-	cache->counter++;
-	CacheArray_PopulateEntry(cache->counter, entry, k, value);
-
+	if(_CacheTable_Full(t)) {
+		// too many tombstones, rebuild table from the cached entries
+		retired = t;
+		t = _CacheTable_New(cache->cap);
+		for(uint i = 0; i < cache->size; i++) {
+			_CacheTable_Insert(t, cache->arr[i]);
+		}
+		__atomic_store_n(&cache->table, t, __ATOMIC_RELEASE);
+	} else {
+		_CacheTable_Insert(t, entry);
+	}
 
-	// Add the new entry to the rax.
-	raxInsert(cache->lookup, (unsigned char *)key, key_len, entry, NULL);
+	// wait for readers which might still reference unlinked objects
+	if(evicted != NULL || retired != NULL) {
+		CacheRCU_Synchronize();
+		if(evicted != NULL) CacheEntry_Free(evicted, cache->free_item);
+		if(retired != NULL) rm_free(retired);
+	}
 
 	return true;
 }
@@ -58,17 +158,14 @@ Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyF
 	ASSERT(cap > 0);
 	ASSERT(copyFunc != NULL);
 
-	Cache *cache     = rm_malloc(sizeof(Cache));
+	Cache *cache     = rm_calloc(1, sizeof(Cache));
 	cache->cap       = cap;
-	cache->size      = 0;
-	cache->lookup    = raxNew();       // Instantiate key entry mapping.
-	cache->counter   = 0;             // Initialize counter to zero.
+	cache->table     = _CacheTable_New(cap);
 	cache->copy_item = copyFunc;
 	cache->free_item = freeFunc;
-	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
+	cache->arr = rm_calloc(cap, sizeof(CacheEntry *)); // Array of cached entries.
 
-	// Initialize the read-write lock to protect access to the cache.
-	int res = pthread_rwlock_init(&cache->_cache_rwlock, NULL);
+	int res = pthread_mutex_init(&cache->_write_lock, NULL);
 	UNUSED(res);
 	ASSERT(res == 0);
 
@@ -76,30 +173,38 @@ Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyF
 }
 
 void *Cache_GetValue(Cache *cache, const char *key) {
+	ASSERT(cache != NULL);
+
 	void *item = NULL;
+	size_t key_len = strlen(key);
+	uint64_t hash = XXH64(key, key_len, 0);
 
-	ASSERT(cache != NULL);
+	CacheRCU_ReadLock();
 
-	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	CacheTable *t = __atomic_load_n(&cache->table, __ATOMIC_ACQUIRE);
+	CacheEntry *entry = _CacheTable_Find(t, key, key_len, hash);
 
-	size_t key_len = strlen(key);
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+	if(entry != NULL) {
+		// mark entry as recently used, avoid dirtying a shared cache line
+		// when the bit is already set
+		if(!__atomic_load_n(&entry->ref, __ATOMIC_RELAXED)) {
+			__atomic_store_n(&entry->ref, true, __ATOMIC_RELAXED);
+		}
 
-	if(entry == raxNotFound) goto cleanup;
+		// return a copy of element
+		item = cache->copy_item(entry->value);
+	}
 
-	/* element is now the most recently used; update its LRU
-	 * note that multiple threads can be here simultaneously */
-	cache->counter++;
-	entry->LRU = cache->counter;
+	CacheRCU_ReadUnlock();
 
-	// return a copy of element
-	item = cache->copy_item(entry->value);
+	CacheCounters *counters =
+		cache->counters + CacheRCU_ReaderID() % CACHE_STAT_STRIPES;
+	if(entry != NULL) {
+		__atomic_fetch_add(&counters->hits, 1, __ATOMIC_RELAXED);
+	} else {
+		__atomic_fetch_add(&counters->misses, 1, __ATOMIC_RELAXED);
+	}
 
-cleanup:
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
 	return item;
 }
 
@@ -109,15 +214,14 @@ void Cache_SetValue(Cache *cache, const char *key, void *value) {
 
 	size_t key_len = strlen(key);
 
-	// Acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
+	int res = pthread_mutex_lock(&cache->_write_lock);
 	UNUSED(res);
 	ASSERT(res == 0);
 
 	// Insert the value to the cache.
 	_Cache_SetValue(cache, key, value, key_len);
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
+	res = pthread_mutex_unlock(&cache->_write_lock);
 	ASSERT(res == 0);
 }
 
@@ -128,40 +232,62 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	size_t key_len = strlen(key);
 	void *value_to_return = value;
 
-	// acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
+	int res = pthread_mutex_lock(&cache->_write_lock);
 	UNUSED(res);
 	ASSERT(res == 0);
 
 	// return true if value was added, false if value already in cache
+	// the new entry can only be evicted by a writer, it is safe to copy
+	// while holding the write lock
 	if(_Cache_SetValue(cache, key, value, key_len)) {
 		// return a copy of original value
 		value_to_return = cache->copy_item(value);
 	}
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
+	res = pthread_mutex_unlock(&cache->_write_lock);
 	ASSERT(res == 0);
 
 	return value_to_return;
 }
 
+void Cache_GetStats(Cache *cache, CacheStats *stats) {
+	ASSERT(cache != NULL);
+	ASSERT(stats != NULL);
+
+	stats->hits   = 0;
+	stats->misses = 0;
+	for(uint i = 0; i < CACHE_STAT_STRIPES; i++) {
+		CacheCounters *counters = cache->counters + i;
+		stats->hits   += __atomic_load_n(&counters->hits, __ATOMIC_RELAXED);
+		stats->misses += __atomic_load_n(&counters->misses, __ATOMIC_RELAXED);
+	}
+
+	int res = pthread_mutex_lock(&cache->_write_lock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	stats->cap       = cache->cap;
+	stats->size      = cache->size;
+	stats->evictions = cache->evictions;
+
+	res = pthread_mutex_unlock(&cache->_write_lock);
+	ASSERT(res == 0);
+}
+
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
 	// free cache entries
-	for(size_t i = 0; i < cache->size; i++) {
-		CacheEntry *entry = cache->arr + i;
-		rm_free(entry->key);
-		cache->free_item(entry->value);
+	for(uint i = 0; i < cache->size; i++) {
+		CacheEntry_Free(cache->arr[i], cache->free_item);
 	}
 
 	rm_free(cache->arr);
-	raxFree(cache->lookup);
+	rm_free(cache->table);
 
-	int res = pthread_rwlock_destroy(&cache->_cache_rwlock);
+	int res = pthread_mutex_destroy(&cache->_write_lock);
 	UNUSED(res);
 	ASSERT(res == 0);
 
 	rm_free(cache);
 }
-
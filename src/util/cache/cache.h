@@ -7,21 +7,51 @@
 #pragma once
 
 #include "cache_array.h"
-#include "rax.h"
+#include <pthread.h>
+
+// number of hit/miss counter stripes, threads are spread across stripes
+// to avoid contending on a single counter
+#define CACHE_STAT_STRIPES 16
+
+// lookup table, open addressing over immutable entries
+typedef struct CacheTable CacheTable;
+
+// per-thread hit/miss counters, padded to a cache line
+typedef struct {
+	uint64_t hits;    // number of lookups that found their key
+	uint64_t misses;  // number of lookups that didn't
+	char _pad[48];
+} CacheCounters;
+
+// cache statistics
+typedef struct {
+	uint cap;            // cache capacity
+	uint size;           // number of cached entries
+	uint64_t hits;       // number of lookups that found their key
+	uint64_t misses;     // number of lookups that didn't
+	uint64_t evictions;  // number of evicted entries
+} CacheStats;
 
 /**
- * @brief Key-value cache, uses LRU policy for eviction.
+ * @brief Key-value cache, uses CLOCK (approximated LRU) policy for eviction.
  * Assumes owership over stored objects.
+ *
+ * Lookups are lock-free, a reader probes the lookup table within an RCU read
+ * section and only sets the found entry's reference bit.
+ * Writers are serialized, unlinked entries are freed once no reader
+ * can reference them.
  */
 typedef struct Cache {
-	uint cap;                          // Cache capacity.
-	uint size;                         // Cache current size.
-	long long counter;                 // Atomic counter for number of reads.
-	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
-	CacheEntry *arr;                   // Array of cache elements.
-	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
-	CacheEntryCopyFunc copy_item;      // Callback function that copies cached value.
-	pthread_rwlock_t _cache_rwlock;    // Read-write lock to protect access to the cache.
+	uint cap;                                 // Cache capacity.
+	uint size;                                // Cache current size.
+	uint hand;                                // CLOCK hand, position within arr.
+	CacheTable *table;                        // Lookup table, replaced when rehashed.
+	CacheEntry **arr;                         // Cached entries, swept by the CLOCK hand.
+	uint64_t evictions;                       // Number of evicted entries.
+	CacheCounters counters[CACHE_STAT_STRIPES]; // Hit/miss counters.
+	CacheEntryFreeFunc free_item;             // Callback function that free cached value.
+	CacheEntryCopyFunc copy_item;             // Callback function that copies cached value.
+	pthread_mutex_t _write_lock;              // Serializes cache modifications.
 } Cache;
 
 /**
@@ -60,9 +90,16 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Collects cache statistics.
+ * @note   Counters are read without synchronization and may be slightly stale.
+ * @param  *cache: cache pointer.
+ * @param  *stats: [output] cache statistics.
+ */
+void Cache_GetStats(Cache *cache, CacheStats *stats);
+
 /**
  * @brief  Destroys the cache and free all stored items.
  * @param  *cache: cache pointer
  */
 void Cache_Free(Cache *cache);
-
@@ -8,45 +8,64 @@
 #include "../rmalloc.h"
 #include "../../RG.h"
 
-CacheEntry *CacheArray_FindMinLRU(CacheEntry *cache_arr, uint cap) {
-	ASSERT(cache_arr != NULL);
+#include <string.h>
 
-	CacheEntry *min_LRU_entry = cache_arr;
+CacheEntry *CacheEntry_New
+(
+	const char *key,
+	size_t key_len,
+	uint64_t hash,
+	void *value
+) {
+	ASSERT(key != NULL);
 
-	for(size_t i = 1; i < cap; i++) {
-		CacheEntry *current_entry = cache_arr + i;
-		if(current_entry->LRU < min_LRU_entry->LRU) {
-			min_LRU_entry = current_entry;
-		}
-	}
-
-	return min_LRU_entry;
-}
+	CacheEntry *entry = rm_malloc(sizeof(CacheEntry));
 
-CacheEntry *CacheArray_PopulateEntry(long long counter, CacheEntry *entry, char *key,
-  									void *value) {
+	entry->key     = rm_malloc(key_len + 1);
+	entry->key_len = key_len;
+	entry->hash    = hash;
+	entry->value   = value;
+	// new entries survive the first sweep of the CLOCK hand
+	entry->ref     = true;
 
-	entry->key   = key;
-	entry->value = value;
-	entry->LRU   = counter;
+	memcpy(entry->key, key, key_len);
+	entry->key[key_len] = '\0';
 
 	return entry;
 }
 
-void CacheArray_CleanEntry(CacheEntry *entry, CacheEntryFreeFunc free_entry) {
+void CacheEntry_Free
+(
+	CacheEntry *entry,
+	CacheEntryFreeFunc free_entry
+) {
 	ASSERT(entry != NULL);
 	ASSERT(free_entry != NULL);
 
-	if(entry->key != NULL) {
-		rm_free(entry->key);
-		entry->key = NULL;
-	}
+	free_entry(entry->value);
+	rm_free(entry->key);
+	rm_free(entry);
+}
 
-	if(entry->value != NULL) {
-		free_entry(entry->value);
-		entry->value = NULL;
-	}
+uint CacheArray_ClockEvict
+(
+	CacheEntry **arr,
+	uint cap,
+	uint *hand
+) {
+	ASSERT(arr  != NULL);
+	ASSERT(hand != NULL);
+	ASSERT(cap  > 0);
 
-	entry->LRU = 0;
-}
+	// terminates within two sweeps, as the first clears every reference bit
+	while(true) {
+		uint pos = *hand;
+		*hand = (pos + 1) % cap;
+
+		CacheEntry *entry = arr[pos];
+		if(!__atomic_load_n(&entry->ref, __ATOMIC_RELAXED)) return pos;
 
+		// give entry a second chance
+		__atomic_store_n(&entry->ref, false, __ATOMIC_RELAXED);
+	}
+}
@@ -21,23 +21,38 @@ typedef void (*CacheEntryFreeFunc)(void *);
 // cache entry duplicate function
 typedef void *(*CacheEntryCopyFunc)(void *);
 
-/**
- * @brief  A struct for an entry in cache array with a key and value.
- */
+// a cached key-value pair
+// entries are immutable once published, except for their reference bit
 typedef struct CacheEntry_t {
-	char *key;      // Entry key.
-	void *value;    // Entry stored value.
-	long long LRU;  // Indicates the time when the entry was last recently used.
+	char *key;       // entry key
+	size_t key_len;  // key length
+	uint64_t hash;   // key hash
+	void *value;     // entry stored value
+	bool ref;        // CLOCK reference bit, set whenever the entry is read
 } CacheEntry;
 
-
-// Returns a pointer to the entry in the cache array with the minimum LRU.
-CacheEntry *CacheArray_FindMinLRU(CacheEntry *cache_arr, uint cap);
-
-// Assign new values to the fields of a cache entry.
-CacheEntry *CacheArray_PopulateEntry(long long counter, CacheEntry *entry, char *key,
-  			void *value);
-
-// Free the fields of a cache entry to prepare it for reuse.
-void CacheArray_CleanEntry(CacheEntry *entry, CacheEntryFreeFunc free_entry);
-
+// create a new entry, takes ownership over value
+CacheEntry *CacheEntry_New
+(
+	const char *key,  // entry key, copied
+	size_t key_len,   // key length
+	uint64_t hash,    // key hash
+	void *value       // entry value
+);
+
+// free entry and its value
+void CacheEntry_Free
+(
+	CacheEntry *entry,             // entry to free
+	CacheEntryFreeFunc free_entry  // value free function
+);
+
+// advance the CLOCK hand over a full cache array until an entry whose
+// reference bit is clear is found, clearing reference bits along the way
+// returns the position of the entry to evict
+uint CacheArray_ClockEvict
+(
+	CacheEntry **arr,  // cached entries
+	uint cap,          // number of entries
+	uint *hand         // [input/output] CLOCK hand
+);
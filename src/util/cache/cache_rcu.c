@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "cache_rcu.h"
+#include "RG.h"
+#include "../rmalloc.h"
+
+#include <sched.h>
+#include <stdbool.h>
+
+// per-thread reader record
+// padded to a cache line such that readers don't share lines
+typedef struct CacheReader {
+	uint64_t seq;              // odd while within a read section
+	uint depth;                // read section nesting depth, owner only
+	uint id;                   // sequential reader ID
+	struct CacheReader *next;  // next registered reader
+	char _pad[40];
+} CacheReader;
+
+// registered readers, records are never released
+static CacheReader *_readers = NULL;
+static uint _reader_count = 0;
+
+// calling thread's reader record
+static __thread CacheReader *_reader = NULL;
+
+static CacheReader *_CacheRCU_Reader(void) {
+	if(likely(_reader != NULL)) return _reader;
+
+	CacheReader *r = rm_calloc(1, sizeof(CacheReader));
+	r->id = __atomic_fetch_add(&_reader_count, 1, __ATOMIC_RELAXED);
+
+	// push record to the registry
+	r->next = __atomic_load_n(&_readers, __ATOMIC_ACQUIRE);
+	while(!__atomic_compare_exchange_n(&_readers, &r->next, r, false,
+				__ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE));
+
+	_reader = r;
+	return r;
+}
+
+void CacheRCU_ReadLock
+(
+	void
+) {
+	CacheReader *r = _CacheRCU_Reader();
+	if(r->depth++ > 0) return;
+
+	// full barrier, orders the announcement before any shared read
+	__atomic_fetch_add(&r->seq, 1, __ATOMIC_SEQ_CST);
+}
+
+void CacheRCU_ReadUnlock
+(
+	void
+) {
+	CacheReader *r = _reader;
+	ASSERT(r != NULL && r->depth > 0);
+	if(--r->depth > 0) return;
+
+	__atomic_fetch_add(&r->seq, 1, __ATOMIC_RELEASE);
+}
+
+void CacheRCU_Synchronize
+(
+	void
+) {
+	ASSERT(_reader == NULL || _reader->depth == 0);
+
+	// order preceding unlinks before inspecting readers
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	// readers registered after this point can't observe unlinked objects
+	CacheReader *r = __atomic_load_n(&_readers, __ATOMIC_ACQUIRE);
+	for(; r != NULL; r = r->next) {
+		uint64_t seq = __atomic_load_n(&r->seq, __ATOMIC_ACQUIRE);
+		if((seq & 1) == 0) continue;
+
+		// wait for reader to leave its current read section
+		while(__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) == seq) sched_yield();
+	}
+}
+
+uint CacheRCU_ReaderID
+(
+	void
+) {
+	return _CacheRCU_Reader()->id;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// minimal read-copy-update support for the cache's lookup path
+//
+// every thread reading from a cache registers a private reader record
+// entering and leaving a read section only touches that record
+// writers unlink shared objects and then wait for all readers which were
+// within a read section at the time, after which the unlinked objects
+// can be freed safely
+
+// enter a read section, read sections may be nested
+void CacheRCU_ReadLock
+(
+	void
+);
+
+// leave a read section
+void CacheRCU_ReadUnlock
+(
+	void
+);
+
+// wait until every read section in progress has ended
+// must not be called from within a read section
+void CacheRCU_Synchronize
+(
+	void
+);
+
+// returns a small sequential ID for the calling thread
+uint CacheRCU_ReaderID
+(
+	void
+);
@@ -9,7 +9,9 @@
 #include "datablock_iterator.h"
 #include "../arr.h"
 #include "../rmalloc.h"
+#include "../storage_tier.h"
 #include <math.h>
+#include <string.h>
 #include <stdbool.h>
 
 // computes the number of blocks required to accommodate n items.
@@ -24,6 +26,10 @@
 #define ITEM_POSITION_WITHIN_BLOCK(idx, cap) \
     (idx % cap)
 
+// computes the number of dirty flags required to cover n items.
+#define ITEM_COUNT_TO_RANGE_COUNT(n) \
+    (((n) + DATABLOCK_DIRTY_RANGE - 1) / DATABLOCK_DIRTY_RANGE)
+
 // retrieves block in which item with index resides.
 #define GET_ITEM_BLOCK(dataBlock, idx) \
     dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx, dataBlock->blockCap)]
@@ -45,12 +51,24 @@ static void _DataBlock_AddBlocks
 
 	uint i;
 	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
-		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, dataBlock->blockCap);
+		dataBlock->blocks[i] = (dataBlock->tiered) ?
+			Block_NewMapped(dataBlock->itemSize, dataBlock->blockCap) :
+			Block_New(dataBlock->itemSize, dataBlock->blockCap);
 		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
 	dataBlock->blocks[i - 1]->next = NULL;
 
+	uint64_t prevItemCap = dataBlock->itemCap;
 	dataBlock->itemCap = dataBlock->blockCount * dataBlock->blockCap;
+
+	// grow dirty flags, new ranges start out clean
+	if(dataBlock->dirty) {
+		uint64_t prevRangeCount = ITEM_COUNT_TO_RANGE_COUNT(prevItemCap);
+		uint64_t rangeCount = ITEM_COUNT_TO_RANGE_COUNT(dataBlock->itemCap);
+		dataBlock->dirty = rm_realloc(dataBlock->dirty, sizeof(bool) * rangeCount);
+		memset(dataBlock->dirty + prevRangeCount, 0,
+				sizeof(bool) * (rangeCount - prevRangeCount));
+	}
 }
 
 // Checks to see if idx is within global array bounds
@@ -88,6 +106,11 @@ DataBlock *DataBlock_New
 ) {
 	DataBlock *dataBlock = rm_malloc(sizeof(DataBlock));
 	dataBlock->blocks      =  NULL;
+	dataBlock->dirty       =  NULL;
+	dataBlock->tiered      =  false;
+	dataBlock->packedSize  =  NULL;
+	dataBlock->pack        =  NULL;
+	dataBlock->itemCap     =  0;
 	dataBlock->itemSize    =  itemSize + ITEM_HEADER_SIZE;
 	dataBlock->itemCount   =  0;
 	dataBlock->blockCount  =  0;
@@ -169,6 +192,15 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 	return ITEM_DATA(item_header);
 }
 
+void *DataBlock_GetItemIncludingDeleted(const DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+
+	// return NULL if idx is out of bounds
+	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return NULL;
+
+	return ITEM_DATA(DataBlock_GetItemHeader(dataBlock, idx));
+}
+
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 	// make sure we've got room for items
 	if(dataBlock->itemCount >= dataBlock->itemCap) {
@@ -189,6 +221,7 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
 	MARK_HEADER_AS_NOT_DELETED(item_header);
+	DataBlock_MarkDirty(dataBlock, pos);
 
 	return ITEM_DATA(item_header);
 }
@@ -208,6 +241,7 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	}
 
 	MARK_HEADER_AS_DELETED(item_header);
+	DataBlock_MarkDirty(dataBlock, idx);
 
 	/* DataBlock_DeleteItem should be thread-safe as it's being called
 	 * from GraphBLAS concurent operations, e.g. GxB_SelectOp.
@@ -232,6 +266,46 @@ inline bool DataBlock_ItemIsDeleted(void *item) {
 	return IS_ITEM_DELETED(header);
 }
 
+//------------------------------------------------------------------------------
+// Change tracking
+//------------------------------------------------------------------------------
+
+void DataBlock_TrackChanges(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	if(dataBlock->dirty) return;
+
+	uint64_t rangeCount = ITEM_COUNT_TO_RANGE_COUNT(dataBlock->itemCap);
+	dataBlock->dirty = rm_calloc(rangeCount, sizeof(bool));
+}
+
+// setting a flag is idempotent, concurrent deletions may race on it safely
+inline void DataBlock_MarkDirty(DataBlock *dataBlock, uint64_t idx) {
+	if(dataBlock->dirty == NULL) return;
+	ASSERT(idx < dataBlock->itemCap);
+	dataBlock->dirty[idx / DATABLOCK_DIRTY_RANGE] = true;
+}
+
+uint64_t DataBlock_RangeCount(const DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	uint64_t n = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+	return ITEM_COUNT_TO_RANGE_COUNT(n);
+}
+
+bool DataBlock_RangeIsDirty(const DataBlock *dataBlock, uint64_t range) {
+	ASSERT(dataBlock != NULL);
+	if(dataBlock->dirty == NULL) return false;
+	ASSERT(range < ITEM_COUNT_TO_RANGE_COUNT(dataBlock->itemCap));
+	return dataBlock->dirty[range];
+}
+
+void DataBlock_ClearDirty(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	if(dataBlock->dirty == NULL) return;
+
+	uint64_t rangeCount = ITEM_COUNT_TO_RANGE_COUNT(dataBlock->itemCap);
+	memset(dataBlock->dirty, 0, sizeof(bool) * rangeCount);
+}
+
 //------------------------------------------------------------------------------
 // Out of order functionality
 //------------------------------------------------------------------------------
@@ -262,10 +336,88 @@ void DataBlock_MarkAsDeletedOutOfOrder
 	array_append(dataBlock->deletedIdx, idx);
 }
 
+//------------------------------------------------------------------------------
+// Storage tier
+//------------------------------------------------------------------------------
+
+// moves the out of line content of the block's items into the block's payload
+static void _DataBlock_PackBlock
+(
+	DataBlock *dataBlock,
+	Block *block
+) {
+	if(dataBlock->pack == NULL) return;
+	if(block->mappedSize == 0 || block->payload != NULL) return;
+
+	size_t size = 0;
+	for(uint64_t i = 0; i < dataBlock->blockCap; i++) {
+		DataBlockItemHeader *item_header =
+			(DataBlockItemHeader *)block->data + (i * block->itemSize);
+		if(IS_ITEM_DELETED(item_header)) continue;
+		size += dataBlock->packedSize(ITEM_DATA(item_header));
+	}
+
+	if(size == 0) return;
+
+	// items are left untouched if a region isn't available
+	unsigned char *pos = Block_AllocatePayload(block, size);
+	if(pos == NULL) return;
+
+	for(uint64_t i = 0; i < dataBlock->blockCap; i++) {
+		DataBlockItemHeader *item_header =
+			(DataBlockItemHeader *)block->data + (i * block->itemSize);
+		if(IS_ITEM_DELETED(item_header)) continue;
+		pos = dataBlock->pack(ITEM_DATA(item_header), pos);
+	}
+
+	ASSERT(pos <= (unsigned char *)block->payload + size);
+}
+
+void DataBlock_UseStorageTier
+(
+	DataBlock *dataBlock,
+	fpPackedSize packedSize,
+	fpPack pack
+) {
+	ASSERT(dataBlock != NULL);
+	ASSERT((packedSize == NULL) == (pack == NULL));
+	ASSERT(dataBlock->itemCount == 0);
+	ASSERT(array_len(dataBlock->deletedIdx) == 0);
+
+	if(dataBlock->tiered || !StorageTier_Enabled()) return;
+
+	// replace empty heap blocks with mapped ones
+	dataBlock->tiered     = true;
+	dataBlock->packedSize = packedSize;
+	dataBlock->pack       = pack;
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		Block_Free(dataBlock->blocks[i]);
+		dataBlock->blocks[i] = Block_NewMapped(dataBlock->itemSize,
+				dataBlock->blockCap);
+		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
+	}
+}
+
+void DataBlock_Seal(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	if(!dataBlock->tiered) return;
+
+	uint64_t n = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+	uint64_t full = n / dataBlock->blockCap;
+	for(uint64_t i = 0; i < full; i++) {
+		Block *block = dataBlock->blocks[i];
+		if(block->offset != -1) continue;  // already sealed
+
+		_DataBlock_PackBlock(dataBlock, block);
+		Block_Seal(block);
+	}
+}
+
 void DataBlock_Free(DataBlock *dataBlock) {
 	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
 
 	rm_free(dataBlock->blocks);
+	if(dataBlock->dirty) rm_free(dataBlock->dirty);
 	array_free(dataBlock->deletedIdx);
 	int res = pthread_mutex_destroy(&dataBlock->mutex);
 	UNUSED(res);
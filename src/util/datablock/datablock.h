@@ -14,6 +14,13 @@
 
 typedef void (*fpDestructor)(void *);
 
+// Returns the number of bytes required to pack an item's out of line content.
+typedef size_t (*fpPackedSize)(const void *);
+
+// Moves an item's out of line content into a buffer,
+// returns the position within the buffer following the packed content.
+typedef void *(*fpPack)(void *, void *);
+
 // Returns the item header size.
 #define ITEM_HEADER_SIZE 1
 
@@ -32,6 +39,9 @@ typedef void (*fpDestructor)(void *);
 // Checks if the deleted bit in the header is 1 or not.
 #define IS_ITEM_DELETED(header) ((header)->deleted & 1)
 
+// Number of consecutive items sharing a single dirty flag.
+#define DATABLOCK_DIRTY_RANGE 1024
+
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
  * Item deletions are thread-safe, and a DataBlockIterator can be used to traverse a
@@ -46,6 +56,10 @@ typedef struct {
 	uint64_t *deletedIdx;       // Array of free indicies.
 	pthread_mutex_t mutex;      // Mutex guarding from concurent updates.
 	fpDestructor destructor;    // Function pointer to a clean-up function of an item.
+	bool *dirty;                // Per-range dirty flags, NULL if changes aren't tracked.
+	bool tiered;                // Blocks are allocated from the storage tier.
+	fpPackedSize packedSize;    // Size of an item's out of line content, NULL if none.
+	fpPack pack;                // Packs an item's out of line content into its block.
 } DataBlock;
 
 // This struct is for data block item header data.
@@ -84,6 +98,9 @@ DataBlockIterator *DataBlock_FullScan(const DataBlock *dataBlock);
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
+// Get item at position idx, even if it is marked as deleted.
+void *DataBlock_GetItemIncludingDeleted(const DataBlock *dataBlock, uint64_t idx);
+
 // Allocate a new item within given dataBlock,
 // if idx is not NULL, idx will contain item position
 // return a pointer to the newly allocated item.
@@ -98,6 +115,37 @@ uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 // Returns true if the given item has been deleted.
 bool DataBlock_ItemIsDeleted(void *item);
 
+// Start tracking modified item ranges.
+void DataBlock_TrackChanges(DataBlock *dataBlock);
+
+// Marks the range containing item at position idx as modified.
+// no-op if changes aren't tracked.
+void DataBlock_MarkDirty(DataBlock *dataBlock, uint64_t idx);
+
+// Returns the number of ranges covering all allocated and deleted items.
+uint64_t DataBlock_RangeCount(const DataBlock *dataBlock);
+
+// Returns true if range was modified since the last call to DataBlock_ClearDirty.
+bool DataBlock_RangeIsDirty(const DataBlock *dataBlock, uint64_t range);
+
+// Marks all ranges as unmodified.
+void DataBlock_ClearDirty(DataBlock *dataBlock);
+
+// Allocate blocks from the storage tier, must be called on an empty datablock.
+// If packedSize and pack are provided, items' out of line content is moved
+// into a region owned by the item's block once the block is sealed.
+void DataBlock_UseStorageTier
+(
+	DataBlock *dataBlock,     // datablock
+	fpPackedSize packedSize,  // item packed size routine, optional
+	fpPack pack               // item packing routine, optional
+);
+
+// Packs and seals every block which is fully populated and not yet sealed.
+// Out of line content which was packed is freed, the caller must make sure
+// no references to it are held.
+void DataBlock_Seal(DataBlock *dataBlock);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "RG.h"
+#include "sort_key.h"
+#include "qsort.h"
+#include "rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/point.h"
+#include "../datatypes/array.h"
+#include "../datatypes/path/sipath.h"
+#include "../graph/entities/graph_entity.h"
+
+// marks the end of a list or a path
+// lower than any type tag, such that shorter lists order first
+#define END_MARKER 0
+
+// key/value pair of a map
+typedef struct {
+	SIValue key;
+	SIValue val;
+} _MapEntry;
+
+#define MAP_ENTRY_ISLT(a, b) (strcmp((a)->key.stringval, (b)->key.stringval) < 0)
+
+static sds _Encode(sds key, SIValue v);
+
+// values are ordered by type first, numerics share a single tag
+static inline unsigned char _Tag
+(
+	SIType t
+) {
+	if(t & SI_NUMERIC) t = T_INT64;
+	return __builtin_ctz(t) + 1;
+}
+
+// big endian, such that bytes compare as the integer would
+static inline sds _AppendUInt64
+(
+	sds key,
+	uint64_t v
+) {
+	unsigned char buf[8];
+	for(int i = 0; i < 8; i++) buf[i] = v >> (56 - 8 * i);
+	return sdscatlen(key, buf, 8);
+}
+
+static inline sds _AppendUInt32
+(
+	sds key,
+	uint32_t v
+) {
+	unsigned char buf[4];
+	for(int i = 0; i < 4; i++) buf[i] = v >> (24 - 8 * i);
+	return sdscatlen(key, buf, 4);
+}
+
+// flip the sign bit, such that negative integers order first
+static inline sds _AppendInt64
+(
+	sds key,
+	int64_t v
+) {
+	return _AppendUInt64(key, (uint64_t)v ^ (1ULL << 63));
+}
+
+// positive floats order as their bits do, negative floats are reversed
+static inline sds _AppendDouble
+(
+	sds key,
+	double d
+) {
+	if(d == 0) d = 0;  // -0.0 equals 0.0
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+	bits = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+	return _AppendUInt64(key, bits);
+}
+
+static inline sds _AppendFloat
+(
+	sds key,
+	float f
+) {
+	if(f == 0) f = 0;  // -0.0 equals 0.0
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	bits = (bits >> 31) ? ~bits : bits | (1U << 31);
+	return _AppendUInt32(key, bits);
+}
+
+// numerics are compared as doubles
+// integers which share a double representation are then ordered
+// by their distance from it
+static sds _EncodeNumeric
+(
+	sds key,
+	SIValue v
+) {
+	double d = SI_GET_NUMERIC(v);
+	key = _AppendDouble(key, d);
+
+	int64_t residual = 0;
+	if(SI_TYPE(v) == T_INT64) {
+		int64_t i = v.longval;
+		// 2^63 can't be represented as an int64
+		residual = (d >= 0x1p63) ? (i - INT64_MAX) - 1 : i - (int64_t)d;
+	}
+
+	return _AppendInt64(key, residual);
+}
+
+static sds _EncodeMap
+(
+	sds key,
+	SIValue map
+) {
+	// maps are ordered by key count, then by their sorted keys
+	// and then by their values
+	uint n = Map_KeyCount(map);
+	key = _AppendUInt32(key, n);
+	if(n == 0) return key;
+
+	_MapEntry *entries = rm_malloc(sizeof(_MapEntry) * n);
+	for(uint i = 0; i < n; i++) {
+		Map_GetIdx(map, i, &entries[i].key, &entries[i].val);
+	}
+	QSORT(_MapEntry, entries, n, MAP_ENTRY_ISLT);
+
+	for(uint i = 0; i < n; i++) {
+		const char *k = entries[i].key.stringval;
+		key = sdscatlen(key, k, strlen(k) + 1);
+	}
+	for(uint i = 0; i < n; i++) key = _Encode(key, entries[i].val);
+
+	rm_free(entries);
+	return key;
+}
+
+static sds _Encode
+(
+	sds key,
+	SIValue v
+) {
+	SIType t = SI_TYPE(v);
+	unsigned char tag = _Tag(t);
+	key = sdscatlen(key, &tag, 1);
+
+	switch(t) {
+		case T_NULL:
+		case T_PTR:
+			return key;
+		case T_INT64:
+		case T_DOUBLE:
+			return _EncodeNumeric(key, v);
+		case T_BOOL: {
+			unsigned char b = v.longval != 0;
+			return sdscatlen(key, &b, 1);
+		}
+		case T_STRING:
+			// include the terminating null, such that prefixes order first
+			return sdscatlen(key, v.stringval, strlen(v.stringval) + 1);
+		case T_NODE:
+		case T_EDGE:
+			return _AppendUInt64(key, ENTITY_GET_ID((GraphEntity *)v.ptrval));
+		case T_POINT:
+			key = _AppendFloat(key, Point_lon(v));
+			return _AppendFloat(key, Point_lat(v));
+		case T_ARRAY: {
+			uint32_t n = SIArray_Length(v);
+			for(uint32_t i = 0; i < n; i++) key = _Encode(key, SIArray_Get(v, i));
+			unsigned char end = END_MARKER;
+			return sdscatlen(key, &end, 1);
+		}
+		case T_MAP:
+			return _EncodeMap(key, v);
+		case T_PATH: {
+			// alternating nodes and edges
+			size_t n = SIPath_NodeCount(v);
+			for(size_t i = 0; i < n; i++) {
+				if(i > 0) key = _Encode(key, SIPath_GetRelationship(v, i - 1));
+				key = _Encode(key, SIPath_GetNode(v, i));
+			}
+			unsigned char end = END_MARKER;
+			return sdscatlen(key, &end, 1);
+		}
+		default:
+			// temporal values
+			return _AppendInt64(key, v.longval);
+	}
+}
+
+sds SortKey_Append
+(
+	sds key,
+	SIValue v,
+	bool desc
+) {
+	ASSERT(key != NULL);
+
+	size_t start = sdslen(key);
+	key = _Encode(key, v);
+
+	// inverting every byte reverses the order, including prefixes
+	// as terminators are the lowest byte values
+	if(desc) {
+		size_t len = sdslen(key);
+		for(size_t i = start; i < len; i++) key[i] = ~key[i];
+	}
+
+	return key;
+}
+
+sds SortKey_AppendTypeBound
+(
+	sds key,
+	SIType t,
+	bool upper
+) {
+	ASSERT(key != NULL);
+
+	// encodings open with their type tag
+	unsigned char tag = _Tag(t) + upper;
+	return sdscatlen(key, &tag, 1);
+}
+
+int SortKey_Compare
+(
+	const sds a,
+	const sds b
+) {
+	size_t a_len = sdslen(a);
+	size_t b_len = sdslen(b);
+	int rel = memcmp(a, b, (a_len < b_len) ? a_len : b_len);
+	if(rel != 0) return rel;
+	return (a_len > b_len) - (a_len < b_len);
+}
+
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../value.h"
+#include "sds/sds.h"
+
+// sort keys encode a tuple of values as a byte string
+// such that comparing two keys with memcmp orders them
+// as comparing their values one by one with SIValue_Compare would
+//
+// values of different types are ordered by type, numerics are compared
+// with one another by value, nulls are ordered after all other values
+// except for points, as SIValue_Compare orders them
+//
+// each encoded value is self delimiting, as such keys can be concatenated
+
+// appends the encoding of 'v' to 'key'
+// 'desc' reverses the order of 'v' within the key
+// returns the updated key
+sds SortKey_Append
+(
+	sds key,    // key to append to
+	SIValue v,  // value to encode
+	bool desc   // descending order
+);
+
+// appends a bound which orders before every encoding of values of type 't'
+// or after every such encoding when 'upper' is set
+// numerics share a single bound
+sds SortKey_AppendTypeBound
+(
+	sds key,    // key to append to
+	SIType t,   // bounded type
+	bool upper  // bound from above
+);
+
+// compares two sort keys, return value similar to memcmp
+int SortKey_Compare
+(
+	const sds a,
+	const sds b
+);
+
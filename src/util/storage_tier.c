@@ -0,0 +1,246 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "arr.h"
+#include "rmalloc.h"
+#include "storage_tier.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+// contiguous range within the scratch file
+typedef struct {
+	int64_t offset;  // position within file
+	size_t size;     // number of bytes
+} Extent;
+
+typedef struct {
+	int fd;                 // scratch file descriptor
+	size_t page_size;       // system page size
+	int64_t end;            // end of the last extent ever handed out
+	bool forked;            // a child might map released extents
+	Extent *free;           // released extents available for reuse
+	Extent *quarantine;     // released extents a child might still map
+	pthread_mutex_t mutex;  // guards extent bookkeeping
+} StorageTier;
+
+static StorageTier *tier = NULL;
+
+// return extent's disk space to the file system
+static void _PunchHole
+(
+	Extent e
+) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+	// best effort, a failure only means disk space isn't reclaimed
+	fallocate(tier->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, e.offset,
+			e.size);
+#endif
+}
+
+// get an unused extent of exactly 'size' bytes
+static int64_t _AcquireExtent
+(
+	size_t size
+) {
+	int64_t offset = -1;
+
+	pthread_mutex_lock(&tier->mutex);
+
+	// regions are sized in whole blocks, exact matches are the common case
+	uint n = array_len(tier->free);
+	for(uint i = 0; i < n; i++) {
+		if(tier->free[i].size == size) {
+			offset = tier->free[i].offset;
+			array_del_fast(tier->free, i);
+			break;
+		}
+	}
+
+	if(offset == -1) {
+		offset = tier->end;
+		tier->end += size;
+	}
+
+	pthread_mutex_unlock(&tier->mutex);
+
+	return offset;
+}
+
+static void _ReleaseExtent
+(
+	int64_t offset,
+	size_t size
+) {
+	Extent e = {.offset = offset, .size = size};
+
+	pthread_mutex_lock(&tier->mutex);
+
+	// rewriting an extent a child still maps would change its view
+	if(tier->forked) {
+		array_append(tier->quarantine, e);
+	} else {
+		_PunchHole(e);
+		array_append(tier->free, e);
+	}
+
+	pthread_mutex_unlock(&tier->mutex);
+}
+
+// write 'size' bytes from 'addr' to the scratch file at 'offset'
+static bool _Write
+(
+	const void *addr,
+	size_t size,
+	int64_t offset
+) {
+	const char *buf = addr;
+	while(size > 0) {
+		ssize_t n = pwrite(tier->fd, buf, size, offset);
+		if(n < 0) {
+			if(errno == EINTR) continue;
+			return false;
+		}
+		buf    += n;
+		size   -= n;
+		offset += n;
+	}
+	return true;
+}
+
+bool StorageTier_Init
+(
+	const char *dir
+) {
+	ASSERT(dir != NULL);
+	ASSERT(tier == NULL);
+
+	char *path;
+	asprintf(&path, "%s/graphstore.XXXXXX", dir);
+	int fd = mkstemp(path);
+	if(fd != -1) unlink(path);
+	free(path);
+
+	if(fd == -1) return false;
+
+	tier = rm_calloc(1, sizeof(StorageTier));
+	tier->fd         = fd;
+	tier->page_size  = sysconf(_SC_PAGESIZE);
+	tier->free       = array_new(Extent, 0);
+	tier->quarantine = array_new(Extent, 0);
+
+	int res = pthread_mutex_init(&tier->mutex, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	return true;
+}
+
+inline bool StorageTier_Enabled(void) {
+	return tier != NULL;
+}
+
+size_t StorageTier_MappingSize
+(
+	size_t size
+) {
+	ASSERT(tier != NULL);
+
+	// small regions would waste most of their page
+	if(size < tier->page_size) return 0;
+
+	return (size + tier->page_size - 1) & ~(tier->page_size - 1);
+}
+
+void *StorageTier_Alloc
+(
+	size_t size
+) {
+	ASSERT(tier != NULL);
+	ASSERT(size > 0 && size % tier->page_size == 0);
+
+	void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	return (addr == MAP_FAILED) ? NULL : addr;
+}
+
+bool StorageTier_Seal
+(
+	void *addr,
+	size_t size,
+	int64_t *offset
+) {
+	ASSERT(tier   != NULL);
+	ASSERT(addr   != NULL);
+	ASSERT(offset != NULL);
+	ASSERT(*offset == -1);
+
+	int64_t off = _AcquireExtent(size);
+
+	// 'offset' might reside within the region, set it prior to writing
+	*offset = off;
+	if(!_Write(addr, size, off)) {
+		*offset = -1;
+		_ReleaseExtent(off, size);
+		return false;
+	}
+
+	// replace the anonymous pages with identical file-backed ones
+	// addresses remain valid, readers observe the same content throughout
+	void *res = mmap(addr, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_FIXED, tier->fd, off);
+
+	// a failing fixed mapping might have discarded the original pages
+	RedisModule_Assert(res != MAP_FAILED);
+
+	return true;
+}
+
+void StorageTier_Free
+(
+	void *addr,
+	size_t size,
+	int64_t offset
+) {
+	ASSERT(tier != NULL);
+	ASSERT(addr != NULL);
+
+	int res = munmap(addr, size);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	if(offset != -1) _ReleaseExtent(offset, size);
+}
+
+void StorageTier_ForkPrepare(void) {
+	if(tier == NULL) return;
+
+	pthread_mutex_lock(&tier->mutex);
+	tier->forked = true;
+	pthread_mutex_unlock(&tier->mutex);
+}
+
+void StorageTier_ForkDone(void) {
+	if(tier == NULL) return;
+
+	pthread_mutex_lock(&tier->mutex);
+
+	tier->forked = false;
+
+	uint n = array_len(tier->quarantine);
+	for(uint i = 0; i < n; i++) {
+		_PunchHole(tier->quarantine[i]);
+		array_append(tier->free, tier->quarantine[i]);
+	}
+	array_clear(tier->quarantine);
+
+	pthread_mutex_unlock(&tier->mutex);
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// memory-mapped storage tier
+//
+// regions are allocated as private anonymous mappings
+// once a region's content is stable it can be sealed: its content is written
+// to a scratch file and the region is remapped, in place, as a private
+// mapping of that file
+//
+// sealed pages are clean and file-backed, the OS is free to evict cold pages
+// and fault them back in on access, hot pages remain resident
+// writing to a sealed page turns it into a private anonymous page
+// as such content observed by a forked child is never affected by the parent
+//
+// the scratch file is unlinked upon creation, it holds no persistent state
+
+// initialize the storage tier, scratch file is created within 'dir'
+// returns false if the scratch file could not be created
+bool StorageTier_Init
+(
+	const char *dir  // directory to hold the scratch file
+);
+
+// returns true if the storage tier is enabled
+bool StorageTier_Enabled(void);
+
+// returns the size of a mapping able to hold 'size' bytes
+// 0 if 'size' is too small to benefit from a dedicated mapping
+size_t StorageTier_MappingSize
+(
+	size_t size  // number of bytes required
+);
+
+// allocates a zeroed region of 'size' bytes
+// 'size' must be a value returned by StorageTier_MappingSize
+// returns NULL on failure
+void *StorageTier_Alloc
+(
+	size_t size  // region size
+);
+
+// backs region by the scratch file
+// 'offset' is set to the region's position within the scratch file
+// returns false if region remains anonymous
+bool StorageTier_Seal
+(
+	void *addr,      // region to seal
+	size_t size,     // region size
+	int64_t *offset  // [output] file offset
+);
+
+// releases region, 'offset' is -1 for regions which were never sealed
+void StorageTier_Free
+(
+	void *addr,     // region to release
+	size_t size,    // region size
+	int64_t offset  // file offset
+);
+
+// a process is about to fork
+// file extents released from now on are kept aside, as the child
+// might still map them, until StorageTier_ForkDone is called
+void StorageTier_ForkPrepare(void);
+
+// no forked child is alive, release extents kept aside
+void StorageTier_ForkDone(void);
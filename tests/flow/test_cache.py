@@ -243,3 +243,80 @@ class testCache(FlowTestsBase):
         cached_result = graph.query(query, params)
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
+
+    def test13_auto_parameterize(self):
+        # queries which differ only by their literals share a cache entry
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "AUTO_PARAMETERIZE", "yes")
+        graph = Graph(redis_con, 'Cache_Auto_Parameterize')
+        graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x, s: 'it\\'s ' + toString(x)})")
+
+        result = graph.query("MATCH (n:N {v: 1}) RETURN n.s AS s")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [["it's 1"]])
+
+        result = graph.query("MATCH (n:N {v: 7}) RETURN n.s AS s")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [["it's 7"]])
+
+        # string literals and user provided parameters
+        query = "MATCH (n:N) WHERE n.s = '%s' AND n.v > $min RETURN n.v AS v"
+        result = graph.query(query % "it\\'s 3", {'min': 0})
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[3]])
+
+        result = graph.query(query % "it\\'s 5", {'min': 0})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[5]])
+
+        # skip and limit
+        query = "MATCH (n:N) RETURN n.v AS v ORDER BY n.v SKIP %d LIMIT %d"
+        result = graph.query(query % (1, 2))
+        self.env.assertEqual(result.result_set, [[1], [2]])
+        result = graph.query(query % (5, 3))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[5], [6], [7]])
+
+        # unaliased projections retain their literals, as they name the column
+        result = graph.query("RETURN 1 + 2")
+        self.env.assertEqual(result.header[0][1], "1 + 2")
+        result = graph.query("RETURN 2 + 2")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.header[0][1], "2 + 2")
+        self.env.assertEqual(result.result_set, [[4]])
+
+        # variable length bounds are not parameterized
+        graph.query("MATCH (a:N {v: 0}), (b:N {v: 1}) CREATE (a)-[:R]->(b)")
+        result = graph.query("MATCH (:N {v: 0})-[*1..1]->(m) RETURN m.v AS v")
+        self.env.assertEqual(result.result_set, [[1]])
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "AUTO_PARAMETERIZE", "no")
+        result = graph.query("MATCH (n:N {v: 2}) RETURN n.s AS s")
+        self.env.assertFalse(result.cached_execution)
+        graph.delete()
+
+    def test14_cache_info(self):
+        graph = Graph(redis_con, 'Cache_Info')
+
+        def info():
+            return {name: value for name, value in redis_con.execute_command("GRAPH.INFO", "Cache_Info")}
+
+        for i in range(CACHE_SIZE + 2):
+            graph.query("RETURN {val}".format(val=i))
+        graph.query("RETURN 0 + 1")
+        graph.query("RETURN 0 + 1")
+
+        stats = info()
+        self.env.assertEqual(stats['cache_capacity'], CACHE_SIZE)
+        self.env.assertEqual(stats['cache_size'], CACHE_SIZE)
+        self.env.assertEqual(stats['cache_hits'], 1)
+        self.env.assertEqual(stats['cache_misses'], CACHE_SIZE + 3)
+        self.env.assertEqual(stats['cache_evictions'], 3)
+
+        # missing graph
+        try:
+            redis_con.execute_command("GRAPH.INFO", "Cache_Info_Missing")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+        graph.delete()
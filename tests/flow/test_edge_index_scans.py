@@ -504,3 +504,91 @@ class testEdgeByIndexScanFlow(FlowTestsBase):
         result = redis_graph.query("MATCH ()-[u:R2]->() WHERE u.id1 = 990000000262240069 AND u.id2 = 990000000262240067 RETURN u.id1, u.id2")
         expected_result = [[990000000262240069, 990000000262240067]]
         self.env.assertEquals(result.result_set, expected_result)
+
+    def test21_ordered_index_lookups(self):
+        # indexed :R and none indexed :S edges hold the same values
+        # every lookup should return the same values for both relationships
+        redis_graph = Graph(self.env.getConnection(), 'ordered_edge_index')
+        redis_graph.query("CREATE INDEX FOR ()-[r:R]-() ON (r.v)")
+
+        redis_graph.query("""UNWIND range(0, 9) AS x
+                             CREATE (a:N {id: x % 3})
+                             CREATE (a)-[:R {v: x}]->(:M), (a)-[:S {v: x}]->(:M)
+                             CREATE (a)-[:R {v: toString(x)}]->(:M), (a)-[:S {v: toString(x)}]->(:M)""")
+
+        predicates = [
+            "e.v = 4",
+            "e.v > 2 AND e.v <= 7",
+            "e.v >= '5'",
+            "e.v IN [1, 3, '3', 3]",
+        ]
+
+        for predicate in predicates:
+            # scan all edges
+            q = f"MATCH (a)-[e:R]->() WHERE {predicate} RETURN a.id, e.v ORDER BY a.id, e.v"
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn('Edge By Index Scan', plan)
+            indexed = redis_graph.query(q).result_set
+
+            q = f"MATCH (a)-[e:S]->() WHERE {predicate} RETURN a.id, e.v ORDER BY a.id, e.v"
+            expected = redis_graph.query(q).result_set
+            self.env.assertEquals(indexed, expected)
+
+            # source node is resolved prior to the index scan
+            q = f"MATCH (a:N {{id: 1}}) MATCH (a)-[e:R]->() WHERE {predicate} RETURN a.id, e.v ORDER BY a.id, e.v"
+            indexed = redis_graph.query(q).result_set
+
+            q = f"MATCH (a:N {{id: 1}}) MATCH (a)-[e:S]->() WHERE {predicate} RETURN a.id, e.v ORDER BY a.id, e.v"
+            expected = redis_graph.query(q).result_set
+            self.env.assertEquals(indexed, expected)
+
+    def test22_adjacent_index_lookups(self):
+        # edges of a resolved source node are located through the
+        # per source node index, indexed :R and none indexed :S edges
+        # hold the same values, every lookup should return the same values
+        redis_graph = Graph(self.env.getConnection(), 'adjacent_edge_index')
+        redis_graph.query("CREATE INDEX FOR ()-[r:R]-() ON (r.w)")
+
+        redis_graph.query("""UNWIND range(0, 4) AS x
+                             CREATE (a:N {id: x})
+                             WITH a, x
+                             UNWIND range(0, 99) AS y
+                             CREATE (a)-[:R {w: (x * y) % 37}]->(:M {id: y}),
+                                    (a)-[:S {w: (x * y) % 37}]->(:M {id: y})""")
+        # edges holding a string or no value at all
+        redis_graph.query("""MATCH (a:N) WHERE a.id < 2
+                             CREATE (a)-[:R {w: 'w' + toString(a.id)}]->(:M {id: -1}),
+                                    (a)-[:S {w: 'w' + toString(a.id)}]->(:M {id: -1}),
+                                    (a)-[:R]->(:M {id: -2}), (a)-[:S]->(:M {id: -2})""")
+
+        predicates = [
+            "e.w = 5",
+            "e.w > 30",
+            "e.w >= 10 AND e.w < 12",
+            "e.w IN [0, 36, 'w1', 0]",
+            "e.w STARTS WITH 'w'",
+            "e.w > 20 AND b.id % 2 = 0",
+        ]
+
+        for predicate in predicates:
+            q = f"""MATCH (a:N) WHERE a.id IN [1, 3, 4]
+                    MATCH (a)-[e:{{rel}}]->(b)
+                    WHERE {predicate}
+                    RETURN a.id, e.w, b.id ORDER BY a.id, b.id"""
+            plan = redis_graph.execution_plan(q.format(rel='R'))
+            self.env.assertIn('Edge By Index Scan', plan)
+            indexed = redis_graph.query(q.format(rel='R')).result_set
+            expected = redis_graph.query(q.format(rel='S')).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # updated and deleted edges are reflected by the index
+        redis_graph.query("MATCH (:N {id: 3})-[e]->(b:M) WHERE b.id < 10 SET e.w = 100")
+        redis_graph.query("MATCH (:N {id: 4})-[e]->(b:M) WHERE b.id < 50 DELETE e")
+
+        q = """MATCH (a:N) WHERE a.id IN [3, 4]
+               MATCH (a)-[e:{rel}]->(b)
+               WHERE e.w >= 30
+               RETURN a.id, e.w, b.id ORDER BY a.id, b.id"""
+        indexed = redis_graph.query(q.format(rel='R')).result_set
+        expected = redis_graph.query(q.format(rel='S')).result_set
+        self.env.assertEquals(indexed, expected)
@@ -0,0 +1,112 @@
+from common import *
+import os
+
+GRAPH_ID = "export_src"
+IMPORT_ID = "export_dst"
+FILENAME = "export_import.rgx"
+
+redis_con = None
+redis_graph = None
+
+class testExportImport():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        q = """CREATE (a:A:B {s: 'str', i: 1, d: 2.5, b: true, arr: [1, 'x', [2.5, null]]}),
+                      (b:B {p: point({latitude: 32.5, longitude: 34.25})}),
+                      (c {i: 3}),
+                      (a)-[:R {w: 1}]->(b),
+                      (a)-[:R {w: 2}]->(b),
+                      (b)-[:R]->(c),
+                      (c)-[:S {arr: ['a', 'b']}]->(a)"""
+        redis_graph.query(q)
+
+        # leave gaps within the node and edge ID ranges
+        q = "UNWIND range(0, 99) AS x CREATE (:C {v: x})-[:S {v: x}]->(:C)"
+        redis_graph.query(q)
+        redis_graph.query("MATCH (n:C) WHERE n.v % 10 = 0 DETACH DELETE n")
+
+    def snapshot(self, graph):
+        nodes = graph.query("""MATCH (n) RETURN labels(n), properties(n)
+                               ORDER BY toString(labels(n)), toString(properties(n))""").result_set
+        edges = graph.query("""MATCH (a)-[e]->(b)
+                               RETURN type(e), properties(e), properties(a), properties(b)
+                               ORDER BY type(e), toString(properties(e)), toString(properties(a))""").result_set
+        return nodes, edges
+
+    def test01_export_import(self):
+        result = redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, FILENAME)
+        self.env.assertEquals(result, "193 nodes exported, 94 edges exported")
+
+        result = redis_con.execute_command("GRAPH.IMPORT", IMPORT_ID, FILENAME)
+        self.env.assertEquals(result, "193 nodes imported, 94 edges imported")
+
+        imported = Graph(redis_con, IMPORT_ID)
+        self.env.assertEquals(self.snapshot(imported), self.snapshot(redis_graph))
+
+        # imported graph is fully functional
+        imported.query("CREATE (:A {s: 'new'})")
+        result = imported.query("MATCH (n:A) RETURN count(n)").result_set
+        self.env.assertEquals(result[0][0], 2)
+
+    def test02_import_existing_key(self):
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", GRAPH_ID, FILENAME)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("already exists", str(e))
+
+    def test03_invalid_file(self):
+        for filename in ["../" + FILENAME, "/tmp/" + FILENAME]:
+            try:
+                redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, filename)
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertIn("Invalid export file name", str(e))
+
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", "missing", "missing.rgx")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Failed to open file", str(e))
+
+        # a non export file is rejected, graph isn't created
+        redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, FILENAME)
+        path = os.path.join(redis_con.config_get("dir")["dir"], FILENAME)
+        with open(path, "r+b") as f:
+            f.seek(-3, 2)
+            f.truncate()
+
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", "truncated", FILENAME)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("not a valid graph export", str(e))
+        self.env.assertEquals(redis_con.exists("truncated"), 0)
+
+    def test04_import_content(self):
+        # GRAPH.IMPORT accepts the file's content, imports are replicated this way
+        redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, FILENAME)
+        path = os.path.join(redis_con.config_get("dir")["dir"], FILENAME)
+        with open(path, "rb") as f:
+            content = f.read()
+        os.remove(path)
+
+        result = redis_con.execute_command("GRAPH.IMPORT", "content", "DATA", content)
+        self.env.assertEquals(result, "193 nodes imported, 94 edges imported")
+
+        imported = Graph(redis_con, "content")
+        self.env.assertEquals(self.snapshot(imported), self.snapshot(redis_graph))
+
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", "invalid", "DATA", content[:-3])
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("not a valid graph export", str(e))
+        self.env.assertEquals(redis_con.exists("invalid"), 0)
@@ -151,3 +151,34 @@ class testGraphCreationFlow(FlowTestsBase):
                 self.env.assertTrue(False)
             except redis.exceptions.ResponseError as e:
                 self.env.assertContains("The bound variable 'r' can't be redeclared in a CREATE clause", str(e))
+
+    # edges created by a single query are introduced in batches
+    # one batch per relationship type, make sure multi-edges, both within
+    # the batch and with existing edges, are created
+    def test10_create_edges_batch(self):
+        query = """UNWIND range(0, 9) AS x CREATE (:Batch {v: x})"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.nodes_created, 10)
+
+        # connect each node to its successor, twice, using two relationship types
+        query = """UNWIND range(0, 8) AS x
+                   MATCH (a:Batch {v: x}), (b:Batch {v: x + 1})
+                   CREATE (a)-[:R {v: x}]->(b), (a)-[:R {v: x}]->(b), (b)-[:S]->(a)"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.relationships_created, 27)
+        self.env.assertEquals(result.properties_set, 18)
+
+        # add parallel edges to already existing ones
+        query = """MATCH (a:Batch)-[:S]->(b:Batch) CREATE (a)-[:S]->(b)"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.relationships_created, 9)
+
+        query = """MATCH (a:Batch)-[e:R]->(b:Batch) RETURN a.v, b.v, count(e) ORDER BY a.v"""
+        result = redis_graph.query(query)
+        expected_result = [[x, x + 1, 2] for x in range(9)]
+        self.env.assertEquals(result.result_set, expected_result)
+
+        query = """MATCH (a:Batch)<-[e:S]-(b:Batch) RETURN a.v, b.v, count(e) ORDER BY a.v"""
+        result = redis_graph.query(query)
+        expected_result = [[x, x + 1, 2] for x in range(9)]
+        self.env.assertEquals(result.result_set, expected_result)
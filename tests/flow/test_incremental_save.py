@@ -0,0 +1,92 @@
+from common import *
+import time
+
+GRAPH_ID = "incremental_save"
+FLUSH_INTERVAL = 100 # ms
+
+redis_con = None
+redis_graph = None
+
+class testIncrementalSave():
+    def __init__(self):
+        self.env = Env(decodeResponses=True,
+                moduleArgs='INCREMENTAL_SAVE_INTERVAL %d' % FLUSH_INTERVAL)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+    def wait_for_snapshot(self):
+        # changes which can't be logged trigger a snapshot
+        for _ in range(100):
+            persistence = redis_con.info("persistence")
+            if persistence['rdb_changes_since_last_save'] == 0 and \
+               persistence['rdb_bgsave_in_progress'] == 0:
+                return
+            time.sleep(0.1)
+        self.env.assertTrue(False)
+
+    def restart(self):
+        global redis_con
+        global redis_graph
+
+        # make sure all changes were logged
+        time.sleep(FLUSH_INTERVAL * 5 / 1000)
+
+        # restart without taking a snapshot
+        redis_con.config_set("save", "")
+        self.env.stop()
+        self.env.start()
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+    def snapshot(self):
+        q = "MATCH (n) OPTIONAL MATCH (n)-[e]->(m) RETURN n, e, m ORDER BY ID(n), ID(e)"
+        return redis_graph.query(q).result_set
+
+    def test01_replay_changes(self):
+        if self.env.envRunner.debugger is not None:
+            self.env.skip()
+
+        # graph creation and new schema require a snapshot
+        q = """UNWIND range(0, 9) AS x
+               CREATE (:A {v: x})-[:R {v: x}]->(:B {v: x})"""
+        redis_graph.query(q)
+        self.wait_for_snapshot()
+
+        # modify graph without introducing new schema
+        redis_graph.query("MATCH (a:A) WHERE a.v < 3 DETACH DELETE a")
+        redis_graph.query("MATCH (b:B) WHERE b.v > 7 SET b.v = b.v * 10")
+        redis_graph.query("MATCH ()-[r:R]->() WHERE r.v = 5 SET r.v = 'five'")
+        redis_graph.query("MATCH ()-[r:R]->() WHERE r.v = 6 DELETE r")
+        redis_graph.query("CREATE (:A {v: [1, 2]})-[:R {v: 1.5}]->(:B)")
+        redis_graph.query("MATCH (a:A {v: 4}), (b:B {v: 0}) CREATE (a)-[:R]->(b)")
+
+        expected = self.snapshot()
+        self.restart()
+        actual = self.snapshot()
+        self.env.assertEquals(actual, expected)
+
+    def test02_reuse_deleted_ids(self):
+        if self.env.envRunner.debugger is not None:
+            self.env.skip()
+
+        # deleted IDs are reused by newly created entities
+        redis_graph.query("MATCH (n:B) WHERE n.v = 1 DETACH DELETE n")
+        redis_graph.query("MATCH (a:A {v: 3}) CREATE (a)-[:R {v: 'new'}]->(:B {v: -1})")
+
+        expected = self.snapshot()
+        self.restart()
+        actual = self.snapshot()
+        self.env.assertEquals(actual, expected)
+
+    def test03_graph_deletion(self):
+        if self.env.envRunner.debugger is not None:
+            self.env.skip()
+
+        # graph deletion requires a snapshot
+        redis_graph.delete()
+        self.wait_for_snapshot()
+        self.restart()
+        self.env.assertFalse(redis_con.exists(GRAPH_ID))
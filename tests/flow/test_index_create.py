@@ -1,4 +1,5 @@
 from common import *
+import time
 
 GRAPH_ID = "index"
 redis_graph = None
@@ -173,3 +174,54 @@ class testIndexCreationFlow(FlowTestsBase):
         result = redis_graph.query("CREATE INDEX FOR ()-[r:follow]-() ON (r.prop1, r.prop2)")
         self.env.assertEquals(result.indices_created, 2)
 
+    def test05_background_index_construction(self):
+        # labels larger than a single construction batch
+        # are indexed in the background
+        redis_graph.query("UNWIND range(0, 29999) AS x CREATE (:Big {v: x})")
+        redis_graph.query("UNWIND range(0, 29999) AS x CREATE ()-[:BIG {v: x}]->()")
+
+        result = redis_graph.query("CREATE INDEX FOR (n:Big) ON (n.v)")
+        self.env.assertEquals(result.indices_created, 1)
+        result = redis_graph.query("CREATE INDEX FOR ()-[e:BIG]-() ON (e.v)")
+        self.env.assertEquals(result.indices_created, 1)
+
+        # modifications made while indices are populated
+        redis_graph.query("CREATE (:Big {v: -1}), ()-[:BIG {v: -1}]->()")
+        redis_graph.query("MATCH (n:Big {v: 0}) DELETE n")
+        redis_graph.query("MATCH ()-[e:BIG {v: 0}]->() DELETE e")
+        redis_graph.query("MATCH (n:Big {v: 1}) SET n.v = -2")
+        redis_graph.query("MATCH ()-[e:BIG {v: 1}]->() SET e.v = -2")
+
+        # wait for both indices to become operational
+        q = """CALL db.indexes() YIELD label, status, progress
+               WHERE label IN ['Big', 'BIG'] AND status <> 'OPERATIONAL'
+               RETURN count(1)"""
+        for _ in range(100):
+            if redis_graph.query(q).result_set[0][0] == 0:
+                break
+            time.sleep(0.1)
+
+        q = """CALL db.indexes() YIELD label, status, progress
+               WHERE label IN ['Big', 'BIG']
+               RETURN status, progress"""
+        result = redis_graph.query(q).result_set
+        self.env.assertEquals(result, [['OPERATIONAL', 100], ['OPERATIONAL', 100]])
+
+        queries = [
+            ("MATCH (n:Big) WHERE n.v = -1 RETURN count(n)", 1),
+            ("MATCH (n:Big) WHERE n.v = -2 RETURN count(n)", 1),
+            ("MATCH (n:Big) WHERE n.v = 0 RETURN count(n)", 0),
+            ("MATCH (n:Big) WHERE n.v = 1 RETURN count(n)", 0),
+            ("MATCH (n:Big) WHERE n.v >= 0 RETURN count(n)", 29998),
+            ("MATCH ()-[e:BIG]->() WHERE e.v = -1 RETURN count(e)", 1),
+            ("MATCH ()-[e:BIG]->() WHERE e.v = -2 RETURN count(e)", 1),
+            ("MATCH ()-[e:BIG]->() WHERE e.v = 0 RETURN count(e)", 0),
+            ("MATCH ()-[e:BIG]->() WHERE e.v = 1 RETURN count(e)", 0),
+            ("MATCH ()-[e:BIG]->() WHERE e.v >= 0 RETURN count(e)", 29998),
+        ]
+
+        for q, expected in queries:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn("Index Scan", plan)
+            result = redis_graph.query(q).result_set
+            self.env.assertEquals(result[0][0], expected)
@@ -612,3 +612,365 @@ class testIndexScanFlow():
         result = redis_graph.query("CALL db.idx.fulltext.queryNodes('User', 'stop')")
         self.env.assertEquals(result.result_set, [])
 
+
+    def test21_ordered_index_lookups(self):
+        # indexed :A and none indexed :B hold the same values
+        # every lookup should return the same values for both labels
+        redis_graph = Graph(self.env.getConnection(), 'ordered_index')
+        redis_graph.query("CREATE INDEX ON :A(v)")
+
+        values = "[-2.5, -1, 0, 1, 1.0, 2, 3.5, 9007199254740993, true, false, '', 'a', 'ab', 'b', [1, 2], null]"
+        redis_graph.query(f"UNWIND {values} AS x CREATE (:A {{v: x}}), (:B {{v: x}})")
+
+        predicates = [
+            "n.v = 1",
+            "n.v = 1.0",
+            "n.v = 9007199254740993",
+            "n.v = true",
+            "n.v = 'a'",
+            "n.v > 0",
+            "n.v >= 1 AND n.v < 3.5",
+            "n.v > 1 AND n.v <= 1",
+            "n.v < 'b'",
+            "n.v >= 'a' AND n.v < 'b'",
+            "n.v > 0 AND n.v < 'b'",
+            "n.v IN [2, 1, 'a', 1, true]",
+            "n.v IN []",
+        ]
+
+        for predicate in predicates:
+            q = f"MATCH (n:A) WHERE {predicate} RETURN n.v ORDER BY n.v"
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn('Node By Index Scan', plan)
+            indexed = redis_graph.query(q).result_set
+
+            q = f"MATCH (n:B) WHERE {predicate} RETURN n.v ORDER BY n.v"
+            expected = redis_graph.query(q).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # updated values replace their previous index entries
+        redis_graph.query("MATCH (n:A {v: 2}) SET n.v = 'c'")
+        result = redis_graph.query("MATCH (n:A) WHERE n.v = 2 RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[0]])
+        result = redis_graph.query("MATCH (n:A) WHERE n.v > 'b' RETURN n.v")
+        self.env.assertEquals(result.result_set, [['c']])
+
+        # removed values are dropped from the index
+        redis_graph.query("MATCH (n:A {v: 'c'}) SET n.v = NULL")
+        result = redis_graph.query("MATCH (n:A) WHERE n.v > 'b' RETURN n.v")
+        self.env.assertEquals(result.result_set, [])
+
+        # deleted nodes are dropped from the index
+        redis_graph.query("MATCH (n:A {v: 'a'}) DELETE n")
+        result = redis_graph.query("MATCH (n:A) WHERE n.v IN ['a', 'ab'] RETURN n.v")
+        self.env.assertEquals(result.result_set, [['ab']])
+
+    def test22_composite_index_lookups(self):
+        # indexed :A and none indexed :B hold the same values
+        # every lookup should return the same values for both labels
+        redis_graph = Graph(self.env.getConnection(), 'composite_index')
+        result = redis_graph.query("CREATE INDEX FOR (n:A) ON (n.tenant, n.ts)")
+        self.env.assertEquals(result.indices_created, 2)
+
+        result = redis_graph.query("CALL db.indexes() YIELD label, composites")
+        self.env.assertEquals(result.result_set, [['A', [['tenant', 'ts']]]])
+
+        redis_graph.query("""UNWIND range(0, 99) AS x
+                             CREATE (:A {tenant: x % 3, ts: x}), (:B {tenant: x % 3, ts: x})""")
+        # nodes missing the second attribute
+        redis_graph.query("CREATE (:A {tenant: 1}), (:B {tenant: 1})")
+
+        predicates = [
+            "n.tenant = 1",
+            "n.tenant = 1 AND n.ts = 10",
+            "n.tenant = 1 AND n.ts > 50",
+            "n.tenant = 1 AND n.ts >= 10 AND n.ts <= 40",
+            "n.tenant = 1 AND n.ts > 10 AND n.ts < 13",
+            "n.tenant = 1 AND n.ts > 90 AND n.ts < 10",
+            "n.tenant = 2 AND n.ts < 20.5",
+            "n.tenant = 1 AND n.ts > 'a'",
+            "n.tenant = 1 AND n.tenant = 2",
+            "n.tenant = 0 AND n.ts > 50 AND n.ts % 2 = 0",
+        ]
+
+        for predicate in predicates:
+            for direction in ["ASC", "DESC"]:
+                q = f"MATCH (n:A) WHERE {predicate} RETURN n.tenant, n.ts ORDER BY n.ts {direction}"
+                plan = redis_graph.execution_plan(q)
+                self.env.assertIn('Node By Index Scan', plan)
+                # nodes are produced ordered by ts, sorting is omitted
+                self.env.assertNotIn('Sort', plan)
+                indexed = redis_graph.query(q).result_set
+
+                q = f"MATCH (n:B) WHERE {predicate} RETURN n.tenant, n.ts ORDER BY n.ts {direction}"
+                expected = redis_graph.query(q).result_set
+                self.env.assertEquals(indexed, expected)
+
+        # sorting by an attribute the scan isn't ordered by requires sorting
+        q = "MATCH (n:A) WHERE n.ts > 50 RETURN n.ts ORDER BY n.tenant"
+        self.env.assertIn('Sort', redis_graph.execution_plan(q))
+
+        # updated values replace their previous composite entries
+        redis_graph.query("MATCH (n:A {tenant: 1, ts: 10}) SET n.tenant = 2")
+        result = redis_graph.query("MATCH (n:A) WHERE n.tenant = 1 AND n.ts = 10 RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[0]])
+        result = redis_graph.query("MATCH (n:A) WHERE n.tenant = 2 AND n.ts = 10 RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[1]])
+
+        # composites survive persistence
+        self.env.dumpAndReload()
+        result = redis_graph.query("CALL db.indexes() YIELD label, composites")
+        self.env.assertEquals(result.result_set, [['A', [['tenant', 'ts']]]])
+        result = redis_graph.query("MATCH (n:A) WHERE n.tenant = 2 AND n.ts < 12 RETURN n.ts ORDER BY n.ts")
+        self.env.assertEquals(result.result_set, [[2], [5], [8], [10], [11]])
+
+        # dropping one of the attributes drops the composite
+        redis_graph.query("DROP INDEX ON :A(ts)")
+        result = redis_graph.query("CALL db.indexes() YIELD label, composites")
+        self.env.assertEquals(result.result_set, [['A', []]])
+
+    def test23_ordered_label_scan(self):
+        # indexed :A and none indexed :B hold the same values
+        # every query should return the same values for both labels
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, 'ordered_scan')
+        redis_graph.query("CREATE INDEX ON :A(ts)")
+
+        redis_graph.query("""UNWIND range(0, 49) AS x
+                             CREATE (:A {ts: x}), (:B {ts: x})""")
+        # nodes holding no value or a value which isn't indexable
+        # order before and after the indexed values
+        values = "[null, [1, 2], [0], 'a', true, point({latitude: 1, longitude: 2})]"
+        redis_graph.query(f"UNWIND {values} AS x CREATE (:A {{ts: x}}), (:B {{ts: x}})")
+
+        queries = [
+            "MATCH (n:{label}) RETURN n.ts ORDER BY n.ts DESC LIMIT 20",
+            "MATCH (n:{label}) RETURN n.ts ORDER BY n.ts LIMIT 20",
+            "MATCH (n:{label}) RETURN n.ts ORDER BY n.ts DESC",
+            "MATCH (n:{label}) RETURN n.ts ORDER BY n.ts",
+            "MATCH (n:{label}) WHERE n.ts <> 7 RETURN n.ts ORDER BY n.ts DESC LIMIT 10",
+        ]
+
+        for q in queries:
+            plan = redis_graph.execution_plan(q.format(label='A'))
+            # the label is scanned in order through the index, sorting is omitted
+            self.env.assertIn('Node By Index Scan', plan)
+            self.env.assertNotIn('Sort', plan)
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # nodes holding no indexable value are indexed as well
+        # scan stops once limit is reached
+        q = "MATCH (n:A) RETURN n.ts ORDER BY n.ts LIMIT 3"
+        result = redis_graph.query(q)
+        self.env.assertEquals(result.result_set, [[[0]], [[1, 2]], ['a']])
+
+        profile = redis_con.execute_command("GRAPH.PROFILE", 'ordered_scan', q)
+        profile = [x[0:x.index(',')].strip() for x in profile]
+        self.env.assertIn("Node By Index Scan | (n:A) | Records produced: 3", profile)
+
+        # sorting by an attribute which isn't indexed requires sorting
+        q = "MATCH (n:A) RETURN n.v ORDER BY n.v DESC LIMIT 3"
+        self.env.assertIn('Sort', redis_graph.execution_plan(q))
+
+    def test24_index_only_scans(self):
+        # indexed :A and none indexed :B hold the same values
+        # every query should return the same values for both labels
+        redis_graph = Graph(self.env.getConnection(), 'index_only')
+        redis_graph.query("CREATE INDEX ON :A(name)")
+        redis_graph.query("CREATE INDEX FOR (n:A) ON (n.tenant, n.ts)")
+
+        redis_graph.query("""UNWIND range(0, 99) AS x
+                             CREATE (:A {name: 'n' + toString(x), tenant: x % 3, ts: x}),
+                                    (:B {name: 'n' + toString(x), tenant: x % 3, ts: x})""")
+        # nodes holding a value which isn't a string or no value at all
+        redis_graph.query("CREATE (:A {name: 1, ts: 1}), (:B {name: 1, ts: 1}), (:A), (:B)")
+
+        predicates = [
+            "n.name STARTS WITH 'n1'",
+            "n.name STARTS WITH 'n1' AND n.ts > 15",
+            "n.name STARTS WITH ''",
+            "n.name STARTS WITH 'x'",
+            "n.tenant = 1 AND n.ts > 50",
+            "n.tenant = 2 AND n.ts < 20 AND n.ts % 2 = 0",
+        ]
+
+        for predicate in predicates:
+            q = f"MATCH (n:{{label}}) WHERE {predicate} RETURN n.name, n.tenant, n.ts ORDER BY n.name"
+            plan = redis_graph.execution_plan(q.format(label='A'))
+            self.env.assertIn('Node By Index Scan', plan)
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+            # aggregations over indexed attributes
+            q = f"MATCH (n:{{label}}) WHERE {predicate} RETURN n.tenant, count(n.ts), sum(n.ts) ORDER BY n.tenant"
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # prefix lookups nested under OR or given as a parameter
+        q = "MATCH (n:{label}) WHERE n.name STARTS WITH 'n1' OR n.ts = 5 RETURN n.name ORDER BY n.name"
+        indexed = redis_graph.query(q.format(label='A')).result_set
+        expected = redis_graph.query(q.format(label='B')).result_set
+        self.env.assertEquals(indexed, expected)
+
+        q = "MATCH (n:{label}) WHERE n.name STARTS WITH $p RETURN n.name ORDER BY n.name"
+        indexed = redis_graph.query(q.format(label='A'), {'p': 'n2'}).result_set
+        expected = redis_graph.query(q.format(label='B'), {'p': 'n2'}).result_set
+        self.env.assertEquals(indexed, expected)
+
+        # counts resolved entirely by the index are answered without scanning
+        predicates = [
+            ("n.name STARTS WITH 'n1'", 11),
+            ("n.tenant = 1 AND n.ts > 50", 16),
+            ("n.name = 'n7'", 1),
+        ]
+        for predicate, expected in predicates:
+            q = f"MATCH (n:A) WHERE {predicate} RETURN count(n)"
+            plan = redis_graph.execution_plan(q)
+            self.env.assertNotIn('Node By Index Scan', plan)
+            self.env.assertNotIn('Aggregate', plan)
+            result = redis_graph.query(q)
+            self.env.assertEquals(result.result_set, [[expected]])
+
+        # unresolved filters require scanning
+        q = "MATCH (n:A) WHERE n.tenant = 1 AND n.ts > 50 AND n.ts % 2 = 0 RETURN count(n)"
+        self.env.assertIn('Node By Index Scan', redis_graph.execution_plan(q))
+        result = redis_graph.query(q)
+        self.env.assertEquals(result.result_set, [[8]])
+
+    def test25_spatial_index_scans(self):
+        # indexed :A and none indexed :B hold the same points
+        # every query should return the same values for both labels
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, 'spatial_scan')
+        redis_graph.query("CREATE INDEX ON :A(loc)")
+
+        # points scattered around the globe, including both sides of the
+        # antimeridian and near the poles
+        redis_graph.query("""UNWIND range(-89, 89, 2) AS lat
+                             UNWIND range(-179, 179, 4) AS lon
+                             WITH point({latitude: lat, longitude: lon}) AS p, lat, lon
+                             CREATE (:A {loc: p, lat: lat, lon: lon}),
+                                    (:B {loc: p, lat: lat, lon: lon})""")
+        # nodes holding no point or a value which isn't a point
+        redis_graph.query("CREATE (:A), (:B), (:A {loc: 1}), (:B {loc: 1})")
+
+        origins = [
+            "point({latitude: 0, longitude: 0})",
+            "point({latitude: 11, longitude: 179.5})",
+            "point({latitude: -87, longitude: -45})",
+            "point({latitude: 89.9, longitude: 10})",
+        ]
+        radii = [1000, 150000, 600000, 2500000]
+
+        for origin in origins:
+            for radius in radii:
+                q = f"""MATCH (n:{{label}})
+                        WHERE distance(n.loc, {origin}) < {radius}
+                        RETURN n.lat, n.lon ORDER BY n.lat, n.lon"""
+                plan = redis_graph.execution_plan(q.format(label='A'))
+                self.env.assertIn('Node By Index Scan', plan)
+                indexed = redis_graph.query(q.format(label='A')).result_set
+                expected = redis_graph.query(q.format(label='B')).result_set
+                self.env.assertEquals(indexed, expected)
+
+            # nearest neighbours are produced by the index, sorting is omitted
+            q = f"""MATCH (n:{{label}})
+                    RETURN distance(n.loc, {origin}) AS d
+                    ORDER BY d LIMIT 25"""
+            plan = redis_graph.execution_plan(q.format(label='A'))
+            self.env.assertIn('Node By Index Scan', plan)
+            self.env.assertNotIn('Sort', plan)
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # nodes without a point are produced last
+        q = """MATCH (n:{label})
+               RETURN n.lat, distance(n.loc, point({latitude: 0, longitude: 0})) AS d
+               ORDER BY d"""
+        indexed = redis_graph.query(q.format(label='A')).result_set
+        expected = redis_graph.query(q.format(label='B')).result_set
+        self.env.assertEquals(len(indexed), len(expected))
+        self.env.assertEquals([row[1] for row in indexed], [row[1] for row in expected])
+
+        # updated points are reflected by the index
+        redis_graph.query("""MATCH (n) WHERE n.lat = 1 AND n.lon = 1
+                             SET n.loc = point({latitude: 45, longitude: 45})""")
+        q = """MATCH (n:{label})
+               WHERE distance(n.loc, point({latitude: 1, longitude: 1})) < 1000
+               RETURN count(n)"""
+        indexed = redis_graph.query(q.format(label='A')).result_set
+        expected = redis_graph.query(q.format(label='B')).result_set
+        self.env.assertEquals(indexed, [[0]])
+        self.env.assertEquals(indexed, expected)
+
+    def test26_membership_index_scans(self):
+        # indexed :A and none indexed :B hold the same lists
+        # every query should return the same values for both labels
+        redis_graph = Graph(self.env.getConnection(), 'membership_scan')
+        redis_graph.query("CREATE INDEX ON :A(tags)")
+
+        redis_graph.query("""UNWIND range(0, 99) AS x
+                             WITH x, [c IN ['red', 'green', 'blue', 'black'] WHERE x % (size(c) - 1) = 0] AS tags
+                             CREATE (:A {id: x, tags: tags + [x % 7]}),
+                                    (:B {id: x, tags: tags + [x % 7]})""")
+        # lists holding repeated, missing and none indexable elements
+        # and nodes holding no value at all
+        values = "[['red', 'red', 1, 1.0], [null, 'red'], [[1], 'green'], [], null]"
+        redis_graph.query(f"""UNWIND range(0, size({values}) - 1) AS i
+                              WITH i, {values}[i] AS tags
+                              CREATE (:A {{id: 100 + i, tags: tags}}),
+                                     (:B {{id: 100 + i, tags: tags}})""")
+
+        predicates = [
+            "'red' IN n.tags",
+            "'black' IN n.tags",
+            "1 IN n.tags",
+            "1.0 IN n.tags",
+            "'purple' IN n.tags",
+            "true IN n.tags",
+            "any(t IN n.tags WHERE t = 'green')",
+            "any(t IN n.tags WHERE 3 = t)",
+            "'red' IN n.tags AND 2 IN n.tags",
+            "'blue' IN n.tags AND n.id > 50",
+        ]
+
+        for predicate in predicates:
+            q = f"MATCH (n:{{label}}) WHERE {predicate} RETURN n.id ORDER BY n.id"
+            plan = redis_graph.execution_plan(q.format(label='A'))
+            self.env.assertIn('Node By Index Scan', plan)
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+            # lookups resolved by the index are counted by the index
+            q = f"MATCH (n:{{label}}) WHERE {predicate} RETURN count(n)"
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # parameterized lookups
+        for q in ["MATCH (n:{label}) WHERE $x IN n.tags RETURN n.id ORDER BY n.id",
+                  "MATCH (n:{label}) WHERE any(t IN n.tags WHERE t = $x) RETURN n.id ORDER BY n.id"]:
+            plan = redis_graph.execution_plan(q.format(label='A'), {'x': 'blue'})
+            self.env.assertIn('Node By Index Scan', plan)
+            indexed = redis_graph.query(q.format(label='A'), {'x': 'blue'}).result_set
+            expected = redis_graph.query(q.format(label='B'), {'x': 'blue'}).result_set
+            self.env.assertEquals(indexed, expected)
+
+        # predicates which aren't a membership lookup scan the label
+        q = "MATCH (n:A) WHERE any(t IN n.tags WHERE t > 'c') RETURN n.id"
+        self.env.assertNotIn('Node By Index Scan', redis_graph.execution_plan(q))
+
+        # updated lists are reflected by the index
+        redis_graph.query("MATCH (n) WHERE n.id < 10 SET n.tags = ['purple']")
+        redis_graph.query("MATCH (n) WHERE n.id >= 90 AND n.id < 100 SET n.tags = null")
+        for predicate in ["'purple' IN n.tags", "'red' IN n.tags"]:
+            q = f"MATCH (n:{{label}}) WHERE {predicate} RETURN n.id ORDER BY n.id"
+            indexed = redis_graph.query(q.format(label='A')).result_set
+            expected = redis_graph.query(q.format(label='B')).result_set
+            self.env.assertEquals(indexed, expected)
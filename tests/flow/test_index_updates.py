@@ -195,3 +195,38 @@ class testIndexUpdatesFlow(FlowTestsBase):
         # Validate that the previous value has been removed
         result = redis_graph.query("CALL db.idx.fulltext.queryNodes('label_a', 'Group C')")
         self.env.assertEquals(len(result.result_set), 0)
+
+    # Validate that an entity updated multiple times within a single query
+    # is indexed by its final value
+    def test08_coalesced_updates(self):
+        redis_graph.query("CREATE INDEX ON :COALESCE(v)")
+        redis_graph.query("CREATE (:COALESCE {v: 0})")
+
+        result = redis_graph.query("MATCH (a:COALESCE) UNWIND range(1, 10) AS x SET a.v = x")
+        self.env.assertEquals(result.properties_set, 10)
+
+        query = """MATCH (a:COALESCE {v: 10}) RETURN count(a)"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Node By Index Scan", plan)
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], 1)
+
+        # intermediate values aren't indexed
+        for v in range(0, 10):
+            result = redis_graph.query("MATCH (a:COALESCE {v: %d}) RETURN count(a)" % v)
+            self.env.assertEquals(result.result_set[0][0], 0)
+
+        # setting an indexed property to its current value retains the entry
+        redis_graph.query("MATCH (a:COALESCE) SET a.v = 10")
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], 1)
+
+    # Validate that entities are indexed once their creation is committed,
+    # such that subsequent clauses of the same query find them
+    def test09_index_visible_within_query(self):
+        redis_graph.query("CREATE INDEX ON :VISIBLE(v)")
+        query = """UNWIND range(1, 5) AS x CREATE (:VISIBLE {v: x})
+                   WITH count(*) AS c
+                   MATCH (a:VISIBLE) WHERE a.v > 2 RETURN count(a)"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], 3)
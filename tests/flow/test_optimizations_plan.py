@@ -426,3 +426,63 @@ class testOptimizationsPlan(FlowTestsBase):
                     [0, 3],
                     [0, 3]]
         self.env.assertEqual(resultset, expected)
+
+    # Traversed nodes resolve their IDs and attributes alike.
+    def test28_node_attribute_access(self):
+        # 'a' is only used by functions requiring its ID
+        query = """MATCH (a:person)-[:works_with]->(b) WHERE b.val = 0 RETURN id(a), labels(a) ORDER BY id(a)"""
+        resultset = graph.query(query).result_set
+        expected = [[1, ['person']],
+                    [2, ['person']],
+                    [3, ['person']]]
+        self.env.assertEqual(resultset, expected)
+
+        # multi-hop traversals without attribute access
+        query = """MATCH (a:person)-[:works_with]->(b)-[:works_with]->(c) RETURN count(*)"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[36]])
+
+        query = """MATCH (a:person) WHERE (a)-[:works_with]->(:person {name: 'Roi'}) RETURN count(a)"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[3]])
+
+        # inline properties of an anonymous node are accessed
+        query = """MATCH (a:person)-[:works_with]->(:person {name: 'Roi'}) RETURN a.name ORDER BY a.name"""
+        resultset = graph.query(query).result_set
+        expected = [['Ailon'], ['Alon'], ['Boaz']]
+        self.env.assertEqual(resultset, expected)
+
+        # variable length traversal destinations
+        query = """MATCH (:person {name: 'Roi'})-[:works_with*1..1]->(c) RETURN c.name ORDER BY c.name"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, expected)
+
+        # named paths are built out of their nodes
+        query = """MATCH p = (:person {name: 'Roi'})-[:works_with]->() RETURN nodes(p)[1].name AS name ORDER BY name"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, expected)
+
+        # returned nodes hold their attributes
+        query = """MATCH (:person {val: 0})-[:works_with]->(b) RETURN b ORDER BY b.val LIMIT 1"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset[0][0].properties['name'], 'Alon')
+
+        # traversed nodes can be updated
+        query = """MATCH (:person {name: 'Alon'})-[:works_with]->(b:person) WHERE id(b) = 0 SET b.visited = true RETURN b.visited"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[True]])
+
+        query = """MATCH (b:person) WHERE b.visited = true SET b.visited = NULL RETURN b.name"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [['Roi']])
+
+        # traversed nodes can be deleted and read within the same query
+        graph.query("""CREATE (:tmp {v: 1})-[:r]->(:tmp {v: 2})""")
+        query = """MATCH (:tmp {v: 1})-[:r]->(b) DETACH DELETE b RETURN b.v"""
+        result = graph.query(query)
+        self.env.assertEqual(result.nodes_deleted, 1)
+        self.env.assertEqual(result.result_set, [[2]])
+
+        query = """MATCH (a:tmp) DELETE a RETURN a.v"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[1]])
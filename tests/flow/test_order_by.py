@@ -33,3 +33,39 @@ class testOrderBy(FlowTestsBase):
         q = """MATCH (n:Person) RETURN n.id, n.name ORDER BY n.id DESC, n.name ASC LIMIT 10"""
         actual_result = redis_graph.query(q)
         self.env.assertEquals(actual_result.result_set, expected)
+
+    def test_top_n(self):
+        # many duplicate sort keys, the second key makes the order deterministic
+        q = """UNWIND range(1, 1000) AS x RETURN x ORDER BY x % 3, x DESC SKIP 5 LIMIT 10"""
+        expected = sorted(range(1, 1001), key=lambda x: (x % 3, -x))[5:15]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, [[x] for x in expected])
+
+        q = """UNWIND range(1, 1000) AS x RETURN x ORDER BY (x * 7919) % 1000 LIMIT 3"""
+        expected = sorted(range(1, 1001), key=lambda x: (x * 7919) % 1000)[:3]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, [[x] for x in expected])
+
+    def test_external_sort(self):
+        redis_con = self.env.getConnection()
+        # spill sorted runs of 100 records to disk
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "SORT_SPILL_THRESHOLD", 100)
+
+        q = """UNWIND range(1, 1000) AS x
+               RETURN x, toString(x) AS s, [x, 'a'] AS l, {k: x} AS m, x / 2.0 AS f
+               ORDER BY (x * 7919) % 1000 DESC"""
+        xs = sorted(range(1, 1001), key=lambda x: -((x * 7919) % 1000))
+        expected = [[x, str(x), [x, 'a'], {'k': x}, x / 2.0] for x in xs]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+        # graph entities are retrieved once merged
+        q = """MATCH p = (n:Person) UNWIND range(1, 100) AS x
+               RETURN x, n.name, nodes(p)[0].id ORDER BY x DESC, n.name"""
+        expected = []
+        for x in range(100, 0, -1):
+            expected += [[x, "Bing", 819], [x, "Mo", 622], [x, "Qiu", 819]]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "SORT_SPILL_THRESHOLD", 0)
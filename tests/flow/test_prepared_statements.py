@@ -0,0 +1,207 @@
+from common import *
+
+GRAPH_ID = "prepared_statements"
+
+redis_con = None
+redis_graph = None
+
+
+class testPreparedStatements(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+        q = "UNWIND range(0, 9) AS x CREATE (:P {v: x, name: 'p' + toString(x)})"
+        redis_graph.query(q)
+
+    def prepare(self, query, *params):
+        return redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, query,
+                                         *params)
+
+    def execute(self, handle, *args):
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle,
+                                        *args)
+        return query_result.QueryResult(redis_graph, res)
+
+    def test01_execute(self):
+        q = "MATCH (p:P) WHERE p.v >= $min AND p.name <> $name RETURN p.v ORDER BY p.v"
+        handle = self.prepare(q, "min", "INTEGER", "name", "STRING")
+
+        result = self.execute(handle, 7, "p8")
+        self.env.assertEquals(result.result_set, [[7], [9]])
+        self.env.assertTrue(result.cached_execution)
+
+        # same statement, different arguments
+        result = self.execute(handle, 5, "p6")
+        self.env.assertEquals(result.result_set, [[5], [7], [8], [9]])
+
+    def test02_types(self):
+        q = "RETURN $i, $f, $s, $b"
+        handle = self.prepare(q, "i", "INTEGER", "f", "float", "s", "STRING",
+                              "b", "BOOLEAN")
+
+        result = self.execute(handle, -1, 2, "x", "FALSE")
+        self.env.assertEquals(result.result_set, [[-1, 2.0, "x", False]])
+
+        result = self.execute(handle, 1, 0.5, "'quoted'", "true")
+        self.env.assertEquals(result.result_set, [[1, 0.5, "'quoted'", True]])
+
+    def test03_same_statement(self):
+        # each preparation is assigned its own handle
+        q = "MATCH (p:P {v: $v}) RETURN p.name"
+        a = self.prepare(q, "v", "INTEGER")
+        b = self.prepare(q, "v", "INTEGER")
+        self.env.assertNotEqual(a, b)
+
+        # different declarations result in a different statement
+        c = self.prepare(q, "v", "FLOAT")
+        self.env.assertNotEqual(a, c)
+
+        result = self.execute(a, 3)
+        self.env.assertEquals(result.result_set, [["p3"]])
+
+        # 3.0 is a float, equal to the integer 3
+        result = self.execute(c, 3)
+        self.env.assertEquals(result.result_set, [["p3"]])
+
+    def test04_write_statement(self):
+        q = "CREATE (:W {v: $v}) WITH 1 AS x MATCH (w:W) RETURN count(w)"
+        handle = self.prepare(q, "v", "INTEGER")
+
+        result = self.execute(handle, 1)
+        self.env.assertEquals(result.nodes_created, 1)
+        self.env.assertEquals(result.result_set, [[1]])
+
+        result = self.execute(handle, 2)
+        self.env.assertEquals(result.nodes_created, 1)
+        self.env.assertEquals(result.result_set, [[2]])
+
+    def test05_flags(self):
+        # flags follow the statement's arguments
+        q = "MATCH (p:P {v: $v}) RETURN p.v"
+        handle = self.prepare(q, "v", "INTEGER")
+
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, 4,
+                                        "--compact", "timeout", 1000)
+        self.env.assertEquals(res[1], [[[3, 4]]])
+
+    def test06_invalid_prepare(self):
+        invalid = [
+            # undeclared parameter
+            ["RETURN $a"],
+            # unused declaration
+            ["RETURN 1", "a", "INTEGER"],
+            # unknown type
+            ["RETURN $a", "a", "MAP"],
+            # duplicate declaration
+            ["RETURN $a", "a", "INTEGER", "a", "STRING"],
+            # parameter values are bound on execution
+            ["CYPHER a=1 RETURN $a", "a", "INTEGER"],
+            # index operations can't be prepared
+            ["CREATE INDEX ON :P(v)"],
+            # invalid query
+            ["RETURN $a +", "a", "INTEGER"],
+        ]
+
+        for args in invalid:
+            try:
+                self.prepare(*args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError:
+                pass
+
+        # missing type
+        try:
+            self.prepare("RETURN $a", "a")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("wrong number of arguments", str(e))
+
+    def test07_invalid_execute(self):
+        q = "RETURN $i, $f, $b"
+        handle = self.prepare(q, "i", "INTEGER", "f", "FLOAT", "b", "BOOLEAN")
+
+        invalid = [
+            # unknown handle
+            [1000, 1, 1, "true"],
+            ["x", 1, 1, "true"],
+            # missing arguments
+            [handle, 1, 1],
+            # type mismatch
+            [handle, "x", 1, "true"],
+            [handle, 1.5, 1, "true"],
+            [handle, 1, "x", "true"],
+            [handle, 1, "inf", "true"],
+            [handle, 1, 1, "yes"],
+        ]
+
+        for args in invalid:
+            try:
+                self.execute(*args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError:
+                pass
+
+    def test08_graph_deletion(self):
+        q = "RETURN $v"
+        handle = self.prepare(q, "v", "INTEGER")
+        redis_graph.delete()
+
+        # statements are discarded with their graph
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, 1)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+    def test09_deallocate(self):
+        # statements can only be prepared against an existing graph
+        q = "RETURN $v"
+        try:
+            self.prepare(q, "v", "INTEGER")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+        self.env.assertEquals(redis_con.exists(GRAPH_ID), 0)
+
+        redis_graph.query("CREATE ()")
+        handle = self.prepare(q, "v", "INTEGER")
+        result = self.execute(handle, 1)
+        self.env.assertEquals(result.result_set, [[1]])
+
+        res = redis_con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle)
+        self.env.assertEquals(res, "OK")
+
+        # deallocated and unknown handles are rejected
+        invalid = [
+            ["GRAPH.EXECUTE", GRAPH_ID, handle, 1],
+            ["GRAPH.DEALLOCATE", GRAPH_ID, handle],
+            ["GRAPH.DEALLOCATE", GRAPH_ID, "x"],
+        ]
+
+        for cmd in invalid:
+            try:
+                redis_con.execute_command(*cmd)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError:
+                pass
+
+        # deallocating a statement doesn't affect an identical one
+        other = self.prepare(q, "v", "INTEGER")
+        self.env.assertNotEqual(other, handle)
+        redis_con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, other)
+
+        # handles are never reused
+        q = "RETURN $v + 1"
+        other = self.prepare(q, "v", "INTEGER")
+        self.env.assertGreater(other, handle)
+        result = self.execute(other, 1)
+        self.env.assertEquals(result.result_set, [[2]])
+        try:
+            self.execute(handle, 1)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
@@ -110,3 +110,53 @@ class testReplication(FlowTestsBase):
         result = graph.query(q).result_set
         replica_result = replica.query(q).result_set
         env.assertEquals(replica_result, result)
+
+    def test_prepared_statement_replication(self):
+        env = self.env
+        source_con = env.getConnection()
+        replica_con = env.getSlaveConnection()
+        graph = Graph(source_con, GRAPH_ID)
+        replica = Graph(replica_con, GRAPH_ID)
+
+        # replicas aren't aware of prepared statements
+        # write statements are replicated as the equivalent query
+        q = "CREATE (:P {i: $i, f: $f, s: $s, b: $b})"
+        handle = source_con.execute_command("GRAPH.PREPARE", GRAPH_ID, q,
+                "i", "INTEGER", "f", "FLOAT", "s", "STRING", "b", "BOOLEAN")
+        source_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle,
+                -3, 2, "it's a \\ test", "true")
+
+        # the WAIT command forces master slave sync to complete
+        source_con.execute_command("WAIT", "1", "0")
+
+        q = "MATCH (p:P) RETURN p.i, p.f, p.s, p.b"
+        result = graph.query(q).result_set
+        replica_result = replica.query(q).result_set
+        env.assertEquals(result, [[-3, 2.0, "it's a \\ test", True]])
+        env.assertEquals(replica_result, result)
+
+        # statements can be prepared and deallocated on replicas
+        q = "MATCH (p:P) RETURN count(p)"
+        handle = replica_con.execute_command("GRAPH.PREPARE", GRAPH_ID, q)
+        replica_con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle)
+
+    def test_import_replication(self):
+        env = self.env
+        source_con = env.getConnection()
+        replica_con = env.getSlaveConnection()
+        imported_id = GRAPH_ID + "_imported"
+        filename = "replication.rgx"
+
+        source_con.execute_command("GRAPH.EXPORT", GRAPH_ID, filename)
+        source_con.execute_command("GRAPH.IMPORT", imported_id, filename)
+
+        # imported content is replicated, replicas don't read the file
+        os.remove(os.path.join(source_con.config_get("dir")["dir"], filename))
+
+        # the WAIT command forces master slave sync to complete
+        source_con.execute_command("WAIT", "1", "0")
+
+        q = "MATCH (n) RETURN labels(n), properties(n) ORDER BY id(n)"
+        result = Graph(source_con, imported_id).query(q).result_set
+        replica_result = Graph(replica_con, imported_id).query(q).result_set
+        env.assertEquals(replica_result, result)
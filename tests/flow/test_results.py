@@ -1,4 +1,6 @@
 from common import *
+import socket
+import struct
 
 graph = None
 redis_con = None
@@ -189,3 +191,210 @@ class testResultSetFlow(FlowTestsBase):
         query = """RETURN 'Foo\r\nBar'"""
         result = graph.query(query)
         self.env.assertEqual(result.result_set[0][0], 'Foo\r\nBar')
+
+    # large read-only result-sets are streamed to the client
+    def test11_streamed_resultset(self):
+        query = """UNWIND range(1, 5000) AS x
+                   RETURN x, toString(x) AS s, [x, x * 2] AS arr"""
+
+        # read-only query, streamed
+        streamed = graph.query(query).result_set
+
+        # write query, fully accumulated before replying
+        query = """CREATE () WITH 1 AS one
+                   UNWIND range(1, 5000) AS x
+                   RETURN x, toString(x) AS s, [x, x * 2] AS arr"""
+        accumulated = graph.query(query).result_set
+
+        self.env.assertEquals(len(streamed), 5000)
+        self.env.assertEquals(streamed, accumulated)
+        self.env.assertEquals(streamed[4999], [5000, '5000', [5000, 10000]])
+
+        # remove created node
+        graph.query("MATCH (n) WHERE NOT n:person DELETE n")
+
+    # an error encountered after rows were streamed replaces the statistics
+    def test12_streamed_resultset_error(self):
+        query = "UNWIND range(1, 5000) AS x RETURN 10 / (x - 2000)"
+        res = redis_con.execute_command("GRAPH.RO_QUERY", "G", query)
+
+        self.env.assertEquals(len(res), 3)
+        self.env.assertEquals(len(res[1]), 1999)
+        self.env.assertTrue(isinstance(res[2], ResponseError))
+        self.env.assertIn("Division by zero", str(res[2]))
+
+        # errors encountered before streaming began are emitted as is
+        query = "UNWIND range(1, 5000) AS x RETURN 10 / (x - 20)"
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", "G", query)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Division by zero", str(e))
+
+    def binary_connection(self):
+        kwargs = dict(redis_con.connection_pool.connection_kwargs)
+        kwargs['decode_responses'] = False
+        return redis.Redis(**kwargs)
+
+    def decode_binary_chunk(self, chunk):
+        nrows, ncols = struct.unpack_from('<II', chunk, 0)
+        pos = 8
+        columns = []
+        for _ in range(ncols):
+            types = chunk[pos:pos + nrows]
+            pos += nrows
+            slots = struct.unpack_from('<%dQ' % nrows, chunk, pos)
+            pos += 8 * nrows
+            columns.append(list(zip(types, slots)))
+
+        heap_len, = struct.unpack_from('<Q', chunk, pos)
+        heap = chunk[pos + 8:pos + 8 + heap_len]
+        self.env.assertEquals(len(chunk), pos + 8 + heap_len)
+
+        def properties(offset):
+            n, = struct.unpack_from('<I', heap, offset)
+            props = {}
+            for i in range(n):
+                attr, t, slot = struct.unpack_from('<IBQ', heap, offset + 4 + i * 13)
+                props[attr] = value(t, slot)
+            return props
+
+        def value(t, slot):
+            if t == 1:    # null
+                return None
+            if t == 3:    # integer
+                return struct.unpack('<q', struct.pack('<Q', slot))[0]
+            if t == 4:    # boolean
+                return slot == 1
+            if t == 5:    # double
+                return struct.unpack('<d', struct.pack('<Q', slot))[0]
+            if t == 2:    # string
+                n, = struct.unpack_from('<I', heap, slot)
+                return heap[slot + 4:slot + 4 + n].decode()
+            if t == 6:    # array
+                n, = struct.unpack_from('<I', heap, slot)
+                return [value(*struct.unpack_from('<BQ', heap, slot + 4 + i * 9)) for i in range(n)]
+            if t == 10:   # map
+                n, = struct.unpack_from('<I', heap, slot)
+                pos = slot + 4
+                m = {}
+                for _ in range(n):
+                    klen, = struct.unpack_from('<I', heap, pos)
+                    key = heap[pos + 4:pos + 4 + klen].decode()
+                    pos += 4 + klen
+                    m[key] = value(*struct.unpack_from('<BQ', heap, pos))
+                    pos += 9
+                return m
+            if t == 11:   # point
+                return list(struct.unpack_from('<dd', heap, slot))
+            if t == 8:    # node
+                node_id, nlabels = struct.unpack_from('<QI', heap, slot)
+                labels = list(struct.unpack_from('<%dI' % nlabels, heap, slot + 12))
+                return (node_id, labels, properties(slot + 12 + 4 * nlabels))
+            if t == 7:    # edge
+                edge_id, reltype, src, dest = struct.unpack_from('<QIQQ', heap, slot)
+                return (edge_id, reltype, src, dest, properties(slot + 28))
+            if t == 9:    # path
+                nodes, edges = struct.unpack_from('<QQ', heap, slot)
+                return (value(6, nodes), value(6, edges))
+            self.env.assertTrue(False)
+
+        return [[value(*columns[c][r]) for c in range(ncols)] for r in range(nrows)]
+
+    def test13_binary_resultset(self):
+        con = self.binary_connection()
+        query = """MATCH p = (a:person {name: 'Roi'})-[e:know]->(b:person {name: 'Alon'})
+                   RETURN 1, -2, 2.5, true, false, null, 'str',
+                          [1, 'a', [null]], {k: 'v', n: 1}, point({latitude: 1.5, longitude: -2.5}),
+                          a, e, p"""
+        res = con.execute_command("GRAPH.QUERY", "G", query, "--binary")
+        self.env.assertEquals(len(res), 3)
+
+        # compact header
+        self.env.assertEquals(res[0][0], [1, b'1'])
+        self.env.assertEquals(len(res[1]), 1)
+
+        rows = self.decode_binary_chunk(res[1][0])
+        self.env.assertEquals(len(rows), 1)
+        row = rows[0]
+        self.env.assertEquals(row[:10], [1, -2, 2.5, True, False, None, 'str',
+                                         [1, 'a', [None]], {'k': 'v', 'n': 1}, [1.5, -2.5]])
+
+        a_id, a_labels, a_props = row[10]
+        self.env.assertEquals(a_labels, [0])
+        self.env.assertEquals(sorted(a_props.values(), key=str), [0, 'Roi'])
+
+        e_id, reltype, src, dest, e_props = row[11]
+        self.env.assertEquals((reltype, src, e_props), (0, a_id, {}))
+
+        nodes, edges = row[12]
+        self.env.assertEquals([n[0] for n in nodes], [a_id, dest])
+        self.env.assertEquals(edges[0][0], e_id)
+
+    def test14_binary_streamed_resultset(self):
+        con = self.binary_connection()
+        query = "UNWIND range(1, 3000) AS x RETURN x, toString(x)"
+        expected = [[x, str(x)] for x in range(1, 3001)]
+
+        # streamed and fully accumulated replies are chunked alike
+        for cmd in ["GRAPH.RO_QUERY", "GRAPH.QUERY"]:
+            res = con.execute_command(cmd, "G", query, "--binary")
+            self.env.assertEquals(len(res[1]), 3)
+            rows = []
+            for chunk in res[1]:
+                rows += self.decode_binary_chunk(chunk)
+            self.env.assertEquals(rows, expected)
+
+    def test15_resp3_resultset(self):
+        if int(redis_con.info()['redis_version'].split('.')[0]) < 7:
+            self.env.skip()
+
+        kwargs = redis_con.connection_pool.connection_kwargs
+        sock = socket.create_connection((kwargs['host'], kwargs['port']))
+        f = sock.makefile('rwb')
+
+        def send(*args):
+            f.write(b'*%d\r\n' % len(args))
+            for arg in args:
+                arg = arg.encode()
+                f.write(b'$%d\r\n%s\r\n' % (len(arg), arg))
+            f.flush()
+            return read()
+
+        def read():
+            line = f.readline()[:-2]
+            t, rest = line[:1], line[1:]
+            if t == b'+':
+                return rest.decode()
+            if t == b'-':
+                return ResponseError(rest.decode())
+            if t == b':':
+                return int(rest)
+            if t == b'$':
+                return f.read(int(rest) + 2)[:-2].decode()
+            if t == b'*':
+                return [read() for _ in range(int(rest))]
+            if t == b'%':
+                return {read(): read() for _ in range(int(rest))}
+            if t == b'_':
+                return None
+            if t == b',':
+                return float(rest)
+            if t == b'#':
+                return rest == b't'
+            self.env.assertTrue(False)
+
+        send("HELLO", "3")
+        query = """MATCH (a:person {name: 'Roi'})-[e:know]->(:person {name: 'Alon'})
+                   RETURN 2.5, true, null, {k: [1, 'a']}, point({latitude: 1.5, longitude: -2.5}), a, e"""
+        res = send("GRAPH.QUERY", "G", query)
+        sock.close()
+
+        row = res[1][0]
+        self.env.assertEquals(row[:5], [2.5, True, None, {'k': [1, 'a']},
+                                        {'latitude': 1.5, 'longitude': -2.5}])
+        self.env.assertEquals(row[5]['labels'], ['person'])
+        self.env.assertEquals(row[5]['properties'], {'name': 'Roi', 'val': 0})
+        self.env.assertEquals(row[6]['type'], 'know')
+        self.env.assertEquals(row[6]['src_node'], row[5]['id'])
+
@@ -0,0 +1,100 @@
+from common import *
+import time
+
+GRAPH_ID = "storage_tier"
+
+redis_con = None
+redis_graph = None
+
+class testStorageTier():
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='STORAGE_TIER yes')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+    def snapshot(self):
+        q = """MATCH (n:N)-[e:R]->(m:N)
+               RETURN count(n), sum(n.v), sum(e.v), sum(m.v)"""
+        return redis_graph.query(q).result_set
+
+    def test01_populate(self):
+        # spans multiple entity blocks
+        q = """UNWIND range(0, 49999) AS x
+               CREATE (:N {v: x})-[:R {v: x}]->(:N {v: -x})"""
+        result = redis_graph.query(q)
+        self.env.assertEquals(result.nodes_created, 100000)
+        self.env.assertEquals(result.relationships_created, 50000)
+
+        # modify entities within sealed blocks
+        redis_graph.query("MATCH (n:N) WHERE n.v % 1000 = 0 SET n.v = n.v + 1")
+        redis_graph.query("MATCH (n:N) WHERE n.v % 1000 = 7 DETACH DELETE n")
+
+        # reuse deleted entity slots
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})-[:R {v: x}]->(:N {v: x})")
+
+        actual = self.snapshot()
+        self.env.assertEquals(actual[0][0], 50000 - 50 + 10)
+
+    def test02_fork(self):
+        global redis_con
+        global redis_graph
+
+        if self.env.envRunner.debugger is not None:
+            self.env.skip()
+
+        expected = self.snapshot()
+
+        # modifications made while a child is alive don't affect the snapshot
+        redis_con.execute_command("BGSAVE")
+        redis_graph.query("MATCH (n:N) WHERE n.v % 1000 = 3 SET n.v = 0")
+        while redis_con.info("persistence")['rdb_bgsave_in_progress'] == 1:
+            time.sleep(0.1)
+
+        modified = self.snapshot()
+        self.env.assertNotEqual(modified, expected)
+
+        # restart, loading the snapshot taken by the child
+        redis_con.config_set("save", "")
+        self.env.stop()
+        self.env.start()
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+        actual = self.snapshot()
+        self.env.assertEquals(actual, expected)
+
+    def test03_reload(self):
+        expected = self.snapshot()
+        self.env.dumpAndReload()
+        actual = self.snapshot()
+        self.env.assertEquals(actual, expected)
+
+    def test04_properties(self):
+        # string values of sealed blocks are moved to the storage tier
+        g = Graph(redis_con, "storage_tier_properties")
+        q = """UNWIND range(0, 39999) AS x
+               CREATE (:S {id: x, name: 'name-' + toString(x)})"""
+        g.query(q)
+
+        # modify packed attribute sets in place, grow and shrink them
+        g.query("MATCH (s:S) WHERE s.id % 1000 = 0 SET s.name = 'renamed'")
+        g.query("MATCH (s:S) WHERE s.id % 1000 = 1 SET s.extra = 1")
+        g.query("MATCH (s:S) WHERE s.id % 1000 = 2 SET s.id = NULL")
+
+        queries = [
+            ("MATCH (s:S) WHERE s.name = 'name-' + toString(s.id) RETURN count(s)", 39920),
+            ("MATCH (s:S) WHERE s.name = 'renamed' RETURN count(s)", 40),
+            ("MATCH (s:S) WHERE s.extra = 1 AND s.name = 'name-' + toString(s.id) RETURN count(s)", 40),
+            ("MATCH (s:S) WHERE s.id IS NULL AND s.name STARTS WITH 'name-' RETURN count(s)", 40),
+        ]
+
+        for q, expected in queries:
+            self.env.assertEquals(g.query(q).result_set[0][0], expected)
+
+        self.env.dumpAndReload()
+
+        for q, expected in queries:
+            self.env.assertEquals(g.query(q).result_set[0][0], expected)
@@ -0,0 +1,141 @@
+from common import *
+
+GRAPH_ID = "unique_constraints"
+redis_graph = None
+redis_con = None
+
+
+class testUniqueConstraintsFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        global redis_con
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+    # returns the properties of 'label' constrained to be unique
+    def unique_properties(self, label):
+        query = "CALL db.indexes() YIELD label, unique RETURN label, unique"
+        for row in redis_graph.query(query).result_set:
+            if row[0] == label:
+                return row[1]
+        return None
+
+    # returns the statistics of a query returning no rows
+    def query_stats(self, query):
+        return redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, query)[-1]
+
+    def expect_error(self, query, error):
+        try:
+            redis_graph.query(query)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains(error, str(e))
+
+    def test01_create_constraint(self):
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:Person {id: x})")
+
+        # constraint over an unindexed property introduces its backing index
+        stats = self.query_stats("CREATE CONSTRAINT ON (p:Person) ASSERT p.id IS UNIQUE")
+        self.env.assertIn("Indices created: 1", stats)
+        self.env.assertIn("Constraints created: 1", stats)
+        self.env.assertEquals(self.unique_properties('Person'), ['id'])
+
+        # constraint already exists
+        stats = self.query_stats("CREATE CONSTRAINT ON (p:Person) ASSERT p.id IS UNIQUE")
+        self.env.assertNotIn("Constraints created: 1", stats)
+
+    def test02_enforce_constraint(self):
+        # creating a node holding a constrained value fails
+        self.expect_error("CREATE (:Person {id: 1})", "Unique constraint violation on :Person(id)")
+
+        # numerics compare by value
+        self.expect_error("CREATE (:Person {id: 1.0})", "Unique constraint violation")
+
+        # a node introducing a value twice within a single query is rolled back
+        self.expect_error("CREATE (:Person {id: 11}), (:Person {id: 11})", "Unique constraint violation")
+        result = redis_graph.query("MATCH (p:Person) RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 10)
+
+        # updating a node to hold a constrained value fails and is rolled back
+        self.expect_error("MATCH (p:Person {id: 1}) SET p.id = 2", "Unique constraint violation")
+        result = redis_graph.query("MATCH (p:Person {id: 1}) RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 1)
+
+        # nodes missing the constrained property aren't constrained
+        result = redis_graph.query("CREATE (:Person), (:Person)")
+        self.env.assertEquals(result.nodes_created, 2)
+        redis_graph.query("MATCH (p:Person) WHERE p.id IS NULL DELETE p")
+
+        # a node may keep its own value
+        redis_graph.query("MATCH (p:Person {id: 1}) SET p.id = 1")
+
+        # label holding a constraint along with unconstrained labels
+        self.expect_error("CREATE (:Person:Employee {id: 2})", "Unique constraint violation")
+
+        # values swapped within a single query remain unique
+        redis_graph.query("MATCH (a:Person {id: 1}), (b:Person {id: 2}) SET a.id = 2, b.id = 1")
+        result = redis_graph.query("MATCH (p:Person) WHERE p.id IN [1, 2] RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 2)
+
+    def test03_merge_probe(self):
+        # nodes are matched by probing the unique index
+        query = "UNWIND range(1, 20) AS x MERGE (p:Person {id: x}) RETURN count(p)"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Node By Index Scan", plan)
+
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], 20)
+        self.env.assertEquals(result.nodes_created, 10)
+
+        # rerunning the query creates no nodes
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], 20)
+        self.env.assertEquals(result.nodes_created, 0)
+
+    def test04_constraint_over_duplicates(self):
+        redis_graph.query("CREATE (:Dup {v: 1}), (:Dup {v: 1}), (:Dup {v: 2})")
+        self.expect_error("CREATE CONSTRAINT ON (d:Dup) ASSERT d.v IS UNIQUE",
+                          "property holds duplicate values")
+
+        # index introduced by the failed constraint is dropped
+        self.env.assertEquals(self.unique_properties('Dup'), None)
+
+        # constraint over an existing index
+        redis_graph.query("CREATE INDEX ON :Dup(v)")
+        self.expect_error("CREATE CONSTRAINT ON (d:Dup) ASSERT d.v IS UNIQUE",
+                          "property holds duplicate values")
+        self.env.assertEquals(self.unique_properties('Dup'), [])
+
+        redis_graph.query("MATCH (d:Dup {v: 1}) WITH d LIMIT 1 DELETE d")
+        stats = self.query_stats("CREATE CONSTRAINT ON (d:Dup) ASSERT d.v IS UNIQUE")
+        self.env.assertIn("Constraints created: 1", stats)
+        self.env.assertEquals(self.unique_properties('Dup'), ['v'])
+
+    def test05_persistence(self):
+        # constraints survive persistence
+        self.env.dumpAndReload()
+        self.env.assertEquals(self.unique_properties('Person'), ['id'])
+        self.env.assertEquals(self.unique_properties('Dup'), ['v'])
+        self.expect_error("CREATE (:Person {id: 1})", "Unique constraint violation")
+
+    def test06_drop_constraint(self):
+        # an index backing a constraint can't be dropped
+        self.expect_error("DROP INDEX ON :Person(id)", "index backs a unique constraint")
+
+        stats = self.query_stats("DROP CONSTRAINT ON (p:Person) ASSERT p.id IS UNIQUE")
+        self.env.assertIn("Constraints deleted: 1", stats)
+        self.env.assertEquals(self.unique_properties('Person'), [])
+
+        # backing index is retained, values are no longer constrained
+        result = redis_graph.query("CREATE (:Person {id: 1})")
+        self.env.assertEquals(result.nodes_created, 1)
+
+        self.expect_error("DROP CONSTRAINT ON (p:Person) ASSERT p.id IS UNIQUE",
+                          "no such constraint")
+
+    def test07_invalid_constraints(self):
+        self.expect_error("CREATE CONSTRAINT ON (p:Person) ASSERT exists(p.id)",
+                          "only supports unique constraints")
+        self.expect_error("CREATE CONSTRAINT ON (p:Person) ASSERT q.id IS UNIQUE",
+                          "property of the constrained node")
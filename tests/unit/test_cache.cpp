@@ -96,9 +96,64 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	// Verify that oldest entry do not exists - queue is [ 4 | 3 | 2 ].
 	ASSERT_TRUE(Cache_GetValue(cache, key1) == NULL);
 
+	//--------------------------------------------------------------------------
+	// Statistics
+	//--------------------------------------------------------------------------
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	ASSERT_EQ(stats.cap, 3);
+	ASSERT_EQ(stats.size, 3);
+	ASSERT_EQ(stats.hits, 2);
+	ASSERT_EQ(stats.misses, 2);
+	ASSERT_EQ(stats.evictions, 1);
+
 	Cache_Free(cache);
 
 	// Expecting CacheObjFree to be called 9 times.
 	ASSERT_EQ(free_count, 9);
 }
 
+TEST_F(CacheTest, ClockEviction) {
+	Cache *cache = Cache_New(3, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *keys[5] = {"a", "b", "c", "d", "e"};
+	for(int i = 0; i < 4; i++) {
+		Cache_SetValue(cache, keys[i], CacheObj_New(keys[i]));
+	}
+
+	// first eviction sweeps over all entries, evicting the oldest
+	// cache holds [ d | b | c ]
+	ASSERT_TRUE(Cache_GetValue(cache, "a") == NULL);
+
+	// a read entry is given a second chance
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, "b");
+	ASSERT_TRUE(from_cache != NULL);
+	CacheObj_Free(from_cache);
+
+	Cache_SetValue(cache, "e", CacheObj_New("e"));
+
+	// cache holds [ d | b | e ]
+	ASSERT_TRUE(Cache_GetValue(cache, "c") == NULL);
+	for(int i = 0; i < 5; i++) {
+		if(i == 0 || i == 2) continue;
+		from_cache = (CacheObj *)Cache_GetValue(cache, keys[i]);
+		ASSERT_TRUE(from_cache != NULL);
+		ASSERT_STREQ(from_cache->str, keys[i]);
+		CacheObj_Free(from_cache);
+	}
+
+	// re-inserting an existing key doesn't replace it
+	CacheObj *dup = CacheObj_New("b");
+	ASSERT_EQ(Cache_SetGetValue(cache, "b", dup), dup);
+	CacheObj_Free(dup);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	ASSERT_EQ(stats.size, 3);
+	ASSERT_EQ(stats.evictions, 2);
+
+	Cache_Free(cache);
+}
+
@@ -16,6 +16,8 @@ extern "C" {
 #include "../../src/util/datablock/datablock.h"
 #include "../../src/util/datablock/oo_datablock.h"
 #include "../../src/util/rmalloc.h"
+#include "../../src/util/storage_tier.h"
+#include "../../src/graph/entities/attribute_set.h"
 
 #ifdef __cplusplus
 }
@@ -241,3 +243,183 @@ TEST_F(DataBlockTest, OutOfOrderBuilding) {
 	DataBlock_Free(dataBlock);
 }
 
+
+TEST_F(DataBlockTest, TrackChanges) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, 1, sizeof(int), NULL);
+
+	// changes aren't tracked by default
+	DataBlock_AllocateItem(dataBlock, NULL);
+	ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, 0));
+
+	DataBlock_TrackChanges(dataBlock);
+	ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, 0));
+
+	// populate three ranges
+	uint64_t n = DATABLOCK_DIRTY_RANGE * 2 + 1;
+	for(uint64_t i = 1; i < n; i++) DataBlock_AllocateItem(dataBlock, NULL);
+
+	ASSERT_EQ(3, DataBlock_RangeCount(dataBlock));
+	for(uint64_t r = 0; r < 3; r++) {
+		ASSERT_TRUE(DataBlock_RangeIsDirty(dataBlock, r));
+	}
+
+	DataBlock_ClearDirty(dataBlock);
+	for(uint64_t r = 0; r < 3; r++) {
+		ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, r));
+	}
+
+	// deletion marks its range
+	DataBlock_DeleteItem(dataBlock, DATABLOCK_DIRTY_RANGE + 5);
+	ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, 0));
+	ASSERT_TRUE(DataBlock_RangeIsDirty(dataBlock, 1));
+	ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, 2));
+
+	// deleted items are still covered by ranges
+	ASSERT_EQ(3, DataBlock_RangeCount(dataBlock));
+
+	// explicit modification
+	DataBlock_ClearDirty(dataBlock);
+	DataBlock_MarkDirty(dataBlock, 3);
+	ASSERT_TRUE(DataBlock_RangeIsDirty(dataBlock, 0));
+	ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, 1));
+
+	// out of order allocations are never tracked
+	DataBlock_ClearDirty(dataBlock);
+	DataBlock_AllocateItemOutOfOrder(dataBlock, n + DATABLOCK_DIRTY_RANGE);
+	for(uint64_t r = 0; r < DataBlock_RangeCount(dataBlock); r++) {
+		ASSERT_FALSE(DataBlock_RangeIsDirty(dataBlock, r));
+	}
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, StorageTier) {
+	ASSERT_TRUE(StorageTier_Init("."));
+
+	uint64_t blockCap = 1024;
+	DataBlock *dataBlock = DataBlock_New(blockCap, blockCap, sizeof(int64_t), NULL);
+	DataBlock_UseStorageTier(dataBlock, NULL, NULL);
+
+	// populate three blocks
+	uint64_t n = blockCap * 3;
+	for(uint64_t i = 0; i < n; i++) {
+		int64_t *item = (int64_t *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// blocks are sealed explicitly
+	ASSERT_EQ(3, dataBlock->blockCount);
+	ASSERT_NE(0, dataBlock->blocks[0]->mappedSize);
+	ASSERT_EQ(-1, dataBlock->blocks[0]->offset);
+
+	// fully populated blocks are sealed, the last block remains anonymous
+	DataBlock_Seal(dataBlock);
+	ASSERT_NE(-1, dataBlock->blocks[0]->offset);
+	ASSERT_NE(-1, dataBlock->blocks[1]->offset);
+	ASSERT_EQ(-1, dataBlock->blocks[2]->offset);
+
+	// content is retained
+	for(uint64_t i = 0; i < n; i++) {
+		int64_t *item = (int64_t *)DataBlock_GetItem(dataBlock, i);
+		ASSERT_EQ(i, *item);
+	}
+
+	// sealed blocks remain writable
+	int64_t *item = (int64_t *)DataBlock_GetItem(dataBlock, 5);
+	*item = -5;
+	DataBlock_DeleteItem(dataBlock, 6);
+	ASSERT_EQ(-5, *(int64_t *)DataBlock_GetItem(dataBlock, 5));
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, 6) == NULL);
+
+	DataBlock_Free(dataBlock);
+
+	// out of order population
+	dataBlock = DataBlock_New(blockCap, blockCap, sizeof(int64_t), NULL);
+	DataBlock_UseStorageTier(dataBlock, NULL, NULL);
+
+	n = blockCap + blockCap / 2;
+	for(uint64_t i = 0; i < n; i++) {
+		int64_t *item = (int64_t *)DataBlock_AllocateItemOutOfOrder(dataBlock, n - i - 1);
+		*item = n - i - 1;
+	}
+	ASSERT_EQ(-1, dataBlock->blocks[0]->offset);
+
+	DataBlock_Seal(dataBlock);
+	ASSERT_NE(-1, dataBlock->blocks[0]->offset);
+	ASSERT_EQ(-1, dataBlock->blocks[1]->offset);
+
+	for(uint64_t i = 0; i < n; i++) {
+		int64_t *item = (int64_t *)DataBlock_GetItem(dataBlock, i);
+		ASSERT_EQ(i, *item);
+	}
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, StorageTierPacking) {
+	// storage tier is initialized once per process
+	if(!StorageTier_Enabled()) ASSERT_TRUE(StorageTier_Init("."));
+
+	uint64_t blockCap = 1024;
+	DataBlock *dataBlock = DataBlock_New(blockCap, blockCap,
+			sizeof(AttributeSet), (fpDestructor)AttributeSet_Free);
+	DataBlock_UseStorageTier(dataBlock, (fpPackedSize)AttributeSet_PackedSize,
+			(fpPack)AttributeSet_Pack);
+
+	// populate a block and a half, each entity holds a string and a number
+	char str[32];
+	uint64_t n = blockCap + blockCap / 2;
+	for(uint64_t i = 0; i < n; i++) {
+		AttributeSet *set = (AttributeSet *)DataBlock_AllocateItem(dataBlock, NULL);
+		*set = NULL;
+		sprintf(str, "value-%llu", (unsigned long long)i);
+		AttributeSet_Add(set, 0, SI_ConstStringVal(str));
+		AttributeSet_Add(set, 1, SI_LongVal(i));
+	}
+	DataBlock_DeleteItem(dataBlock, 3);
+
+	// only the fully populated block is packed
+	DataBlock_Seal(dataBlock);
+	ASSERT_TRUE(dataBlock->blocks[0]->payload != NULL);
+	ASSERT_NE(-1, dataBlock->blocks[0]->payloadOffset);
+	ASSERT_TRUE(dataBlock->blocks[1]->payload == NULL);
+
+	for(uint64_t i = 0; i < n; i++) {
+		AttributeSet *set = (AttributeSet *)DataBlock_GetItem(dataBlock, i);
+		if(i == 3) {
+			ASSERT_TRUE(set == NULL);
+			continue;
+		}
+
+		ASSERT_EQ(i < blockCap, (*set)->packed);
+		sprintf(str, "value-%llu", (unsigned long long)i);
+		ASSERT_STREQ(str, AttributeSet_Get(*set, 0)->stringval);
+		ASSERT_EQ(i, AttributeSet_Get(*set, 1)->longval);
+	}
+
+	// packed sets remain modifiable
+	AttributeSet *set = (AttributeSet *)DataBlock_GetItem(dataBlock, 5);
+	ASSERT_TRUE(AttributeSet_Update(set, 0, SI_ConstStringVal("updated")));
+	ASSERT_TRUE((*set)->packed);
+	ASSERT_STREQ("updated", AttributeSet_Get(*set, 0)->stringval);
+
+	// growing a packed set moves it back to the heap
+	set = (AttributeSet *)DataBlock_GetItem(dataBlock, 6);
+	AttributeSet_Add(set, 2, SI_BoolVal(true));
+	ASSERT_FALSE((*set)->packed);
+	ASSERT_STREQ("value-6", AttributeSet_Get(*set, 0)->stringval);
+	ASSERT_EQ(3, ATTRIBUTE_SET_COUNT(*set));
+
+	// as does shrinking it
+	set = (AttributeSet *)DataBlock_GetItem(dataBlock, 7);
+	ASSERT_TRUE(AttributeSet_Update(set, 1, SI_NullVal()));
+	ASSERT_FALSE((*set)->packed);
+	ASSERT_STREQ("value-7", AttributeSet_Get(*set, 0)->stringval);
+	ASSERT_EQ(1, ATTRIBUTE_SET_COUNT(*set));
+
+	// deleting entities within a packed block
+	DataBlock_DeleteItem(dataBlock, 5);
+	DataBlock_DeleteItem(dataBlock, 8);
+
+	DataBlock_Free(dataBlock);
+}
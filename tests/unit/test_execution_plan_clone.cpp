@@ -90,6 +90,10 @@ class ExecutionPlanCloneTest: public ::testing::Test {
 			ASSERT_TRUE(plan);
 			ExecutionPlan *clone = ExecutionPlan_Clone(plan);
 			ExecutionPlan_OpsEqual(plan, clone, plan->root, clone->root);
+			// query graphs are shared with the template
+			ASSERT_EQ(clone->query_graph, plan->query_graph);
+			ASSERT_TRUE(clone->shared_query_graphs);
+			ASSERT_FALSE(plan->shared_query_graphs);
 			AST_Free(ast);
 			ExecutionPlan_Free(clone);
 			ExecutionPlan_Free(plan);
@@ -0,0 +1,499 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/datatypes/array.h"
+#include "../../src/graph/entities/graph_entity.h"
+#include "../../src/index/ordered_index.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class OrderedIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+// collect entity IDs produced by iterating over 'ranges'
+static void _collect(OrderedIndex *idx, OrderedRange *ranges, EntityID *ids,
+		uint *count) {
+	OrderedIndexIterator *it = OrderedIndexIterator_New(idx, ranges);
+
+	const void *key;
+	*count = 0;
+	while((key = OrderedIndexIterator_Next(it)) != NULL) {
+		memcpy(ids + *count, key, sizeof(EntityID));
+		*count += 1;
+	}
+
+	OrderedIndexIterator_Free(it);
+}
+
+static OrderedRange *_range(SIType t, SIValue min, bool include_min,
+		SIValue max, bool include_max) {
+	OrderedRange *ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_New(t, min, include_min, max,
+				include_max));
+	return ranges;
+}
+
+TEST_F(OrderedIndexTest, Ranges) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	// entity i holds value i * 10
+	for(EntityID i = 0; i < 10; i++) {
+		OrderedIndex_Insert(idx, SI_LongVal(i * 10), &i);
+	}
+	EntityID s = 10;
+	OrderedIndex_Insert(idx, SI_ConstStringVal("a"), &s);
+	ASSERT_EQ(11, OrderedIndex_Count(idx));
+
+	uint count;
+	EntityID ids[16];
+
+	// equality, integers and doubles are comparable
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_DoubleVal(30), true, SI_DoubleVal(30),
+				true), ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(3, ids[0]);
+
+	// (20, 50]
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_LongVal(20), false, SI_LongVal(50),
+				true), ids, &count);
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(3, ids[0]);
+	ASSERT_EQ(4, ids[1]);
+	ASSERT_EQ(5, ids[2]);
+
+	// open range is bounded by type
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_LongVal(75), true, SI_NullVal(),
+				false), ids, &count);
+	ASSERT_EQ(2, count);
+	ASSERT_EQ(8, ids[0]);
+	ASSERT_EQ(9, ids[1]);
+
+	_collect(idx, _range(T_STRING, SI_NullVal(), false, SI_NullVal(), false),
+			ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(10, ids[0]);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, Updates) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	EntityID id = 7;
+	OrderedIndex_Insert(idx, SI_LongVal(1), &id);
+
+	// reindexing an entity replaces its previous value
+	OrderedIndex_Insert(idx, SI_LongVal(2), &id);
+	ASSERT_EQ(1, OrderedIndex_Count(idx));
+
+	uint count;
+	EntityID ids[4];
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_LongVal(1), true, SI_LongVal(1), true),
+			ids, &count);
+	ASSERT_EQ(0, count);
+
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_LongVal(2), true, SI_LongVal(2), true),
+			ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(7, ids[0]);
+
+	OrderedIndex_Remove(idx, &id);
+	ASSERT_EQ(0, OrderedIndex_Count(idx));
+
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_NullVal(), false, SI_NullVal(), false),
+			ids, &count);
+	ASSERT_EQ(0, count);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, ModifiedDuringIteration) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	for(EntityID i = 0; i < 4; i++) {
+		OrderedIndex_Insert(idx, SI_LongVal(i), &i);
+	}
+
+	OrderedIndexIterator *it = OrderedIndexIterator_New(idx,
+			_range((SIType)SI_NUMERIC, SI_NullVal(), false, SI_NullVal(), false));
+
+	EntityID id;
+	memcpy(&id, OrderedIndexIterator_Next(it), sizeof(EntityID));
+	ASSERT_EQ(0, id);
+
+	// remove the next entry, iterator should skip it
+	EntityID removed = 1;
+	OrderedIndex_Remove(idx, &removed);
+
+	memcpy(&id, OrderedIndexIterator_Next(it), sizeof(EntityID));
+	ASSERT_EQ(2, id);
+	memcpy(&id, OrderedIndexIterator_Next(it), sizeof(EntityID));
+	ASSERT_EQ(3, id);
+	ASSERT_TRUE(OrderedIndexIterator_Next(it) == NULL);
+
+	OrderedIndexIterator_Free(it);
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, TuplePrefix) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	// entity i holds tuple (i % 2, i)
+	for(EntityID i = 0; i < 10; i++) {
+		SIValue tuple[2] = {SI_LongVal(i % 2), SI_LongVal(i)};
+		OrderedIndex_InsertTuple(idx, tuple, 2, &i);
+	}
+	// missing values are indexed as null, ordering last
+	EntityID m = 10;
+	SIValue tuple[2] = {SI_LongVal(1), SI_NullVal()};
+	OrderedIndex_InsertTuple(idx, tuple, 2, &m);
+
+	uint count;
+	EntityID ids[16];
+	OrderedRange *ranges;
+	SIValue prefix[1] = {SI_LongVal(1)};
+
+	// prefix only, ordered by the following value
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, T_NULL, SI_NullVal(),
+				false, SI_NullVal(), false));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(6, count);
+	ASSERT_EQ(1, ids[0]);
+	ASSERT_EQ(3, ids[1]);
+	ASSERT_EQ(5, ids[2]);
+	ASSERT_EQ(7, ids[3]);
+	ASSERT_EQ(9, ids[4]);
+	ASSERT_EQ(10, ids[5]);
+
+	// prefix followed by [3, 7]
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, (SIType)SI_NUMERIC,
+				SI_LongVal(3), true, SI_LongVal(7), true));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(3, ids[0]);
+	ASSERT_EQ(5, ids[1]);
+	ASSERT_EQ(7, ids[2]);
+
+	// prefix followed by (3, 7)
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, (SIType)SI_NUMERIC,
+				SI_LongVal(3), false, SI_LongVal(7), false));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(5, ids[0]);
+
+	// open range within prefix is bounded by type, excluding nulls
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, (SIType)SI_NUMERIC,
+				SI_LongVal(6), true, SI_NullVal(), false));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(2, count);
+	ASSERT_EQ(7, ids[0]);
+	ASSERT_EQ(9, ids[1]);
+
+	// full tuple equality
+	SIValue point[2] = {SI_LongVal(0), SI_DoubleVal(4)};
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(point, 2, T_NULL, SI_NullVal(),
+				false, SI_NullVal(), false));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(4, ids[0]);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, Reverse) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	// entity i holds value i * 10
+	for(EntityID i = 0; i < 10; i++) {
+		OrderedIndex_Insert(idx, SI_LongVal(i * 10), &i);
+	}
+
+	uint count;
+	EntityID ids[16];
+	OrderedIndexIterator *it;
+	const void *key;
+
+	// [20, 50)
+	it = OrderedIndexIterator_New(idx, _range((SIType)SI_NUMERIC, SI_LongVal(20), true,
+				SI_LongVal(50), false));
+	OrderedIndexIterator_Reverse(it);
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+	}
+	OrderedIndexIterator_Free(it);
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(4, ids[0]);
+	ASSERT_EQ(3, ids[1]);
+	ASSERT_EQ(2, ids[2]);
+
+	// (20, 50]
+	it = OrderedIndexIterator_New(idx, _range((SIType)SI_NUMERIC, SI_LongVal(20), false,
+				SI_LongVal(50), true));
+	OrderedIndexIterator_Reverse(it);
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+	}
+	OrderedIndexIterator_Free(it);
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(5, ids[0]);
+	ASSERT_EQ(4, ids[1]);
+	ASSERT_EQ(3, ids[2]);
+
+	// multiple ranges are visited last to first
+	OrderedRange *ranges = array_new(OrderedRange, 2);
+	array_append(ranges, OrderedRange_New((SIType)SI_NUMERIC, SI_LongVal(10), true,
+				SI_LongVal(10), true));
+	array_append(ranges, OrderedRange_New((SIType)SI_NUMERIC, SI_LongVal(70), true,
+				SI_NullVal(), false));
+	it = OrderedIndexIterator_New(idx, ranges);
+	OrderedIndexIterator_Reverse(it);
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+	}
+	ASSERT_EQ(4, count);
+	ASSERT_EQ(9, ids[0]);
+	ASSERT_EQ(8, ids[1]);
+	ASSERT_EQ(7, ids[2]);
+	ASSERT_EQ(1, ids[3]);
+
+	// reset restarts from the last entry
+	OrderedIndexIterator_Reset(it);
+	memcpy(ids, OrderedIndexIterator_Next(it), sizeof(EntityID));
+	ASSERT_EQ(9, ids[0]);
+	OrderedIndexIterator_Free(it);
+
+	OrderedIndex_Free(idx);
+
+	// entity i holds tuple (i % 2, i), missing values order first
+	idx = OrderedIndex_New(sizeof(EntityID));
+	for(EntityID i = 0; i < 10; i++) {
+		SIValue tuple[2] = {SI_LongVal(i % 2), SI_LongVal(i)};
+		OrderedIndex_InsertTuple(idx, tuple, 2, &i);
+	}
+	EntityID m = 10;
+	SIValue tuple[2] = {SI_LongVal(1), SI_NullVal()};
+	OrderedIndex_InsertTuple(idx, tuple, 2, &m);
+
+	SIValue prefix[1] = {SI_LongVal(1)};
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, T_NULL, SI_NullVal(),
+				false, SI_NullVal(), false));
+	it = OrderedIndexIterator_New(idx, ranges);
+	OrderedIndexIterator_Reverse(it);
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+	}
+	OrderedIndexIterator_Free(it);
+	ASSERT_EQ(6, count);
+	ASSERT_EQ(10, ids[0]);
+	ASSERT_EQ(9, ids[1]);
+	ASSERT_EQ(1, ids[5]);
+
+	// prefix followed by (3, 7)
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, (SIType)SI_NUMERIC,
+				SI_LongVal(3), false, SI_LongVal(7), false));
+	it = OrderedIndexIterator_New(idx, ranges);
+	OrderedIndexIterator_Reverse(it);
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+	}
+	OrderedIndexIterator_Free(it);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(5, ids[0]);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, StringPrefix) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	const char *values[6] = {"a", "ab", "abc", "abd", "b", "aa"};
+	for(EntityID i = 0; i < 6; i++) {
+		OrderedIndex_Insert(idx, SI_ConstStringVal((char *)values[i]), &i);
+	}
+	EntityID n = 6;
+	OrderedIndex_Insert(idx, SI_LongVal(1), &n);
+
+	// strings opening with "ab", in order
+	OrderedRange *ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewStringPrefix("ab"));
+	OrderedIndexIterator *it = OrderedIndexIterator_New(idx, ranges);
+
+	uint count;
+	const void *key;
+	EntityID ids[8];
+	for(count = 0; (key = OrderedIndexIterator_Next(it)) != NULL; count++) {
+		memcpy(ids + count, key, sizeof(EntityID));
+
+		// indexed value is stored along the entry
+		const SIValue *stored = OrderedIndexIterator_Values(it);
+		ASSERT_EQ(T_STRING, SI_TYPE(stored[0]));
+		ASSERT_STREQ(values[ids[count]], stored[0].stringval);
+	}
+	OrderedIndexIterator_Free(it);
+
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(1, ids[0]);
+	ASSERT_EQ(2, ids[1]);
+	ASSERT_EQ(3, ids[2]);
+
+	// empty prefix covers every string
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewStringPrefix(""));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(6, count);
+	ASSERT_EQ(0, ids[0]);
+	ASSERT_EQ(4, ids[5]);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, StoredValues) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	// entity i holds tuple (i % 2, i * 1.5)
+	for(EntityID i = 0; i < 4; i++) {
+		SIValue tuple[2] = {SI_LongVal(i % 2), SI_DoubleVal(i * 1.5)};
+		OrderedIndex_InsertTuple(idx, tuple, 2, &i);
+	}
+
+	// replacing an entry replaces its stored values
+	EntityID e = 3;
+	SIValue tuple[2] = {SI_LongVal(1), SI_ConstStringVal((char *)"x")};
+	OrderedIndex_InsertTuple(idx, tuple, 2, &e);
+
+	SIValue prefix[1] = {SI_LongVal(1)};
+	OrderedRange *ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(prefix, 1, T_NULL, SI_NullVal(),
+				false, SI_NullVal(), false));
+	OrderedIndexIterator *it = OrderedIndexIterator_New(idx, ranges);
+
+	// strings order before numerics
+	const void *key = OrderedIndexIterator_Next(it);
+	ASSERT_TRUE(key != NULL);
+	const SIValue *stored = OrderedIndexIterator_Values(it);
+	ASSERT_EQ(1, stored[0].longval);
+	ASSERT_STREQ("x", stored[1].stringval);
+
+	// integers and doubles are kept apart
+	key = OrderedIndexIterator_Next(it);
+	ASSERT_TRUE(key != NULL);
+	stored = OrderedIndexIterator_Values(it);
+	ASSERT_EQ(T_INT64, SI_TYPE(stored[0]));
+	ASSERT_EQ(T_DOUBLE, SI_TYPE(stored[1]));
+	ASSERT_EQ(1.5, stored[1].doubleval);
+
+	ASSERT_TRUE(OrderedIndexIterator_Next(it) == NULL);
+	OrderedIndexIterator_Free(it);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, Lookup) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	EntityID a = 1;
+	EntityID b = 2;
+	OrderedIndex_Insert(idx, SI_ConstStringVal((char *)"ab"), &a);
+	OrderedIndex_Insert(idx, SI_LongVal(7), &b);
+	ASSERT_FALSE(OrderedIndex_HasDuplicates(idx));
+
+	EntityID key = 0;
+	const SIValue *stored = OrderedIndex_Lookup(idx,
+			SI_ConstStringVal((char *)"ab"), &key);
+	ASSERT_TRUE(stored != NULL);
+	ASSERT_EQ(a, key);
+	ASSERT_STREQ("ab", stored[0].stringval);
+
+	// strings opening with a looked up string don't match it
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, SI_ConstStringVal((char *)"a"), &key)
+			== NULL);
+
+	// numerics compare by value
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, SI_DoubleVal(7.0), &key) != NULL);
+	ASSERT_EQ(b, key);
+
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, SI_LongVal(8), &key) == NULL);
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, SI_NullVal(), &key) == NULL);
+
+	// entities sharing a value
+	EntityID c = 3;
+	OrderedIndex_Insert(idx, SI_DoubleVal(7.0), &c);
+	ASSERT_TRUE(OrderedIndex_HasDuplicates(idx));
+
+	OrderedIndex_Remove(idx, &b);
+	ASSERT_FALSE(OrderedIndex_HasDuplicates(idx));
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, UnindexableValues) {
+	OrderedIndex *idx = OrderedIndex_New(sizeof(EntityID));
+
+	SIValue arr = SIArray_New(1);
+	SIArray_Append(&arr, SI_LongVal(1));
+
+	// entities 0 and 1 hold null, 2 and 3 hold the same array
+	SIValue values[6] = {SI_NullVal(), SI_NullVal(), arr, arr,
+		SI_Point(1, 2), SI_LongVal(7)};
+	for(EntityID i = 0; i < 6; i++) {
+		OrderedIndex_Insert(idx, values[i], &i);
+	}
+	SIArray_Free(arr);
+
+	// values which can't be looked up never conflict
+	ASSERT_EQ(6, OrderedIndex_Count(idx));
+	ASSERT_FALSE(OrderedIndex_HasDuplicates(idx));
+
+	EntityID key = 0;
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, SI_NullVal(), &key) == NULL);
+
+	uint count;
+	EntityID ids[8];
+	OrderedRange *ranges;
+
+	// a scan over the entire index orders every entity by type
+	ranges = array_new(OrderedRange, 1);
+	array_append(ranges, OrderedRange_NewPrefix(NULL, 0, T_NULL, SI_NullVal(),
+				false, SI_NullVal(), false));
+	_collect(idx, ranges, ids, &count);
+	ASSERT_EQ(6, count);
+	ASSERT_EQ(2, ids[0]);
+	ASSERT_EQ(3, ids[1]);
+	ASSERT_EQ(5, ids[2]);
+	ASSERT_EQ(0, ids[3]);
+	ASSERT_EQ(1, ids[4]);
+	ASSERT_EQ(4, ids[5]);
+
+	// ranges are bounded by type
+	_collect(idx, _range((SIType)SI_NUMERIC, SI_NullVal(), false, SI_NullVal(),
+				false), ids, &count);
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(5, ids[0]);
+
+	OrderedIndex_Free(idx);
+}
@@ -59,3 +59,27 @@ TEST_F(RecordTest, RecordToString) {
 	Record_Free(r);
 }
 
+
+TEST_F(RecordTest, RecordNodeID) {
+	rax *_rax = raxNew();
+	for(int i = 0; i < 3; i++) {
+		char buf[2] = {(char)i, '\0'};
+		raxInsert(_rax, (unsigned char *)buf, 2, NULL, NULL);
+	}
+
+	Record r = Record_New(_rax);
+	Record_AddNodeID(r, 0, 7);
+	Record_AddScalar(r, 1, SI_NullVal());
+
+	// ID-only nodes report their ID without being materialized
+	ASSERT_EQ(Record_GetType(r, 0), REC_TYPE_NODE_ID);
+	ASSERT_EQ(Record_GetNodeID(r, 0), 7);
+	ASSERT_EQ(Record_GetType(r, 0), REC_TYPE_NODE_ID);
+
+	// missing and NULL entries
+	ASSERT_EQ(Record_GetNodeID(r, 1), INVALID_ENTITY_ID);
+	ASSERT_EQ(Record_GetNodeID(r, 2), INVALID_ENTITY_ID);
+
+	Record_Free(r);
+	raxFree(_rax);
+}
@@ -841,6 +841,75 @@ TEST_F(RGMatrixTest, RGMatrix_flush) {
 	ASSERT_TRUE(A == NULL);
 }
 
+// pending changes aren't merged while sync is deferred
+TEST_F(RGMatrixTest, RGMatrix_defer_sync) {
+	GrB_Type    t                   =  GrB_BOOL;
+	RG_Matrix   A                   =  NULL;
+	GrB_Matrix  M                   =  NULL;
+	GrB_Matrix  DP                  =  NULL;
+	GrB_Matrix  DM                  =  NULL;
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nvals               =  0;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+
+	// merge on every wait
+	Config_Option_set(Config_DELTA_MAX_PENDING_CHANGES, "1");
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+
+	RG_Matrix_DeferSync(true);
+
+	info = RG_Matrix_setElement_BOOL(A, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// merge is deferred
+	RG_Matrix_wait(A, false);
+	ASSERT_EQ(RG_Matrix_DeferredSyncCount(), 1);
+	M_EMPTY();
+	DM_EMPTY();
+	DP_NOT_EMPTY();
+
+	// forced sync isn't deferred
+	RG_Matrix_wait(A, true);
+	M_NOT_EMPTY();
+	DP_EMPTY();
+
+	// pending changes grow beyond deferral limit
+	for(GrB_Index i = 1; i < nrows; i++) {
+		info = RG_Matrix_setElement_BOOL(A, i, 1);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+	RG_Matrix_wait(A, false);
+	DP_EMPTY();
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, nrows);
+
+	// resume normal behavior
+	RG_Matrix_DeferSync(false);
+
+	info = RG_Matrix_removeElement_BOOL(A, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_wait(A, false);
+	DM_EMPTY();
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, nrows - 1);
+
+	// restore flush threshold
+	Config_Option_set(Config_DELTA_MAX_PENDING_CHANGES, "10000");
+
+	// clean up
+	RG_Matrix_free(&A);
+	ASSERT_TRUE(A == NULL);
+}
+
 //------------------------------------------------------------------------------
 // transpose test
 //------------------------------------------------------------------------------
@@ -1034,6 +1103,122 @@ TEST_F(RGMatrixTest, RGMatrix_managed_transposed) {
 	ASSERT_TRUE(A == NULL);
 }
 
+// set a batch of entries
+TEST_F(RGMatrixTest, RGMatrix_set_elements) {
+	RG_Matrix   A                   =  NULL;
+	RG_Matrix   T                   =  NULL;  // A transposed
+	GrB_Matrix  M                   =  NULL;  // primary internal matrix
+	GrB_Matrix  DP                  =  NULL;  // delta plus
+	GrB_Matrix  DM                  =  NULL;  // delta minus
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nvals               =  0;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+	uint64_t    x                   =  0;
+	bool        b                   =  false;
+
+	//--------------------------------------------------------------------------
+	// uint64 matrix
+	//--------------------------------------------------------------------------
+
+	info = RG_Matrix_new(&A, GrB_UINT64, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	T   =  RG_Matrix_getTranspose(A);
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+
+	// flushed entry at position 0,1
+	info = RG_Matrix_setElement_UINT64(A, 1, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_wait(A, true);
+
+	// [0,1] already exists, [2,4] is new, [3,5] is repeated
+	GrB_Index  I[4]  =  {0,  2,  3,  3};
+	GrB_Index  J[4]  =  {1,  4,  5,  5};
+	uint64_t   X[4]  =  {10, 11, 12, 13};
+
+	info = RG_Matrix_setElements_UINT64(A, I, J, X, 4);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_TRUE(RG_Matrix_isDirty(A));
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, 3);
+
+	// new entry is a single edge
+	info = RG_Matrix_extractElement_UINT64(&x, A, 2, 4);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(x, 11);
+
+	// existing and repeated entries turned into multi-edge
+	info = RG_Matrix_extractElement_UINT64(&x, A, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 3, 5);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+
+	// M holds [0,1], DP holds [2,4] and [3,5]
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 1);
+	GrB_Matrix_nvals(&nvals, DP);
+	ASSERT_EQ(nvals, 2);
+	DM_EMPTY();
+
+	// transposed is updated
+	for(int k = 0; k < 4; k++) {
+		info = RG_Matrix_extractElement_BOOL(&b, T, J[k], I[k]);
+		ASSERT_EQ(info, GrB_SUCCESS);
+		ASSERT_TRUE(b);
+	}
+	RG_Matrix_nvals(&nvals, T);
+	ASSERT_EQ(nvals, 3);
+
+	RG_Matrix_free(&A);
+	ASSERT_TRUE(A == NULL);
+
+	//--------------------------------------------------------------------------
+	// boolean matrix
+	//--------------------------------------------------------------------------
+
+	info = RG_Matrix_new(&A, GrB_BOOL, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+
+	// entry at position 1,1 marked for deletion
+	info = RG_Matrix_setElement_BOOL(A, 1, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_wait(A, true);
+	info = RG_Matrix_removeElement_BOOL(A, 1, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	DM_NOT_EMPTY();
+
+	// [1,1] is revived, [2,2] is new and repeated
+	GrB_Index  BI[3]  =  {1, 2, 2};
+	GrB_Index  BJ[3]  =  {1, 2, 2};
+
+	info = RG_Matrix_setElements_BOOL(A, BI, BJ, 3);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, 2);
+
+	// M holds [1,1], DP holds [2,2]
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 1);
+	GrB_Matrix_nvals(&nvals, DP);
+	ASSERT_EQ(nvals, 1);
+	DM_EMPTY();
+
+	RG_Matrix_free(&A);
+	ASSERT_TRUE(A == NULL);
+}
+
 //------------------------------------------------------------------------------
 // fuzzy test compare RG_Matrix to GrB_Matrix
 //------------------------------------------------------------------------------
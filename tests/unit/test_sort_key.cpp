@@ -0,0 +1,137 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/sort_key.h"
+#include "../../src/datatypes/array.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class SortKeyTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+static int _sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+// compares the sort keys of 'a' and 'b'
+static int _compare(SIValue a, SIValue b, bool desc) {
+	sds ka = SortKey_Append(sdsempty(), a, desc);
+	sds kb = SortKey_Append(sdsempty(), b, desc);
+	int rel = SortKey_Compare(ka, kb);
+	sdsfree(ka);
+	sdsfree(kb);
+	return _sign(rel);
+}
+
+TEST_F(SortKeyTest, ScalarOrder) {
+	SIValue values[11] = {
+		SI_ConstStringVal(""),
+		SI_ConstStringVal("a"),
+		SI_ConstStringVal("ab"),
+		SI_ConstStringVal("b"),
+		SI_BoolVal(false),
+		SI_BoolVal(true),
+		SI_DoubleVal(-2.5),
+		SI_LongVal(-2),
+		SI_DoubleVal(0),
+		SI_LongVal(1),
+		SI_DoubleVal(1.5),
+	};
+
+	// keys order as SIValue_Compare does
+	for(int i = 0; i < 11; i++) {
+		for(int j = 0; j < 11; j++) {
+			int expected = _sign(SIValue_Compare(values[i], values[j], NULL));
+			ASSERT_EQ(expected, _compare(values[i], values[j], false));
+			ASSERT_EQ(-expected, _compare(values[i], values[j], true));
+		}
+	}
+}
+
+TEST_F(SortKeyTest, Numerics) {
+	// integers and doubles holding the same value are equal
+	ASSERT_EQ(0, _compare(SI_LongVal(3), SI_DoubleVal(3.0), false));
+	ASSERT_EQ(0, _compare(SI_DoubleVal(-0.0), SI_DoubleVal(0.0), false));
+
+	// integers which can't be told apart as doubles
+	ASSERT_EQ(-1, _compare(SI_LongVal(INT64_MAX - 1), SI_LongVal(INT64_MAX), false));
+	ASSERT_EQ(-1, _compare(SI_LongVal(INT64_MIN), SI_LongVal(INT64_MIN + 1), false));
+	ASSERT_EQ(-1, _compare(SI_LongVal(-1), SI_LongVal(0), false));
+}
+
+TEST_F(SortKeyTest, Null) {
+	// nulls are ordered after all other scalars
+	ASSERT_EQ(-1, _compare(SI_LongVal(100), SI_NullVal(), false));
+	ASSERT_EQ(-1, _compare(SI_ConstStringVal("z"), SI_NullVal(), false));
+	ASSERT_EQ(1, _compare(SI_LongVal(100), SI_NullVal(), true));
+	ASSERT_EQ(0, _compare(SI_NullVal(), SI_NullVal(), false));
+}
+
+TEST_F(SortKeyTest, Arrays) {
+	SIValue a = SI_Array(2);
+	SIValue b = SI_Array(2);
+	SIValue c = SI_Array(1);
+
+	SIArray_Append(&a, SI_LongVal(1));
+	SIArray_Append(&a, SI_LongVal(2));
+	SIArray_Append(&b, SI_LongVal(1));
+	SIArray_Append(&b, SI_LongVal(3));
+	SIArray_Append(&c, SI_LongVal(1));
+
+	// lists are compared element by element, then by length
+	ASSERT_EQ(-1, _compare(a, b, false));
+	ASSERT_EQ(-1, _compare(c, a, false));
+	ASSERT_EQ(1, _compare(c, a, true));
+	ASSERT_EQ(0, _compare(a, a, false));
+
+	// lists are ordered before strings
+	ASSERT_EQ(-1, _compare(a, SI_ConstStringVal(""), false));
+
+	SIValue_Free(a);
+	SIValue_Free(b);
+	SIValue_Free(c);
+}
+
+TEST_F(SortKeyTest, Tuples) {
+	// (1, "b") < (1, "c") < (2, "a")
+	sds k1 = SortKey_Append(sdsempty(), SI_LongVal(1), false);
+	k1 = SortKey_Append(k1, SI_ConstStringVal("b"), false);
+	sds k2 = SortKey_Append(sdsempty(), SI_LongVal(1), false);
+	k2 = SortKey_Append(k2, SI_ConstStringVal("c"), false);
+	sds k3 = SortKey_Append(sdsempty(), SI_LongVal(2), false);
+	k3 = SortKey_Append(k3, SI_ConstStringVal("a"), false);
+
+	ASSERT_LT(SortKey_Compare(k1, k2), 0);
+	ASSERT_LT(SortKey_Compare(k2, k3), 0);
+
+	// mixed directions, first value ascending, second descending
+	sds d1 = SortKey_Append(sdsempty(), SI_LongVal(1), false);
+	d1 = SortKey_Append(d1, SI_ConstStringVal("b"), true);
+	sds d2 = SortKey_Append(sdsempty(), SI_LongVal(1), false);
+	d2 = SortKey_Append(d2, SI_ConstStringVal("ba"), true);
+
+	ASSERT_GT(SortKey_Compare(d1, d2), 0);
+
+	sdsfree(k1);
+	sdsfree(k2);
+	sdsfree(k3);
+	sdsfree(d1);
+	sdsfree(d2);
+}